@@ -45,6 +45,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/local_session_selection.h"
 #include "tensorflow/core/common_runtime/memory_types.h"
 #include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/common_runtime/process_state.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
@@ -72,6 +73,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/core/threadpool_options.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/numbers.h"
@@ -82,6 +84,7 @@ limitations under the License.
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/lib/connected_traceme.h"
 #include "tensorflow/core/profiler/lib/device_profiler_session.h"
@@ -188,6 +191,18 @@ thread::ThreadPool* GlobalThreadPool(const SessionOptions& options,
   return registry->default_pool;
 }
 
+// If positive, overrides the number of NUMA nodes that sessions partition
+// their threads over. Set by DirectSession::TestOnlySetNumNumaNodes.
+std::atomic<int> test_only_num_numa_nodes{0};
+
+// Returns the number of NUMA nodes that sessions with
+// `config.experimental.use_numa_affinity` partition their threads over.
+int NumNumaNodes() {
+  const int test_only_num_nodes = test_only_num_numa_nodes.load();
+  if (test_only_num_nodes > 0) return test_only_num_nodes;
+  return port::NUMAEnabled() ? port::NUMANumNodes() : 1;
+}
+
 // TODO(vrv): Figure out how to unify the many different functions
 // that generate RendezvousKey, since many of them have to be
 // consistent with each other.
@@ -380,8 +395,18 @@ DirectSession::DirectSession(const SessionOptions& options,
       thread_pools_.emplace_back(pool, owned);
     }
   } else if (options_.config.use_per_session_threads()) {
-    thread_pools_.emplace_back(NewThreadPoolFromSessionOptions(options_),
-                               true /* owned */);
+    if (options_.config.experimental().use_numa_affinity()) {
+      CreateNumaNodeThreads(NumNumaNodes());
+    }
+    if (numa_node_threads_.empty()) {
+      thread_pools_.emplace_back(NewThreadPoolFromSessionOptions(options_),
+                                 true /* owned */);
+    } else {
+      // Runs that do not pick a node use node 0's threads, rather than a
+      // full-size pool that would over-subscribe the host.
+      thread_pools_.emplace_back(numa_node_threads_[0]->inter_op_pool.get(),
+                                 false /* owned */);
+    }
   } else {
     // Run locally if environment value of TF_NUM_INTEROP_THREADS is negative
     // and config.inter_op_parallelism_threads is unspecified or negative.
@@ -429,6 +454,46 @@ DirectSession::DirectSession(const SessionOptions& options,
   }
 }
 
+void DirectSession::CreateNumaNodeThreads(int num_numa_nodes) {
+  if (num_numa_nodes < 2) return;
+  const int num_inter_op_threads =
+      NumInterOpThreadsFromSessionOptions(options_);
+  int num_intra_op_threads = options_.config.intra_op_parallelism_threads();
+  if (num_intra_op_threads <= 0) num_intra_op_threads = port::MaxParallelism();
+  const bool low_latency_hint =
+      !options_.config.experimental().disable_thread_spinning();
+  for (int node = 0; node < num_numa_nodes; ++node) {
+    auto threads = std::make_unique<NumaNodeThreads>();
+    threads->numa_node = node;
+    ThreadOptions thread_options;
+    thread_options.numa_node = node;
+    threads->inter_op_pool = std::make_unique<thread::ThreadPool>(
+        options_.env, thread_options, absl::StrCat("ComputeNuma", node),
+        std::max(1, num_inter_op_threads / num_numa_nodes), low_latency_hint,
+        /*allocator=*/nullptr);
+    threads->intra_op_pool = std::make_unique<thread::ThreadPool>(
+        options_.env, thread_options, absl::StrCat("IntraOpNuma", node),
+        std::max(1, num_intra_op_threads / num_numa_nodes), low_latency_hint,
+        /*allocator=*/nullptr);
+    threads->allocator =
+        ProcessState::singleton()->GetNUMABoundCPUAllocator(node);
+    numa_node_threads_.push_back(std::move(threads));
+  }
+  VLOG(1) << "Direct session partitioned its threads over " << num_numa_nodes
+          << " NUMA nodes";
+}
+
+DirectSession::NumaNodeThreads* DirectSession::PickNumaNode() {
+  NumaNodeThreads* best = numa_node_threads_[0].get();
+  for (const auto& threads : numa_node_threads_) {
+    if (threads->num_active_steps.load(std::memory_order_relaxed) <
+        best->num_active_steps.load(std::memory_order_relaxed)) {
+      best = threads.get();
+    }
+  }
+  return best;
+}
+
 // Calling Run() concurrently with destruction is a caller bug; this wait is a
 // bounded mitigation for runs in flight when destruction begins, relying on
 // Close()'s cancellation to unwind them.
@@ -650,6 +715,8 @@ absl::Status DirectSession::RunInternal(
   thread::ThreadPool* pool;
   // Use std::unique_ptr to ensure garbage collection
   std::unique_ptr<thread::ThreadPool> threadpool_wrapper;
+  // The NUMA node running this step, if the session is partitioned by node.
+  NumaNodeThreads* numa_node = nullptr;
 
   const bool inline_execution_requested =
       run_in_caller_thread_ || run_options.inter_op_thread_pool() == -1;
@@ -677,7 +744,20 @@ absl::Status DirectSession::RunInternal(
     }
 
     pool = thread_pools_[run_options.inter_op_thread_pool()].first;
+    if (!numa_node_threads_.empty() &&
+        run_options.inter_op_thread_pool() == 0) {
+      numa_node = PickNumaNode();
+      pool = numa_node->inter_op_pool.get();
+    }
+  }
+  if (numa_node != nullptr) {
+    numa_node->num_active_steps.fetch_add(1, std::memory_order_relaxed);
   }
+  auto numa_node_cleanup = gtl::MakeCleanup([numa_node] {
+    if (numa_node != nullptr) {
+      numa_node->num_active_steps.fetch_sub(1, std::memory_order_relaxed);
+    }
+  });
 
   const int64_t call_timeout = run_options.timeout_in_ms() > 0
                                    ? run_options.timeout_in_ms()
@@ -743,6 +823,15 @@ absl::Status DirectSession::RunInternal(
   args.run_all_kernels_inline = pool == nullptr;
   args.start_time_usecs = start_time_usecs;
   args.deadline = deadline;
+  if (numa_node != nullptr) {
+    // Keep the kernels and the host memory of the step on the same node as
+    // its inter-op threads.
+    if (args.user_intra_op_threadpool == nullptr) {
+      args.user_intra_op_threadpool =
+          numa_node->intra_op_pool->AsEigenThreadPool();
+    }
+    args.user_host_allocator = numa_node->allocator;
+  }
 
   const bool do_trace = (run_options.trace_level() > RunOptions::NO_TRACE);
 
@@ -2183,4 +2272,8 @@ void DirectSession::TestOnlyResetGlobalThreadPool() {
   registry->default_pool = nullptr;
 }
 
+void DirectSession::TestOnlySetNumNumaNodes(int num_numa_nodes) {
+  test_only_num_numa_nodes.store(num_numa_nodes);
+}
+
 }  // namespace tensorflow
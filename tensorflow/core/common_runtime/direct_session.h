@@ -144,9 +144,16 @@ class DirectSession : public Session {
   // Never use in production.
   static void TestOnlyResetGlobalThreadPool();
 
+  // Makes sessions created afterwards partition their threads as if the host
+  // had `num_numa_nodes` NUMA nodes, or restores the host's count if it is 0.
+  // FOR TESTING ONLY.
+  static void TestOnlySetNumNumaNodes(int num_numa_nodes);
+
  private:
   // For access to collective_graph_key_.
   friend class DirectSessionCollectiveTest;
+  // For access to thread_pools_ and numa_node_threads_.
+  friend class DirectSessionNumaTest;
 
   // We create one executor and its dependent library runtime for
   // every partition.
@@ -358,6 +365,27 @@ class DirectSession : public Session {
   // is owned.
   std::vector<std::pair<thread::ThreadPool*, bool>> thread_pools_;
 
+  // The threads and host memory of one NUMA node. Sessions with their own
+  // threads and `config.experimental.use_numa_affinity` partition their
+  // threads by node, and run each step on a single node.
+  struct NumaNodeThreads {
+    int numa_node = 0;
+    std::unique_ptr<thread::ThreadPool> inter_op_pool;
+    std::unique_ptr<thread::ThreadPool> intra_op_pool;
+    Allocator* allocator = nullptr;  // Not owned.
+    std::atomic<int> num_active_steps{0};
+  };
+
+  // Creates `numa_node_threads_` for `num_numa_nodes` nodes, unless there is
+  // a single node.
+  void CreateNumaNodeThreads(int num_numa_nodes);
+
+  // Returns the node with the fewest active steps.
+  // REQUIRES: !numa_node_threads_.empty()
+  NumaNodeThreads* PickNumaNode();
+
+  std::vector<std::unique_ptr<NumaNodeThreads>> numa_node_threads_;
+
   absl::Status init_error_;  // Set to an error if construction failed.
 
   // If true, blocks until device has finished all queued operations in a step.
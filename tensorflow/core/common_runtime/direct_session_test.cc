@@ -48,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
@@ -788,6 +789,34 @@ TEST_F(DirectSessionMinusAXTest, TestPerSessionThreads) {
   delete tp;
 }
 
+TEST_F(DirectSessionMinusAXTest, TestPerSessionThreadsNumaAffinity) {
+  Initialize({1, 2, 3, 4});
+
+  // On hosts with a single NUMA node, the session uses its usual threads.
+  SessionOptions options;
+  options.config.set_use_per_session_threads(true);
+  options.config.mutable_experimental()->set_use_numa_affinity(true);
+  std::unique_ptr<Session> session(NewSession(options));
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def_));
+
+  thread::ThreadPool* tp = new thread::ThreadPool(Env::Default(), "test", 4);
+  std::vector<std::string> output_names = {y_ + ":0"};
+  auto fn = [&session, output_names]() {
+    for (int i = 0; i < 100; ++i) {
+      std::vector<Tensor> outputs;
+      TF_ASSERT_OK(session->Run({}, output_names, {}, &outputs));
+      ASSERT_EQ(1, outputs.size());
+      auto mat = outputs[0].matrix<float>();
+      EXPECT_FLOAT_EQ(3.0, mat(0, 0));
+    }
+  };
+  for (int i = 0; i < 4; ++i) {
+    tp->Schedule(fn);
+  }
+  delete tp;
+}
+
 TEST_F(DirectSessionMinusAXTest, TwoCreateCallsFails) {
   Initialize({1, 2, 3, 4});
   auto session = CreateSession();
@@ -2957,6 +2986,52 @@ void BM_FeedFetchCallableSingleThreadExecutor(
                            /* use_single_threaded_executor */ true);
 }
 
+// Runs independent matmul steps from several client threads, in a session
+// whose threads and host memory are (arg 1) or are not (arg 0) partitioned by
+// NUMA node.
+void BM_DirectSessionNumaAffinity(::testing::benchmark::State& state) {
+  const bool use_numa_affinity = state.range(0);
+  const int kNumClients = 8;
+  const int kDim = 256;
+
+  Graph g(OpRegistry::Global());
+  Tensor value(DT_FLOAT, TensorShape({kDim, kDim}));
+  value.flat<float>().setConstant(1.0f);
+  Node* x = test::graph::Constant(&g, value);
+  for (int i = 0; i < 4; ++i) {
+    x = test::graph::Matmul(&g, x, x, false, false);
+  }
+  GraphDef gd;
+  g.ToGraphDef(&gd);
+
+  SessionOptions opts;
+  opts.config.set_use_per_session_threads(true);
+  opts.config.mutable_experimental()->set_use_numa_affinity(use_numa_affinity);
+  std::unique_ptr<Session> session(NewSession(opts));
+  TF_CHECK_OK(session->Create(gd));
+  const std::vector<std::string> outputs = {x->name() + ":0"};
+  {
+    std::vector<Tensor> output_values;
+    TF_CHECK_OK(session->Run({}, outputs, {}, &output_values));
+  }
+
+  thread::ThreadPool clients(Env::Default(), "clients", kNumClients);
+  for (auto s : state) {
+    BlockingCounter done(kNumClients);
+    for (int i = 0; i < kNumClients; ++i) {
+      clients.Schedule([&session, &outputs, &done]() {
+        std::vector<Tensor> output_values;
+        TF_CHECK_OK(session->Run({}, outputs, {}, &output_values));
+        done.DecrementCount();
+      });
+    }
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kNumClients);
+}
+
+BENCHMARK(BM_DirectSessionNumaAffinity)->Arg(0)->Arg(1)->UseRealTime();
+
 BENCHMARK(BM_FeedFetch)->Arg(1)->Arg(2)->Arg(5)->Arg(10);
 BENCHMARK(BM_FeedFetchCallable)->Arg(1)->Arg(2)->Arg(5)->Arg(10);
 BENCHMARK(BM_FeedFetchCallableSingleThread)->Arg(1)->Arg(2)->Arg(5)->Arg(10);
@@ -3142,4 +3217,54 @@ TEST(DirectSessionTest, TestStatefulOutputRequiredOp) {
   TF_ASSERT_OK(session->Close());
 }
 
+// Partitions the threads of sessions over two fake NUMA nodes.
+class DirectSessionNumaTest : public ::testing::Test {
+ protected:
+  void SetUp() override { DirectSession::TestOnlySetNumNumaNodes(2); }
+  void TearDown() override { DirectSession::TestOnlySetNumNumaNodes(0); }
+
+  // Checks that each node of `session` has its own host allocator, and that
+  // the session has no full-size pool next to the per-node pools.
+  void CheckNumaPartition(const DirectSession& session) {
+    ASSERT_EQ(session.numa_node_threads_.size(), 2);
+    Allocator* allocator0 = session.numa_node_threads_[0]->allocator;
+    Allocator* allocator1 = session.numa_node_threads_[1]->allocator;
+    ASSERT_NE(allocator0, nullptr);
+    ASSERT_NE(allocator1, nullptr);
+    EXPECT_NE(allocator0, allocator1);
+
+    ASSERT_EQ(session.thread_pools_.size(), 1);
+    EXPECT_EQ(session.thread_pools_[0].first,
+              session.numa_node_threads_[0]->inter_op_pool.get());
+    EXPECT_FALSE(session.thread_pools_[0].second);
+  }
+};
+
+TEST_F(DirectSessionNumaTest, PartitionsThreadsAndHostMemoryByNode) {
+  SessionOptions options;
+  options.config.set_use_per_session_threads(true);
+  options.config.mutable_experimental()->set_use_numa_affinity(true);
+  std::unique_ptr<Session> session(NewSession(options));
+  ASSERT_TRUE(session != nullptr);
+  CheckNumaPartition(*static_cast<DirectSession*>(session.get()));
+
+  Graph graph(OpRegistry::Global());
+  Tensor a(DT_FLOAT, TensorShape({2, 2}));
+  test::FillValues<float>(&a, {1, 2, 3, 4});
+  Node* y = test::graph::Matmul(&graph, test::graph::Constant(&graph, a),
+                                test::graph::Constant(&graph, a), false,
+                                false);
+  GraphDef def;
+  graph.ToGraphDef(&def);
+  TF_ASSERT_OK(session->Create(def));
+  for (int i = 0; i < 4; ++i) {
+    std::vector<Tensor> outputs;
+    TF_ASSERT_OK(session->Run({}, {y->name() + ":0"}, {}, &outputs));
+    ASSERT_EQ(outputs.size(), 1);
+    test::ExpectTensorEqual<float>(
+        outputs[0], test::AsTensor<float>({7, 10, 15, 22}, {2, 2}));
+  }
+  TF_ASSERT_OK(session->Close());
+}
+
 }  // namespace tensorflow
@@ -31,10 +31,12 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/executor_factory.h"
 #include "tensorflow/core/common_runtime/graph_view.h"
 #include "tensorflow/core/common_runtime/immutable_executor_state.h"
+#include "tensorflow/core/common_runtime/kernel_stats.h"
 #include "tensorflow/core/common_runtime/pending_counts.h"
 #include "tensorflow/core/common_runtime/propagator_state.h"
 #include "tensorflow/core/common_runtime/renamed_device.h"
 #include "tensorflow/core/common_runtime/simple_propagator_state.h"
+#include "tensorflow/core/common_runtime/static_memory_plan.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -46,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/op_segment.h"
+#include "tensorflow/core/framework/step_arena_allocator.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_reference.h"
 #include "tensorflow/core/framework/types.h"
@@ -62,6 +65,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/manual_constructor.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
@@ -77,8 +81,10 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/scoped_annotation.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
 #include "tensorflow/core/profiler/lib/traceme_encode.h"
+#include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/protobuf/error_codes.pb.h"
 #include "tensorflow/core/util/determinism.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/managed_stack_trace.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
 #include "tsl/platform/tracing.h"
@@ -145,91 +151,195 @@ struct KernelTimer {
 typedef absl::InlinedVector<TensorValue, 4UL> TensorValueVec;
 typedef absl::InlinedVector<AllocatorAttributes, 4UL> AllocatorAttributeVec;
 
-class ExecutorImpl : public Executor {
+// Ready queues used by the "WORK_STEALING" executor. Each worker owns one
+// deque: the owner pushes and pops at the back, so a node's successors tend to
+// run on the thread that produced their inputs, while idle workers steal the
+// oldest node from the front of other deques.
+template <typename T>
+class WorkStealingQueues {
  public:
-  explicit ExecutorImpl(const LocalExecutorParams& p) : immutable_state_(p) {}
+  explicit WorkStealingQueues(int num_queues) : queues_(num_queues) {}
 
-  absl::Status Initialize(const Graph& graph) {
-    TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
-    kernel_stats_.Initialize(immutable_state_.graph_view());
-    return absl::OkStatus();
+  int num_queues() const { return queues_.size(); }
+
+  bool empty() const { return num_queued_.load() == 0; }
+
+  // Pushes `item` onto the back of queue `owner`, or of a queue picked
+  // round-robin if `owner` is negative.
+  void Push(int owner, T item) {
+    if (owner < 0) {
+      owner = next_queue_.fetch_add(1, std::memory_order_relaxed) %
+              queues_.size();
+    }
+    Queue& q = queues_[owner];
+    {
+      mutex_lock l(q.mu);
+      q.items.push_back(std::move(item));
+    }
+    num_queued_.fetch_add(1);
+  }
+
+  // Pops the newest item of queue `owner`, or steals the oldest item of
+  // another queue. Returns nullopt if all queues are empty.
+  absl::optional<T> Pop(int owner) {
+    if (empty()) return absl::nullopt;
+    absl::optional<T> item = PopBack(&queues_[owner]);
+    const int n = queues_.size();
+    for (int i = 1; !item && i < n; ++i) {
+      item = PopFront(&queues_[(owner + i) % n]);
+    }
+    return item;
   }
 
  private:
-  void RunAsyncInternal(const Args& args, DoneCallback done) override;
+  // A deque built on a vector: `head` is the index of the oldest item.
+  struct alignas(64) Queue {
+    mutex mu;
+    std::vector<T> items TF_GUARDED_BY(mu);
+    size_t head TF_GUARDED_BY(mu) = 0;
+  };
 
-  template <class PropagatorStateType>
-  friend class ExecutorState;
+  absl::optional<T> PopBack(Queue* q) {
+    mutex_lock l(q->mu);
+    if (q->items.size() == q->head) return absl::nullopt;
+    absl::optional<T> item(std::move(q->items.back()));
+    q->items.pop_back();
+    TakenLocked(q);
+    return item;
+  }
 
-  // Stores execution time information about the kernels in an executor's graph.
-  class KernelStats {
-   public:
-    KernelStats() = default;
-
-    void Initialize(const GraphView& gview) {
-      is_expensive_.resize(gview.num_nodes());
-      cost_estimates_ =
-          std::make_unique<std::atomic_uint_fast64_t[]>(gview.num_nodes());
-      for (int32_t i = 0; i < gview.num_nodes(); ++i) {
-        if (gview.node(i)) {
-          is_expensive_[i] =
-              gview.node(i)->kernel && gview.node(i)->kernel->IsExpensive();
-          cost_estimates_[i] = kInitialCostEstimateCycles;
-        }
-      }
-    }
+  absl::optional<T> PopFront(Queue* q) {
+    mutex_lock l(q->mu);
+    if (q->items.size() == q->head) return absl::nullopt;
+    absl::optional<T> item(std::move(q->items[q->head++]));
+    TakenLocked(q);
+    return item;
+  }
 
-    // Returns true iff the given node is considered "expensive". The
-    // executor uses this flag to optimize graph execution, for example
-    // by "inlining" inexpensive kernels.
-    bool IsExpensive(const NodeItem& node) const {
-      return is_expensive_[node.node_id] &&
-             (cost_estimates_[node.node_id].load(std::memory_order_relaxed) >
-              kOpIsExpensiveThresholdCycles);
+  void TakenLocked(Queue* q) TF_EXCLUSIVE_LOCKS_REQUIRED(q->mu) {
+    if (q->items.size() == q->head) {
+      q->items.clear();
+      q->head = 0;
     }
+    num_queued_.fetch_sub(1);
+  }
+
+  std::vector<Queue> queues_;
+  std::atomic<int64_t> num_queued_{0};
+  std::atomic<uint32_t> next_queue_{0};
+
+  WorkStealingQueues(const WorkStealingQueues&) = delete;
+  void operator=(const WorkStealingQueues&) = delete;
+};
+
+// The ExecutorState and worker index of the work-stealing loop running on the
+// current thread, if any.
+thread_local const void* work_stealing_state = nullptr;
+thread_local int work_stealing_worker = -1;
+
+class ExecutorImpl : public Executor {
+ public:
+  ExecutorImpl(const LocalExecutorParams& p, bool work_stealing,
+               bool adaptive_inlining)
+      : immutable_state_(p), adaptive_inlining_(adaptive_inlining) {
+    options_.work_stealing = work_stealing;
+  }
 
-    // Returns the value of kernel->IsExpensive().
-    bool HasExpensiveMarker(const NodeItem& node) const {
-      return is_expensive_[node.node_id];
+  ~ExecutorImpl() override {
+    if (kernel_stats_.adaptive() && VLOG_IS_ON(1)) {
+      VLOG(1) << "Learned kernel costs for executor on "
+              << immutable_state_.params().device->name() << ":\n"
+              << kernel_stats_.DebugString(immutable_state_.graph_view());
     }
+  }
 
-    // Updates the dynamic cost estimate, which is used to determine whether the
-    // given node is expensive. The new cost estimate is a weighted average of
-    // the old cost estimate and the latest cost. We only update cost estimates
-    // for kernels for which IsExpensive() return true.
-    void UpdateCostEstimate(const NodeItem& node, uint64_t elapsed_cycles) {
-      // N.B. Updates to `cost_estimate` are atomic but unlocked.  Simultaneous
-      // updates may result in one or more updates being ignored.  This does not
-      // affect correctness but may slow down the update frequency.
-      std::atomic_uint_fast64_t& cost_estimate = cost_estimates_[node.node_id];
-      auto prev_estimate = cost_estimate.load(std::memory_order_relaxed);
-
-      uint64_t new_estimate =
-          ((kCostDecay - 1) * prev_estimate + elapsed_cycles) / kCostDecay;
-
-      cost_estimate.store(new_estimate, std::memory_order_relaxed);
+  absl::Status Initialize(const Graph& graph) {
+    TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
+    kernel_stats_.Initialize(immutable_state_.graph_view(), adaptive_inlining_);
+    TF_RETURN_IF_ERROR(ReadInt64FromEnvVar("TF_EXECUTOR_STEP_ARENA_BYTES",
+                                           /*default_val=*/0,
+                                           &options_.step_arena_bytes));
+    bool static_memory_plan = false;
+    TF_RETURN_IF_ERROR(ReadBoolFromEnvVar("TF_EXECUTOR_STATIC_MEMORY_PLAN",
+                                          /*default_val=*/false,
+                                          &static_memory_plan));
+    if (static_memory_plan &&
+        immutable_state_.params().device->device_type() == DEVICE_CPU &&
+        !immutable_state_.requires_control_flow_support()) {
+      InitializeStaticMemoryPlan(graph);
     }
+    return absl::OkStatus();
+  }
 
-   private:
-    // Initial time (in CPU cycles) we expect an operation to take.  Used to
-    // determine whether an operation should be place in a threadpool.
-    // Operations start out "expensive".
-    static constexpr uint64_t kInitialCostEstimateCycles = 100 * 1000 * 1000;
-    static constexpr uint64_t kOpIsExpensiveThresholdCycles = 8000;
-    static constexpr uint64_t kCostDecay = 10;
-
-    std::vector<bool> is_expensive_;
-    // std::unique_ptr<std::atomic<bool>[]> is_expensive_;
-    std::unique_ptr<std::atomic_uint_fast64_t[]> cost_estimates_;
+  // A StaticMemoryPlan for the graph, indexed for the executor.
+  struct PlannedMemory {
+    StaticMemoryPlan plan;
+    // The slots of the outputs of node `i` start at
+    // `output_slots[first_output[i]]`, or `first_output[i]` is -1 if none of
+    // them is planned. Outputs that are not planned have slot -1.
+    std::vector<int> first_output;
+    std::vector<int> output_slots;
+  };
+
+  // Options shared by every step of the executor.
+  struct Options {
+    // If true, ready nodes are dispatched through WorkStealingQueues.
+    bool work_stealing = false;
+    // If positive, steps on CPU devices allocate small tensors from a
+    // StepArenaAllocator of this many bytes.
+    int64_t step_arena_bytes = 0;
+    // If set, each step allocates the planned outputs from one buffer.
+    const PlannedMemory* planned_memory = nullptr;
   };
 
+ private:
+  void RunAsyncInternal(const Args& args, DoneCallback done) override;
+
+  // Plans the outputs of `graph` and sets `options_.planned_memory`, or leaves
+  // it unset if the graph cannot be planned.
+  void InitializeStaticMemoryPlan(const Graph& graph);
+
+  template <class PropagatorStateType>
+  friend class ExecutorState;
+
   ImmutableExecutorState immutable_state_;
+  // If true, `kernel_stats_` learns the cost of every kernel and decides
+  // alone which nodes are inlined. Set by the ADAPTIVE_INLINING executor
+  // types.
+  const bool adaptive_inlining_;
   KernelStats kernel_stats_;
+  Options options_;
+  std::unique_ptr<PlannedMemory> planned_memory_;
 
   ExecutorImpl(const ExecutorImpl&) = delete;
   void operator=(const ExecutorImpl&) = delete;
 };
 
+void ExecutorImpl::InitializeStaticMemoryPlan(const Graph& graph) {
+  auto planned = std::make_unique<PlannedMemory>();
+  absl::Status s =
+      PlanStaticMemory(graph, StaticMemoryPlanOptions(), &planned->plan);
+  if (!s.ok()) {
+    VLOG(1) << "Not planning the memory of the executor on "
+            << immutable_state_.params().device->name() << ": " << s;
+    return;
+  }
+  if (planned->plan.slots.empty()) return;
+  planned->first_output.assign(graph.num_node_ids(), -1);
+  for (int i = 0; i < planned->plan.slots.size(); ++i) {
+    const StaticMemoryPlan::Slot& slot = planned->plan.slots[i];
+    int& first_output = planned->first_output[slot.node_id];
+    if (first_output < 0) {
+      first_output = planned->output_slots.size();
+      planned->output_slots.resize(
+          first_output + graph.FindNodeId(slot.node_id)->num_outputs(), -1);
+    }
+    planned->output_slots[first_output + slot.output] = i;
+  }
+  options_.planned_memory = planned.get();
+  planned_memory_ = std::move(planned);
+}
+
 // The state associated with one invocation of ExecutorImpl::Run.
 //
 // ExecutorState dispatches nodes when they become ready, and delegates to an
@@ -284,7 +394,8 @@ class ExecutorState {
  public:
   ExecutorState(const Executor::Args& args,
                 const ImmutableExecutorState& immutable_state_,
-                ExecutorImpl::KernelStats* kernel_stats_);
+                KernelStats* kernel_stats_,
+                const ExecutorImpl::Options& options);
   ~ExecutorState();
 
   void RunAsync(Executor::DoneCallback done);
@@ -341,12 +452,40 @@ class ExecutorState {
   // REQUIRES: `!ready->empty()`.
   void ScheduleReady(TaggedNodeSeq* ready, TaggedNodeReadyQueue* inline_ready);
 
+  // With adaptive inlining, the cost that ScheduleReady() charges `item`
+  // against kCheapBatchCostCycles.
+  uint64_t NodeCostForBatching(const NodeItem& item) const;
+
+  // Runs `*cheap_nodes` in closures whose estimated cost is at most about
+  // kCheapBatchCostCycles each. Clears `*cheap_nodes`.
+  void RunCheapNodes(TaggedNodeSeq* cheap_nodes, int64_t scheduled_nsec);
+
   // A wrapper for runner_ to keep track of the pending queue length. Op
   // execution should dispatch work using this function instead of using runner_
   // directly.
   template <typename Closure>
   void RunTask(Closure&& c, int sample_rate = 0);
 
+  // Work-stealing mode: pushes `ready` onto the ready queues, preferring the
+  // queue of the calling worker, and starts workers to drain them.
+  void PushReadyWorkStealing(const TaggedNode* begin, const TaggedNode* end,
+                             int64_t scheduled_nsec);
+
+  // Starts up to `max_new_workers` work-stealing loops while fewer than
+  // `work_stealing_queues_->num_queues()` are active.
+  void StartWorkStealingWorkers(int max_new_workers);
+
+  // Increments `num_active_workers_` unless all workers are active. On success
+  // sets `*worker` to the index of the queue the new worker owns. Indices are
+  // reused after workers exit, so two workers may briefly share a queue; the
+  // queues are locked, so this only costs locality.
+  bool TryClaimWorker(int* worker);
+
+  // Runs ready nodes from `work_stealing_queues_` on behalf of worker `worker`
+  // until all queues are empty. Each active loop holds one outstanding op, so
+  // the ExecutorState cannot finish while the loop touches it.
+  void WorkStealingLoop(int worker);
+
   // Clean up when this executor is done.
   void Finish();
   void ScheduleFinish();
@@ -371,6 +510,11 @@ class ExecutorState {
   // TODO(fishx): Make it configurable if necessary.
   static constexpr uint64_t kInlineScheduleReadyThreshold = 500;
 
+  // With adaptive inlining, the estimated number of cycles of inexpensive
+  // nodes that ScheduleReady() runs inline, or packs into one closure, before
+  // handing the rest to another closure.
+  static constexpr uint64_t kCheapBatchCostCycles = 512 * 1000;
+
   // Not owned.
   RendezvousInterface* rendezvous_;
   CollectiveExecutor* collective_executor_ = nullptr;
@@ -390,7 +534,7 @@ class ExecutorState {
   checkpoint::TensorSliceReaderCacheWrapper* slice_reader_cache_;
   CallFrameInterface* call_frame_;
   const ImmutableExecutorState& immutable_state_;
-  ExecutorImpl::KernelStats* const kernel_stats_;
+  KernelStats* const kernel_stats_;
   CancellationManager* cancellation_manager_;
   tsl::CoordinationServiceAgent* coordination_service_agent_;
   absl::optional<ManagedStackTrace> stack_trace_ = std::nullopt;
@@ -400,6 +544,29 @@ class ExecutorState {
   bool sync_on_finish_;
   const bool run_all_kernels_inline_;
 
+  // A ready node waiting in `work_stealing_queues_`.
+  struct QueuedNode {
+    TaggedNode tagged_node;
+    int64_t scheduled_nsec;
+  };
+  // Only set for executors created as "WORK_STEALING".
+  std::unique_ptr<WorkStealingQueues<QueuedNode>> work_stealing_queues_;
+  std::atomic<int> num_active_workers_{0};
+
+  // Serves the small tensors of this step if the executor has a step arena.
+  // Released, not deleted, when the step ends.
+  StepArenaAllocator* step_arena_ = nullptr;
+  // Tensors larger than this always come from the device allocator.
+  static constexpr size_t kStepArenaMaxAllocationBytes = 4096;
+  // A small tensor that outlives its step keeps the whole arena region alive.
+  // Steps run without an arena while the regions retained this way add up to
+  // this many arenas, which bounds the memory held by escaped tensors.
+  static constexpr int64_t kMaxRetainedStepArenas = 4;
+
+  // The buffer of this step if the executor has a static memory plan.
+  const ExecutorImpl::PlannedMemory* planned_memory_ = nullptr;
+  StaticMemoryPlanBuffer* planned_buffer_ = nullptr;
+
   PropagatorStateType propagator_;
 
   // Invoked when the execution finishes.
@@ -420,7 +587,8 @@ class ExecutorState {
 template <class PropagatorStateType>
 ExecutorState<PropagatorStateType>::ExecutorState(
     const Executor::Args& args, const ImmutableExecutorState& immutable_state,
-    ExecutorImpl::KernelStats* kernel_stats)
+    KernelStats* kernel_stats,
+    const ExecutorImpl::Options& options)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
       step_id_(args.step_id),
@@ -451,10 +619,42 @@ ExecutorState<PropagatorStateType>::ExecutorState(
       run_all_kernels_inline_(args.run_all_kernels_inline),
       propagator_(immutable_state, step_id_, vlog_),
       num_outstanding_ops_(0) {
-  if (args.user_intra_op_threadpool != nullptr) {
-    Device* device = immutable_state_.params().device;
+  Device* device = immutable_state_.params().device;
+  Allocator* host_allocator = device->device_type() == DEVICE_CPU
+                                  ? args.user_host_allocator
+                                  : nullptr;
+  if (args.user_intra_op_threadpool != nullptr || host_allocator != nullptr) {
     user_device_ = RenamedDevice::NewRenamedDevice(
-        device->name(), device, false, false, args.user_intra_op_threadpool);
+        device->name(), device, false, false, args.user_intra_op_threadpool,
+        host_allocator);
+  }
+  if (options.work_stealing && !run_all_kernels_inline_) {
+    // One queue per inter-op thread that may run a work-stealing loop.
+    int num_workers = port::MaxParallelism();
+    if (session_config_ != nullptr &&
+        session_config_->inter_op_parallelism_threads() > 0) {
+      num_workers = session_config_->inter_op_parallelism_threads();
+    }
+    work_stealing_queues_ =
+        std::make_unique<WorkStealingQueues<QueuedNode>>(num_workers);
+  }
+  Allocator* step_allocator = host_allocator != nullptr
+                                  ? host_allocator
+                                  : device->GetAllocator(AllocatorAttributes());
+  if (options.step_arena_bytes > 0 && device->device_type() == DEVICE_CPU) {
+    if (StepArenaAllocator::RetainedBytes() <
+        kMaxRetainedStepArenas * options.step_arena_bytes) {
+      step_arena_ = new StepArenaAllocator(step_allocator,
+                                           options.step_arena_bytes,
+                                           kStepArenaMaxAllocationBytes);
+    } else {
+      metrics::RecordStepArenaSkipped();
+    }
+  }
+  if (options.planned_memory != nullptr) {
+    planned_memory_ = options.planned_memory;
+    planned_buffer_ =
+        new StaticMemoryPlanBuffer(&planned_memory_->plan, step_allocator);
   }
 }
 
@@ -463,6 +663,12 @@ ExecutorState<PropagatorStateType>::~ExecutorState() {
   if (device_context_) {
     device_context_->Unref();
   }
+  if (step_arena_ != nullptr) {
+    step_arena_->Release();
+  }
+  if (planned_buffer_ != nullptr) {
+    planned_buffer_->Unref();
+  }
   delete slice_reader_cache_;
 }
 
@@ -605,7 +811,7 @@ absl::Status ExecutorState<PropagatorStateType>::ProcessSync(
         },
         tsl::profiler::GetTFTraceMeLevel(is_expensive));
     device->Compute(op_kernel, &ctx);
-  } else if (kernel_stats_->HasExpensiveMarker(item)) {
+  } else if (kernel_stats_->ShouldTime(item)) {
     KernelTimer timer;
     device->Compute(op_kernel, &ctx);
     // For expensive kernels, always update the cost estimate. For inexpensive
@@ -778,6 +984,7 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
   params->slice_reader_cache = slice_reader_cache_;
   params->runner = &runner_;
   params->run_all_kernels_inline = run_all_kernels_inline_;
+  params->step_arena = step_arena_;
   params->stats_collector = stats_collector_;
   params->inc_num_deferred_ops_function = [this]() {
     mutex_lock lock(num_deferred_ops_mu_);
@@ -921,6 +1128,13 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
       params->outputs_required_array = item.outputs_required.get();
       params->inputs = *inputs;
       params->input_alloc_attrs = input_alloc_attrs;
+      if (planned_buffer_ != nullptr) {
+        const int first_output = planned_memory_->first_output[id];
+        params->planned_outputs = planned_buffer_;
+        params->planned_output_slots =
+            first_output < 0 ? nullptr
+                             : &planned_memory_->output_slots[first_output];
+      }
 
       if (item.kernel_is_async) {
         ProcessAsync(item, *params, tagged_node, first_input, stats,
@@ -1302,7 +1516,26 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
   } else {
     const TaggedNode* curr_expensive_node = nullptr;
     TaggedNodeSeq expensive_nodes;
-    if (inline_ready == nullptr) {
+    // With adaptive inlining, inexpensive nodes that do not fit in the inline
+    // budget. They are run in batches by RunCheapNodes().
+    const bool adaptive = kernel_stats_->adaptive();
+    TaggedNodeSeq cheap_nodes;
+    uint64_t inline_cost = 0;
+    if (inline_ready == nullptr && work_stealing_queues_) {
+      PushReadyWorkStealing(ready->data(), ready->data() + ready->size(),
+                            scheduled_nsec);
+    } else if (inline_ready == nullptr && adaptive) {
+      // Give each expensive node its own closure, and batch the rest.
+      for (auto& tagged_node : *ready) {
+        if (tagged_node.get_is_dead() ||
+            !kernel_stats_->IsExpensive(*tagged_node.node_item)) {
+          cheap_nodes.push_back(tagged_node);
+        } else {
+          RunTask([=]() { Process(tagged_node, scheduled_nsec); },
+                  /*sample_rate=*/ready->size());
+        }
+      }
+    } else if (inline_ready == nullptr) {
       // Schedule to run all the ready ops in thread pool.
       for (auto& tagged_node : *ready) {
         RunTask([=]() { Process(tagged_node, scheduled_nsec); },
@@ -1312,6 +1545,13 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
       for (auto& tagged_node : *ready) {
         const NodeItem& item = *tagged_node.node_item;
         if (tagged_node.get_is_dead() || !kernel_stats_->IsExpensive(item)) {
+          if (adaptive) {
+            if (inline_cost >= kCheapBatchCostCycles) {
+              cheap_nodes.push_back(tagged_node);
+              continue;
+            }
+            inline_cost += NodeCostForBatching(item);
+          }
           // Inline this inexpensive node.
           inline_ready->push_back(tagged_node);
         } else {
@@ -1331,7 +1571,13 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
         expensive_nodes.push_back(*curr_expensive_node);
       }
     }
-    if (!expensive_nodes.empty()) {
+    if (!expensive_nodes.empty() && work_stealing_queues_) {
+      // Worker loops replace the per-node closures below, so a wide fan-out
+      // costs at most one runner enqueue per idle worker.
+      PushReadyWorkStealing(expensive_nodes.data(),
+                            expensive_nodes.data() + expensive_nodes.size(),
+                            scheduled_nsec);
+    } else if (!expensive_nodes.empty()) {
       if (expensive_nodes.size() < kInlineScheduleReadyThreshold) {
         for (auto& tagged_node : expensive_nodes) {
           RunTask(std::bind(&ExecutorState::Process, this, tagged_node,
@@ -1372,10 +1618,102 @@ void ExecutorState<PropagatorStateType>::ScheduleReady(
         }
       }
     }
+    if (!cheap_nodes.empty()) {
+      RunCheapNodes(&cheap_nodes, scheduled_nsec);
+    }
   }
   ready->clear();
 }
 
+template <class PropagatorStateType>
+uint64_t ExecutorState<PropagatorStateType>::NodeCostForBatching(
+    const NodeItem& item) const {
+  // Nodes that are never timed, such as NoOps and constants, have a zero
+  // estimate; charge a small fixed cost so that batches stay bounded.
+  constexpr uint64_t kMinNodeCostCycles = 100;
+  return std::max(kernel_stats_->CostEstimate(item), kMinNodeCostCycles);
+}
+
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::RunCheapNodes(
+    TaggedNodeSeq* cheap_nodes, int64_t scheduled_nsec) {
+  TaggedNodeSeq batch;
+  uint64_t batch_cost = 0;
+  for (size_t i = 0; i < cheap_nodes->size(); ++i) {
+    const TaggedNode& tagged_node = (*cheap_nodes)[i];
+    batch.push_back(tagged_node);
+    batch_cost += NodeCostForBatching(*tagged_node.node_item);
+    if (batch_cost >= kCheapBatchCostCycles || i + 1 == cheap_nodes->size()) {
+      RunTask([this, batch = std::move(batch), scheduled_nsec]() {
+        for (auto& tagged_node : batch) {
+          Process(tagged_node, scheduled_nsec);
+        }
+      });
+      batch = TaggedNodeSeq();
+      batch_cost = 0;
+    }
+  }
+  cheap_nodes->clear();
+}
+
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::PushReadyWorkStealing(
+    const TaggedNode* begin, const TaggedNode* end, int64_t scheduled_nsec) {
+  const int owner = work_stealing_state == this ? work_stealing_worker : -1;
+  for (const TaggedNode* it = begin; it != end; ++it) {
+    work_stealing_queues_->Push(owner, QueuedNode{*it, scheduled_nsec});
+  }
+  StartWorkStealingWorkers(end - begin);
+}
+
+template <class PropagatorStateType>
+bool ExecutorState<PropagatorStateType>::TryClaimWorker(int* worker) {
+  int active = num_active_workers_.load();
+  do {
+    if (active >= work_stealing_queues_->num_queues()) return false;
+  } while (!num_active_workers_.compare_exchange_weak(active, active + 1));
+  *worker = active;
+  return true;
+}
+
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::StartWorkStealingWorkers(
+    int max_new_workers) {
+  int worker;
+  for (int i = 0; i < max_new_workers && TryClaimWorker(&worker); ++i) {
+    // The caller holds an outstanding op, so the count cannot reach zero here.
+    num_outstanding_ops_.fetch_add(1, std::memory_order_relaxed);
+    RunTask([this, worker]() { WorkStealingLoop(worker); },
+            /*sample_rate=*/max_new_workers);
+  }
+}
+
+template <class PropagatorStateType>
+void ExecutorState<PropagatorStateType>::WorkStealingLoop(int worker) {
+  tsl::profiler::TraceMe activity("ExecutorState::WorkStealingLoop",
+                                  tsl::profiler::GetTFTraceMeLevel(
+                                      /*is_expensive=*/false));
+  const void* const prev_state = work_stealing_state;
+  const int prev_worker = work_stealing_worker;
+  work_stealing_state = this;
+  work_stealing_worker = worker;
+  while (true) {
+    while (absl::optional<QueuedNode> node =
+               work_stealing_queues_->Pop(worker)) {
+      Process(node->tagged_node, node->scheduled_nsec);
+    }
+    // A node pushed between the last Pop() and the decrement below may have
+    // found every worker active and not started a new one, so check again
+    // after retiring.
+    num_active_workers_.fetch_sub(1);
+    if (work_stealing_queues_->empty() || !TryClaimWorker(&worker)) break;
+    work_stealing_worker = worker;
+  }
+  work_stealing_state = prev_state;
+  work_stealing_worker = prev_worker;
+  if (num_outstanding_ops_.fetch_sub(1) == 1) ScheduleFinish();
+}
+
 template <class PropagatorStateType>
 void ExecutorState<PropagatorStateType>::ScheduleFinish() {
   // Checks condition to decide if needs to invoke Finish(). If there are
@@ -1516,23 +1854,24 @@ void ExecutorState<PropagatorStateType>::Finish() {
 void ExecutorImpl::RunAsyncInternal(const Args& args, DoneCallback done) {
   if (OpOrderDeterminismRequired()) {
     (new ExecutorState<OrderedPropagatorState>(args, immutable_state_,
-                                               &kernel_stats_))
+                                               &kernel_stats_, options_))
         ->RunAsync(std::move(done));
   } else if (immutable_state_.requires_control_flow_support()) {
-    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_))
+    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_,
+                                        options_))
         ->RunAsync(std::move(done));
   } else {
     (new ExecutorState<SimplePropagatorState>(args, immutable_state_,
-                                              &kernel_stats_))
+                                              &kernel_stats_, options_))
         ->RunAsync(std::move(done));
   }
 }
 
-}  // namespace
-
-absl::Status NewLocalExecutor(const LocalExecutorParams& params,
-                              const Graph& graph, Executor** executor) {
-  ExecutorImpl* impl = new ExecutorImpl(params);
+absl::Status NewLocalExecutorImpl(const LocalExecutorParams& params,
+                                  const Graph& graph, bool work_stealing,
+                                  bool adaptive_inlining, Executor** executor) {
+  ExecutorImpl* impl =
+      new ExecutorImpl(params, work_stealing, adaptive_inlining);
   const absl::Status s = impl->Initialize(graph);
   if (s.ok()) {
     *executor = impl;
@@ -1542,6 +1881,14 @@ absl::Status NewLocalExecutor(const LocalExecutorParams& params,
   return s;
 }
 
+}  // namespace
+
+absl::Status NewLocalExecutor(const LocalExecutorParams& params,
+                              const Graph& graph, Executor** executor) {
+  return NewLocalExecutorImpl(params, graph, /*work_stealing=*/false,
+                              /*adaptive_inlining=*/false, executor);
+}
+
 absl::Status CreateNonCachedKernel(
     Device* device, FunctionLibraryRuntime* flib,
     const std::shared_ptr<const NodeProperties>& props, int graph_def_version,
@@ -1560,21 +1907,47 @@ namespace {
 class DefaultExecutorRegistrar {
  public:
   DefaultExecutorRegistrar() {
-    Factory* factory = new Factory;
+    Factory* factory =
+        new Factory(/*work_stealing=*/false, /*adaptive_inlining=*/false);
     ExecutorFactory::Register("", factory);
     ExecutorFactory::Register("DEFAULT", factory);
+    // Same as the default executor, except that expensive ready nodes are
+    // distributed through per-worker work-stealing deques rather than one
+    // runner closure per node.
+    ExecutorFactory::Register(
+        "WORK_STEALING",
+        new Factory(/*work_stealing=*/true, /*adaptive_inlining=*/false));
+    // Same as the default executor, except that every kernel is timed and
+    // the learned costs decide which nodes run inline and how cheap nodes
+    // are batched into closures.
+    ExecutorFactory::Register(
+        "ADAPTIVE_INLINING",
+        new Factory(/*work_stealing=*/false, /*adaptive_inlining=*/true));
+    ExecutorFactory::Register(
+        "WORK_STEALING_ADAPTIVE_INLINING",
+        new Factory(/*work_stealing=*/true, /*adaptive_inlining=*/true));
   }
 
  private:
   class Factory : public ExecutorFactory {
+   public:
+    Factory(bool work_stealing, bool adaptive_inlining)
+        : work_stealing_(work_stealing),
+          adaptive_inlining_(adaptive_inlining) {}
+
     absl::Status NewExecutor(const LocalExecutorParams& params,
                              const Graph& graph,
                              std::unique_ptr<Executor>* out_executor) override {
       Executor* ret = nullptr;
-      TF_RETURN_IF_ERROR(NewLocalExecutor(params, graph, &ret));
+      TF_RETURN_IF_ERROR(NewLocalExecutorImpl(
+          params, graph, work_stealing_, adaptive_inlining_, &ret));
       out_executor->reset(ret);
       return absl::OkStatus();
     }
+
+   private:
+    const bool work_stealing_;
+    const bool adaptive_inlining_;
   };
 };
 static DefaultExecutorRegistrar registrar;
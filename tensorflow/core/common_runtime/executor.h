@@ -110,6 +110,10 @@ class Executor {
     ScopedStepContainer* step_container = nullptr;
     CollectiveExecutor* collective_executor = nullptr;
     thread::ThreadPoolInterface* user_intra_op_threadpool = nullptr;
+    // If set, kernels on CPU devices allocate the memory that is not shared
+    // with other devices from this allocator, e.g. one local to the NUMA node
+    // whose threads run the step.
+    Allocator* user_host_allocator = nullptr;
     tsl::CoordinationServiceAgent* coordination_service_agent = nullptr;
     int64_t start_time_usecs = 0;
     // The deadline for the kernel to complete by. Empty if unspecified.
@@ -16,6 +16,10 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/executor.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
 
 #include "tensorflow/cc/framework/ops.h"
 #include "tensorflow/cc/ops/array_ops.h"
@@ -25,6 +29,7 @@ limitations under the License.
 #include "tensorflow/cc/ops/standard_ops.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
 #include "tensorflow/core/common_runtime/graph_constructor.h"
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/common_runtime/lower_functional_ops.h"
@@ -34,12 +39,14 @@ limitations under the License.
 #include "tensorflow/core/framework/local_rendezvous.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/rendezvous.h"
+#include "tensorflow/core/framework/step_arena_allocator.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/monitoring/cell_reader.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
@@ -50,6 +57,8 @@ limitations under the License.
 
 namespace tensorflow {
 
+using ::tensorflow::monitoring::testing::CellReader;
+
 class ExecutorTest : public ::testing::Test {
  protected:
   ExecutorTest()
@@ -76,8 +85,10 @@ class ExecutorTest : public ::testing::Test {
     delete exec_;
   }
 
-  // Resets executor_ with a new executor based on a graph 'gdef'.
-  void Create(std::unique_ptr<const Graph> graph) {
+  // Resets executor_ with a new executor based on a graph 'gdef'. An empty
+  // 'executor_type' selects the default local executor.
+  void Create(std::unique_ptr<const Graph> graph,
+              const std::string& executor_type = "") {
     const int version = graph->versions().producer();
     LocalExecutorParams params;
     params.device = device_.get();
@@ -92,8 +103,17 @@ class ExecutorTest : public ::testing::Test {
     };
     rendez_ = NewLocalRendezvous();
     delete exec_;
-    TF_CHECK_OK(NewLocalExecutor(params, *graph, &exec_));
-    runner_ = [this](std::function<void()> fn) { thread_pool_->Schedule(fn); };
+    if (executor_type.empty()) {
+      TF_CHECK_OK(NewLocalExecutor(params, *graph, &exec_));
+    } else {
+      std::unique_ptr<Executor> exec;
+      TF_CHECK_OK(NewExecutor(executor_type, params, *graph, &exec));
+      exec_ = exec.release();
+    }
+    runner_ = [this](std::function<void()> fn) {
+      ++num_closures_;
+      thread_pool_->Schedule(fn);
+    };
   }
 
   absl::Status Run(Rendezvous* rendez) {
@@ -115,6 +135,8 @@ class ExecutorTest : public ::testing::Test {
   StepStatsCollector step_stats_collector_;
   StepStats step_stats_;
   Executor::Args::Runner runner_;
+  // Number of closures passed to `runner_`.
+  std::atomic<int64_t> num_closures_{0};
   Rendezvous* rendez_ = nullptr;
 };
 
@@ -190,6 +212,161 @@ TEST_F(ExecutorTest, SimpleAdd) {
   EXPECT_EQ(2.0, V(out));  // out = 1.0 + 1.0 = 2.0
 }
 
+// c = sum_i (a + a), with a layer of 'width' independent Adds feeding a chain.
+std::unique_ptr<Graph> WideAddGraph(int width) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in0 = test::graph::Recv(g.get(), "a", "float", ALICE, 1, BOB);
+  Node* sum = nullptr;
+  for (int i = 0; i < width; ++i) {
+    Node* n = test::graph::Add(g.get(), in0, in0);
+    sum = sum == nullptr ? n : test::graph::Add(g.get(), sum, n);
+  }
+  test::graph::Send(g.get(), sum, "c", BOB, 1, ALICE);
+  return g;
+}
+
+TEST_F(ExecutorTest, WorkStealingWideGraph) {
+  const int kWidth = 256;
+  Create(WideAddGraph(kWidth), "WORK_STEALING");
+  Rendezvous::Args args;
+  TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0),
+                             false));
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(
+      rendez_->Recv(Key(BOB, kIncarnation, ALICE, "c"), args, &out, &is_dead));
+  EXPECT_EQ(2.0 * kWidth, V(out));
+}
+
+TEST_F(ExecutorTest, AdaptiveInliningWideGraph) {
+  const int kWidth = 1024;
+  Create(WideAddGraph(kWidth), "ADAPTIVE_INLINING");
+  Rendezvous::Args args;
+  TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0),
+                             false));
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(
+      rendez_->Recv(Key(BOB, kIncarnation, ALICE, "c"), args, &out, &is_dead));
+  EXPECT_EQ(2.0 * kWidth, V(out));
+  // The Adds are marked expensive and start with the initial cost estimate,
+  // so the first step gives each of them its own closure. How the estimates
+  // are learned is covered by kernel_stats_test.
+  EXPECT_GE(num_closures_.load(), kWidth);
+}
+
+TEST_F(ExecutorTest, StepArena) {
+  const int kWidth = 64;
+  const int kArenaBytes = 65536;
+  // Each step fetches a tensor that keeps its arena alive, so arenas stop
+  // being created after the first 4 steps.
+  const int kNumSteps = 6;
+  CellReader<int64_t> served("/tensorflow/core/step_arena_allocations");
+  CellReader<int64_t> skipped("/tensorflow/core/step_arena_skipped_steps");
+  const int64_t retained_bytes = StepArenaAllocator::RetainedBytes();
+  setenv("TF_EXECUTOR_STEP_ARENA_BYTES", "65536", /*overwrite=*/1);
+  Create(WideAddGraph(kWidth));
+  unsetenv("TF_EXECUTOR_STEP_ARENA_BYTES");
+  Rendezvous::Args args;
+  auto run_step = [&](float input, Tensor* output) {
+    TF_ASSERT_OK(rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args,
+                               V(input), false));
+    TF_ASSERT_OK(Run(rendez_));
+    bool is_dead = false;
+    TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "c"), args,
+                               output, &is_dead));
+  };
+  std::vector<Tensor> outputs(kNumSteps);
+  for (int step = 0; step < kNumSteps; ++step) {
+    run_step(step, &outputs[step]);
+  }
+  EXPECT_GE(served.Delta(), 4 * kWidth);
+  EXPECT_EQ(skipped.Delta(), kNumSteps - 4);
+  EXPECT_EQ(StepArenaAllocator::RetainedBytes(),
+            retained_bytes + 4 * kArenaBytes);
+  // The outputs may live in the arenas of steps that have ended.
+  for (int step = 0; step < kNumSteps; ++step) {
+    EXPECT_EQ(2.0 * kWidth * step, V(outputs[step]));
+  }
+
+  // Dropping the outputs frees the retained arenas.
+  outputs.clear();
+  EXPECT_EQ(StepArenaAllocator::RetainedBytes(), retained_bytes);
+  Tensor output;
+  run_step(1, &output);
+  EXPECT_GE(served.Delta(), kWidth);
+  EXPECT_EQ(skipped.Delta(), 0);
+}
+
+TEST_F(ExecutorTest, StaticMemoryPlan) {
+  // c -> (-) -> (-) -> ... -> send, where every output has a static shape.
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  Tensor ones(DT_FLOAT, TensorShape({1024}));
+  ones.flat<float>().setConstant(1.0f);
+  Node* x = test::graph::Constant(g.get(), ones);
+  for (int i = 0; i < 8; ++i) {
+    x = test::graph::Add(g.get(), test::graph::Unary(g.get(), "Neg", x), x);
+  }
+  test::graph::Send(g.get(), x, "c", BOB, 1, ALICE);
+  setenv("TF_EXECUTOR_STATIC_MEMORY_PLAN", "true", /*overwrite=*/1);
+  Create(std::move(g));
+  unsetenv("TF_EXECUTOR_STATIC_MEMORY_PLAN");
+  Rendezvous::Args args;
+  Tensor outputs[3];
+  for (int step = 0; step < 3; ++step) {
+    TF_ASSERT_OK(Run(rendez_));
+    bool is_dead = false;
+    TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "c"), args,
+                               &outputs[step], &is_dead));
+  }
+  // The outputs may live in the buffers of steps that have ended.
+  for (int step = 0; step < 3; ++step) {
+    ASSERT_EQ(outputs[step].NumElements(), 1024);
+    EXPECT_EQ(outputs[step].flat<float>()(1023), 0.0f);
+  }
+}
+
+// Counts the allocations it serves.
+class CountingAllocator : public Allocator {
+ public:
+  std::string Name() override { return "counting"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    num_allocations_.fetch_add(1);
+    return cpu_allocator()->AllocateRaw(alignment, num_bytes);
+  }
+  void DeallocateRaw(void* ptr) override {
+    cpu_allocator()->DeallocateRaw(ptr);
+  }
+  int num_allocations() const { return num_allocations_.load(); }
+
+ private:
+  std::atomic<int> num_allocations_{0};
+};
+
+TEST_F(ExecutorTest, UserHostAllocator) {
+  const int kWidth = 16;
+  Create(WideAddGraph(kWidth));
+  CountingAllocator allocator;
+  Rendezvous::Args args;
+  TF_ASSERT_OK(
+      rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0), false));
+  Executor::Args exec_args;
+  exec_args.rendezvous = rendez_;
+  exec_args.runner = runner_;
+  exec_args.user_host_allocator = &allocator;
+  TF_ASSERT_OK(exec_->Run(exec_args));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(
+      rendez_->Recv(Key(BOB, kIncarnation, ALICE, "c"), args, &out, &is_dead));
+  EXPECT_EQ(2.0 * kWidth, V(out));
+  // The Adds of the first layer cannot forward their inputs, so they allocate
+  // their outputs from the step's host allocator.
+  EXPECT_GE(allocator.num_allocations(), kWidth);
+}
+
 TEST_F(ExecutorTest, StepStatsNumerical) {
   // Similar to SimpleAdd, but tests numerical values in StepStats
 
@@ -552,6 +729,72 @@ BENCHMARK(BM_executor)->UseRealTime()->ArgPair(8192, 32);
 // Tall fat graph
 BENCHMARK(BM_executor)->UseRealTime()->ArgPair(1024, 1024);
 
+// Runs 'width' independent chains of 'depth' Adds on 16K-element vectors, which
+// stay above the executor's expensive-op threshold, with the default executor
+// or with the work-stealing one.
+static void BM_executor_work_stealing(::testing::benchmark::State& state) {
+  const int width = state.range(0);
+  const int depth = state.range(1);
+  const bool work_stealing = state.range(2);
+
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor ones(DT_FLOAT, TensorShape({16 << 10}));
+  ones.flat<float>().setConstant(1.0f);
+  Node* one = test::graph::Constant(g, ones);
+  for (int i = 0; i < width; ++i) {
+    Node* n = one;
+    for (int j = 0; j < depth; ++j) {
+      n = test::graph::Add(g, n, one);
+    }
+  }
+  FixupSourceAndSinkEdges(g);
+  test::Benchmark("cpu", g, /*options=*/nullptr, /*init=*/nullptr,
+                  /*rendez=*/nullptr, work_stealing ? "WORK_STEALING" : "",
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+
+  state.SetLabel(work_stealing ? "work_stealing" : "default");
+  state.SetItemsProcessed(static_cast<int64_t>(width) * depth *
+                          state.iterations());
+}
+
+// Wide graphs
+BENCHMARK(BM_executor_work_stealing)->UseRealTime()->Args({4096, 1, 0});
+BENCHMARK(BM_executor_work_stealing)->UseRealTime()->Args({4096, 1, 1});
+BENCHMARK(BM_executor_work_stealing)->UseRealTime()->Args({512, 8, 0});
+BENCHMARK(BM_executor_work_stealing)->UseRealTime()->Args({512, 8, 1});
+
+// Deep graphs
+BENCHMARK(BM_executor_work_stealing)->UseRealTime()->Args({4, 1024, 0});
+BENCHMARK(BM_executor_work_stealing)->UseRealTime()->Args({4, 1024, 1});
+
+// Runs a wide graph of scalar Adds, with the default executor or the
+// ADAPTIVE_INLINING executor.
+static void BM_executor_adaptive_inlining(
+    ::testing::benchmark::State& state) {
+  const int width = state.range(0);
+  const bool adaptive = state.range(1);
+
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* one = test::graph::Constant(g, V(1.0));
+  for (int i = 0; i < width; ++i) {
+    test::graph::Add(g, one, one);
+  }
+  FixupSourceAndSinkEdges(g);
+  test::Benchmark("cpu", g, /*options=*/nullptr, /*init=*/nullptr,
+                  /*rendez=*/nullptr, adaptive ? "ADAPTIVE_INLINING" : "",
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+
+  state.SetLabel(adaptive ? "adaptive" : "default");
+  state.SetItemsProcessed(static_cast<int64_t>(width) * state.iterations());
+}
+
+BENCHMARK(BM_executor_adaptive_inlining)->UseRealTime()->ArgPair(64, 0);
+BENCHMARK(BM_executor_adaptive_inlining)->UseRealTime()->ArgPair(64, 1);
+BENCHMARK(BM_executor_adaptive_inlining)->UseRealTime()->ArgPair(4096, 0);
+BENCHMARK(BM_executor_adaptive_inlining)->UseRealTime()->ArgPair(4096, 1);
+
 static void BM_const_identity(::testing::benchmark::State& state) {
   const int width = state.range(0);
   const int outputs_per_const = state.range(1);
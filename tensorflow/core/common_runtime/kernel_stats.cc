@@ -0,0 +1,76 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/kernel_stats.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/platform/strcat.h"
+
+namespace tensorflow {
+
+void KernelStats::Initialize(const GraphView& gview, bool adaptive) {
+  adaptive_ = adaptive;
+  is_expensive_.resize(gview.num_nodes());
+  cost_estimates_ =
+      std::make_unique<std::atomic_uint_fast64_t[]>(gview.num_nodes());
+  num_samples_ =
+      std::make_unique<std::atomic_uint_fast32_t[]>(gview.num_nodes());
+  for (int32_t i = 0; i < gview.num_nodes(); ++i) {
+    if (gview.node(i)) {
+      is_expensive_[i] =
+          gview.node(i)->kernel && gview.node(i)->kernel->IsExpensive();
+      cost_estimates_[i] =
+          (is_expensive_[i] || !adaptive_) ? kInitialCostEstimateCycles : 0;
+      num_samples_[i] = 0;
+    }
+  }
+}
+
+std::string KernelStats::DebugString(const GraphView& gview) const {
+  std::string out;
+  for (int32_t i = 0; i < gview.num_nodes(); ++i) {
+    const NodeItem* item = gview.node(i);
+    if (item == nullptr || item->kernel == nullptr) continue;
+    strings::StrAppend(
+        &out, item->kernel->name(), " (", item->kernel->type_string(),
+        "): cost_estimate_cycles=", cost_estimates_[i].load(),
+        " samples=", num_samples_[i].load(),
+        " marked_expensive=", is_expensive_[i] ? "true" : "false",
+        " expensive=", IsExpensive(*item) ? "true" : "false", "\n");
+  }
+  return out;
+}
+
+void KernelStats::UpdateCostEstimate(const NodeItem& node,
+                                     uint64_t elapsed_cycles) {
+  // N.B. Updates to `cost_estimate` are atomic but unlocked.  Simultaneous
+  // updates may result in one or more updates being ignored.  This does not
+  // affect correctness but may slow down the update frequency.
+  std::atomic_uint_fast64_t& cost_estimate = cost_estimates_[node.node_id];
+  auto prev_estimate = cost_estimate.load(std::memory_order_relaxed);
+
+  uint64_t new_estimate =
+      ((kCostDecay - 1) * prev_estimate + elapsed_cycles) / kCostDecay;
+
+  cost_estimate.store(new_estimate, std::memory_order_relaxed);
+  num_samples_[node.node_id].fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace tensorflow
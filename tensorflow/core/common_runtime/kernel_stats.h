@@ -0,0 +1,93 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_KERNEL_STATS_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_KERNEL_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/graph_view.h"
+
+namespace tensorflow {
+
+// Stores execution time information about the kernels in an executor's graph.
+class KernelStats {
+ public:
+  // Initial time (in CPU cycles) we expect an operation to take.  Used to
+  // determine whether an operation should be place in a threadpool.
+  // Operations start out "expensive".
+  static constexpr uint64_t kInitialCostEstimateCycles = 100 * 1000 * 1000;
+  static constexpr uint64_t kOpIsExpensiveThresholdCycles = 8000;
+  static constexpr uint64_t kCostDecay = 10;
+
+  KernelStats() = default;
+
+  // In adaptive mode, every kernel is timed and the learned cost alone
+  // decides whether a node is expensive: kernels that claim to be
+  // inexpensive start with a zero estimate and are dispatched to the
+  // threadpool only if they turn out to be slow.
+  void Initialize(const GraphView& gview, bool adaptive);
+
+  bool adaptive() const { return adaptive_; }
+
+  // Returns true iff the given node is considered "expensive". The
+  // executor uses this flag to optimize graph execution, for example
+  // by "inlining" inexpensive kernels.
+  bool IsExpensive(const NodeItem& node) const {
+    return (adaptive_ || is_expensive_[node.node_id]) &&
+           (cost_estimates_[node.node_id].load(std::memory_order_relaxed) >
+            kOpIsExpensiveThresholdCycles);
+  }
+
+  // Returns the value of kernel->IsExpensive().
+  bool HasExpensiveMarker(const NodeItem& node) const {
+    return is_expensive_[node.node_id];
+  }
+
+  // Returns true if the executor should time the given node and feed the
+  // result to UpdateCostEstimate().
+  bool ShouldTime(const NodeItem& node) const {
+    return adaptive_ || is_expensive_[node.node_id];
+  }
+
+  // Returns the current cost estimate of the given node, in CPU cycles.
+  uint64_t CostEstimate(const NodeItem& node) const {
+    return cost_estimates_[node.node_id].load(std::memory_order_relaxed);
+  }
+
+  // Returns one line per kernel with its learned cost, for debugging.
+  std::string DebugString(const GraphView& gview) const;
+
+  // Updates the dynamic cost estimate, which is used to determine whether the
+  // given node is expensive. The new cost estimate is a weighted average of
+  // the old cost estimate and the latest cost. We only update cost estimates
+  // for kernels for which IsExpensive() return true.
+  void UpdateCostEstimate(const NodeItem& node, uint64_t elapsed_cycles);
+
+ private:
+  bool adaptive_ = false;
+  std::vector<bool> is_expensive_;
+  std::unique_ptr<std::atomic_uint_fast64_t[]> cost_estimates_;
+  // Number of updates of each cost estimate.
+  std::unique_ptr<std::atomic_uint_fast32_t[]> num_samples_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_KERNEL_STATS_H_
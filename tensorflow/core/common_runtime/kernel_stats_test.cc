@@ -0,0 +1,132 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/kernel_stats.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/graph_view.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Builds `c -> neg` with its CPU kernels. Const is marked inexpensive, and
+// Neg is marked expensive like other CPU kernels.
+class KernelStatsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    device_ = DeviceFactory::NewDevice("CPU", {},
+                                       "/job:localhost/replica:0/task:0");
+    ASSERT_NE(device_, nullptr);
+    Scope root = Scope::NewRootScope();
+    auto c = ops::Const(root.WithOpName("c"), 1.0f);
+    ops::Neg(root.WithOpName("neg"), c);
+    TF_ASSERT_OK(root.ToGraph(&graph_));
+    TF_ASSERT_OK(gview_.Initialize(&graph_));
+    for (Node* n : graph_.op_nodes()) {
+      absl::Status s;
+      kernels_.push_back(CreateOpKernel(DEVICE_CPU, device_.get(),
+                                        cpu_allocator(), n->def(),
+                                        graph_.versions().producer(), &s));
+      TF_ASSERT_OK(s);
+      gview_.node(n->id())->kernel = kernels_.back().get();
+    }
+  }
+
+  const NodeItem& Item(const std::string& name) {
+    for (Node* n : graph_.op_nodes()) {
+      if (n->name() == name) {
+        return *gview_.node(n->id());
+      }
+    }
+    LOG(FATAL) << "No node named " << name;
+  }
+
+  std::unique_ptr<Device> device_;
+  Graph graph_{OpRegistry::Global()};
+  GraphView gview_;
+  std::vector<std::unique_ptr<OpKernel>> kernels_;
+};
+
+TEST_F(KernelStatsTest, DefaultModeOnlyTimesMarkedKernels) {
+  KernelStats stats;
+  stats.Initialize(gview_, /*adaptive=*/false);
+  EXPECT_FALSE(stats.ShouldTime(Item("c")));
+  EXPECT_FALSE(stats.IsExpensive(Item("c")));
+  EXPECT_TRUE(stats.ShouldTime(Item("neg")));
+  EXPECT_TRUE(stats.IsExpensive(Item("neg")));
+}
+
+TEST_F(KernelStatsTest, AdaptiveModeTimesEveryKernel) {
+  KernelStats stats;
+  stats.Initialize(gview_, /*adaptive=*/true);
+  EXPECT_TRUE(stats.ShouldTime(Item("c")));
+  EXPECT_TRUE(stats.ShouldTime(Item("neg")));
+  // Kernels marked inexpensive start cheap, and the others start expensive.
+  EXPECT_EQ(stats.CostEstimate(Item("c")), 0);
+  EXPECT_FALSE(stats.IsExpensive(Item("c")));
+  EXPECT_EQ(stats.CostEstimate(Item("neg")),
+            KernelStats::kInitialCostEstimateCycles);
+  EXPECT_TRUE(stats.IsExpensive(Item("neg")));
+}
+
+TEST_F(KernelStatsTest, AdaptiveModeLearnsCheapKernel) {
+  constexpr uint64_t kCheapCycles = 1000;
+  KernelStats stats;
+  stats.Initialize(gview_, /*adaptive=*/true);
+  const NodeItem& neg = Item("neg");
+  stats.UpdateCostEstimate(neg, kCheapCycles);
+  EXPECT_TRUE(stats.IsExpensive(neg));
+  // The initial estimate decays by a factor of 0.9 per sample, so it drops
+  // below the threshold within 100 samples.
+  for (int i = 1; i < 100; ++i) {
+    stats.UpdateCostEstimate(neg, kCheapCycles);
+  }
+  EXPECT_FALSE(stats.IsExpensive(neg));
+  EXPECT_LT(stats.CostEstimate(neg),
+            KernelStats::kOpIsExpensiveThresholdCycles);
+}
+
+TEST_F(KernelStatsTest, AdaptiveModeLearnsExpensiveKernel) {
+  constexpr uint64_t kExpensiveCycles = 1000 * 1000;
+  KernelStats stats;
+  stats.Initialize(gview_, /*adaptive=*/true);
+  const NodeItem& c = Item("c");
+  stats.UpdateCostEstimate(c, kExpensiveCycles);
+  EXPECT_EQ(stats.CostEstimate(c), kExpensiveCycles / KernelStats::kCostDecay);
+  EXPECT_TRUE(stats.IsExpensive(c));
+}
+
+TEST_F(KernelStatsTest, DefaultModeNeverPromotesUnmarkedKernel) {
+  KernelStats stats;
+  stats.Initialize(gview_, /*adaptive=*/false);
+  const NodeItem& c = Item("c");
+  stats.UpdateCostEstimate(c, 1000 * 1000);
+  EXPECT_FALSE(stats.IsExpensive(c));
+}
+
+}  // namespace
+}  // namespace tensorflow
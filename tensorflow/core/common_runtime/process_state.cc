@@ -145,6 +145,26 @@ Allocator* ProcessState::GetCPUAllocator(int numa_node) {
   return cpu_allocators_[numa_node];
 }
 
+Allocator* ProcessState::GetNUMABoundCPUAllocator(int numa_node) {
+  if (numa_enabled_ || numa_node == port::kNUMANoAffinity) {
+    return GetCPUAllocator(numa_node);
+  }
+  mutex_lock lock(mu_);
+  if (numa_bound_cpu_allocators_.size() <= static_cast<size_t>(numa_node)) {
+    numa_bound_cpu_allocators_.resize(numa_node + 1, nullptr);
+  }
+  Allocator*& allocator = numa_bound_cpu_allocators_[numa_node];
+  if (allocator == nullptr) {
+    allocator = new PoolAllocator(
+        /*pool_size_limit=*/100, /*auto_resize=*/true,
+        new BasicCPUAllocator(numa_node, cpu_alloc_visitors_,
+                              cpu_free_visitors_),
+        new NoopRounder, strings::StrCat("cpu_pool_numa_", numa_node));
+    VLOG(2) << "Using PoolAllocator bound to numa_node=" << numa_node;
+  }
+  return allocator;
+}
+
 void ProcessState::AddCPUAllocVisitor(SubAllocator::Visitor visitor) {
   VLOG(1) << "AddCPUAllocVisitor";
   mutex_lock lock(mu_);
@@ -171,6 +191,10 @@ void ProcessState::TestOnlyReset() {
     if (a != default_cpu_allocator) delete a;
   }
   cpu_allocators_.clear();
+  for (Allocator* a : numa_bound_cpu_allocators_) {
+    delete a;
+  }
+  numa_bound_cpu_allocators_.clear();
   for (Allocator* a : cpu_al_) {
     delete a;
   }
@@ -67,6 +67,12 @@ class ProcessState : public ProcessStateInterface {
   // Treats numa_node == kNUMANoAffinity as numa_node == 0.
   Allocator* GetCPUAllocator(int numa_node) override;
 
+  // Returns a CPU allocator whose memory is bound to `numa_node`, whether or
+  // not EnableNUMA() was called. Unlike GetCPUAllocator, this does not change
+  // the allocators of other callers, so a session can keep its own host
+  // memory node-local. Returns GetCPUAllocator(numa_node) if NUMA is enabled.
+  Allocator* GetNUMABoundCPUAllocator(int numa_node);
+
   // Registers alloc visitor for the CPU allocator(s).
   // REQUIRES: must be called before GetCPUAllocator.
   void AddCPUAllocVisitor(SubAllocator::Visitor v);
@@ -100,6 +106,8 @@ class ProcessState : public ProcessStateInterface {
   // Indexed by numa_node.  If we want numa-specific allocators AND a
   // non-specific allocator, maybe should index by numa_node+1.
   std::vector<Allocator*> cpu_allocators_ TF_GUARDED_BY(mu_);
+  // Allocators returned by GetNUMABoundCPUAllocator, indexed by numa_node.
+  std::vector<Allocator*> numa_bound_cpu_allocators_ TF_GUARDED_BY(mu_);
   std::vector<SubAllocator::Visitor> cpu_alloc_visitors_ TF_GUARDED_BY(mu_);
   std::vector<SubAllocator::Visitor> cpu_free_visitors_ TF_GUARDED_BY(mu_);
 
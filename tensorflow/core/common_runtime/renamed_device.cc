@@ -35,7 +35,8 @@ namespace tensorflow {
 std::unique_ptr<Device> RenamedDevice::NewRenamedDevice(
     const std::string& new_base, Device* underlying, bool owns_underlying,
     bool isolate_session_state,
-    thread::ThreadPoolInterface* underlying_threadpool) {
+    thread::ThreadPoolInterface* underlying_threadpool,
+    Allocator* host_allocator) {
   DeviceNameUtils::ParsedName parsed_name;
   CHECK(DeviceNameUtils::ParseFullName(new_base, &parsed_name));
   DeviceNameUtils::ParsedName underlying_parsed_name =
@@ -52,17 +53,20 @@ std::unique_ptr<Device> RenamedDevice::NewRenamedDevice(
   // Call absl::WrapUnique to access private constructor.
   return absl::WrapUnique(
       new RenamedDevice(underlying, std::move(attributes), owns_underlying,
-                        isolate_session_state, underlying_threadpool));
+                        isolate_session_state, underlying_threadpool,
+                        host_allocator));
 }
 
 RenamedDevice::RenamedDevice(Device* underlying, DeviceAttributes attributes,
                              bool owns_underlying_device,
                              bool isolate_session_state,
-                             thread::ThreadPoolInterface* underlying_threadpool)
+                             thread::ThreadPoolInterface* underlying_threadpool,
+                             Allocator* host_allocator)
     : Device(underlying->env(), std::move(attributes)),
       underlying_device_(underlying),
       owns_underlying_device_(owns_underlying_device),
-      isolate_session_state_(isolate_session_state) {
+      isolate_session_state_(isolate_session_state),
+      host_allocator_(host_allocator) {
   if (underlying_threadpool != nullptr) {
     underlying_threadpool_.reset(new thread::ThreadPool(underlying_threadpool));
     eigen_worker_threads_.workers = underlying_threadpool_.get();
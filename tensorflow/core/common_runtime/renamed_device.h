@@ -29,12 +29,18 @@ namespace tensorflow {
 // This class is used to wrap local devices when using clusterspec propagation
 // where the name of a particular device may change in the context of a given
 // session.
+//
+// If `underlying_threadpool` is set, CPU work runs on it instead of on the
+// threads of the underlying device. If `host_allocator` is set, allocations
+// that need not be accessible to other devices are served by it instead of by
+// the underlying device, e.g. to keep the memory of a step on one NUMA node.
 class RenamedDevice : public Device {
  public:
   static std::unique_ptr<Device> NewRenamedDevice(
       const std::string& new_base, Device* underlying, bool owns_underlying,
       bool isolate_session_state,
-      thread::ThreadPoolInterface* underlying_threadpool = nullptr);
+      thread::ThreadPoolInterface* underlying_threadpool = nullptr,
+      Allocator* host_allocator = nullptr);
 
   ~RenamedDevice() override;
 
@@ -58,6 +64,10 @@ class RenamedDevice : public Device {
   }
 
   Allocator* GetAllocator(AllocatorAttributes attr) override {
+    if (host_allocator_ != nullptr && !attr.gpu_compatible() &&
+        !attr.nic_compatible()) {
+      return host_allocator_;
+    }
     return underlying_device_->GetAllocator(attr);
   }
 
@@ -159,10 +169,12 @@ class RenamedDevice : public Device {
  private:
   RenamedDevice(Device* underlying, DeviceAttributes attributes,
                 bool owns_underlying, bool isolate_session_state,
-                thread::ThreadPoolInterface* underlying_threadpool);
+                thread::ThreadPoolInterface* underlying_threadpool,
+                Allocator* host_allocator);
   Device* const underlying_device_;
   const bool owns_underlying_device_;
   const bool isolate_session_state_;
+  Allocator* const host_allocator_;  // Not owned.
 
   std::unique_ptr<thread::ThreadPool> underlying_threadpool_;
   // eigen_worker_threads_ is stored here so that we can pass the pointer
@@ -0,0 +1,345 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_memory_plan.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <utility>
+
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace {
+
+int64_t AlignedSize(int64_t num_bytes) {
+  return (num_bytes + Allocator::kAllocatorAlignment - 1) /
+         Allocator::kAllocatorAlignment * Allocator::kAllocatorAlignment;
+}
+
+// Returns true if the outputs of `node` are not allocated by its kernel, so
+// planning them would only waste space.
+bool ForwardsOrOwnsOutputs(const Node* node) {
+  if (node->IsConstant() || node->IsArg() || node->IsRecv() ||
+      node->IsIdentity() || node->IsVariable()) {
+    return true;
+  }
+  const std::string& op = node->type_string();
+  return op == "Reshape" || op == "Squeeze" || op == "ExpandDims" ||
+         op == "ReadVariableOp" || op == "Snapshot";
+}
+
+// Output shapes of the nodes of a graph, from the shape functions of their ops
+// applied in topological order. This is a subset of ShapeRefiner, which cannot
+// be used here since its library depends on the executor: only the values of
+// constants are propagated, and nodes whose shapes cannot be inferred get
+// unknown output shapes.
+class OutputShapes {
+ public:
+  explicit OutputShapes(const Graph& graph)
+      : graph_(graph),
+        shapes_(graph.num_node_ids()),
+        constants_(graph.num_node_ids()) {}
+
+  void InferNode(const Node* node) {
+    std::vector<PartialTensorShape>& outputs = shapes_[node->id()];
+    outputs.assign(node->num_outputs(), PartialTensorShape());
+    const OpRegistrationData* op_reg_data;
+    if (!graph_.op_registry()->LookUp(node->type_string(), &op_reg_data).ok() ||
+        op_reg_data->shape_inference_fn == nullptr) {
+      return;
+    }
+    std::vector<PartialTensorShape> input_shapes(node->num_inputs());
+    std::vector<const Tensor*> input_tensors(node->num_inputs(), nullptr);
+    for (const Edge* edge : node->in_edges()) {
+      if (edge->IsControlEdge()) continue;
+      const int src = edge->src()->id();
+      if (edge->src_output() < shapes_[src].size()) {
+        input_shapes[edge->dst_input()] = shapes_[src][edge->src_output()];
+      }
+      input_tensors[edge->dst_input()] = constants_[src].get();
+    }
+    shape_inference::InferenceContext c(
+        graph_.versions().producer(), node->attrs(), op_reg_data->op_def,
+        input_shapes, input_tensors, /*input_tensors_as_shapes=*/{},
+        /*input_handle_shapes_and_types=*/{});
+    if (!c.construction_status().ok() ||
+        !c.Run(op_reg_data->shape_inference_fn).ok()) {
+      return;
+    }
+    for (int i = 0; i < c.num_outputs() && i < outputs.size(); ++i) {
+      TensorShapeProto proto;
+      c.ShapeHandleToProto(c.output(i), &proto);
+      if (!PartialTensorShape::BuildPartialTensorShape(proto, &outputs[i])
+               .ok()) {
+        outputs[i] = PartialTensorShape();
+      }
+    }
+    if (node->IsConstant()) {
+      const TensorProto* value;
+      auto constant = std::make_unique<Tensor>();
+      if (TryGetNodeAttr(node->attrs(), "value", &value) &&
+          constant->FromProto(*value)) {
+        constants_[node->id()] = std::move(constant);
+      }
+    }
+  }
+
+  const PartialTensorShape& shape(const Node* node, int output) const {
+    return shapes_[node->id()][output];
+  }
+
+ private:
+  const Graph& graph_;
+  std::vector<std::vector<PartialTensorShape>> shapes_;
+  std::vector<std::unique_ptr<Tensor>> constants_;
+};
+
+// Ancestor sets of the nodes of a graph, one bit per node.
+class AncestorSets {
+ public:
+  AncestorSets(const Graph& graph, const std::vector<Node*>& order)
+      : num_words_((graph.num_node_ids() + 63) / 64),
+        bits_(static_cast<size_t>(graph.num_node_ids()) * num_words_, 0) {
+    for (const Node* node : order) {
+      uint64_t* dst = row(node->id());
+      for (const Edge* edge : node->in_edges()) {
+        const int src = edge->src()->id();
+        const uint64_t* src_row = row(src);
+        for (int i = 0; i < num_words_; ++i) dst[i] |= src_row[i];
+        dst[src / 64] |= uint64_t{1} << (src % 64);
+      }
+    }
+  }
+
+  // Returns true if `a` is a strict ancestor of `b`.
+  bool IsAncestor(int a, int b) const {
+    return (row(b)[a / 64] >> (a % 64)) & 1;
+  }
+
+ private:
+  uint64_t* row(int id) { return &bits_[static_cast<size_t>(id) * num_words_]; }
+  const uint64_t* row(int id) const {
+    return &bits_[static_cast<size_t>(id) * num_words_];
+  }
+
+  const int num_words_;
+  std::vector<uint64_t> bits_;
+};
+
+}  // namespace
+
+absl::Status PlanStaticMemory(const Graph& graph,
+                              const StaticMemoryPlanOptions& options,
+                              StaticMemoryPlan* plan) {
+  *plan = StaticMemoryPlan();
+  if (graph.num_node_ids() > options.max_nodes) {
+    return errors::ResourceExhausted("Graph has ", graph.num_node_ids(),
+                                     " nodes, more than the ",
+                                     options.max_nodes,
+                                     " supported by static memory planning.");
+  }
+
+  std::vector<Node*> order;
+  GetReversePostOrder(graph, &order);
+
+  OutputShapes shapes(graph);
+  std::vector<std::vector<int>> users;
+  for (Node* node : order) {
+    if (!node->IsOp()) continue;
+    shapes.InferNode(node);
+    if (ForwardsOrOwnsOutputs(node)) continue;
+    for (int i = 0; i < node->num_outputs(); ++i) {
+      const DataType dtype = node->output_type(i);
+      const PartialTensorShape& shape = shapes.shape(node, i);
+      if (IsRefType(dtype) || !DataTypeCanUseMemcpy(dtype) ||
+          !shape.IsFullyDefined()) {
+        continue;
+      }
+      const int64_t size = shape.num_elements() * DataTypeSize(dtype);
+      if (size <= 0) continue;
+      plan->slots.push_back({node->id(), i, /*offset=*/0, size, {}});
+      users.emplace_back();
+    }
+  }
+  if (plan->slots.empty()) return absl::OkStatus();
+
+  // Map each planned output to its slot and collect its consumers. An output
+  // nobody consumes is only live while its producer runs.
+  std::vector<int> first_slot(graph.num_node_ids(), -1);
+  for (int s = plan->slots.size() - 1; s >= 0; --s) {
+    first_slot[plan->slots[s].node_id] = s;
+  }
+  for (const Edge* edge : graph.edges()) {
+    if (edge->IsControlEdge()) continue;
+    int s = first_slot[edge->src()->id()];
+    if (s < 0) continue;
+    for (; s < plan->slots.size() &&
+           plan->slots[s].node_id == edge->src()->id();
+         ++s) {
+      if (plan->slots[s].output == edge->src_output()) {
+        users[s].push_back(edge->dst()->id());
+        break;
+      }
+    }
+  }
+  for (int s = 0; s < plan->slots.size(); ++s) {
+    if (users[s].empty()) users[s].push_back(plan->slots[s].node_id);
+  }
+
+  const AncestorSets ancestors(graph, order);
+  // Slot `a` is dead before slot `b` is allocated if every user of `a` has
+  // finished before the producer of `b` starts.
+  auto precedes = [&](int a, int b) {
+    const int producer = plan->slots[b].node_id;
+    for (int user : users[a]) {
+      if (user == producer || !ancestors.IsAncestor(user, producer)) {
+        return false;
+      }
+    }
+    return true;
+  };
+  auto may_share = [&](int a, int b) {
+    return precedes(a, b) || precedes(b, a);
+  };
+
+  // Place the largest slots first, each at the lowest offset that does not
+  // intersect a placed slot it may not share with.
+  std::vector<int> by_size(plan->slots.size());
+  std::iota(by_size.begin(), by_size.end(), 0);
+  std::stable_sort(by_size.begin(), by_size.end(), [&](int a, int b) {
+    return plan->slots[a].size > plan->slots[b].size;
+  });
+  std::vector<int> placed;
+  std::vector<std::pair<int64_t, int64_t>> taken;
+  for (int s : by_size) {
+    StaticMemoryPlan::Slot& slot = plan->slots[s];
+    taken.clear();
+    for (int p : placed) {
+      if (!may_share(s, p)) {
+        taken.emplace_back(plan->slots[p].offset,
+                           plan->slots[p].offset + plan->slots[p].size);
+      }
+    }
+    std::sort(taken.begin(), taken.end());
+    int64_t offset = 0;
+    for (const auto& [begin, end] : taken) {
+      if (offset + slot.size <= begin) break;
+      offset = std::max(offset, AlignedSize(end));
+    }
+    slot.offset = offset;
+    plan->total_bytes = std::max(plan->total_bytes, offset + slot.size);
+    plan->unshared_bytes += AlignedSize(slot.size);
+    placed.push_back(s);
+  }
+
+  for (int a = 0; a < plan->slots.size(); ++a) {
+    StaticMemoryPlan::Slot& slot_a = plan->slots[a];
+    for (int b = a + 1; b < plan->slots.size(); ++b) {
+      StaticMemoryPlan::Slot& slot_b = plan->slots[b];
+      if (slot_a.offset < slot_b.offset + slot_b.size &&
+          slot_b.offset < slot_a.offset + slot_a.size) {
+        slot_a.overlapping_slots.push_back(b);
+        slot_b.overlapping_slots.push_back(a);
+      }
+    }
+  }
+  VLOG(1) << "Planned " << plan->slots.size() << " outputs into "
+          << plan->total_bytes << " bytes instead of " << plan->unshared_bytes;
+  return absl::OkStatus();
+}
+
+// A view of one slot of a StaticMemoryPlanBuffer. Marks the slot as dead when
+// the last tensor referencing it is destroyed.
+class StaticMemoryPlanBuffer::SlotBuffer : public TensorBuffer {
+ public:
+  SlotBuffer(StaticMemoryPlanBuffer* owner, int slot, size_t size)
+      : TensorBuffer(owner->data_ + owner->plan_->slots[slot].offset),
+        owner_(owner),
+        slot_(slot),
+        size_(size) {
+    owner_->Ref();
+  }
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("static_memory_plan");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+ private:
+  ~SlotBuffer() override {
+    owner_->live_[slot_].store(false, std::memory_order_release);
+    owner_->Unref();
+  }
+
+  StaticMemoryPlanBuffer* const owner_;
+  const int slot_;
+  const size_t size_;
+};
+
+StaticMemoryPlanBuffer::StaticMemoryPlanBuffer(const StaticMemoryPlan* plan,
+                                               Allocator* allocator)
+    : plan_(plan),
+      allocator_(allocator),
+      live_(new std::atomic<bool>[plan->slots.size()]) {
+  for (int i = 0; i < plan->slots.size(); ++i) live_[i] = false;
+  if (plan_->total_bytes > 0) {
+    data_ = static_cast<char*>(allocator_->AllocateRaw(
+        Allocator::kAllocatorAlignment, plan_->total_bytes));
+  }
+}
+
+StaticMemoryPlanBuffer::~StaticMemoryPlanBuffer() {
+  if (data_ != nullptr) allocator_->DeallocateRaw(data_);
+}
+
+bool StaticMemoryPlanBuffer::Allocate(int slot, DataType type,
+                                      const TensorShape& shape,
+                                      Tensor* tensor) {
+  if (data_ == nullptr || slot >= plan_->slots.size()) return false;
+  const StaticMemoryPlan::Slot& planned = plan_->slots[slot];
+  const int64_t num_bytes = shape.num_elements() * DataTypeSize(type);
+  bool fits = DataTypeCanUseMemcpy(type) && num_bytes <= planned.size &&
+              !live_[slot].load(std::memory_order_acquire);
+  // The graph orders the producers of overlapping slots after the consumers
+  // of this one, but a kernel may still hold on to or forward their outputs.
+  for (int i = 0; fits && i < planned.overlapping_slots.size(); ++i) {
+    fits = !live_[planned.overlapping_slots[i]].load(std::memory_order_acquire);
+  }
+  if (!fits) {
+    num_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  live_[slot].store(true, std::memory_order_relaxed);
+  auto* buf = new SlotBuffer(this, slot, num_bytes);
+  *tensor = Tensor(type, shape, buf);
+  buf->Unref();
+  return true;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,99 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLAN_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLAN_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/refcount.h"
+
+namespace tensorflow {
+
+// An assignment of node outputs to byte ranges of one buffer per step, in the
+// style of the TFLite arena planner. Outputs whose shapes are fully known
+// ahead of execution get a slot; two slots may share bytes only if the graph
+// orders their lifetimes, i.e. every consumer of one is an ancestor of the
+// producer of the other.
+struct StaticMemoryPlan {
+  struct Slot {
+    int node_id;
+    int output;
+    int64_t offset;
+    int64_t size;
+    // Other slots whose byte ranges intersect this one.
+    std::vector<int> overlapping_slots;
+  };
+
+  int64_t total_bytes = 0;
+  std::vector<Slot> slots;
+  // Sum of the sizes of all slots, i.e. the bytes needed without reuse.
+  int64_t unshared_bytes = 0;
+};
+
+struct StaticMemoryPlanOptions {
+  // Graphs with more nodes are not planned, since the liveness analysis uses
+  // O(num_nodes^2) bits.
+  int max_nodes = 8192;
+};
+
+// Plans the memory for the outputs of `graph`, which must be acyclic, whose
+// shapes are fully known by shape inference and whose types can be copied
+// with memcpy. Outputs of ops that do not allocate them, such as constants,
+// arguments, receives and identities, are not planned.
+absl::Status PlanStaticMemory(const Graph& graph,
+                              const StaticMemoryPlanOptions& options,
+                              StaticMemoryPlan* plan);
+
+// The buffer of one step executed with a StaticMemoryPlan. A slot is handed out
+// only if neither it nor an overlapping slot is still referenced by a tensor,
+// so the plan never aliases live data even if a kernel keeps a tensor alive
+// longer than the graph suggests. The buffer is freed when the step has
+// released its reference and the last tensor in it has been destroyed.
+class StaticMemoryPlanBuffer : public PlannedOutputAllocator,
+                               public core::RefCounted {
+ public:
+  // `plan` must outlive the calls to Allocate(), but not the tensors.
+  StaticMemoryPlanBuffer(const StaticMemoryPlan* plan, Allocator* allocator);
+
+  bool Allocate(int slot, DataType type, const TensorShape& shape,
+                Tensor* tensor) override;
+
+  // Number of Allocate() calls that were refused.
+  int64_t num_fallbacks() const { return num_fallbacks_.load(); }
+
+ private:
+  class SlotBuffer;
+
+  ~StaticMemoryPlanBuffer() override;
+
+  const StaticMemoryPlan* const plan_;
+  Allocator* const allocator_;
+  char* data_ = nullptr;
+  std::unique_ptr<std::atomic<bool>[]> live_;
+  std::atomic<int64_t> num_fallbacks_{0};
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLAN_H_
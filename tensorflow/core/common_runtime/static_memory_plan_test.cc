@@ -0,0 +1,151 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_memory_plan.h"
+
+#include <string>
+
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Returns the index of the slot of output 0 of the node named `name`.
+int SlotOf(const Graph& graph, const StaticMemoryPlan& plan,
+           const std::string& name) {
+  for (int i = 0; i < plan.slots.size(); ++i) {
+    if (graph.FindNodeId(plan.slots[i].node_id)->name() == name &&
+        plan.slots[i].output == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool Overlap(const StaticMemoryPlan::Slot& a, const StaticMemoryPlan::Slot& b) {
+  return a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+}
+
+// c -> n1 -> n2 -> n3 -> n4, with 1KB float outputs.
+absl::Status BuildChain(Graph* graph) {
+  Scope root = Scope::NewRootScope();
+  auto c = ops::Const(root.WithOpName("c"), 1.0f, TensorShape({256}));
+  auto n1 = ops::Neg(root.WithOpName("n1"), c);
+  auto n2 = ops::Neg(root.WithOpName("n2"), n1);
+  auto n3 = ops::Neg(root.WithOpName("n3"), n2);
+  ops::Neg(root.WithOpName("n4"), n3);
+  return root.ToGraph(graph);
+}
+
+TEST(StaticMemoryPlanTest, ChainReusesMemory) {
+  Graph graph(OpRegistry::Global());
+  TF_ASSERT_OK(BuildChain(&graph));
+  StaticMemoryPlan plan;
+  TF_ASSERT_OK(PlanStaticMemory(graph, StaticMemoryPlanOptions(), &plan));
+
+  // The constant is not planned.
+  ASSERT_EQ(plan.slots.size(), 4);
+  EXPECT_EQ(SlotOf(graph, plan, "c"), -1);
+  EXPECT_EQ(plan.unshared_bytes, 4 * 1024);
+  EXPECT_EQ(plan.total_bytes, 2 * 1024);
+
+  const int n1 = SlotOf(graph, plan, "n1");
+  const int n2 = SlotOf(graph, plan, "n2");
+  const int n3 = SlotOf(graph, plan, "n3");
+  // An output and its consumer's output are live at the same time.
+  EXPECT_FALSE(Overlap(plan.slots[n1], plan.slots[n2]));
+  EXPECT_FALSE(Overlap(plan.slots[n2], plan.slots[n3]));
+  EXPECT_EQ(plan.slots[n1].offset, plan.slots[n3].offset);
+  EXPECT_EQ(plan.slots[n1].overlapping_slots, std::vector<int>({n3}));
+}
+
+TEST(StaticMemoryPlanTest, ParallelOutputsDoNotShare) {
+  Scope root = Scope::NewRootScope();
+  auto c = ops::Const(root.WithOpName("c"), 1.0f, TensorShape({256}));
+  auto a = ops::Neg(root.WithOpName("a"), c);
+  auto b = ops::Neg(root.WithOpName("b"), c);
+  ops::Add(root.WithOpName("sum"), a, b);
+  Graph graph(OpRegistry::Global());
+  TF_ASSERT_OK(root.ToGraph(&graph));
+
+  StaticMemoryPlan plan;
+  TF_ASSERT_OK(PlanStaticMemory(graph, StaticMemoryPlanOptions(), &plan));
+  ASSERT_EQ(plan.slots.size(), 3);
+  EXPECT_EQ(plan.total_bytes, 3 * 1024);
+  for (const StaticMemoryPlan::Slot& slot : plan.slots) {
+    EXPECT_TRUE(slot.overlapping_slots.empty());
+  }
+}
+
+TEST(StaticMemoryPlanTest, UnknownShapesAreNotPlanned) {
+  Scope root = Scope::NewRootScope();
+  auto x = ops::Placeholder(root.WithOpName("x"), DT_FLOAT);
+  ops::Neg(root.WithOpName("neg"), x);
+  Graph graph(OpRegistry::Global());
+  TF_ASSERT_OK(root.ToGraph(&graph));
+
+  StaticMemoryPlan plan;
+  TF_ASSERT_OK(PlanStaticMemory(graph, StaticMemoryPlanOptions(), &plan));
+  EXPECT_TRUE(plan.slots.empty());
+  EXPECT_EQ(plan.total_bytes, 0);
+}
+
+TEST(StaticMemoryPlanTest, TooManyNodes) {
+  Graph graph(OpRegistry::Global());
+  TF_ASSERT_OK(BuildChain(&graph));
+  StaticMemoryPlanOptions options;
+  options.max_nodes = 4;
+  StaticMemoryPlan plan;
+  EXPECT_FALSE(PlanStaticMemory(graph, options, &plan).ok());
+}
+
+TEST(StaticMemoryPlanBufferTest, RefusesSlotsWhileOverlappingSlotIsLive) {
+  Graph graph(OpRegistry::Global());
+  TF_ASSERT_OK(BuildChain(&graph));
+  StaticMemoryPlan plan;
+  TF_ASSERT_OK(PlanStaticMemory(graph, StaticMemoryPlanOptions(), &plan));
+  const int n1 = SlotOf(graph, plan, "n1");
+  const int n3 = SlotOf(graph, plan, "n3");
+
+  auto* buffer = new StaticMemoryPlanBuffer(&plan, cpu_allocator());
+  Tensor t1;
+  ASSERT_TRUE(buffer->Allocate(n1, DT_FLOAT, TensorShape({256}), &t1));
+  t1.flat<float>().setConstant(1.0f);
+  // `t1` still holds the memory of `n3`.
+  Tensor t3;
+  EXPECT_FALSE(buffer->Allocate(n3, DT_FLOAT, TensorShape({256}), &t3));
+  EXPECT_EQ(buffer->num_fallbacks(), 1);
+  // Larger than planned.
+  EXPECT_FALSE(buffer->Allocate(SlotOf(graph, plan, "n2"), DT_FLOAT,
+                                TensorShape({257}), &t3));
+
+  const void* data = t1.data();
+  t1 = Tensor();
+  ASSERT_TRUE(buffer->Allocate(n3, DT_FLOAT, TensorShape({256}), &t3));
+  EXPECT_EQ(t3.data(), data);
+
+  // The tensor keeps the buffer alive after the step releases it.
+  buffer->Unref();
+  t3.flat<float>().setConstant(3.0f);
+  EXPECT_EQ(t3.flat<float>()(255), 3.0f);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -14,15 +14,23 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/compression_utils.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -31,8 +39,11 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/framework/variant_op_registry.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/platform/tstring.h"
 #include "tensorflow/core/platform/types.h"
 
@@ -42,11 +53,154 @@ namespace {
 
 // Increment this when making changes to the `CompressedElement` proto. The
 // `UncompressElement` function will determine what to read according to the
-// version.
-constexpr int kCompressedElementVersion = 0;
+// version. Version 1 added `codec`.
+constexpr int kCompressedElementVersion = 1;
+// The version of snappy-compressed elements, which predate `codec` and are
+// written with the old version so that older readers can read them.
+constexpr int kSnappyCompressedElementVersion = 0;
+
+class SnappyCodec : public ElementCodec {
+ public:
+  absl::Status Compress(const iovec* iov, size_t num_pieces, size_t num_bytes,
+                        std::string* out) const override {
+    if (num_bytes > std::numeric_limits<uint32_t>::max()) {
+      return absl::OutOfRangeError(
+          absl::StrCat("Encountered dataset element of size ", num_bytes,
+                       ", exceeding the 4GB Snappy limit."));
+    }
+    if (!port::Snappy_CompressFromIOVec(iov, num_bytes, out)) {
+      return absl::InternalError("Failed to compress using snappy.");
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Uncompress(absl::string_view compressed, const iovec* iov,
+                          size_t num_pieces, size_t num_bytes) const override {
+    size_t uncompressed_size;
+    if (!port::Snappy_GetUncompressedLength(
+            compressed.data(), compressed.size(), &uncompressed_size)) {
+      return absl::InternalError(absl::StrCat(
+          "Could not get snappy uncompressed length. Compressed data size: ",
+          compressed.size()));
+    }
+    if (uncompressed_size != num_bytes) {
+      return absl::InternalError(absl::StrCat(
+          "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
+          " whereas the tensor metadata suggests ", num_bytes));
+    }
+    if (!port::Snappy_UncompressToIOVec(compressed.data(), compressed.size(),
+                                        iov, num_pieces)) {
+      return absl::InternalError("Failed to perform snappy decompression.");
+    }
+    return absl::OkStatus();
+  }
+};
+
+// Stores the bytes as they are, for workers that are short on CPU.
+class NoCompressionCodec : public ElementCodec {
+ public:
+  absl::Status Compress(const iovec* iov, size_t num_pieces, size_t num_bytes,
+                        std::string* out) const override {
+    out->clear();
+    out->reserve(num_bytes);
+    for (size_t i = 0; i < num_pieces; ++i) {
+      if (iov[i].iov_len > 0) {
+        out->append(static_cast<const char*>(iov[i].iov_base),
+                    iov[i].iov_len);
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Uncompress(absl::string_view compressed, const iovec* iov,
+                          size_t num_pieces, size_t num_bytes) const override {
+    if (compressed.size() != num_bytes) {
+      return absl::InternalError(absl::StrCat(
+          "Uncompressed size mismatch. Got ", compressed.size(),
+          " bytes whereas the tensor metadata suggests ", num_bytes));
+    }
+    for (size_t i = 0; i < num_pieces; ++i) {
+      if (iov[i].iov_len > 0) {
+        std::memcpy(iov[i].iov_base, compressed.data(), iov[i].iov_len);
+        compressed.remove_prefix(iov[i].iov_len);
+      }
+    }
+    return absl::OkStatus();
+  }
+};
+
+mutex* get_codecs_lock() {
+  static mutex lock(LINKER_INITIALIZED);
+  return &lock;
+}
+
+// Whether codecs can no longer be registered. Guarded by `get_codecs_lock()`.
+// Set by the first lookup, after which `element_codecs()` is immutable and is
+// read without locking.
+bool codecs_frozen = false;
+
+using ElementCodecs =
+    absl::flat_hash_map<std::string, std::unique_ptr<ElementCodec>>;
+ElementCodecs& element_codecs() {
+  static auto& codecs = *[] {
+    auto* codecs = new ElementCodecs();
+    codecs->emplace(kSnappyCodec, std::make_unique<SnappyCodec>());
+    codecs->emplace(kNoCompressionCodec,
+                    std::make_unique<NoCompressionCodec>());
+    return codecs;
+  }();
+  return codecs;
+}
+
+// Returns the registered codecs. The first call stops registration, so that
+// lookups on the compression hot path do not lock.
+const ElementCodecs& frozen_element_codecs() {
+  static const ElementCodecs& codecs = []() -> const ElementCodecs& {
+    mutex_lock l(*get_codecs_lock());
+    codecs_frozen = true;
+    return element_codecs();
+  }();
+  return codecs;
+}
 
 }  // namespace
 
+void ElementCodec::Register(const std::string& name,
+                            std::unique_ptr<ElementCodec> codec) {
+  mutex_lock l(*get_codecs_lock());
+  if (codecs_frozen) {
+    LOG(ERROR) << "Element codec " << name << " is registered after element "
+               << "codecs have been looked up, so it is ignored. Codecs "
+               << "must be registered during static initialization.";
+    return;
+  }
+  if (!element_codecs().emplace(name, std::move(codec)).second) {
+    LOG(ERROR) << "Two element codecs are being registered with name " << name
+               << ". Only the first one is used.";
+  }
+}
+
+absl::StatusOr<const ElementCodec*> ElementCodec::Get(absl::string_view name) {
+  const ElementCodecs& codecs = frozen_element_codecs();
+  auto it = codecs.find(name);
+  if (it != codecs.end()) {
+    return it->second.get();
+  }
+  std::vector<std::string> available_names;
+  for (const auto& [available_name, codec] : codecs) {
+    available_names.push_back(available_name);
+  }
+  std::sort(available_names.begin(), available_names.end());
+  return absl::NotFoundError(absl::StrCat(
+      "No element codec has been registered for name ", name,
+      ". The available names are: [ ", absl::StrJoin(available_names, ", "),
+      " ]"));
+}
+
+bool ElementCodec::IsRegistered(absl::string_view name) {
+  return frozen_element_codecs().contains(name);
+}
+
 class Iov {
  public:
   explicit Iov(size_t size) : iov_(size), idx_(0), num_bytes_(0) {}
@@ -72,6 +226,13 @@ class Iov {
 
 absl::Status CompressElement(const std::vector<Tensor>& element,
                              CompressedElement* out) {
+  return CompressElement(element, kSnappyCodec, out);
+}
+
+absl::Status CompressElement(const std::vector<Tensor>& element,
+                             absl::string_view codec, CompressedElement* out) {
+  TF_ASSIGN_OR_RETURN(const ElementCodec* element_codec,
+                      ElementCodec::Get(codec));
   // First pass: preprocess the non`memcpy`able tensors.
   size_t num_string_tensors = 0;
   size_t num_string_tensor_strings = 0;
@@ -129,27 +290,33 @@ absl::Status CompressElement(const std::vector<Tensor>& element,
     }
   }
 
-  if (iov.NumBytes() > std::numeric_limits<uint32_t>::max()) {
-    return absl::OutOfRangeError(
-        absl::StrCat("Encountered dataset element of size ", iov.NumBytes(),
-                     ", exceeding the 4GB Snappy limit."));
+  TF_RETURN_IF_ERROR(element_codec->Compress(iov.Data(), iov.NumPieces(),
+                                             iov.NumBytes(),
+                                             out->mutable_data()));
+  if (codec == kSnappyCodec) {
+    out->set_version(kSnappyCompressedElementVersion);
+  } else {
+    out->set_version(kCompressedElementVersion);
+    out->set_codec(std::string(codec));
   }
-  if (!port::Snappy_CompressFromIOVec(iov.Data(), iov.NumBytes(),
-                                      out->mutable_data())) {
-    return absl::InternalError("Failed to compress using snappy.");
-  }
-  out->set_version(kCompressedElementVersion);
   VLOG(3) << "Compressed element from " << iov.NumBytes() << " bytes to "
-          << out->data().size() << " bytes";
+          << out->data().size() << " bytes with " << codec;
   return absl::OkStatus();
 }
 
 absl::Status UncompressElement(const CompressedElement& compressed,
                                std::vector<Tensor>* out) {
-  if (compressed.version() != kCompressedElementVersion) {
+  if (compressed.version() != kSnappyCompressedElementVersion &&
+      (compressed.version() != kCompressedElementVersion ||
+       compressed.codec().empty())) {
     return absl::InternalError(absl::StrCat(
         "Unsupported compressed element version: ", compressed.version()));
   }
+  TF_ASSIGN_OR_RETURN(
+      const ElementCodec* codec,
+      ElementCodec::Get(compressed.version() == kSnappyCompressedElementVersion
+                            ? kSnappyCodec
+                            : compressed.codec()));
   int num_components = compressed.component_metadata_size();
   out->clear();
   out->reserve(num_components);
@@ -224,24 +391,8 @@ absl::Status UncompressElement(const CompressedElement& compressed,
   }
 
   // Step 2: Uncompress into the iovec.
-  const std::string& compressed_data = compressed.data();
-  size_t uncompressed_size;
-  if (!port::Snappy_GetUncompressedLength(
-          compressed_data.data(), compressed_data.size(), &uncompressed_size)) {
-    return absl::InternalError(absl::StrCat(
-        "Could not get snappy uncompressed length. Compressed data size: ",
-        compressed_data.size()));
-  }
-  if (uncompressed_size != static_cast<size_t>(iov.NumBytes())) {
-    return absl::InternalError(absl::StrCat(
-        "Uncompressed size mismatch. Snappy expects ", uncompressed_size,
-        " whereas the tensor metadata suggests ", iov.NumBytes()));
-  }
-  if (!port::Snappy_UncompressToIOVec(compressed_data.data(),
-                                      compressed_data.size(), iov.Data(),
-                                      iov.NumPieces())) {
-    return absl::InternalError("Failed to perform snappy decompression.");
-  }
+  TF_RETURN_IF_ERROR(codec->Uncompress(compressed.data(), iov.Data(),
+                                       iov.NumPieces(), iov.NumBytes()));
 
   // Third pass: deserialize nonstring, non`memcpy`able tensors.
   nonmemcpyable_pos = nonmemcpyable.mdata();
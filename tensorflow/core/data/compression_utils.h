@@ -15,16 +15,61 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_COMPRESSION_UTILS_H_
 #define TENSORFLOW_CORE_DATA_COMPRESSION_UTILS_H_
 
+#include <cstddef>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/status.h"
 
 namespace tensorflow {
 namespace data {
 
+// Codec names for `CompressElement`.
+inline constexpr char kSnappyCodec[] = "snappy";
+inline constexpr char kNoCompressionCodec[] = "none";
+
+// A compression algorithm for the bytes of `CompressedElement`s. Codecs are
+// registered under a name, which is recorded in the elements they compress so
+// that readers can uncompress them with the same codec. "snappy" and "none"
+// are always registered; other codecs are registered by the libraries that
+// implement them.
+class ElementCodec {
+ public:
+  virtual ~ElementCodec() = default;
+
+  // Compresses the concatenation of the `num_pieces` buffers in `iov`, which
+  // hold `num_bytes` bytes in total, into `out`.
+  virtual absl::Status Compress(const iovec* iov, size_t num_pieces,
+                                size_t num_bytes, std::string* out) const = 0;
+
+  // Uncompresses `compressed` into the `num_pieces` buffers in `iov`, which
+  // hold `num_bytes` bytes in total. Returns an error if `compressed` does not
+  // uncompress to exactly `num_bytes` bytes.
+  virtual absl::Status Uncompress(absl::string_view compressed,
+                                  const iovec* iov, size_t num_pieces,
+                                  size_t num_bytes) const = 0;
+
+  // Registers `codec` under `name`. Codecs can not be unregistered, and must be
+  // registered during static initialization: the first call to `Get` or
+  // `IsRegistered` makes the registry immutable, so that lookups do not lock.
+  // Later registrations are logged and ignored.
+  static void Register(const std::string& name,
+                       std::unique_ptr<ElementCodec> codec);
+
+  // Returns the codec registered under `name`, or a `NotFound` error.
+  static absl::StatusOr<const ElementCodec*> Get(absl::string_view name);
+
+  // Returns whether a codec is registered under `name`.
+  static bool IsRegistered(absl::string_view name);
+};
+
 // Compresses the components of `element` into the `CompressedElement` proto.
 //
 // In addition to writing the actual compressed bytes, `Compress` fills
@@ -34,6 +79,13 @@ namespace data {
 absl::Status CompressElement(const std::vector<Tensor>& element,
                              CompressedElement* out);
 
+// Like `CompressElement` above, but compresses with the codec registered under
+// `codec`. Snappy-compressed elements can be read by all versions of
+// `UncompressElement`; elements compressed with other codecs can only be read
+// by versions that know about codecs.
+absl::Status CompressElement(const std::vector<Tensor>& element,
+                             absl::string_view codec, CompressedElement* out);
+
 // Uncompresses a `CompressedElement` into a vector of tensor components.
 absl::Status UncompressElement(const CompressedElement& compressed,
                                std::vector<Tensor>* out);
@@ -15,6 +15,8 @@ limitations under the License.
 #include "tensorflow/core/data/compression_utils.h"
 
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -44,6 +46,54 @@ TEST(CompressionUtilsTest, Exceeds4GB) {
                              HasSubstr("exceeding the 4GB Snappy limit")));
 }
 
+TEST(CompressionUtilsTest, CodecIsRecorded) {
+  std::vector<Tensor> element = {CreateTensor<int64_t>(TensorShape{128, 128})};
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, "zstd-3", &compressed));
+  EXPECT_EQ(compressed.version(), 1);
+  EXPECT_EQ(compressed.codec(), "zstd-3");
+  // Snappy elements stay readable by readers that predate codecs.
+  TF_ASSERT_OK(CompressElement(element, kSnappyCodec, &compressed));
+  EXPECT_EQ(compressed.version(), 0);
+  EXPECT_EQ(compressed.codec(), "");
+}
+
+TEST(CompressionUtilsTest, UnknownCodec) {
+  CompressedElement compressed;
+  EXPECT_THAT(
+      CompressElement({CreateTensor<int64_t>(TensorShape{1}, {1})}, "lzma",
+                      &compressed),
+      absl_testing::StatusIs(error::NOT_FOUND, HasSubstr("zstd-19")));
+  EXPECT_FALSE(ElementCodec::IsRegistered("lzma"));
+  EXPECT_TRUE(ElementCodec::IsRegistered("zstd"));
+}
+
+class UnimplementedCodec : public ElementCodec {
+ public:
+  absl::Status Compress(const iovec* iov, size_t num_pieces, size_t num_bytes,
+                        std::string* out) const override {
+    return absl::UnimplementedError("Compress");
+  }
+  absl::Status Uncompress(absl::string_view compressed, const iovec* iov,
+                          size_t num_pieces, size_t num_bytes) const override {
+    return absl::UnimplementedError("Uncompress");
+  }
+};
+
+TEST(CompressionUtilsTest, RegistrationAfterLookupIsIgnored) {
+  EXPECT_TRUE(ElementCodec::IsRegistered(kSnappyCodec));
+  ElementCodec::Register("unimplemented",
+                         std::make_unique<UnimplementedCodec>());
+  EXPECT_FALSE(ElementCodec::IsRegistered("unimplemented"));
+}
+
+TEST(CompressionUtilsTest, NoCompressionKeepsTheBytes) {
+  std::vector<Tensor> element = {CreateTensor<int64_t>(TensorShape{128, 128})};
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, kNoCompressionCodec, &compressed));
+  EXPECT_EQ(compressed.data().size(), 128 * 128 * sizeof(int64_t));
+}
+
 std::vector<std::vector<Tensor>> TestCases() {
   return {
       // Single int64.
@@ -109,6 +159,29 @@ TEST_P(ParameterizedCompressionUtilsTest, VersionMismatch) {
               absl_testing::StatusIs(error::INTERNAL));
 }
 
+TEST_P(ParameterizedCompressionUtilsTest, RoundTripWithCodecs) {
+  std::vector<Tensor> element = GetParam();
+  for (const char* codec : {kSnappyCodec, kNoCompressionCodec, "zstd",
+                            "zstd-1", "zstd-19"}) {
+    CompressedElement compressed;
+    TF_ASSERT_OK(CompressElement(element, codec, &compressed));
+    std::vector<Tensor> round_trip_element;
+    TF_ASSERT_OK(UncompressElement(compressed, &round_trip_element));
+    TF_EXPECT_OK(
+        ExpectEqual(element, round_trip_element, /*compare_order=*/true));
+  }
+}
+
+TEST_P(ParameterizedCompressionUtilsTest, CodecMismatch) {
+  std::vector<Tensor> element = GetParam();
+  CompressedElement compressed;
+  TF_ASSERT_OK(CompressElement(element, "zstd", &compressed));
+  compressed.set_codec("unknown");
+  std::vector<Tensor> round_trip_element;
+  EXPECT_THAT(UncompressElement(compressed, &round_trip_element),
+              absl_testing::StatusIs(error::NOT_FOUND));
+}
+
 INSTANTIATE_TEST_SUITE_P(Instantiation, ParameterizedCompressionUtilsTest,
                          ::testing::ValuesIn(TestCases()));
 
@@ -0,0 +1,230 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/element_encoding.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/refcount.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// How the contents of a tensor are stored.
+enum Encoding : uint64_t {
+  // The raw bytes of a tensor that can be copied with memcpy.
+  kMemcpy = 0,
+  // The lengths of all strings followed by their bytes.
+  kString = 1,
+  // A serialized `TensorProto`.
+  kProto = 2,
+};
+
+absl::Status CorruptElementError() {
+  return absl::DataLossError("The encoded element is corrupted.");
+}
+
+// A tensor buffer that aliases encoded bytes, which `owner` keeps alive.
+class AliasingBuffer : public TensorBuffer {
+ public:
+  AliasingBuffer(const core::RefCounted* owner, const char* allocator_name,
+                 const char* data, size_t size)
+      : TensorBuffer(const_cast<char*>(data)),
+        owner_(owner),
+        allocator_name_(allocator_name),
+        size_(size) {
+    owner_->Ref();
+  }
+  ~AliasingBuffer() override { owner_->Unref(); }
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name(allocator_name_);
+  }
+  // The encoded bytes may be read-only or shared, so kernels must not reuse
+  // them for their outputs.
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const core::RefCounted* const owner_;
+  const char* const allocator_name_;
+  const size_t size_;
+};
+
+}  // namespace
+
+uint64_t AlignElementEncodingOffset(uint64_t offset) {
+  return (offset + kElementEncodingAlignment - 1) / kElementEncodingAlignment *
+         kElementEncodingAlignment;
+}
+
+absl::Status EncodeComponent(
+    const Tensor& component,
+    const std::function<absl::Status(absl::string_view)>& append) {
+  Encoding encoding;
+  std::string scratch;
+  absl::string_view data;
+  if (DataTypeCanUseMemcpy(component.dtype())) {
+    encoding = kMemcpy;
+    data = component.tensor_data();
+  } else if (component.dtype() == DT_STRING) {
+    encoding = kString;
+    auto strings = component.flat<tstring>();
+    for (int64_t i = 0; i < strings.size(); ++i) {
+      core::PutFixed64(&scratch, strings(i).size());
+    }
+    for (int64_t i = 0; i < strings.size(); ++i) {
+      scratch.append(strings(i).data(), strings(i).size());
+    }
+    data = scratch;
+  } else {
+    encoding = kProto;
+    TensorProto proto;
+    component.AsProtoTensorContent(&proto);
+    if (!proto.SerializeToString(&scratch)) {
+      return absl::InternalError(
+          absl::StrCat("Failed to serialize a tensor of type ",
+                       DataTypeString(component.dtype()), "."));
+    }
+    data = scratch;
+  }
+  std::string header;
+  core::PutFixed64(&header, component.dtype());
+  core::PutFixed64(&header, encoding);
+  core::PutFixed64(&header, component.dims());
+  for (int64_t dim : component.shape().dim_sizes()) {
+    core::PutFixed64(&header, dim);
+  }
+  core::PutFixed64(&header, data.size());
+  header.resize(AlignElementEncodingOffset(header.size()), '\0');
+  TF_RETURN_IF_ERROR(append(header));
+  TF_RETURN_IF_ERROR(append(data));
+  const std::string padding(
+      AlignElementEncodingOffset(data.size()) - data.size(), '\0');
+  return append(padding);
+}
+
+absl::Status DecodeComponent(const core::RefCounted* owner,
+                             const char* allocator_name, const char* base,
+                             const char** pos, const char* limit,
+                             Tensor* component) {
+  auto remaining = [limit](const char* p) -> uint64_t { return limit - p; };
+  auto read_fixed64 = [pos, &remaining](uint64_t* value) {
+    if (remaining(*pos) < sizeof(uint64_t)) {
+      return false;
+    }
+    *value = core::DecodeFixed64(*pos);
+    *pos += sizeof(uint64_t);
+    return true;
+  };
+  auto align = [base, limit](const char* p) {
+    return std::min(base + AlignElementEncodingOffset(p - base), limit);
+  };
+  uint64_t dtype_value, encoding, num_dims;
+  if (!read_fixed64(&dtype_value) || !read_fixed64(&encoding) ||
+      !read_fixed64(&num_dims) || num_dims > TensorShape::MaxDimensions() ||
+      dtype_value > DataType_MAX || !DataType_IsValid(dtype_value)) {
+    return CorruptElementError();
+  }
+  const DataType dtype = static_cast<DataType>(dtype_value);
+  TensorShape shape;
+  for (uint64_t i = 0; i < num_dims; ++i) {
+    uint64_t dim;
+    if (!read_fixed64(&dim)) {
+      return CorruptElementError();
+    }
+    TF_RETURN_IF_ERROR(shape.AddDimWithStatus(static_cast<int64_t>(dim)));
+  }
+  uint64_t data_size;
+  if (!read_fixed64(&data_size)) {
+    return CorruptElementError();
+  }
+  *pos = align(*pos);
+  if (remaining(*pos) < data_size) {
+    return CorruptElementError();
+  }
+  const char* data = *pos;
+  *pos = align(*pos + data_size);
+
+  switch (encoding) {
+    case kMemcpy: {
+      if (!DataTypeCanUseMemcpy(dtype) ||
+          data_size != static_cast<uint64_t>(shape.num_elements()) *
+                           DataTypeSize(dtype)) {
+        return CorruptElementError();
+      }
+      if (reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES == 0) {
+        *component = Tensor(dtype, std::move(shape),
+                            core::RefCountPtr<TensorBuffer>(new AliasingBuffer(
+                                owner, allocator_name, data, data_size)));
+      } else {
+        *component = Tensor(dtype, shape);
+        std::memcpy(component->data(), data, data_size);
+      }
+      return absl::OkStatus();
+    }
+    case kString: {
+      const uint64_t num_strings = shape.num_elements();
+      if (dtype != DT_STRING || data_size / sizeof(uint64_t) < num_strings) {
+        return CorruptElementError();
+      }
+      *component = Tensor(DT_STRING, shape);
+      auto strings = component->flat<tstring>();
+      const char* bytes = data + num_strings * sizeof(uint64_t);
+      const char* bytes_limit = data + data_size;
+      for (uint64_t i = 0; i < num_strings; ++i) {
+        const uint64_t length =
+            core::DecodeFixed64(data + i * sizeof(uint64_t));
+        if (static_cast<uint64_t>(bytes_limit - bytes) < length) {
+          return CorruptElementError();
+        }
+        strings(i).assign(bytes, length);
+        bytes += length;
+      }
+      return absl::OkStatus();
+    }
+    case kProto: {
+      TensorProto proto;
+      if (!ParseProtoUnlimited(&proto, data, data_size) ||
+          !component->FromProto(proto) || component->dtype() != dtype) {
+        return CorruptElementError();
+      }
+      return absl::OkStatus();
+    }
+    default:
+      return CorruptElementError();
+  }
+}
+
+}  // namespace data
+}  // namespace tensorflow
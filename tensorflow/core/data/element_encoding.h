@@ -0,0 +1,65 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_ELEMENT_ENCODING_H_
+#define TENSORFLOW_CORE_DATA_ELEMENT_ENCODING_H_
+
+#include <cstdint>
+#include <functional>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/refcount.h"
+
+namespace tensorflow {
+namespace data {
+
+// An encoding of the components of dataset elements into flat bytes, from
+// which tensors can be decoded without copying their contents.
+//
+// Tensor contents are stored at aligned offsets, so when the encoded bytes are
+// themselves aligned, tensors of types that can be copied with memcpy alias
+// them instead of being copied. Tensors of other types are copied. Contents are
+// stored in host byte order.
+
+// The alignment of the encoding. Every encoded component starts and ends at a
+// multiple of it, relative to the start of the first component.
+inline constexpr uint64_t kElementEncodingAlignment =
+    Allocator::kAllocatorAlignment;
+
+// Returns `offset` rounded up to a multiple of `kElementEncodingAlignment`.
+uint64_t AlignElementEncodingOffset(uint64_t offset);
+
+// Encodes `component` by passing the pieces of its encoding to `append`, in
+// order.
+absl::Status EncodeComponent(
+    const Tensor& component,
+    const std::function<absl::Status(absl::string_view)>& append);
+
+// Decodes the component that starts at `*pos` and advances `*pos` past it.
+// `base` is the start of the first component and `limit` the end of the
+// encoded bytes. Tensors that alias the encoded bytes hold a reference to
+// `owner`, which must keep the bytes alive and unchanged, and report
+// `allocator_name` in their allocation descriptions.
+absl::Status DecodeComponent(const core::RefCounted* owner,
+                             const char* allocator_name, const char* base,
+                             const char** pos, const char* limit,
+                             Tensor* component);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_ELEMENT_ENCODING_H_
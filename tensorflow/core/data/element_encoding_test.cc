@@ -0,0 +1,137 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/element_encoding.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_description.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kAllocatorName[] = "element_encoding_test";
+
+// Owns aligned encoded bytes.
+class Encoded : public core::RefCounted {
+ public:
+  explicit Encoded(const std::vector<Tensor>& element) {
+    std::string bytes;
+    for (const Tensor& component : element) {
+      TF_CHECK_OK(EncodeComponent(component, [&bytes](absl::string_view data) {
+        bytes.append(data.data(), data.size());
+        return absl::OkStatus();
+      }));
+    }
+    size_ = bytes.size();
+    data_ = static_cast<char*>(
+        port::AlignedMalloc(size_ + 1, kElementEncodingAlignment));
+    std::memcpy(data_, bytes.data(), size_);
+  }
+  ~Encoded() override { port::AlignedFree(data_); }
+
+  const char* data() const { return data_; }
+  uint64_t size() const { return size_; }
+
+ private:
+  char* data_;
+  uint64_t size_;
+};
+
+std::vector<Tensor> Decode(const Encoded& encoded, size_t num_components) {
+  std::vector<Tensor> element(num_components);
+  const char* pos = encoded.data();
+  const char* limit = encoded.data() + encoded.size();
+  for (Tensor& component : element) {
+    TF_CHECK_OK(DecodeComponent(&encoded, kAllocatorName, encoded.data(), &pos,
+                                limit, &component));
+  }
+  EXPECT_EQ(pos, limit);
+  return element;
+}
+
+TEST(ElementEncodingTest, RoundTrip) {
+  Tensor strings(DT_STRING, TensorShape({3}));
+  strings.flat<tstring>()(0) = "a";
+  strings.flat<tstring>()(1) = "";
+  strings.flat<tstring>()(2) = std::string(100, 'x');
+  const std::vector<Tensor> element = {
+      test::AsTensor<int64_t>({1, 2, 3, 4, 5, 6}, TensorShape({2, 3})),
+      test::AsScalar<float>(0.5f), strings, test::AsScalar<bool>(true),
+      test::AsTensor<int32_t>({}, TensorShape({0, 4}))};
+  core::RefCountPtr<Encoded> encoded(new Encoded(element));
+  EXPECT_EQ(encoded->size() % kElementEncodingAlignment, 0);
+  std::vector<Tensor> decoded = Decode(*encoded, element.size());
+  ASSERT_EQ(decoded.size(), element.size());
+  for (int i = 0; i < element.size(); ++i) {
+    test::ExpectEqual(decoded[i], element[i]);
+  }
+}
+
+TEST(ElementEncodingTest, TensorsAliasTheEncodedBytes) {
+  const Tensor tensor = test::AsTensor<int64_t>({1, 2, 3, 4}, TensorShape({4}));
+  core::RefCountPtr<Encoded> encoded(new Encoded({tensor}));
+  std::vector<Tensor> decoded = Decode(*encoded, 1);
+  const char* data = decoded[0].tensor_data().data();
+  EXPECT_GE(data, encoded->data());
+  EXPECT_LT(data, encoded->data() + encoded->size());
+  TensorDescription description;
+  decoded[0].FillDescription(&description);
+  EXPECT_EQ(description.allocation_description().allocator_name(),
+            kAllocatorName);
+  // The tensor keeps the encoded bytes alive.
+  Encoded* raw = encoded.release();
+  raw->Unref();
+  test::ExpectEqual(decoded[0], tensor);
+}
+
+TEST(ElementEncodingTest, Truncated) {
+  core::RefCountPtr<Encoded> encoded(
+      new Encoded({test::AsTensor<int64_t>({1, 2, 3, 4}, TensorShape({4}))}));
+  // Cuts off the shape and the tensor contents.
+  const uint64_t sizes[] = {0, 16, kElementEncodingAlignment + sizeof(int64_t)};
+  for (uint64_t size : sizes) {
+    const char* pos = encoded->data();
+    Tensor component;
+    EXPECT_EQ(DecodeComponent(encoded.get(), kAllocatorName, encoded->data(),
+                              &pos, encoded->data() + size, &component)
+                  .code(),
+              absl::StatusCode::kDataLoss);
+  }
+}
+
+TEST(ElementEncodingTest, AlignOffset) {
+  EXPECT_EQ(AlignElementEncodingOffset(0), 0);
+  EXPECT_EQ(AlignElementEncodingOffset(1), kElementEncodingAlignment);
+  EXPECT_EQ(AlignElementEncodingOffset(kElementEncodingAlignment),
+            kElementEncodingAlignment);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
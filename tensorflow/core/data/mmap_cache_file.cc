@@ -0,0 +1,326 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/mmap_cache_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/element_encoding.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/platform/refcount.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kMmapCacheSuffix[] = ".mmapcache";
+constexpr char kTempSuffix[] = ".tmp";
+// Identifies the format and its version.
+constexpr uint64_t kMagic = 0x3165686361636d6dULL;
+// Reported by tensors that alias the mapping.
+constexpr char kAllocatorName[] = "mmap_cache_file";
+// Number of components, number of elements, index offset and magic.
+constexpr uint64_t kFooterBytes = 4 * sizeof(uint64_t);
+constexpr uint64_t kCopyBufferBytes = 4 << 20;  // 4MB
+
+struct Footer {
+  uint64_t num_components = 0;
+  uint64_t num_elements = 0;
+  uint64_t index_offset = 0;
+};
+
+absl::Status CorruptFileError() {
+  return absl::DataLossError("The mmap cache file is corrupted.");
+}
+
+// Parses the footer of a file of `file_size` bytes that ends with `footer`.
+absl::Status ParseFooter(absl::string_view footer, uint64_t file_size,
+                         Footer* result) {
+  if (footer.size() != kFooterBytes) {
+    return CorruptFileError();
+  }
+  result->num_components = core::DecodeFixed64(footer.data());
+  result->num_elements = core::DecodeFixed64(footer.data() + 8);
+  result->index_offset = core::DecodeFixed64(footer.data() + 16);
+  if (core::DecodeFixed64(footer.data() + 24) != kMagic) {
+    return absl::DataLossError(
+        "The file is not an mmap cache file, or was written by an "
+        "incompatible version.");
+  }
+  if (result->index_offset > file_size ||
+      file_size - result->index_offset !=
+          (result->num_elements + 1) * sizeof(uint64_t) + kFooterBytes) {
+    return CorruptFileError();
+  }
+  return absl::OkStatus();
+}
+
+std::string EncodeIndexAndFooter(const std::vector<uint64_t>& offsets,
+                                 uint64_t num_components,
+                                 uint64_t index_offset) {
+  std::string index;
+  index.reserve((offsets.size() + 1) * sizeof(uint64_t) + kFooterBytes);
+  for (uint64_t offset : offsets) {
+    core::PutFixed64(&index, offset);
+  }
+  core::PutFixed64(&index, index_offset);
+  core::PutFixed64(&index, num_components);
+  core::PutFixed64(&index, offsets.size());
+  core::PutFixed64(&index, index_offset);
+  core::PutFixed64(&index, kMagic);
+  return index;
+}
+
+}  // namespace
+
+std::string MmapCacheFilename(absl::string_view prefix) {
+  return absl::StrCat(prefix, kMmapCacheSuffix);
+}
+
+absl::StatusOr<std::unique_ptr<MmapCacheFileWriter>>
+MmapCacheFileWriter::Create(Env* env, const std::string& filename) {
+  std::string temp_filename = absl::StrCat(filename, kTempSuffix);
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(temp_filename, &file));
+  return absl::WrapUnique(new MmapCacheFileWriter(
+      env, filename, std::move(temp_filename), std::move(file)));
+}
+
+MmapCacheFileWriter::MmapCacheFileWriter(Env* env, std::string filename,
+                                         std::string temp_filename,
+                                         std::unique_ptr<WritableFile> file)
+    : env_(env),
+      filename_(std::move(filename)),
+      temp_filename_(std::move(temp_filename)),
+      file_(std::move(file)) {}
+
+absl::Status MmapCacheFileWriter::Add(const std::vector<Tensor>& element) {
+  if (num_components_ < 0) {
+    num_components_ = element.size();
+  } else if (static_cast<int64_t>(element.size()) != num_components_) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected elements with ", num_components_,
+                     " components, got ", element.size()));
+  }
+  offsets_.push_back(offset_);
+  for (const Tensor& component : element) {
+    TF_RETURN_IF_ERROR(EncodeComponent(
+        component, [this](absl::string_view data) { return Append(data); }));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status MmapCacheFileWriter::Finish() {
+  TF_RETURN_IF_ERROR(Append(EncodeIndexAndFooter(
+      offsets_, std::max<int64_t>(num_components_, 0), offset_)));
+  TF_RETURN_IF_ERROR(file_->Close());
+  return env_->RenameFile(temp_filename_, filename_);
+}
+
+absl::Status MmapCacheFileWriter::Append(absl::string_view data) {
+  TF_RETURN_IF_ERROR(file_->Append(data));
+  offset_ += data.size();
+  return absl::OkStatus();
+}
+
+absl::Status MergeMmapCacheFiles(Env* env,
+                                 const std::vector<std::string>& filenames,
+                                 const std::string& merged_filename) {
+  if (filenames.size() == 1) {
+    return env->RenameFile(filenames[0], merged_filename);
+  }
+  const std::string temp_filename = absl::StrCat(merged_filename, kTempSuffix);
+  std::unique_ptr<WritableFile> merged_file;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(temp_filename, &merged_file));
+  std::vector<uint64_t> offsets;
+  uint64_t num_components = 0;
+  uint64_t base_offset = 0;
+  std::unique_ptr<char[]> buffer(new char[kCopyBufferBytes]);
+  for (const std::string& filename : filenames) {
+    uint64_t file_size;
+    TF_RETURN_IF_ERROR(env->GetFileSize(filename, &file_size));
+    std::unique_ptr<RandomAccessFile> file;
+    TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+    if (file_size < kFooterBytes) {
+      return CorruptFileError();
+    }
+    absl::string_view data;
+    TF_RETURN_IF_ERROR(file->Read(file_size - kFooterBytes, kFooterBytes,
+                                  &data, buffer.get()));
+    Footer footer;
+    TF_RETURN_IF_ERROR(ParseFooter(data, file_size, &footer));
+    if (footer.num_elements > 0) {
+      if (!offsets.empty() && footer.num_components != num_components) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Cannot merge cache files with different numbers of "
+                         "components: ",
+                         num_components, " and ", footer.num_components));
+      }
+      num_components = footer.num_components;
+    }
+    // Offsets stay aligned, since every file's data ends at an aligned offset.
+    const uint64_t index_bytes = footer.num_elements * sizeof(uint64_t);
+    for (uint64_t offset = 0; offset < index_bytes;) {
+      const uint64_t n = std::min(kCopyBufferBytes, index_bytes - offset);
+      TF_RETURN_IF_ERROR(
+          file->Read(footer.index_offset + offset, n, &data, buffer.get()));
+      for (uint64_t i = 0; i < n; i += sizeof(uint64_t)) {
+        offsets.push_back(base_offset + core::DecodeFixed64(data.data() + i));
+      }
+      offset += n;
+    }
+    for (uint64_t offset = 0; offset < footer.index_offset;) {
+      const uint64_t n =
+          std::min(kCopyBufferBytes, footer.index_offset - offset);
+      TF_RETURN_IF_ERROR(file->Read(offset, n, &data, buffer.get()));
+      TF_RETURN_IF_ERROR(merged_file->Append(data));
+      offset += n;
+    }
+    base_offset += footer.index_offset;
+  }
+  TF_RETURN_IF_ERROR(merged_file->Append(
+      EncodeIndexAndFooter(offsets, num_components, base_offset)));
+  TF_RETURN_IF_ERROR(merged_file->Close());
+  TF_RETURN_IF_ERROR(env->RenameFile(temp_filename, merged_filename));
+  for (const std::string& filename : filenames) {
+    TF_RETURN_IF_ERROR(env->DeleteFile(filename));
+  }
+  return absl::OkStatus();
+}
+
+// The bytes of a cache file, which are either mapped or have been read into
+// memory.
+class MmapCacheFileReader::Contents : public core::RefCounted {
+ public:
+  explicit Contents(std::unique_ptr<ReadOnlyMemoryRegion> region)
+      : region_(std::move(region)),
+        data_(static_cast<const char*>(region_->data())),
+        size_(region_->length()) {}
+  Contents(char* buffer, uint64_t size)
+      : buffer_(buffer), data_(buffer), size_(size) {}
+
+  ~Contents() override {
+    if (buffer_ != nullptr) {
+      port::AlignedFree(buffer_);
+    }
+  }
+
+  const char* data() const { return data_; }
+  uint64_t size() const { return size_; }
+
+ private:
+  const std::unique_ptr<ReadOnlyMemoryRegion> region_;
+  char* const buffer_ = nullptr;
+  const char* const data_;
+  const uint64_t size_;
+};
+
+absl::StatusOr<std::unique_ptr<MmapCacheFileReader>> MmapCacheFileReader::Open(
+    Env* env, const std::string& filename) {
+  core::RefCountPtr<Contents> contents;
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  absl::Status s = env->NewReadOnlyMemoryRegionFromFile(filename, &region);
+  if (s.ok()) {
+    contents.reset(new Contents(std::move(region)));
+  } else {
+    VLOG(2) << "Reading " << filename << " without mmap: " << s;
+    uint64_t file_size;
+    TF_RETURN_IF_ERROR(env->GetFileSize(filename, &file_size));
+    std::unique_ptr<RandomAccessFile> file;
+    TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file));
+    if (file_size < kFooterBytes) {
+      return CorruptFileError();
+    }
+    char* buffer = static_cast<char*>(
+        port::AlignedMalloc(file_size, kElementEncodingAlignment));
+    if (buffer == nullptr) {
+      return absl::ResourceExhaustedError(
+          absl::StrCat("Failed to allocate ", file_size, " bytes to read ",
+                       filename));
+    }
+    contents.reset(new Contents(buffer, file_size));
+    absl::string_view data;
+    TF_RETURN_IF_ERROR(file->Read(0, file_size, &data, buffer));
+    if (data.size() != file_size) {
+      return CorruptFileError();
+    }
+    if (data.data() != buffer) {
+      std::memcpy(buffer, data.data(), file_size);
+    }
+  }
+  if (contents->size() < kFooterBytes) {
+    return CorruptFileError();
+  }
+  Footer footer;
+  TF_RETURN_IF_ERROR(ParseFooter(
+      absl::string_view(contents->data() + contents->size() - kFooterBytes,
+                        kFooterBytes),
+      contents->size(), &footer));
+  const char* index = contents->data() + footer.index_offset;
+  return absl::WrapUnique(new MmapCacheFileReader(
+      std::move(contents), footer.num_components, footer.num_elements, index));
+}
+
+MmapCacheFileReader::MmapCacheFileReader(core::RefCountPtr<Contents> contents,
+                                         int64_t num_components,
+                                         int64_t num_elements,
+                                         const char* index)
+    : contents_(std::move(contents)),
+      num_components_(num_components),
+      num_elements_(num_elements),
+      index_(index) {}
+
+absl::Status MmapCacheFileReader::Get(int64_t index,
+                                      std::vector<Tensor>* element) const {
+  if (index < 0 || index >= num_elements_) {
+    return absl::OutOfRangeError(absl::StrCat(
+        "Index out of range [0, ", num_elements_, "): ", index));
+  }
+  const uint64_t begin = core::DecodeFixed64(index_ + index * sizeof(uint64_t));
+  const uint64_t end =
+      core::DecodeFixed64(index_ + (index + 1) * sizeof(uint64_t));
+  if (begin > end || end > static_cast<uint64_t>(index_ - contents_->data())) {
+    return CorruptFileError();
+  }
+  const char* pos = contents_->data() + begin;
+  const char* limit = contents_->data() + end;
+  element->clear();
+  element->reserve(num_components_);
+  for (int64_t i = 0; i < num_components_; ++i) {
+    element->emplace_back();
+    TF_RETURN_IF_ERROR(DecodeComponent(contents_.get(), kAllocatorName,
+                                       contents_->data(), &pos, limit,
+                                       &element->back()));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
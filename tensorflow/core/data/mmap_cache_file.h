@@ -0,0 +1,119 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_MMAP_CACHE_FILE_H_
+#define TENSORFLOW_CORE_DATA_MMAP_CACHE_FILE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/refcount.h"
+
+namespace tensorflow {
+namespace data {
+
+// A file format for caching dataset elements that is read by mapping the file
+// into memory.
+//
+// Elements are stored back to back and followed by an index of their offsets,
+// so that any element can be read in O(1). Tensors whose contents can be
+// copied with memcpy are not copied out of the mapping but alias it, and the
+// mapped pages are shared through the page cache by all processes on the host
+// that read the same file. Tensors of other types are copied.
+//
+// Tensor contents are stored in host byte order, so a file can only be read by
+// hosts of the same endianness as the one that wrote it.
+
+// Returns the name of the mmap cache file of the cache `prefix`.
+std::string MmapCacheFilename(absl::string_view prefix);
+
+// Writes elements to a new mmap cache file. The file is written under a
+// temporary name and only appears under its own name once `Finish` succeeds.
+class MmapCacheFileWriter {
+ public:
+  static absl::StatusOr<std::unique_ptr<MmapCacheFileWriter>> Create(
+      Env* env, const std::string& filename);
+
+  MmapCacheFileWriter(const MmapCacheFileWriter&) = delete;
+  MmapCacheFileWriter& operator=(const MmapCacheFileWriter&) = delete;
+
+  absl::Status Add(const std::vector<Tensor>& element);
+
+  // Writes the index and renames the file to its own name.
+  absl::Status Finish();
+
+  int64_t num_elements() const { return offsets_.size(); }
+
+ private:
+  MmapCacheFileWriter(Env* env, std::string filename,
+                      std::string temp_filename,
+                      std::unique_ptr<WritableFile> file);
+
+  absl::Status Append(absl::string_view data);
+
+  Env* const env_;
+  const std::string filename_;
+  const std::string temp_filename_;
+  std::unique_ptr<WritableFile> file_;
+  int64_t num_components_ = -1;
+  uint64_t offset_ = 0;
+  // The offset of each element.
+  std::vector<uint64_t> offsets_;
+};
+
+// Concatenates the mmap cache files `filenames` into a new file
+// `merged_filename`, and deletes them.
+absl::Status MergeMmapCacheFiles(Env* env,
+                                 const std::vector<std::string>& filenames,
+                                 const std::string& merged_filename);
+
+// Reads elements from an mmap cache file. Thread-safe.
+class MmapCacheFileReader {
+ public:
+  // Maps `filename` into memory, or reads it into memory if its file system
+  // does not support mapping.
+  static absl::StatusOr<std::unique_ptr<MmapCacheFileReader>> Open(
+      Env* env, const std::string& filename);
+
+  // Returns the element at `index`. Its tensors may keep the file mapped
+  // after the reader has been destroyed.
+  absl::Status Get(int64_t index, std::vector<Tensor>* element) const;
+
+  int64_t size() const { return num_elements_; }
+
+ private:
+  class Contents;
+
+  MmapCacheFileReader(core::RefCountPtr<Contents> contents,
+                      int64_t num_components, int64_t num_elements,
+                      const char* index);
+
+  const core::RefCountPtr<Contents> contents_;
+  const int64_t num_components_;
+  const int64_t num_elements_;
+  // `num_elements_ + 1` offsets, the last of which is the end of the data.
+  const char* const index_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_MMAP_CACHE_FILE_H_
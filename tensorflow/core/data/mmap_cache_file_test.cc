@@ -0,0 +1,144 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/mmap_cache_file.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+std::string TestFilename(const std::string& name) {
+  return MmapCacheFilename(io::JoinPath(testing::TmpDir(), name));
+}
+
+std::vector<Tensor> TestElement(int64_t i) {
+  Tensor strings(DT_STRING, TensorShape({2}));
+  strings.flat<tstring>()(0) = absl::StrCat("element ", i);
+  strings.flat<tstring>()(1) = "";
+  return {test::AsTensor<int64_t>({i, i + 1, i + 2}, TensorShape({3})),
+          test::AsScalar<float>(i / 2.0f), strings,
+          test::AsScalar<bool>(i % 2 == 0)};
+}
+
+void WriteFile(const std::string& filename, int64_t begin, int64_t end) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<MmapCacheFileWriter> writer,
+      MmapCacheFileWriter::Create(Env::Default(), filename));
+  for (int64_t i = begin; i < end; ++i) {
+    TF_ASSERT_OK(writer->Add(TestElement(i)));
+  }
+  // The file only appears under its name once it is complete.
+  EXPECT_FALSE(Env::Default()->FileExists(filename).ok());
+  TF_ASSERT_OK(writer->Finish());
+}
+
+void ExpectElement(const std::vector<Tensor>& element, int64_t i) {
+  std::vector<Tensor> expected = TestElement(i);
+  ASSERT_EQ(element.size(), expected.size());
+  for (int j = 0; j < expected.size(); ++j) {
+    test::ExpectEqual(element[j], expected[j]);
+  }
+}
+
+TEST(MmapCacheFileTest, RandomAccess) {
+  const std::string filename = TestFilename("random_access");
+  WriteFile(filename, 0, 100);
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<MmapCacheFileReader> reader,
+                          MmapCacheFileReader::Open(Env::Default(), filename));
+  ASSERT_EQ(reader->size(), 100);
+  for (int64_t i : {99, 0, 42, 7, 42}) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(reader->Get(i, &element));
+    ExpectElement(element, i);
+  }
+  std::vector<Tensor> element;
+  EXPECT_EQ(reader->Get(100, &element).code(), absl::StatusCode::kOutOfRange);
+  EXPECT_EQ(reader->Get(-1, &element).code(), absl::StatusCode::kOutOfRange);
+}
+
+TEST(MmapCacheFileTest, TensorsOutliveTheReader) {
+  const std::string filename = TestFilename("outlive");
+  WriteFile(filename, 0, 3);
+  std::vector<Tensor> element;
+  {
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<MmapCacheFileReader> reader,
+        MmapCacheFileReader::Open(Env::Default(), filename));
+    TF_ASSERT_OK(reader->Get(2, &element));
+  }
+  ExpectElement(element, 2);
+  // Tensors that alias the file must not be forwarded to kernel outputs.
+  EXPECT_FALSE(element[0].RefCountIsOne());
+}
+
+TEST(MmapCacheFileTest, EmptyFile) {
+  const std::string filename = TestFilename("empty");
+  WriteFile(filename, 0, 0);
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<MmapCacheFileReader> reader,
+                          MmapCacheFileReader::Open(Env::Default(), filename));
+  EXPECT_EQ(reader->size(), 0);
+}
+
+TEST(MmapCacheFileTest, Merge) {
+  const std::vector<std::string> filenames = {
+      TestFilename("merge_0"), TestFilename("merge_1"),
+      TestFilename("merge_2")};
+  WriteFile(filenames[0], 0, 10);
+  WriteFile(filenames[1], 10, 10);
+  WriteFile(filenames[2], 10, 25);
+  const std::string merged_filename = TestFilename("merged");
+  TF_ASSERT_OK(
+      MergeMmapCacheFiles(Env::Default(), filenames, merged_filename));
+  for (const std::string& filename : filenames) {
+    EXPECT_FALSE(Env::Default()->FileExists(filename).ok());
+  }
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<MmapCacheFileReader> reader,
+      MmapCacheFileReader::Open(Env::Default(), merged_filename));
+  ASSERT_EQ(reader->size(), 25);
+  for (int64_t i = 0; i < 25; ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(reader->Get(i, &element));
+    ExpectElement(element, i);
+  }
+}
+
+TEST(MmapCacheFileTest, NotACacheFile) {
+  const std::string filename = TestFilename("not_a_cache_file");
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename,
+                                 std::string(100, 'x')));
+  EXPECT_EQ(MmapCacheFileReader::Open(Env::Default(), filename).status().code(),
+            absl::StatusCode::kDataLoss);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -217,6 +217,9 @@ class RootDataset::Iterator : public DatasetIterator<RootDataset> {
       if (experiments.contains("autotune_buffer_optimization")) {
         model_->AddExperiment("autotune_buffer_optimization");
       }
+      if (experiments.contains(model::kElementSizeAwareRamBudgetExperiment)) {
+        model_->AddExperiment(model::kElementSizeAwareRamBudgetExperiment);
+      }
     }
     IteratorContext iter_ctx(CreateParams(ctx));
     if (model_) {
@@ -0,0 +1,125 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/adaptive_compression.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// The codecs that adaptive mode chooses from, from the cheapest to the
+// strongest. Codecs that are not registered are skipped.
+constexpr const char* kAdaptiveCodecs[] = {kNoCompressionCodec, kSnappyCodec,
+                                           "zstd-1", "zstd-3", "zstd-9"};
+
+}  // namespace
+
+absl::Status ValidateCompressionCodec(absl::string_view codec) {
+  if (codec == kAdaptiveCompressionCodec || ElementCodec::IsRegistered(codec)) {
+    return absl::OkStatus();
+  }
+  return absl::InvalidArgumentError(absl::StrCat(
+      "Unknown compression codec: ", codec, ". Expected \"",
+      kAdaptiveCompressionCodec, "\" or the name of a registered codec."));
+}
+
+absl::StatusOr<std::unique_ptr<CompressionCodecSelector>>
+CompressionCodecSelector::Create(absl::string_view codec) {
+  TF_RETURN_IF_ERROR(ValidateCompressionCodec(codec));
+  if (codec != kAdaptiveCompressionCodec) {
+    return absl::WrapUnique(
+        new CompressionCodecSelector({std::string(codec)}, /*index=*/0));
+  }
+  std::vector<std::string> codecs;
+  int64_t index = 0;
+  for (const char* candidate : kAdaptiveCodecs) {
+    if (!ElementCodec::IsRegistered(candidate)) {
+      continue;
+    }
+    if (absl::string_view(candidate) == kSnappyCodec) {
+      index = codecs.size();
+    }
+    codecs.push_back(candidate);
+  }
+  return absl::WrapUnique(
+      new CompressionCodecSelector(std::move(codecs), index));
+}
+
+CompressionCodecSelector::CompressionCodecSelector(
+    std::vector<std::string> codecs, int64_t index)
+    : codecs_(std::move(codecs)), index_(index) {}
+
+std::string CompressionCodecSelector::Codec() const {
+  mutex_lock l(mu_);
+  return codecs_[index_];
+}
+
+void CompressionCodecSelector::RecordWorkerTime(absl::Duration duration) {
+  mutex_lock l(mu_);
+  ++num_worker_elements_;
+  worker_time_ += duration;
+  MaybeAdapt();
+}
+
+void CompressionCodecSelector::RecordConsumerTime(absl::Duration duration) {
+  mutex_lock l(mu_);
+  ++num_consumer_elements_;
+  consumer_time_ += duration;
+  MaybeAdapt();
+}
+
+void CompressionCodecSelector::MaybeAdapt() {
+  if (codecs_.size() == 1 || num_worker_elements_ < kWindowSize ||
+      num_consumer_elements_ < kWindowSize) {
+    return;
+  }
+  const absl::Duration worker_time = worker_time_ / num_worker_elements_;
+  const absl::Duration consumer_time = consumer_time_ / num_consumer_elements_;
+  const int64_t previous_index = index_;
+  if (worker_time > consumer_time && index_ > 0) {
+    --index_;
+  } else if (consumer_time > 2 * worker_time &&
+             index_ + 1 < static_cast<int64_t>(codecs_.size())) {
+    ++index_;
+  }
+  if (index_ != previous_index) {
+    VLOG(2) << "Switching compression codec from " << codecs_[previous_index]
+            << " to " << codecs_[index_] << ". Worker time per element: "
+            << worker_time << ", consumer time per element: " << consumer_time;
+  }
+  num_worker_elements_ = 0;
+  worker_time_ = absl::ZeroDuration();
+  num_consumer_elements_ = 0;
+  consumer_time_ = absl::ZeroDuration();
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,92 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_ADAPTIVE_COMPRESSION_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_ADAPTIVE_COMPRESSION_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// The job compression codec that lets each task choose its codec.
+inline constexpr char kAdaptiveCompressionCodec[] = "adaptive";
+
+// Returns an `InvalidArgument` error if `codec` is neither a registered element
+// codec nor `kAdaptiveCompressionCodec`.
+absl::Status ValidateCompressionCodec(absl::string_view codec);
+
+// Chooses the codec with which a worker compresses the elements of a task.
+//
+// A fixed codec is always chosen. In adaptive mode, the selector compares the
+// time the worker spends producing and compressing an element with the time
+// consumers spend between receiving an element and requesting the next one,
+// which includes transferring it. Every `kWindowSize` elements, it moves to a
+// cheaper codec if consumers wait for the worker, and to a stronger codec if
+// the worker waits for consumers for more than twice as long as it works. The
+// codecs range from no compression to zstd level 9, and adaptive mode starts
+// with snappy. Thread-safe.
+class CompressionCodecSelector {
+ public:
+  // The number of elements between adaptive codec changes.
+  static constexpr int64_t kWindowSize = 64;
+
+  // Creates a selector for the job compression codec `codec`.
+  static absl::StatusOr<std::unique_ptr<CompressionCodecSelector>> Create(
+      absl::string_view codec);
+
+  // Returns the codec for the next element.
+  std::string Codec() const;
+
+  // Records that the worker spent `duration` producing and compressing an
+  // element.
+  void RecordWorkerTime(absl::Duration duration);
+
+  // Records that a consumer requested an element `duration` after it received
+  // the previous one.
+  void RecordConsumerTime(absl::Duration duration);
+
+ private:
+  CompressionCodecSelector(std::vector<std::string> codecs, int64_t index);
+
+  // Moves to a cheaper or stronger codec once a window is complete.
+  void MaybeAdapt() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // The codecs to choose from, from the cheapest to the strongest.
+  const std::vector<std::string> codecs_;
+
+  mutable mutex mu_;
+  // The index of the current codec in `codecs_`.
+  int64_t index_ TF_GUARDED_BY(mu_);
+  // Measurements for the current window.
+  int64_t num_worker_elements_ TF_GUARDED_BY(mu_) = 0;
+  absl::Duration worker_time_ TF_GUARDED_BY(mu_);
+  int64_t num_consumer_elements_ TF_GUARDED_BY(mu_) = 0;
+  absl::Duration consumer_time_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_ADAPTIVE_COMPRESSION_H_
@@ -0,0 +1,121 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/adaptive_compression.h"
+
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/platform/status_matchers.h"
+#include "tensorflow/core/platform/statusor.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::tsl::testing::StatusIs;
+using ::testing::HasSubstr;
+
+// Records a window of elements that take `worker_time` on the worker and
+// `consumer_time` on the consumers.
+void RecordWindow(CompressionCodecSelector& selector,
+                  absl::Duration worker_time, absl::Duration consumer_time) {
+  for (int i = 0; i < CompressionCodecSelector::kWindowSize; ++i) {
+    selector.RecordWorkerTime(worker_time);
+    selector.RecordConsumerTime(consumer_time);
+  }
+}
+
+TEST(AdaptiveCompressionTest, ValidateCompressionCodec) {
+  TF_EXPECT_OK(ValidateCompressionCodec("snappy"));
+  TF_EXPECT_OK(ValidateCompressionCodec("none"));
+  TF_EXPECT_OK(ValidateCompressionCodec("zstd-9"));
+  TF_EXPECT_OK(ValidateCompressionCodec(kAdaptiveCompressionCodec));
+  EXPECT_THAT(ValidateCompressionCodec("lz4"),
+              StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("lz4")));
+  EXPECT_THAT(CompressionCodecSelector::Create("lz4").status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(AdaptiveCompressionTest, FixedCodecNeverChanges) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CompressionCodecSelector> selector,
+                          CompressionCodecSelector::Create("zstd-3"));
+  EXPECT_EQ(selector->Codec(), "zstd-3");
+  RecordWindow(*selector, absl::Seconds(1), absl::Milliseconds(1));
+  EXPECT_EQ(selector->Codec(), "zstd-3");
+  RecordWindow(*selector, absl::Milliseconds(1), absl::Seconds(1));
+  EXPECT_EQ(selector->Codec(), "zstd-3");
+}
+
+TEST(AdaptiveCompressionTest, AdaptiveStartsWithSnappy) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CompressionCodecSelector> selector,
+      CompressionCodecSelector::Create(kAdaptiveCompressionCodec));
+  EXPECT_EQ(selector->Codec(), "snappy");
+}
+
+TEST(AdaptiveCompressionTest, SlowConsumersGetStrongerCompression) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CompressionCodecSelector> selector,
+      CompressionCodecSelector::Create(kAdaptiveCompressionCodec));
+  RecordWindow(*selector, absl::Milliseconds(1), absl::Milliseconds(10));
+  EXPECT_EQ(selector->Codec(), "zstd-1");
+  RecordWindow(*selector, absl::Milliseconds(1), absl::Milliseconds(10));
+  EXPECT_EQ(selector->Codec(), "zstd-3");
+  RecordWindow(*selector, absl::Milliseconds(1), absl::Milliseconds(10));
+  EXPECT_EQ(selector->Codec(), "zstd-9");
+  RecordWindow(*selector, absl::Milliseconds(1), absl::Milliseconds(10));
+  EXPECT_EQ(selector->Codec(), "zstd-9");
+}
+
+TEST(AdaptiveCompressionTest, SlowWorkersGetCheaperCompression) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CompressionCodecSelector> selector,
+      CompressionCodecSelector::Create(kAdaptiveCompressionCodec));
+  RecordWindow(*selector, absl::Milliseconds(10), absl::Milliseconds(1));
+  EXPECT_EQ(selector->Codec(), "none");
+  RecordWindow(*selector, absl::Milliseconds(10), absl::Milliseconds(1));
+  EXPECT_EQ(selector->Codec(), "none");
+}
+
+TEST(AdaptiveCompressionTest, BalancedTimesKeepTheCodec) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CompressionCodecSelector> selector,
+      CompressionCodecSelector::Create(kAdaptiveCompressionCodec));
+  RecordWindow(*selector, absl::Milliseconds(10), absl::Milliseconds(15));
+  EXPECT_EQ(selector->Codec(), "snappy");
+}
+
+TEST(AdaptiveCompressionTest, WaitsForAFullWindow) {
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CompressionCodecSelector> selector,
+      CompressionCodecSelector::Create(kAdaptiveCompressionCodec));
+  for (int i = 0; i < CompressionCodecSelector::kWindowSize - 1; ++i) {
+    selector->RecordWorkerTime(absl::Milliseconds(1));
+    selector->RecordConsumerTime(absl::Milliseconds(10));
+  }
+  EXPECT_EQ(selector->Codec(), "snappy");
+  selector->RecordWorkerTime(absl::Milliseconds(1));
+  EXPECT_EQ(selector->Codec(), "snappy");
+  selector->RecordConsumerTime(absl::Milliseconds(10));
+  EXPECT_EQ(selector->Codec(), "zstd-1");
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
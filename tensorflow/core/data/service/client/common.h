@@ -42,6 +42,21 @@ struct DataServiceParams final {
   TargetWorkers target_workers = TargetWorkers::TARGET_WORKERS_UNSPECIFIED;
   DataServiceMetadata metadata;
   std::optional<CrossTrainerCacheOptions> cross_trainer_cache_options;
+  // Whether workers share the elements of this job with other jobs that read
+  // the same dataset.
+  bool use_cross_job_cache = false;
+  // The element codec for compressed datasets, "adaptive", or empty to use the
+  // dataset's compression.
+  std::string compression_codec;
+  // The maximum number of elements and, if positive, bytes to fetch from a
+  // worker per GetElement request. Only uncoordinated reads without a
+  // cross-trainer or cross-job cache fetch more than one element per request.
+  int64_t max_elements_per_request = 1;
+  int64_t max_bytes_per_request = 0;
+  // The maximum number of GetElement requests in flight to each task. Only
+  // uncoordinated reads without a cross-trainer or cross-job cache pipeline
+  // requests.
+  int64_t max_outstanding_requests_per_task = 1;
 };
 
 }  // namespace data
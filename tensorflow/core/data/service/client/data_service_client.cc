@@ -16,6 +16,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -132,7 +133,8 @@ absl::Status DataServiceClient::Initialize(
             params_.dataset_id, params_.processing_mode, job_name,
             params_.num_consumers,
             params_.cross_trainer_cache_options.has_value(),
-            params_.target_workers, job_id_);
+            params_.use_cross_job_cache, params_.target_workers,
+            params_.compression_codec, job_id_);
       },
       /*description=*/
       absl::StrCat("get or create job with dispatcher at ", params_.address),
@@ -509,10 +511,12 @@ void DataServiceClient::UpdateTasks(const ClientHeartbeatResponse& resp)
   int index = 0;
   while (index < tasks_.size()) {
     std::shared_ptr<Task> task = tasks_[index];
-    if (task_id_to_task.contains(task->info.task_id())) {
+    auto it = task_id_to_task.find(task->info.task_id());
+    if (it != task_id_to_task.end()) {
+      task->relative_throughput = it->second.relative_throughput();
       // Remove already-known tasks from `task_id_to_task`, so that at the
       // end of the loop, only new tasks remain.
-      task_id_to_task.erase(task->info.task_id());
+      task_id_to_task.erase(it);
       ++index;
     } else {
       // Task has been removed.
@@ -606,8 +610,9 @@ void DataServiceClient::UpdateBufferSize() TF_LOCKS_EXCLUDED(mu_) {
 
 void DataServiceClient::UpdateWorkerThreads() TF_LOCKS_EXCLUDED(mu_) {
   mutex_lock l(mu_);
-  const int64_t max_num_threads =
-      std::min<int64_t>(tasks_.size(), max_outstanding_requests_);
+  const int64_t max_num_threads = std::min<int64_t>(
+      tasks_.size() * params_.max_outstanding_requests_per_task,
+      max_outstanding_requests_);
   while (num_running_worker_threads_ < max_num_threads && !cancelled_ &&
          status_.ok()) {
     num_running_worker_threads_++;
@@ -634,6 +639,9 @@ void DataServiceClient::RunWorkerThread(int64_t thread_index,
   });
   VLOG(1) << "Starting worker thread";
   std::shared_ptr<Task> task_to_process;
+  // The number of elements reserved in `outstanding_requests_` for the
+  // request to `task_to_process`.
+  int64_t max_elements = 0;
   int64_t num_consecutive_skipped = 0;
   constexpr int64_t MAX_ROUND_FALLBACK_TO_BLOCKING = 5;
   bool allow_skip = true;
@@ -643,8 +651,8 @@ void DataServiceClient::RunWorkerThread(int64_t thread_index,
     {
       mutex_lock l(mu_);
       if (task_to_process) {
-        task_to_process->in_use = false;
-        --outstanding_requests_;
+        --task_to_process->num_outstanding_requests;
+        outstanding_requests_ -= max_elements;
         task_to_process = nullptr;
         worker_thread_cv_.notify_one();
       }
@@ -661,8 +669,16 @@ void DataServiceClient::RunWorkerThread(int64_t thread_index,
         worker_thread_cv_.wait(l);
       }
       DCHECK(task_to_process != nullptr);
-      task_to_process->in_use = true;
-      ++outstanding_requests_;
+      ++task_to_process->num_outstanding_requests;
+      max_elements = 1;
+      if (BatchesRequests(*task_to_process)) {
+        // `ShouldProcessTask` guarantees room for at least one element.
+        max_elements = std::min<int64_t>(
+            params_.max_elements_per_request,
+            max_outstanding_requests_ -
+                static_cast<int64_t>(results_.size()) - outstanding_requests_);
+      }
+      outstanding_requests_ += max_elements;
       if (IsCoordinatedRead()) {
         // Reserve a spot in the results_ queue.
         results_.push(std::make_shared<Result>());
@@ -677,13 +693,14 @@ void DataServiceClient::RunWorkerThread(int64_t thread_index,
     int64_t deadline_micros = std::numeric_limits<int64_t>::max();
     absl::Status s = GetElementTraced(task_to_process.get(), deadline_micros,
                                       /*enqueue_result=*/!IsCoordinatedRead(),
-                                      allow_skip, result, thread_index);
+                                      allow_skip, max_elements, result,
+                                      thread_index);
     if (!s.ok()) {
       mutex_lock l(mu_);
       VLOG(1) << "Failed to get element from worker "
               << task_to_process->info.worker_address() << ": " << s;
-      task_to_process->in_use = false;
-      --outstanding_requests_;
+      --task_to_process->num_outstanding_requests;
+      outstanding_requests_ -= max_elements;
       status_ = errors::CreateWithUpdatedMessage(
           s, absl::StrCat("Failed to get element from worker ",
                           task_to_process->info.worker_address(), ": ",
@@ -726,6 +743,36 @@ bool DataServiceClient::ShouldProcessTask() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   return results_.size() + outstanding_requests_ < max_outstanding_requests_;
 }
 
+// Coordinated reads and cross-trainer caches need one element per request.
+// Other data transfer protocols may not return additional elements, and may
+// replace the worker client of a task when falling back to gRPC.
+bool DataServiceClient::BatchesRequests(const Task& task) const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  if (IsCoordinatedRead() || params_.cross_trainer_cache_options ||
+      params_.use_cross_job_cache) {
+    return false;
+  }
+  const std::string protocol = task.worker->GetDataTransferProtocol();
+  return protocol == kGrpcTransferProtocol ||
+         protocol == kLocalTransferProtocol;
+}
+
+int64_t DataServiceClient::MaxOutstandingRequestsPerTask(const Task& task) const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  if (!BatchesRequests(task)) {
+    return 1;
+  }
+  const int64_t max_requests = params_.max_outstanding_requests_per_task;
+  if (task.relative_throughput <= 0.0) {
+    return max_requests;
+  }
+  // Shifts outstanding requests from straggling tasks to faster ones, so that
+  // stragglers hold fewer of the client's requests.
+  return std::clamp<int64_t>(
+      std::llround(max_requests * task.relative_throughput), 1,
+      2 * max_requests);
+}
+
 // Searches for a task to process, visiting tasks in-order and giving every
 // task a chance to proceed.
 std::shared_ptr<DataServiceClient::Task> DataServiceClient::GetTaskToProcess()
@@ -737,21 +784,25 @@ std::shared_ptr<DataServiceClient::Task> DataServiceClient::GetTaskToProcess()
   for (int i = 0; i < tasks_.size(); ++i) {
     std::shared_ptr<Task>& task = tasks_[next_task_index_];
     if (IsCoordinatedRead() &&
-        (task->in_use ||
+        (task->num_outstanding_requests > 0 ||
          current_round_ >= round_robin_round_limit_.value_or(
                                std::numeric_limits<int64_t>::max()))) {
-      VLOG(4) << "No round robin task found. in_use: " << task->in_use
+      VLOG(4) << "No round robin task found. num_outstanding_requests: "
+              << task->num_outstanding_requests
               << ". current_round: " << current_round_
               << ". round_robin_round_limit: "
               << round_robin_round_limit_.value_or(-1);
       return nullptr;
     }
-    if (current_round_ < task->info.starting_round() || task->in_use ||
+    if (current_round_ < task->info.starting_round() ||
+        task->num_outstanding_requests >=
+            MaxOutstandingRequestsPerTask(*task) ||
         task->end_of_sequence || task->removed) {
       VLOG(3) << "Skipping task " << next_task_index_
               << ". starting round: " << task->info.starting_round()
               << ". current round: " << current_round_
-              << ". task->in_use: " << task->in_use
+              << ". task->num_outstanding_requests: "
+              << task->num_outstanding_requests
               << ". end_of_sequence: " << task->end_of_sequence
               << ". task->removed: " << task->removed;
       AdvanceTaskIndex();
@@ -775,6 +826,7 @@ void DataServiceClient::AdvanceTaskIndex() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
 }
 
 absl::Status DataServiceClient::TryGetElement(const Task& task, bool allow_skip,
+                                              int64_t max_elements,
                                               GetElementResult& result) {
   GetElementRequest req;
   req.set_task_id(task.info.task_id());
@@ -789,6 +841,10 @@ absl::Status DataServiceClient::TryGetElement(const Task& task, bool allow_skip,
   if (params_.cross_trainer_cache_options) {
     req.set_trainer_id(params_.cross_trainer_cache_options->trainer_id());
   }
+  if (max_elements > 1) {
+    req.set_max_elements(max_elements);
+    req.set_max_bytes(params_.max_bytes_per_request);
+  }
   return task.worker->GetElement(req, result);
 }
 
@@ -806,7 +862,8 @@ void DataServiceClient::ProcessGetElementResponse(
     result->task_id = task.info.task_id();
   } else if (get_element_result.skip) {
     task.skipped_previous_round = true;
-  } else {
+  } else if (!task.end_of_sequence) {
+    // Pipelined requests may all return the end of sequence.
     task.end_of_sequence = true;
     finished_tasks_++;
   }
@@ -814,12 +871,22 @@ void DataServiceClient::ProcessGetElementResponse(
     ctx_->RecordBufferEnqueue(result->element);
     results_.push(std::move(result));
   }
+  for (GetElementResult& element : get_element_result.additional_elements) {
+    auto additional_result = std::make_shared<Result>();
+    additional_result->ready = true;
+    additional_result->element = std::move(element.components);
+    additional_result->element_index = element.element_index;
+    additional_result->task_id = task.info.task_id();
+    ctx_->RecordBufferEnqueue(additional_result->element);
+    results_.push(std::move(additional_result));
+  }
   get_next_cv_.notify_all();
 }
 
 absl::Status DataServiceClient::GetElementTraced(
     Task* task, int64_t deadline_micros, bool enqueue_result, bool allow_skip,
-    std::shared_ptr<Result> result, int64_t thread_index) {
+    int64_t max_elements, std::shared_ptr<Result> result,
+    int64_t thread_index) {
   VLOG(3) << "Getting an element for task id " << task->info.task_id();
   tsl::profiler::TraceMe activity("GetDataServiceElement",
                                   tsl::profiler::TraceMeLevel::kInfo);
@@ -837,7 +904,7 @@ absl::Status DataServiceClient::GetElementTraced(
     });
   }
   absl::Status s = GetElement(task, deadline_micros, enqueue_result, allow_skip,
-                              result, thread_index);
+                              max_elements, result, thread_index);
   VLOG(3) << "Got an element for task id " << task->info.task_id();
   return s;
 }
@@ -875,12 +942,14 @@ absl::Status DataServiceClient::MaybeRemoveTask(Task& task,
 
 absl::Status DataServiceClient::GetElement(Task* task, int64_t deadline_micros,
                                            bool enqueue_result, bool allow_skip,
+                                           int64_t max_elements,
                                            std::shared_ptr<Result> result,
                                            int64_t thread_index)
     TF_LOCKS_EXCLUDED(mu_) {
   GetElementResult get_element_result;
   while (true) {
-    absl::Status s = TryGetElement(*task, allow_skip, get_element_result);
+    absl::Status s =
+        TryGetElement(*task, allow_skip, max_elements, get_element_result);
     if (s.ok()) {
       task->num_retries = 0;
       if (get_element_result.skip) {
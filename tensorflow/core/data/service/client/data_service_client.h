@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_CLIENT_DATA_SERVICE_CLIENT_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_CLIENT_DATA_SERVICE_CLIENT_H_
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -100,7 +101,9 @@ class DataServiceClient {
  private:
   struct Task {
     Task(const TaskInfo& info, std::unique_ptr<DataServiceWorkerClient> worker)
-        : info(info), worker(std::move(worker)) {}
+        : info(info),
+          worker(std::move(worker)),
+          relative_throughput(info.relative_throughput()) {}
 
     const TaskInfo info;
     // Client for fetching task elements from the tf.data service worker.
@@ -110,14 +113,19 @@ class DataServiceClient {
     // Whether the task has been removed. The task will eventually be
     // deleted from `tasks_` on the next dispatcher heartbeat.
     bool removed = false;
-    bool skipped_previous_round = false;
-    // Indicates whether a worker thread is currently processing the task.
-    bool in_use TF_GUARDED_BY(&DataServiceClient::mu_) = false;
+    std::atomic<bool> skipped_previous_round{false};
+    // The number of worker threads currently requesting elements from the
+    // task.
+    int64_t num_outstanding_requests TF_GUARDED_BY(&DataServiceClient::mu_) =
+        0;
     // Indicates whether the worker has returned end_of_sequence for the task.
     bool end_of_sequence TF_GUARDED_BY(&DataServiceClient::mu_) = false;
+    // The task's throughput relative to the other tasks of the iteration, as
+    // of the latest dispatcher heartbeat, or 0 if unknown.
+    double relative_throughput TF_GUARDED_BY(&DataServiceClient::mu_) = 0.0;
     // Number of retries. The more it is retried, the longer it should wait
     // before the next retry.
-    int64_t num_retries = 0;
+    std::atomic<int64_t> num_retries{0};
   };
 
   struct Result {
@@ -177,24 +185,31 @@ class DataServiceClient {
   // Reports whether we can request another element without violating
   // `max_outstanding_requests_`.
   bool ShouldProcessTask();
+  // Returns whether requests for `task` may fetch multiple elements and be
+  // pipelined.
+  bool BatchesRequests(const Task& task) const;
+  // Returns the maximum number of concurrent requests for `task`.
+  int64_t MaxOutstandingRequestsPerTask(const Task& task) const;
   // Searches for a task to process, visiting tasks in-order and giving every
   // task a chance to proceed.
   std::shared_ptr<Task> GetTaskToProcess();
   void AdvanceTaskIndex();
+  // Requests up to `max_elements` elements from `task`.
   absl::Status TryGetElement(const Task& task, bool allow_skip,
-                             GetElementResult& result);
+                             int64_t max_elements, GetElementResult& result);
   void ProcessGetElementResponse(bool enqueue_result,
                                  GetElementResult& get_element_result,
                                  std::shared_ptr<Result> result, Task& task);
   absl::Status GetElementTraced(Task* task, int64_t deadline_micros,
                                 bool enqueue_result, bool allow_skip,
+                                int64_t max_elements,
                                 std::shared_ptr<Result> result,
                                 int64_t thread_index = -1);
   absl::Status MaybeRemoveTask(Task& task, int64_t deadline_micros,
                                Result& result);
   absl::Status GetElement(Task* task, int64_t deadline_micros,
                           bool enqueue_result, bool allow_skip,
-                          std::shared_ptr<Result> result,
+                          int64_t max_elements, std::shared_ptr<Result> result,
                           int64_t thread_index = -1);
   bool ResultReady() const;
   std::shared_ptr<Result> PopNextResult();
@@ -210,7 +225,8 @@ class DataServiceClient {
 
   bool cancelled_ TF_GUARDED_BY(mu_) = false;
 
-  // Number of outstanding requests.
+  // Number of outstanding requests. A request for multiple elements counts
+  // once for each element it may return.
   int64_t outstanding_requests_ TF_GUARDED_BY(mu_) = 0;
 
   // max_outstanding_requests controls how many elements may be held in memory
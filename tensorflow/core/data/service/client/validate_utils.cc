@@ -90,12 +90,90 @@ absl::Status ValidateCrossTrainerCache(
   }
   return absl::OkStatus();
 }
+
+// Validates cross-job cache related parameters.
+absl::Status ValidateCrossJobCache(
+    const DataServiceParams& data_service_params) {
+  if (!data_service_params.use_cross_job_cache) {
+    return absl::OkStatus();
+  }
+  if (data_service_params.processing_mode.sharding_policy() !=
+      ProcessingModeDef::OFF) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cross-job caching requires the OFF sharding policy. Got ",
+        ProcessingModeDef::ShardingPolicy_Name(
+            data_service_params.processing_mode.sharding_policy())));
+  }
+  if (data_service_params.metadata.cardinality() >= 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cross-job caching requires the input dataset to be infinite. "
+        "Got input with cardinality ",
+        data_service_params.metadata.cardinality()));
+  }
+  if (data_service_params.num_consumers.has_value()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cross-job caching does not support coordinated reads. "
+        "Got number of coordinated consumers: ",
+        data_service_params.num_consumers.value()));
+  }
+  if (data_service_params.cross_trainer_cache_options.has_value()) {
+    return absl::InvalidArgumentError(
+        "Cross-job caching cannot be combined with cross-trainer caching.");
+  }
+  return absl::OkStatus();
+}
+
+// Validates the parameters for fetching multiple elements per request and
+// pipelining requests.
+absl::Status ValidateRequestBatching(
+    const DataServiceParams& data_service_params) {
+  if (data_service_params.max_elements_per_request < 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "`max_elements_per_request` must be positive. Got ",
+        data_service_params.max_elements_per_request));
+  }
+  if (data_service_params.max_bytes_per_request < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "`max_bytes_per_request` must be non-negative. Got ",
+        data_service_params.max_bytes_per_request));
+  }
+  if (data_service_params.max_outstanding_requests_per_task < 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "`max_outstanding_requests_per_task` must be positive. Got ",
+        data_service_params.max_outstanding_requests_per_task));
+  }
+  const bool batches_requests =
+      data_service_params.max_elements_per_request > 1 ||
+      data_service_params.max_outstanding_requests_per_task > 1;
+  if (batches_requests && data_service_params.num_consumers.has_value()) {
+    return absl::InvalidArgumentError(
+        "Coordinated reads fetch one element per request. Got "
+        "`max_elements_per_request` or `max_outstanding_requests_per_task` "
+        "greater than 1.");
+  }
+  if (batches_requests &&
+      data_service_params.cross_trainer_cache_options.has_value()) {
+    return absl::InvalidArgumentError(
+        "Cross-trainer caching fetches one element per request. Got "
+        "`max_elements_per_request` or `max_outstanding_requests_per_task` "
+        "greater than 1.");
+  }
+  if (batches_requests && data_service_params.use_cross_job_cache) {
+    return absl::InvalidArgumentError(
+        "Cross-job caching fetches one element per request. Got "
+        "`max_elements_per_request` or `max_outstanding_requests_per_task` "
+        "greater than 1.");
+  }
+  return absl::OkStatus();
+}
 }  // namespace
 
 absl::Status ValidateDataServiceParams(
     const DataServiceParams& data_service_params) {
   TF_RETURN_IF_ERROR(ValidateLocalWorkers(data_service_params));
   TF_RETURN_IF_ERROR(ValidateCrossTrainerCache(data_service_params));
+  TF_RETURN_IF_ERROR(ValidateCrossJobCache(data_service_params));
+  TF_RETURN_IF_ERROR(ValidateRequestBatching(data_service_params));
   return absl::OkStatus();
 }
 
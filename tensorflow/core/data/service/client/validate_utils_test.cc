@@ -176,6 +176,122 @@ TEST(ValidateUtilsTest, CrossTrainerCacheDisallowsCoordinatedRead) {
           HasSubstr(
               "Cross-trainer caching does not support coordinated reads.")));
 }
+
+TEST(ValidateUtilsTest, CrossJobCacheSuccess) {
+  DataServiceParams params = GetDefaultParams();
+  params.metadata.set_cardinality(kInfiniteCardinality);
+  params.use_cross_job_cache = true;
+  TF_EXPECT_OK(ValidateDataServiceParams(params));
+}
+
+TEST(ValidateUtilsTest, CrossJobCacheRequiresNoSharding) {
+  DataServiceParams params = GetDefaultParams();
+  params.processing_mode.set_sharding_policy(ProcessingModeDef::DYNAMIC);
+  params.metadata.set_cardinality(kInfiniteCardinality);
+  params.use_cross_job_cache = true;
+  EXPECT_THAT(ValidateDataServiceParams(params),
+              absl_testing::StatusIs(
+                  error::INVALID_ARGUMENT,
+                  HasSubstr("Cross-job caching requires the OFF sharding "
+                            "policy. Got DYNAMIC")));
+}
+
+TEST(ValidateUtilsTest, CrossJobCacheRequiresInfiniteDataset) {
+  DataServiceParams params = GetDefaultParams();
+  params.metadata.set_cardinality(10);
+  params.use_cross_job_cache = true;
+  EXPECT_THAT(ValidateDataServiceParams(params),
+              absl_testing::StatusIs(
+                  error::INVALID_ARGUMENT,
+                  HasSubstr("Cross-job caching requires the input dataset to "
+                            "be infinite.")));
+}
+
+TEST(ValidateUtilsTest, CrossJobCacheDisallowsCoordinatedRead) {
+  DataServiceParams params = GetDefaultParams();
+  params.num_consumers = 1;
+  params.consumer_index = 0;
+  params.metadata.set_cardinality(kInfiniteCardinality);
+  params.use_cross_job_cache = true;
+  EXPECT_THAT(
+      ValidateDataServiceParams(params),
+      absl_testing::StatusIs(
+          error::INVALID_ARGUMENT,
+          HasSubstr("Cross-job caching does not support coordinated reads.")));
+}
+
+TEST(ValidateUtilsTest, CrossJobCacheDisallowsCrossTrainerCache) {
+  DataServiceParams params = GetDefaultParams();
+  params.job_name = "job_name";
+  params.repetition = 1;
+  params.metadata.set_cardinality(kInfiniteCardinality);
+  params.cross_trainer_cache_options.emplace();
+  params.cross_trainer_cache_options->set_trainer_id("trainer ID");
+  params.use_cross_job_cache = true;
+  EXPECT_THAT(
+      ValidateDataServiceParams(params),
+      absl_testing::StatusIs(
+          error::INVALID_ARGUMENT,
+          HasSubstr("cannot be combined with cross-trainer caching")));
+}
+
+TEST(ValidateUtilsTest, RequestBatchingSuccess) {
+  DataServiceParams params = GetDefaultParams();
+  params.max_elements_per_request = 64;
+  params.max_bytes_per_request = 1 << 20;
+  params.max_outstanding_requests_per_task = 4;
+  TF_EXPECT_OK(ValidateDataServiceParams(params));
+}
+
+TEST(ValidateUtilsTest, RequestBatchingRequiresPositiveLimits) {
+  DataServiceParams params = GetDefaultParams();
+  params.max_elements_per_request = 0;
+  EXPECT_THAT(ValidateDataServiceParams(params),
+              absl_testing::StatusIs(
+                  error::INVALID_ARGUMENT,
+                  HasSubstr("`max_elements_per_request` must be positive")));
+  params = GetDefaultParams();
+  params.max_bytes_per_request = -1;
+  EXPECT_THAT(
+      ValidateDataServiceParams(params),
+      absl_testing::StatusIs(
+          error::INVALID_ARGUMENT,
+          HasSubstr("`max_bytes_per_request` must be non-negative")));
+  params = GetDefaultParams();
+  params.max_outstanding_requests_per_task = 0;
+  EXPECT_THAT(
+      ValidateDataServiceParams(params),
+      absl_testing::StatusIs(
+          error::INVALID_ARGUMENT,
+          HasSubstr("`max_outstanding_requests_per_task` must be positive")));
+}
+
+TEST(ValidateUtilsTest, RequestBatchingDisallowsCoordinatedRead) {
+  DataServiceParams params = GetDefaultParams();
+  params.num_consumers = 2;
+  params.consumer_index = 0;
+  params.max_elements_per_request = 16;
+  EXPECT_THAT(
+      ValidateDataServiceParams(params),
+      absl_testing::StatusIs(
+          error::INVALID_ARGUMENT,
+          HasSubstr("Coordinated reads fetch one element per request")));
+}
+
+TEST(ValidateUtilsTest, RequestBatchingDisallowsCrossTrainerCache) {
+  DataServiceParams params = GetDefaultParams();
+  params.job_name = "job_name";
+  params.repetition = 1;
+  params.metadata.set_cardinality(kInfiniteCardinality);
+  params.cross_trainer_cache_options.emplace();
+  params.cross_trainer_cache_options->set_trainer_id("trainer ID");
+  params.max_outstanding_requests_per_task = 2;
+  EXPECT_THAT(
+      ValidateDataServiceParams(params),
+      absl_testing::StatusIs(
+          error::INVALID_ARGUMENT,
+          HasSubstr("Cross-trainer caching fetches one element per request")));
+}
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -0,0 +1,137 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/cross_job_cache.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/service/byte_size.h"
+#include "tensorflow/core/data/service/data_transfer.h"
+#include "tensorflow/core/data/service/task_runner.h"
+#include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/framework/model.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace data {
+
+// The task runner of one task. It reads the shared elements of its dataset as
+// a trainer of the dataset's `CrossTrainerCache`.
+class CrossJobCache::Reader : public TaskRunner {
+ public:
+  Reader(CrossJobCache& cache, std::string key, int64_t task_id,
+         std::shared_ptr<CachingTaskRunner> task_runner)
+      : cache_(cache),
+        key_(std::move(key)),
+        trainer_id_(absl::StrCat("task_", task_id)),
+        task_runner_(std::move(task_runner)) {}
+
+  ~Reader() override { cache_.Release(key_); }
+
+  absl::Status GetNext(const GetElementRequest& req,
+                       GetElementResult& result) override {
+    if (cancelled_) {
+      return absl::CancelledError(
+          "tf.data service cross-job cache task is cancelled.");
+    }
+    GetElementRequest cache_request = req;
+    cache_request.set_trainer_id(trainer_id_);
+    return task_runner_->GetNext(cache_request, result);
+  }
+
+  // Cancels this task only. The input pipeline keeps producing elements for
+  // the other tasks of the dataset.
+  void Cancel() override { cancelled_ = true; }
+
+  std::shared_ptr<model::Model> model() const override {
+    return task_runner_->model();
+  }
+
+ private:
+  CrossJobCache& cache_;
+  const std::string key_;
+  const std::string trainer_id_;
+  const std::shared_ptr<CachingTaskRunner> task_runner_;
+  std::atomic<bool> cancelled_ = false;
+};
+
+CrossJobCache::CrossJobCache(size_t max_cache_size_bytes)
+    : max_cache_size_bytes_(max_cache_size_bytes) {
+  DCHECK_GT(max_cache_size_bytes_, 0);
+}
+
+absl::StatusOr<std::unique_ptr<TaskRunner>> CrossJobCache::CreateTaskRunner(
+    const std::string& key, int64_t task_id,
+    const IteratorFactory& make_iterator) {
+  {
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++it->second.num_readers;
+      return std::make_unique<Reader>(*this, key, task_id,
+                                      it->second.task_runner);
+    }
+  }
+
+  // Creates the input pipeline without holding `mu_`, since building a
+  // dataset may be slow.
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<TaskIterator> iterator, make_iterator());
+  auto task_runner = std::make_shared<CachingTaskRunner>(std::move(iterator),
+                                                         max_cache_size_bytes_);
+  mutex_lock l(mu_);
+  Entry& entry = entries_[key];
+  if (entry.task_runner == nullptr) {
+    VLOG(1) << "Sharing the elements of dataset " << key
+            << " across jobs with " << ByteSize::Bytes(max_cache_size_bytes_)
+            << " of cache.";
+    entry.task_runner = std::move(task_runner);
+  }
+  // Otherwise, another task created the input pipeline concurrently, and
+  // `task_runner` is discarded.
+  ++entry.num_readers;
+  return std::make_unique<Reader>(*this, key, task_id, entry.task_runner);
+}
+
+size_t CrossJobCache::NumDatasets() const {
+  mutex_lock l(mu_);
+  return entries_.size();
+}
+
+void CrossJobCache::Release(const std::string& key) {
+  std::shared_ptr<CachingTaskRunner> task_runner;
+  {
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end() || --it->second.num_readers > 0) {
+      return;
+    }
+    task_runner = std::move(it->second.task_runner);
+    entries_.erase(it);
+  }
+  VLOG(1) << "Stopped sharing the elements of dataset " << key << ".";
+  task_runner->Cancel();
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,90 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_CROSS_JOB_CACHE_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_CROSS_JOB_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/data/service/task_runner.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// Shares the elements of identical datasets across the tasks of different jobs
+// on a worker. Tasks whose datasets have the same key, e.g. the dataset
+// fingerprint, read from a single input pipeline through a sliding-window
+// `CrossTrainerCache` instead of each running its own. This is useful when
+// concurrent jobs, e.g. the trials of a hyperparameter sweep, read the same
+// data.
+//
+// Each task reads the elements of its dataset in order, starting from the
+// oldest element in the cache. Each dataset has a budget of
+// `max_cache_size_bytes`; when it is full, the oldest elements are evicted, so
+// tasks that fall behind skip elements. The input pipeline is destroyed when
+// its last task is destroyed. The datasets must be infinite.
+//
+// The `CrossJobCache` class is thread-safe.
+class CrossJobCache {
+ public:
+  using IteratorFactory =
+      std::function<absl::StatusOr<std::unique_ptr<TaskIterator>>()>;
+
+  // REQUIRES: max_cache_size_bytes > 0
+  explicit CrossJobCache(size_t max_cache_size_bytes);
+  CrossJobCache(const CrossJobCache&) = delete;
+  CrossJobCache& operator=(const CrossJobCache&) = delete;
+
+  // Creates a task runner for task `task_id` that reads the elements of the
+  // dataset identified by `key`. `make_iterator` is only called if no other
+  // task is reading the dataset. The runner must be destroyed before the
+  // cache.
+  absl::StatusOr<std::unique_ptr<TaskRunner>> CreateTaskRunner(
+      const std::string& key, int64_t task_id,
+      const IteratorFactory& make_iterator);
+
+  // Returns the number of datasets with active tasks.
+  size_t NumDatasets() const;
+
+ private:
+  class Reader;
+
+  // An input pipeline shared by the tasks of a dataset.
+  struct Entry {
+    std::shared_ptr<CachingTaskRunner> task_runner;
+    int64_t num_readers = 0;
+  };
+
+  // Releases a reader of the dataset identified by `key`, destroying its input
+  // pipeline if it was the last reader.
+  void Release(const std::string& key);
+
+  const size_t max_cache_size_bytes_;
+
+  mutable mutex mu_;
+  absl::flat_hash_map<std::string, Entry> entries_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_CROSS_JOB_CACHE_H_
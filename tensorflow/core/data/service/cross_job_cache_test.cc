@@ -0,0 +1,204 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/cross_job_cache.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/data/service/data_transfer.h"
+#include "tensorflow/core/data/service/task_runner.h"
+#include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/status_matchers.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/error_codes.pb.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::Gt;
+
+constexpr size_t kSmallCache = 100;                     // 100 bytes
+constexpr size_t kLargeCache = 10 * (size_t{1} << 30);  // 10GB
+
+class InfiniteRangeIterator : public TaskIterator {
+ public:
+  explicit InfiniteRangeIterator(std::atomic<int64_t>& num_produced)
+      : num_produced_(num_produced) {}
+
+  absl::Status GetNext(std::vector<Tensor>& element,
+                       bool& end_of_sequence) override {
+    element = {Tensor{num_produced_++}};
+    end_of_sequence = false;
+    return absl::OkStatus();
+  }
+
+  int64_t Cardinality() const override { return kInfiniteCardinality; }
+
+ private:
+  std::atomic<int64_t>& num_produced_;
+};
+
+// Returns a factory that counts the iterators it creates in `num_iterators`
+// and the elements they produce in `num_produced`.
+CrossJobCache::IteratorFactory RangeIteratorFactory(
+    int64_t& num_iterators, std::atomic<int64_t>& num_produced) {
+  return [&num_iterators, &num_produced]()
+             -> absl::StatusOr<std::unique_ptr<TaskIterator>> {
+    ++num_iterators;
+    return std::make_unique<InfiniteRangeIterator>(num_produced);
+  };
+}
+
+absl::StatusOr<int64_t> GetNext(TaskRunner& task_runner) {
+  GetElementRequest request;
+  GetElementResult result;
+  TF_RETURN_IF_ERROR(task_runner.GetNext(request, result));
+  if (result.end_of_sequence || result.components.size() != 1) {
+    return absl::InternalError("Expected a single-component element.");
+  }
+  return result.components[0].scalar<int64_t>()();
+}
+
+TEST(CrossJobCacheTest, TasksShareElements) {
+  CrossJobCache cache(kLargeCache);
+  int64_t num_iterators = 0;
+  std::atomic<int64_t> num_produced = 0;
+  const CrossJobCache::IteratorFactory make_iterator =
+      RangeIteratorFactory(num_iterators, num_produced);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> task_1,
+      cache.CreateTaskRunner("dataset", /*task_id=*/1, make_iterator));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> task_2,
+      cache.CreateTaskRunner("dataset", /*task_id=*/2, make_iterator));
+  EXPECT_EQ(num_iterators, 1);
+  EXPECT_EQ(cache.NumDatasets(), 1);
+
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_THAT(GetNext(*task_1), absl_testing::IsOkAndHolds(i));
+  }
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_THAT(GetNext(*task_2), absl_testing::IsOkAndHolds(i));
+  }
+  // Elements are produced once for both tasks, plus up to two prefetched
+  // elements.
+  EXPECT_LE(num_produced, 12);
+}
+
+TEST(CrossJobCacheTest, DifferentDatasetsDoNotShare) {
+  CrossJobCache cache(kLargeCache);
+  int64_t num_iterators = 0;
+  std::atomic<int64_t> num_produced_1 = 0, num_produced_2 = 0;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> task_1,
+      cache.CreateTaskRunner(
+          "dataset_1", /*task_id=*/1,
+          RangeIteratorFactory(num_iterators, num_produced_1)));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> task_2,
+      cache.CreateTaskRunner(
+          "dataset_2", /*task_id=*/2,
+          RangeIteratorFactory(num_iterators, num_produced_2)));
+  EXPECT_EQ(num_iterators, 2);
+  EXPECT_EQ(cache.NumDatasets(), 2);
+  EXPECT_THAT(GetNext(*task_1), absl_testing::IsOkAndHolds(0));
+  EXPECT_THAT(GetNext(*task_2), absl_testing::IsOkAndHolds(0));
+}
+
+TEST(CrossJobCacheTest, SlowTaskSkipsEvictedElements) {
+  CrossJobCache cache(kSmallCache);
+  int64_t num_iterators = 0;
+  std::atomic<int64_t> num_produced = 0;
+  const CrossJobCache::IteratorFactory make_iterator =
+      RangeIteratorFactory(num_iterators, num_produced);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> fast_task,
+      cache.CreateTaskRunner("dataset", /*task_id=*/1, make_iterator));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> slow_task,
+      cache.CreateTaskRunner("dataset", /*task_id=*/2, make_iterator));
+  for (int64_t i = 0; i < 1000; ++i) {
+    EXPECT_THAT(GetNext(*fast_task), absl_testing::IsOkAndHolds(i));
+  }
+  EXPECT_THAT(GetNext(*slow_task), absl_testing::IsOkAndHolds(Gt(0)));
+}
+
+TEST(CrossJobCacheTest, LastTaskReleasesDataset) {
+  CrossJobCache cache(kLargeCache);
+  int64_t num_iterators = 0;
+  std::atomic<int64_t> num_produced = 0;
+  const CrossJobCache::IteratorFactory make_iterator =
+      RangeIteratorFactory(num_iterators, num_produced);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> task_1,
+      cache.CreateTaskRunner("dataset", /*task_id=*/1, make_iterator));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> task_2,
+      cache.CreateTaskRunner("dataset", /*task_id=*/2, make_iterator));
+  task_1.reset();
+  EXPECT_EQ(cache.NumDatasets(), 1);
+  EXPECT_THAT(GetNext(*task_2), absl_testing::IsOkAndHolds(0));
+  task_2.reset();
+  EXPECT_EQ(cache.NumDatasets(), 0);
+
+  // A new task starts a new input pipeline.
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> task_3,
+      cache.CreateTaskRunner("dataset", /*task_id=*/3, make_iterator));
+  EXPECT_EQ(num_iterators, 2);
+}
+
+TEST(CrossJobCacheTest, CancelOneTask) {
+  CrossJobCache cache(kLargeCache);
+  int64_t num_iterators = 0;
+  std::atomic<int64_t> num_produced = 0;
+  const CrossJobCache::IteratorFactory make_iterator =
+      RangeIteratorFactory(num_iterators, num_produced);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> task_1,
+      cache.CreateTaskRunner("dataset", /*task_id=*/1, make_iterator));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TaskRunner> task_2,
+      cache.CreateTaskRunner("dataset", /*task_id=*/2, make_iterator));
+  task_1->Cancel();
+  EXPECT_THAT(GetNext(*task_1), absl_testing::StatusIs(error::CANCELLED));
+  EXPECT_THAT(GetNext(*task_2), absl_testing::IsOkAndHolds(0));
+}
+
+TEST(CrossJobCacheTest, IteratorCreationError) {
+  CrossJobCache cache(kLargeCache);
+  EXPECT_THAT(
+      cache.CreateTaskRunner(
+          "dataset", /*task_id=*/1,
+          []() -> absl::StatusOr<std::unique_ptr<TaskIterator>> {
+            return absl::InvalidArgumentError("Bad dataset");
+          }),
+      absl_testing::StatusIs(error::INVALID_ARGUMENT));
+  EXPECT_EQ(cache.NumDatasets(), 0);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -59,6 +59,10 @@ GetElementResult GetElementResult::Copy() const {
   copy.element_index = element_index;
   copy.end_of_sequence = end_of_sequence;
   copy.skip = skip;
+  copy.additional_elements.reserve(additional_elements.size());
+  for (const GetElementResult& element : additional_elements) {
+    copy.additional_elements.push_back(element.Copy());
+  }
   return copy;
 }
 
@@ -79,6 +83,9 @@ size_t GetElementResult::EstimatedMemoryUsageBytes() const {
       size_bytes += compressed->SpaceUsedLong();
     }
   }
+  for (const GetElementResult& element : additional_elements) {
+    size_bytes += element.EstimatedMemoryUsageBytes();
+  }
   return size_bytes;
 }
 
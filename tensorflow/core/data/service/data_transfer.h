@@ -62,6 +62,9 @@ struct GetElementResult {
   // reading from the worker. This is used for load balancing when doing round
   // robin reads.
   bool skip = false;
+  // Elements that follow this element, if the request asked for more than one.
+  // They always have `components` and never `end_of_sequence` or `skip`.
+  std::vector<GetElementResult> additional_elements;
 };
 
 // Client for communicating with the tf.data service transfer server.
@@ -127,16 +127,17 @@ absl::Status DataServiceDispatcherClient::GetDatasetDef(
   return absl::OkStatus();
 }
 
-absl::Status DataServiceDispatcherClient::GetSplit(int64_t iteration_id,
-                                                   int64_t repetition,
-                                                   int64_t split_provider_index,
-                                                   Tensor& split,
-                                                   bool& end_of_splits) {
+absl::Status DataServiceDispatcherClient::GetSplit(
+    int64_t iteration_id, int64_t repetition, int64_t split_provider_index,
+    Tensor& split, bool& end_of_splits, std::optional<int64_t> task_id) {
   TF_RETURN_IF_ERROR(EnsureInitialized());
   GetSplitRequest req;
   req.set_iteration_id(iteration_id);
   req.set_repetition(repetition);
   req.set_split_provider_index(split_provider_index);
+  if (task_id.has_value()) {
+    req.set_task_id(*task_id);
+  }
   GetSplitResponse resp;
   grpc::ClientContext client_ctx;
   grpc::Status status = stub_->GetSplit(&client_ctx, req, &resp);
@@ -226,7 +227,8 @@ absl::Status DataServiceDispatcherClient::GetOrCreateJob(
     const std::string& dataset_id, const ProcessingModeDef& processing_mode,
     const std::optional<std::string>& job_name,
     std::optional<int64_t> num_consumers, bool use_cross_trainer_cache,
-    TargetWorkers target_workers, int64_t& job_id) {
+    bool use_cross_job_cache, TargetWorkers target_workers,
+    const std::string& compression_codec, int64_t& job_id) {
   TF_RETURN_IF_ERROR(EnsureInitialized());
   GetOrCreateJobRequest req;
   req.set_dataset_id(dataset_id);
@@ -239,6 +241,8 @@ absl::Status DataServiceDispatcherClient::GetOrCreateJob(
   }
   req.set_target_workers(target_workers);
   req.set_use_cross_trainer_cache(use_cross_trainer_cache);
+  req.set_use_cross_job_cache(use_cross_job_cache);
+  req.set_compression_codec(compression_codec);
   GetOrCreateJobResponse resp;
   grpc::ClientContext client_ctx;
   grpc::Status status = stub_->GetOrCreateJob(&client_ctx, req, &resp);
@@ -63,10 +63,12 @@ class DataServiceDispatcherClient : public DataServiceClientBase {
                              DatasetDef& dataset_def);
 
   // Gets the next split for the specified iteration id, repetition, and split
-  // provider index.
+  // provider index. `task_id` identifies the requesting task, which lets a
+  // load-aware dispatcher hold back the last splits from straggling tasks.
   absl::Status GetSplit(int64_t iteration_id, int64_t repetition,
                         int64_t split_provider_index, Tensor& split,
-                        bool& end_of_splits);
+                        bool& end_of_splits,
+                        std::optional<int64_t> task_id = std::nullopt);
 
   // Gets the next split for the specified source of a stream of the snapshot in
   // `base_path`. If `end_of_splits` returns true, then there are no more splits
@@ -90,13 +92,20 @@ class DataServiceDispatcherClient : public DataServiceClientBase {
 
   // If `job_name` is set, looks up a job matching `job_name`.
   // If `job_name` is absent or no matching job is found, creates a
-  // new job. The resulting job id is stored in `job_id`.
+  // new job. The resulting job id is stored in `job_id`. If
+  // `compression_codec` is non-empty, workers compress the elements of a
+  // compressed dataset with that codec, or choose one per task if it is
+  // "adaptive". If `use_cross_job_cache` is true, workers share the elements
+  // of the job with other jobs that read the same dataset.
   absl::Status GetOrCreateJob(const std::string& dataset_id,
                               const ProcessingModeDef& processing_mode,
                               const std::optional<std::string>& job_name,
                               std::optional<int64_t> num_consumers,
                               bool use_cross_trainer_cache,
-                              TargetWorkers target_workers, int64_t& job_id);
+                              bool use_cross_job_cache,
+                              TargetWorkers target_workers,
+                              const std::string& compression_codec,
+                              int64_t& job_id);
 
   // Looks up an iteration of a job, creating an iteration if one doesn't
   // already exist. The returned `iteration_client_id` can be used to query
@@ -320,7 +320,9 @@ TEST_F(DispatcherClientTest, EnableCrossTrainerCache) {
   TF_ASSERT_OK(dispatcher_client_->GetOrCreateJob(
       dataset_id, processing_mode, job_name,
       /*num_consumers=*/std::nullopt,
-      /*use_cross_trainer_cache=*/true, TARGET_WORKERS_AUTO, job_id));
+      /*use_cross_trainer_cache=*/true,
+      /*use_cross_job_cache=*/false, TARGET_WORKERS_AUTO,
+      /*compression_codec=*/"", job_id));
   int64_t iteration_client_id;
   TF_ASSERT_OK(dispatcher_client_->GetOrCreateIteration(
       job_id, /*repetition=*/0, iteration_client_id));
@@ -334,6 +336,159 @@ TEST_F(DispatcherClientTest, EnableCrossTrainerCache) {
   EXPECT_TRUE(worker_heartbeat_response.new_tasks(0).use_cross_trainer_cache());
 }
 
+TEST_F(DispatcherClientTest, SendCompressionCodecToWorkers) {
+  TF_ASSERT_OK(SetUpTfDataService(/*num_workers=*/1));
+  DataServiceMetadata metadata = GetDefaultMetadata();
+  metadata.set_cardinality(kInfiniteCardinality);
+  TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id,
+                          RegisterDataset(InfiniteDataset(), metadata));
+
+  ProcessingModeDef processing_mode;
+  processing_mode.set_sharding_policy(ProcessingModeDef::OFF);
+  int64_t job_id;
+  TF_ASSERT_OK(dispatcher_client_->GetOrCreateJob(
+      dataset_id, processing_mode, /*job_name=*/"job",
+      /*num_consumers=*/std::nullopt,
+      /*use_cross_trainer_cache=*/false,
+      /*use_cross_job_cache=*/false, TARGET_WORKERS_AUTO,
+      /*compression_codec=*/"zstd-3", job_id));
+  int64_t iteration_client_id;
+  TF_ASSERT_OK(dispatcher_client_->GetOrCreateIteration(
+      job_id, /*repetition=*/0, iteration_client_id));
+
+  WorkerHeartbeatRequest worker_heartbeat_request;
+  worker_heartbeat_request.set_worker_address(test_cluster_->WorkerAddress(0));
+  TF_ASSERT_OK_AND_ASSIGN(
+      WorkerHeartbeatResponse worker_heartbeat_response,
+      dispatcher_client_->WorkerHeartbeat(worker_heartbeat_request));
+  ASSERT_EQ(worker_heartbeat_response.new_tasks_size(), 1);
+  EXPECT_EQ(worker_heartbeat_response.new_tasks(0).compression_codec(),
+            "zstd-3");
+
+  // The job parameters include the codec.
+  EXPECT_THAT(
+      dispatcher_client_->GetOrCreateJob(
+          dataset_id, processing_mode, /*job_name=*/"job",
+          /*num_consumers=*/std::nullopt,
+          /*use_cross_trainer_cache=*/false,
+          /*use_cross_job_cache=*/false, TARGET_WORKERS_AUTO,
+          /*compression_codec=*/"adaptive", job_id),
+      absl_testing::StatusIs(
+          error::INVALID_ARGUMENT,
+          HasSubstr("Existing compression codec: <zstd-3>; got <adaptive>")));
+}
+
+TEST_F(DispatcherClientTest, SendDatasetFingerprintToWorkers) {
+  TF_ASSERT_OK(SetUpTfDataService(/*num_workers=*/1));
+  DataServiceMetadata metadata = GetDefaultMetadata();
+  metadata.set_cardinality(kInfiniteCardinality);
+  TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id_1,
+                          RegisterDataset(InfiniteDataset(), metadata));
+  TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id_2,
+                          RegisterDataset(InfiniteDataset(), metadata));
+
+  ProcessingModeDef processing_mode;
+  processing_mode.set_sharding_policy(ProcessingModeDef::OFF);
+  for (const std::string& dataset_id : {dataset_id_1, dataset_id_2}) {
+    int64_t job_id;
+    TF_ASSERT_OK(dispatcher_client_->GetOrCreateJob(
+        dataset_id, processing_mode, /*job_name=*/std::nullopt,
+        /*num_consumers=*/std::nullopt,
+        /*use_cross_trainer_cache=*/false,
+        /*use_cross_job_cache=*/true, TARGET_WORKERS_AUTO,
+        /*compression_codec=*/"", job_id));
+    int64_t iteration_client_id;
+    TF_ASSERT_OK(dispatcher_client_->GetOrCreateIteration(
+        job_id, /*repetition=*/0, iteration_client_id));
+  }
+
+  WorkerHeartbeatRequest worker_heartbeat_request;
+  worker_heartbeat_request.set_worker_address(test_cluster_->WorkerAddress(0));
+  TF_ASSERT_OK_AND_ASSIGN(
+      WorkerHeartbeatResponse worker_heartbeat_response,
+      dispatcher_client_->WorkerHeartbeat(worker_heartbeat_request));
+  ASSERT_EQ(worker_heartbeat_response.new_tasks_size(), 2);
+  const TaskDef& task_1 = worker_heartbeat_response.new_tasks(0);
+  const TaskDef& task_2 = worker_heartbeat_response.new_tasks(1);
+  EXPECT_TRUE(task_1.use_cross_job_cache());
+  EXPECT_TRUE(task_2.use_cross_job_cache());
+  EXPECT_NE(task_1.dataset_fingerprint(), 0);
+  // Datasets with the same graph share elements.
+  EXPECT_NE(task_1.dataset_id(), task_2.dataset_id());
+  EXPECT_EQ(task_1.dataset_fingerprint(), task_2.dataset_fingerprint());
+}
+
+TEST_F(DispatcherClientTest, CrossJobCacheRequiresNoSharding) {
+  TF_ASSERT_OK(SetUpTfDataService(/*num_workers=*/1));
+  DataServiceMetadata metadata = GetDefaultMetadata();
+  metadata.set_cardinality(kInfiniteCardinality);
+  TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id,
+                          RegisterDataset(InfiniteDataset(), metadata));
+
+  ProcessingModeDef processing_mode;
+  processing_mode.set_sharding_policy(ProcessingModeDef::DYNAMIC);
+  int64_t job_id;
+  EXPECT_THAT(dispatcher_client_->GetOrCreateJob(
+                  dataset_id, processing_mode, /*job_name=*/std::nullopt,
+                  /*num_consumers=*/std::nullopt,
+                  /*use_cross_trainer_cache=*/false,
+                  /*use_cross_job_cache=*/true, TARGET_WORKERS_AUTO,
+                  /*compression_codec=*/"", job_id),
+              absl_testing::StatusIs(
+                  error::INVALID_ARGUMENT,
+                  HasSubstr("Cross-job caching requires the OFF sharding "
+                            "policy")));
+}
+
+TEST_F(DispatcherClientTest, UncompressedDatasetIgnoresCompressionCodec) {
+  TF_ASSERT_OK(SetUpTfDataService(/*num_workers=*/1));
+  DataServiceMetadata metadata = GetDefaultMetadata();
+  metadata.set_compression(DataServiceMetadata::COMPRESSION_OFF);
+  metadata.set_cardinality(kInfiniteCardinality);
+  TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id,
+                          RegisterDataset(InfiniteDataset(), metadata));
+
+  ProcessingModeDef processing_mode;
+  processing_mode.set_sharding_policy(ProcessingModeDef::OFF);
+  int64_t job_id;
+  TF_ASSERT_OK(dispatcher_client_->GetOrCreateJob(
+      dataset_id, processing_mode, /*job_name=*/std::nullopt,
+      /*num_consumers=*/std::nullopt,
+      /*use_cross_trainer_cache=*/false,
+      /*use_cross_job_cache=*/false, TARGET_WORKERS_AUTO,
+      /*compression_codec=*/"adaptive", job_id));
+  int64_t iteration_client_id;
+  TF_ASSERT_OK(dispatcher_client_->GetOrCreateIteration(
+      job_id, /*repetition=*/0, iteration_client_id));
+
+  WorkerHeartbeatRequest worker_heartbeat_request;
+  worker_heartbeat_request.set_worker_address(test_cluster_->WorkerAddress(0));
+  TF_ASSERT_OK_AND_ASSIGN(
+      WorkerHeartbeatResponse worker_heartbeat_response,
+      dispatcher_client_->WorkerHeartbeat(worker_heartbeat_request));
+  ASSERT_EQ(worker_heartbeat_response.new_tasks_size(), 1);
+  EXPECT_EQ(worker_heartbeat_response.new_tasks(0).compression_codec(), "");
+}
+
+TEST_F(DispatcherClientTest, UnknownCompressionCodec) {
+  TF_ASSERT_OK(SetUpTfDataService(/*num_workers=*/1));
+  TF_ASSERT_OK_AND_ASSIGN(
+      const std::string dataset_id,
+      RegisterDataset(RangeDataset(10), GetDefaultMetadata()));
+
+  ProcessingModeDef processing_mode;
+  processing_mode.set_sharding_policy(ProcessingModeDef::OFF);
+  int64_t job_id;
+  EXPECT_THAT(dispatcher_client_->GetOrCreateJob(
+                  dataset_id, processing_mode, /*job_name=*/std::nullopt,
+                  /*num_consumers=*/std::nullopt,
+                  /*use_cross_trainer_cache=*/false,
+                  /*use_cross_job_cache=*/false, TARGET_WORKERS_AUTO,
+                  /*compression_codec=*/"lz4", job_id),
+              absl_testing::StatusIs(error::INVALID_ARGUMENT,
+                                     HasSubstr("Unknown compression codec")));
+}
+
 TEST_F(DispatcherClientTest, CreateNamedJob) {
   TF_ASSERT_OK(SetUpTfDataService(/*num_workers=*/1));
   DataServiceMetadata metadata = GetDefaultMetadata();
@@ -348,14 +503,18 @@ TEST_F(DispatcherClientTest, CreateNamedJob) {
   TF_ASSERT_OK(dispatcher_client_->GetOrCreateJob(
       dataset_id, processing_mode, job_name,
       /*num_consumers=*/std::nullopt,
-      /*use_cross_trainer_cache=*/true, TARGET_WORKERS_AUTO, job_id_1));
+      /*use_cross_trainer_cache=*/true,
+      /*use_cross_job_cache=*/false, TARGET_WORKERS_AUTO,
+      /*compression_codec=*/"", job_id_1));
 
   int64_t job_id_2 = -2;
   // Creating the same job should succeed and receive the same job id.
   TF_ASSERT_OK(dispatcher_client_->GetOrCreateJob(
       dataset_id, processing_mode, job_name,
       /*num_consumers=*/std::nullopt,
-      /*use_cross_trainer_cache=*/true, TARGET_WORKERS_AUTO, job_id_2));
+      /*use_cross_trainer_cache=*/true,
+      /*use_cross_job_cache=*/false, TARGET_WORKERS_AUTO,
+      /*compression_codec=*/"", job_id_2));
   ASSERT_EQ(job_id_1, job_id_2);
 }
 
@@ -373,7 +532,9 @@ TEST_F(DispatcherClientTest, NamedJobsDoNotMatch) {
   TF_ASSERT_OK(dispatcher_client_->GetOrCreateJob(
       dataset_id, processing_mode, job_name,
       /*num_consumers=*/std::nullopt,
-      /*use_cross_trainer_cache=*/false, TARGET_WORKERS_AUTO, job_id));
+      /*use_cross_trainer_cache=*/false,
+      /*use_cross_job_cache=*/false, TARGET_WORKERS_AUTO,
+      /*compression_codec=*/"", job_id));
 
   // Creating the same iteration with a different argument should fail.
   processing_mode.set_sharding_policy(ProcessingModeDef::DYNAMIC);
@@ -381,7 +542,9 @@ TEST_F(DispatcherClientTest, NamedJobsDoNotMatch) {
       dispatcher_client_->GetOrCreateJob(dataset_id, processing_mode, job_name,
                                          /*num_consumers=*/std::nullopt,
                                          /*use_cross_trainer_cache=*/true,
-                                         TARGET_WORKERS_AUTO, job_id),
+                                         /*use_cross_job_cache=*/false,
+                                         TARGET_WORKERS_AUTO,
+                                         /*compression_codec=*/"", job_id),
       absl_testing::StatusIs(
           error::INVALID_ARGUMENT,
           AllOf(HasSubstr("but found an existing job with different "
@@ -46,6 +46,7 @@ limitations under the License.
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/hash_utils.h"
 #include "tensorflow/core/data/service/auto_scaler.h"
+#include "tensorflow/core/data/service/adaptive_compression.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/credentials_factory.h"
@@ -63,6 +64,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/utils.h"
 #include "tensorflow/core/data/service/validate_utils.h"
 #include "tensorflow/core/data/service/worker.grpc.pb.h"
+#include "tensorflow/core/data/service/worker_load_tracker.h"
 #include "tensorflow/core/data/snapshot_utils.h"
 #include "tensorflow/core/data/standalone.h"
 #include "tensorflow/core/data/utils.h"
@@ -105,6 +107,11 @@ constexpr absl::Duration kDefaultIterationGcCheckInterval = absl::Minutes(10);
 constexpr absl::Duration kDefaultIterationGcTimeout = absl::Minutes(5);
 constexpr absl::Duration kDefaultClientTimeout = absl::Minutes(5);
 constexpr absl::Duration kDefaultWorkerTimeout = absl::Minutes(10);
+constexpr int64_t kDefaultJournalCompactionInterval = 100000;
+
+// How long a `GetSplit` request from a straggling task may be held back, and
+// how often the dispatcher checks whether to release it.
+constexpr absl::Duration kMaxSplitHoldBackTime = absl::Seconds(1);
 
 constexpr std::array<const char*, 8> kNodeNameSharingOps = {
     "HashTable",
@@ -185,6 +192,10 @@ DispatcherConfig ApplyConfigDefaults(const DispatcherConfig& config) {
     new_config.set_worker_max_concurrent_snapshots(
         kDefaultWorkerMaxConcurrentSnapshots);
   }
+  if (new_config.journal_compaction_interval() == 0) {
+    new_config.set_journal_compaction_interval(
+        kDefaultJournalCompactionInterval);
+  }
   return new_config;
 }
 
@@ -279,10 +290,12 @@ absl::Status DataServiceDispatcherImpl::Start() {
     int64_t start = env_->NowMicros();
     while (!end_of_journal) {
       TF_RETURN_IF_ERROR(ApplyWithoutJournaling(update));
+      ++num_updates_since_journal_compaction_;
       TF_RETURN_IF_ERROR(reader.Read(update, end_of_journal));
     }
     absl::Duration duration = absl::Microseconds(env_->NowMicros() - start);
-    LOG(INFO) << "Restored from journal in " << duration << ".";
+    LOG(INFO) << "Restored " << num_updates_since_journal_compaction_
+              << " updates from journal in " << duration << ".";
   }
   for (const auto& iteration : state_.ListIterations()) {
     if (IsDynamicShard(iteration->job->processing_mode)) {
@@ -365,12 +378,7 @@ absl::Status DataServiceDispatcherImpl::RestoreSplitProviders(
     VLOG(1) << "Restoring split provider " << provider_index
             << " for iteration " << iteration.iteration_id << " to index "
             << index;
-    Tensor unused_tensor;
-    bool unused_end_of_splits;
-    for (int i = 0; i < index; ++i) {
-      TF_RETURN_IF_ERROR(split_providers[provider_index]->GetNext(
-          &unused_tensor, &unused_end_of_splits));
-    }
+    TF_RETURN_IF_ERROR(split_providers[provider_index]->Skip(index));
   }
   restored = std::move(split_providers);
   return absl::OkStatus();
@@ -491,11 +499,18 @@ absl::Status DataServiceDispatcherImpl::WorkerHeartbeat(
     // TODO(b/249286501): Skip this if the user does not enable auto-scaling.
     ReportProcessingTimesFromActiveTasks(active_tasks,
                                          request->worker_address());
+    if (config_.load_aware_task_assignment()) {
+      worker_load_tracker_.ReportLoad(worker_address, active_tasks,
+                                      absl::FromUnixMicros(env_->NowMicros()));
+    }
     TF_RETURN_IF_ERROR(
         FindTasksToDelete(current_tasks, assigned_tasks, response));
     TF_RETURN_IF_ERROR(
         FindNewTasks(worker_address, current_tasks, assigned_tasks, response));
   }
+  if (config_.load_aware_task_assignment()) {
+    NotifySplitHoldBack();
+  }
 
   std::vector<std::string> snapshot_paths =
       snapshot_assignment_manager_.LoadBalanceSnapshots(
@@ -570,6 +585,10 @@ absl::Status DataServiceDispatcherImpl::GetSplit(const GetSplitRequest* request,
   VLOG(3) << "Received GetSplit request for iteration " << iteration_id
           << ", repetition " << repetition << ", split provider index "
           << provider_index;
+  if (config_.load_aware_task_assignment() &&
+      request->optional_task_id_case() == GetSplitRequest::kTaskId) {
+    TF_RETURN_IF_ERROR(HoldBackSplitsFromStraggler(*request));
+  }
   mutex_lock l(get_split_mu_);
   int64_t current_repetition = 0;
   SplitProvider* split_provider = nullptr;
@@ -611,6 +630,9 @@ absl::Status DataServiceDispatcherImpl::GetSplit(const GetSplitRequest* request,
   TF_RETURN_IF_ERROR(split_provider->GetNext(&split, &end_of_splits));
   TF_RETURN_IF_ERROR(RecordSplitProduced(iteration_id, repetition,
                                          provider_index, end_of_splits));
+  if (config_.load_aware_task_assignment()) {
+    NotifySplitHoldBack();
+  }
   response->set_end_of_splits(end_of_splits);
   if (end_of_splits) {
     // Reset the split provider to prepare for the next iteration.
@@ -623,6 +645,87 @@ absl::Status DataServiceDispatcherImpl::GetSplit(const GetSplitRequest* request,
   return absl::OkStatus();
 }
 
+absl::Status DataServiceDispatcherImpl::HoldBackSplitsFromStraggler(
+    const GetSplitRequest& request)
+    TF_LOCKS_EXCLUDED(mu_, get_split_mu_, split_hold_back_mu_) {
+  const int64_t deadline_micros =
+      env_->NowMicros() + absl::ToInt64Microseconds(kMaxSplitHoldBackTime);
+  while (true) {
+    // Reads the generation before checking, so that a load report or split
+    // that lands during the check wakes up the wait below.
+    int64_t generation = 0;
+    {
+      mutex_lock l(split_hold_back_mu_);
+      generation = split_hold_back_generation_;
+    }
+    TF_ASSIGN_OR_RETURN(bool hold_back, ShouldHoldBackSplit(request));
+    if (!hold_back) {
+      return absl::OkStatus();
+    }
+    VLOG(3) << "Holding back a split from straggling task "
+            << request.task_id() << " of iteration " << request.iteration_id();
+    mutex_lock l(split_hold_back_mu_);
+    while (split_hold_back_generation_ == generation) {
+      const int64_t remaining_micros = deadline_micros - env_->NowMicros();
+      if (remaining_micros <= 0) {
+        return absl::OkStatus();
+      }
+      split_hold_back_cv_.wait_for(
+          l, std::chrono::microseconds(remaining_micros));
+    }
+  }
+}
+
+void DataServiceDispatcherImpl::NotifySplitHoldBack()
+    TF_LOCKS_EXCLUDED(split_hold_back_mu_) {
+  mutex_lock l(split_hold_back_mu_);
+  ++split_hold_back_generation_;
+  split_hold_back_cv_.notify_all();
+}
+
+absl::StatusOr<bool> DataServiceDispatcherImpl::ShouldHoldBackSplit(
+    const GetSplitRequest& request) TF_LOCKS_EXCLUDED(mu_, get_split_mu_) {
+  mutex_lock split_lock(get_split_mu_);
+  mutex_lock l(mu_);
+  std::shared_ptr<const Iteration> iteration;
+  TF_RETURN_IF_ERROR(state_.IterationFromId(request.iteration_id(), iteration));
+  if (!iteration->distributed_epoch_state.has_value()) {
+    return false;
+  }
+  const DispatcherState::DistributedEpochState& epoch_state =
+      iteration->distributed_epoch_state.value();
+  const int64_t provider_index = request.split_provider_index();
+  if (provider_index < 0 ||
+      static_cast<size_t>(provider_index) >= epoch_state.repetitions.size() ||
+      request.repetition() != epoch_state.repetitions[provider_index]) {
+    return false;
+  }
+  const int64_t num_splits =
+      split_providers_[request.iteration_id()][provider_index]->Cardinality();
+  if (num_splits < 0) {
+    // The number of remaining splits is unknown.
+    return false;
+  }
+  TF_ASSIGN_OR_RETURN(std::vector<int64_t> peer_task_ids,
+                      TaskIdsForIteration(request.iteration_id()));
+  return worker_load_tracker_.ShouldHoldBackSplits(
+      request.task_id(), peer_task_ids,
+      num_splits - epoch_state.indices[provider_index]);
+}
+
+absl::StatusOr<std::vector<int64_t>>
+DataServiceDispatcherImpl::TaskIdsForIteration(int64_t iteration_id) const
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  std::vector<std::shared_ptr<const Task>> tasks;
+  TF_RETURN_IF_ERROR(state_.TasksForIteration(iteration_id, tasks));
+  std::vector<int64_t> task_ids;
+  task_ids.reserve(tasks.size());
+  for (const auto& task : tasks) {
+    task_ids.push_back(task->task_id);
+  }
+  return task_ids;
+}
+
 absl::Status DataServiceDispatcherImpl::MakeSplitProviders(
     const std::string& dataset_id,
     std::vector<std::unique_ptr<SplitProvider>>& split_providers)
@@ -699,9 +802,19 @@ absl::Status DataServiceDispatcherImpl::RegisterDataset(
   } else {
     TF_RETURN_IF_ERROR(ValidateDatasetId(dataset_id));
   }
+  // Workers share elements across jobs whose datasets have the same
+  // fingerprint. Datasets that cannot be fingerprinted are never shared.
+  uint64_t fingerprint = 0;
+  absl::Status fingerprint_status = HashGraph(dataset.graph(), &fingerprint);
+  if (!fingerprint_status.ok()) {
+    VLOG(1) << "Failed to fingerprint dataset " << dataset_id << ": "
+            << fingerprint_status;
+    fingerprint = 0;
+  }
   Update update;
   RegisterDatasetUpdate* register_dataset = update.mutable_register_dataset();
   register_dataset->set_dataset_id(dataset_id);
+  register_dataset->set_fingerprint(fingerprint);
   *register_dataset->mutable_metadata() = metadata;
   TF_RETURN_IF_ERROR(dataset_store_->Put(dataset_id, dataset));
   return Apply(update);
@@ -893,6 +1006,19 @@ absl::Status DataServiceDispatcherImpl::ValidateMatchingJob(
                        TargetWorkersToString(request.target_workers()), ">. ");
   }
 
+  if (job->compression_codec != request.compression_codec()) {
+    strings::StrAppend(&diff, "Existing compression codec: <",
+                       job->compression_codec, ">; got <",
+                       request.compression_codec(), ">. ");
+  }
+
+  if (job->use_cross_job_cache != request.use_cross_job_cache()) {
+    strings::StrAppend(
+        &diff, "Existing cross-job cache: <",
+        (job->use_cross_job_cache ? "enabled" : "disabled"), ">; got <",
+        (request.use_cross_job_cache() ? "enabled" : "disabled"), ">. ");
+  }
+
   if (!diff.empty()) {
     return absl::InvalidArgumentError(absl::StrCat(
         "Tried to create job with name ", job->job_name,
@@ -901,10 +1027,38 @@ absl::Status DataServiceDispatcherImpl::ValidateMatchingJob(
   return absl::OkStatus();
 }
 
+absl::Status DataServiceDispatcherImpl::ValidateCrossJobCache(
+    const GetOrCreateJobRequest& request) const {
+  if (!request.use_cross_job_cache()) {
+    return absl::OkStatus();
+  }
+  if (request.processing_mode_def().sharding_policy() !=
+      ProcessingModeDef::OFF) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Cross-job caching requires the OFF sharding policy. Got ",
+        ProcessingModeDef::ShardingPolicy_Name(
+            request.processing_mode_def().sharding_policy())));
+  }
+  if (request.optional_num_consumers_case() ==
+      GetOrCreateJobRequest::kNumConsumers) {
+    return absl::InvalidArgumentError(
+        "Cross-job caching does not support coordinated reads.");
+  }
+  if (request.use_cross_trainer_cache()) {
+    return absl::InvalidArgumentError(
+        "Cross-job caching cannot be combined with cross-trainer caching.");
+  }
+  return absl::OkStatus();
+}
+
 absl::Status DataServiceDispatcherImpl::CreateJob(
     const std::string& job_name, const GetOrCreateJobRequest& request,
     std::shared_ptr<const Job>& job) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   TF_RETURN_IF_ERROR(ValidateProcessingMode(request.processing_mode_def()));
+  if (!request.compression_codec().empty()) {
+    TF_RETURN_IF_ERROR(ValidateCompressionCodec(request.compression_codec()));
+  }
+  TF_RETURN_IF_ERROR(ValidateCrossJobCache(request));
   int64_t job_id = state_.NextAvailableJobId();
   Update update;
   CreateJobUpdate* create_job = update.mutable_create_job();
@@ -919,6 +1073,8 @@ absl::Status DataServiceDispatcherImpl::CreateJob(
   }
   create_job->set_target_workers(request.target_workers());
   create_job->set_use_cross_trainer_cache(request.use_cross_trainer_cache());
+  create_job->set_compression_codec(request.compression_codec());
+  create_job->set_use_cross_job_cache(request.use_cross_job_cache());
   TF_RETURN_IF_ERROR(Apply(update));
   TF_RETURN_IF_ERROR(state_.JobFromId(job_id, job));
   tensorflow::metrics::RecordTFDataServiceJobsCreated(
@@ -1197,6 +1353,10 @@ absl::Status DataServiceDispatcherImpl::ClientHeartbeat(
 
   std::vector<std::shared_ptr<const Task>> tasks;
   TF_RETURN_IF_ERROR(state_.TasksForIteration(iteration->iteration_id, tasks));
+  std::vector<int64_t> task_ids;
+  if (config_.load_aware_task_assignment()) {
+    TF_ASSIGN_OR_RETURN(task_ids, TaskIdsForIteration(iteration->iteration_id));
+  }
   for (const auto& task : tasks) {
     TaskInfo* task_info = response->mutable_task_info()->Add();
     task_info->set_worker_address(task->worker_address);
@@ -1208,6 +1368,13 @@ absl::Status DataServiceDispatcherImpl::ClientHeartbeat(
     task_info->set_iteration_id(iteration->iteration_id);
     task_info->set_worker_uid(task->worker_uid);
     task_info->set_starting_round(task->starting_round);
+    if (config_.load_aware_task_assignment()) {
+      std::optional<double> relative_throughput =
+          worker_load_tracker_.RelativeThroughput(task->task_id, task_ids);
+      if (relative_throughput.has_value()) {
+        task_info->set_relative_throughput(*relative_throughput);
+      }
+    }
   }
   response->set_iteration_finished(iteration->finished);
   response->set_deployment_mode(config_.deployment_mode());
@@ -1384,6 +1551,18 @@ absl::Status DataServiceDispatcherImpl::PopulateTaskDef(
   std::shared_ptr<const Dataset> dataset;
   TF_RETURN_IF_ERROR(
       state_.DatasetFromId(task->iteration->job->dataset_id, dataset));
+  // Only datasets that are compressed in the first place have their codec
+  // replaced, since their consumers expect compressed elements.
+  const DataServiceMetadata::Compression compression =
+      dataset->metadata.compression();
+  if (compression == DataServiceMetadata::COMPRESSION_SNAPPY ||
+      compression == DataServiceMetadata::COMPRESSION_FORCED_SNAPPY) {
+    task_def->set_compression_codec(task->iteration->job->compression_codec);
+  }
+  if (task->iteration->job->use_cross_job_cache && dataset->fingerprint != 0) {
+    task_def->set_use_cross_job_cache(true);
+    task_def->set_dataset_fingerprint(dataset->fingerprint);
+  }
   if (config_.work_dir().empty()) {
     std::shared_ptr<const DatasetDef> dataset_def;
     TF_RETURN_IF_ERROR(dataset_store_->Get(dataset->dataset_id, dataset_def));
@@ -1426,46 +1605,85 @@ absl::Status DataServiceDispatcherImpl::Apply(const Update& update)
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
   if (journal_writer_.has_value()) {
     TF_RETURN_IF_ERROR(journal_writer_.value()->Write(update));
+    ++num_updates_since_journal_compaction_;
   }
   return state_.Apply(update);
 }
 
+absl::StatusOr<std::optional<int64_t>>
+DataServiceDispatcherImpl::RotateJournalForCompaction()
+    TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+  if (!journal_writer_.has_value() ||
+      config_.journal_compaction_interval() < 0 ||
+      num_updates_since_journal_compaction_ <
+          config_.journal_compaction_interval()) {
+    return std::nullopt;
+  }
+  TF_ASSIGN_OR_RETURN(int64_t sequence_number,
+                      journal_writer_.value()->Rotate());
+  num_updates_since_journal_compaction_ = 0;
+  return sequence_number;
+}
+
 void DataServiceDispatcherImpl::MaintenanceThread() {
   int64_t next_check_micros = 0;
   while (true) {
-    mutex_lock l(mu_);
-    while (!cancelled_ && env_->NowMicros() < next_check_micros) {
-      int64_t remaining_micros = next_check_micros - env_->NowMicros();
-      maintenance_thread_cv_.wait_for(
-          l, std::chrono::microseconds(remaining_micros));
-    }
-    if (cancelled_) {
-      return;
-    }
+    std::optional<int64_t> journal_compaction_sequence_number;
     {
-      absl::Status s = ReleaseMissingClients();
-      if (!s.ok()) {
-        LOG(WARNING) << "Error releasing missing clients: " << s;
+      mutex_lock l(mu_);
+      while (!cancelled_ && env_->NowMicros() < next_check_micros) {
+        int64_t remaining_micros = next_check_micros - env_->NowMicros();
+        maintenance_thread_cv_.wait_for(
+            l, std::chrono::microseconds(remaining_micros));
       }
-    }
-    {
-      absl::Status s = auto_scaler_.UpdateOptimalNumberOfWorkersMetric(
-          state_.GetNumberOfRegisteredWorkers());
-      if (!s.ok()) {
-        VLOG(1) << "Error updating the optimal number of workers metric "
-                   "in tf.data service AutoScaler: "
-                << s;
+      if (cancelled_) {
+        return;
+      }
+      {
+        absl::Status s = ReleaseMissingClients();
+        if (!s.ok()) {
+          LOG(WARNING) << "Error releasing missing clients: " << s;
+        }
       }
+      {
+        absl::Status s = auto_scaler_.UpdateOptimalNumberOfWorkersMetric(
+            state_.GetNumberOfRegisteredWorkers());
+        if (!s.ok()) {
+          VLOG(1) << "Error updating the optimal number of workers metric "
+                     "in tf.data service AutoScaler: "
+                  << s;
+        }
+      }
+      {
+        absl::Status s = GcOldIterations();
+        if (!s.ok()) {
+          LOG(WARNING) << "Error garbage collecting old iterations: " << s;
+        }
+      }
+      DetectMissingWorkers();
+      {
+        absl::StatusOr<std::optional<int64_t>> sequence_number =
+            RotateJournalForCompaction();
+        if (!sequence_number.ok()) {
+          LOG(WARNING) << "Error rotating the journal for compaction: "
+                       << sequence_number.status();
+        } else {
+          journal_compaction_sequence_number = *sequence_number;
+        }
+      }
+      next_check_micros =
+          env_->NowMicros() + (config_.job_gc_check_interval_ms() * 1000);
     }
-    {
-      absl::Status s = GcOldIterations();
+    if (journal_compaction_sequence_number.has_value()) {
+      // Compacts the journal without holding `mu_`, since the journal files
+      // being compacted are no longer written to.
+      absl::Status s =
+          CompactJournal(env_, JournalDir(config_.work_dir()),
+                         *journal_compaction_sequence_number);
       if (!s.ok()) {
-        LOG(WARNING) << "Error garbage collecting old iterations: " << s;
+        LOG(WARNING) << "Error compacting the journal: " << s;
       }
     }
-    DetectMissingWorkers();
-    next_check_micros =
-        env_->NowMicros() + (config_.job_gc_check_interval_ms() * 1000);
   }
 }
 
@@ -1540,6 +1758,7 @@ void DataServiceDispatcherImpl::DetectMissingWorkers()
         it->second + absl::Milliseconds(config_.worker_timeout_ms())) {
       LOG(INFO) << "Lost worker " << it->first << " due to timeout";
       RemoveWorkerFromAutoScaler(it->first);
+      worker_load_tracker_.RemoveWorker(it->first);
 
       latest_worker_heartbeats_time_.erase(it++);
     } else {
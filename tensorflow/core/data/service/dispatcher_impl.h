@@ -25,6 +25,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/data/service/auto_scaler.h"
 #include "tensorflow/core/data/service/common.pb.h"
@@ -35,6 +36,7 @@ limitations under the License.
 #include "tensorflow/core/data/service/snapshot/snapshot_manager.h"
 #include "tensorflow/core/data/service/task_remover.h"
 #include "tensorflow/core/data/service/worker.grpc.pb.h"
+#include "tensorflow/core/data/service/worker_load_tracker.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/macros.h"
@@ -198,7 +200,8 @@ class DataServiceDispatcherImpl {
 
  private:
   // A thread which periodically checks for iterations to clean up, clients to
-  // release, workers to consider missing, and snapshot streams to reassign.
+  // release, workers to consider missing, and snapshot streams to reassign,
+  // and compacts the journal.
   void MaintenanceThread();
 
   // Restores split providers from the state in `iteration` and stores them in
@@ -262,6 +265,20 @@ class DataServiceDispatcherImpl {
   void ReportProcessingTimesFromActiveTasks(
       const std::vector<ActiveTask>& active_tasks,
       const std::string& worker_address) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Returns the ids of the tasks of the iteration with `iteration_id`.
+  absl::StatusOr<std::vector<int64_t>> TaskIdsForIteration(
+      int64_t iteration_id) const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Delays a `GetSplit` request from a straggling task while the remaining
+  // splits of the epoch can be taken by faster tasks, up to a deadline. The
+  // request is checked again whenever `NotifySplitHoldBack` is called.
+  absl::Status HoldBackSplitsFromStraggler(const GetSplitRequest& request)
+      TF_LOCKS_EXCLUDED(mu_, get_split_mu_, split_hold_back_mu_);
+  // Wakes up the requests held back by `HoldBackSplitsFromStraggler`, after a
+  // worker reported its load or a split was produced.
+  void NotifySplitHoldBack() TF_LOCKS_EXCLUDED(split_hold_back_mu_);
+  // Returns whether the next split requested by `request` should be held back.
+  absl::StatusOr<bool> ShouldHoldBackSplit(const GetSplitRequest& request)
+      TF_LOCKS_EXCLUDED(mu_, get_split_mu_);
   // Acquires an iteration client id to read from the given iteration and sets
   // `iteration_client_id`.
   absl::Status AcquireIterationClientId(
@@ -302,6 +319,10 @@ class DataServiceDispatcherImpl {
   // Assigns a task to the worker indicated by its `worker_address` field.
   absl::Status AssignTask(std::shared_ptr<const DispatcherState::Task> task)
       TF_LOCKS_EXCLUDED(mu_);
+  // Validates that a job requesting cross-job caching can share elements
+  // with other jobs.
+  absl::Status ValidateCrossJobCache(
+      const GetOrCreateJobRequest& request) const;
   // Validates that an existing job matches a given request.
   // Returns an error status describing any difference.
   absl::Status ValidateMatchingJob(
@@ -321,6 +342,11 @@ class DataServiceDispatcherImpl {
       TF_LOCKS_EXCLUDED(mu_);
   // Applies a state update, updating both the journal and the in-memory state.
   absl::Status Apply(const Update& update) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // If enough updates have been journaled since the last compaction, starts a
+  // new journal file and returns its sequence number. The journal files before
+  // it can then be compacted without holding `mu_`.
+  absl::StatusOr<std::optional<int64_t>> RotateJournalForCompaction()
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
   // Applies a state update, but doesn't update the journal. Only meant to be
   // used when recovering state when the dispatcher starts.
   absl::Status ApplyWithoutJournaling(const Update& update)
@@ -396,11 +422,21 @@ class DataServiceDispatcherImpl {
 
   std::optional<std::unique_ptr<JournalWriter>> journal_writer_
       TF_GUARDED_BY(mu_);
+  // The number of updates journaled, or recovered from the journal, since the
+  // journal was last compacted.
+  int64_t num_updates_since_journal_compaction_ TF_GUARDED_BY(mu_) = 0;
   DispatcherState state_ TF_GUARDED_BY(mu_);
   // Condition variable for waking up the gc thread.
   condition_variable maintenance_thread_cv_;
   std::unique_ptr<Thread> maintenance_thread_;
   MultipleIterationsAutoScaler auto_scaler_;
+  // Load of the workers' tasks, for load-aware task assignment.
+  WorkerLoadTracker worker_load_tracker_;
+  // Wakes up `GetSplit` requests held back from straggling tasks. The
+  // generation is incremented on every notification.
+  mutex split_hold_back_mu_;
+  condition_variable split_hold_back_cv_;
+  int64_t split_hold_back_generation_ TF_GUARDED_BY(split_hold_back_mu_) = 0;
 
   DataServiceDispatcherImpl(const DataServiceDispatcherImpl&) = delete;
   void operator=(const DataServiceDispatcherImpl&) = delete;
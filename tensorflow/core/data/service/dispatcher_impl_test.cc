@@ -0,0 +1,138 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/dispatcher_impl.h"
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/data/service/dispatcher.pb.h"
+#include "tensorflow/core/data/service/export.pb.h"
+#include "tensorflow/core/data/service/journal.h"
+#include "tensorflow/core/data/service/journal.pb.h"
+#include "tensorflow/core/data/service/test_util.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/service_config.pb.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kJournalDir[] = "tf_data_dispatcher_journal";
+
+// Returns the number of updates in the journal under `work_dir`.
+absl::StatusOr<int64_t> NumJournalUpdates(const std::string& work_dir) {
+  FileJournalReader reader(Env::Default(), io::JoinPath(work_dir, kJournalDir));
+  int64_t num_updates = 0;
+  Update update;
+  bool end_of_journal = false;
+  TF_RETURN_IF_ERROR(reader.Read(update, end_of_journal));
+  while (!end_of_journal) {
+    ++num_updates;
+    TF_RETURN_IF_ERROR(reader.Read(update, end_of_journal));
+  }
+  return num_updates;
+}
+
+absl::StatusOr<int64_t> GetSplit(DataServiceDispatcherImpl& dispatcher,
+                                 int64_t iteration_id) {
+  GetSplitRequest request;
+  request.set_iteration_id(iteration_id);
+  request.set_repetition(0);
+  request.set_split_provider_index(0);
+  GetSplitResponse response;
+  TF_RETURN_IF_ERROR(dispatcher.GetSplit(&request, &response));
+  if (response.end_of_splits()) {
+    return errors::OutOfRange("Reached the end of splits.");
+  }
+  Tensor split;
+  if (!split.FromProto(response.split())) {
+    return errors::Internal("Failed to parse split tensor proto.");
+  }
+  return split.scalar<int64_t>()();
+}
+
+TEST(DataServiceDispatcherImplTest, RestoresSplitsFromCompactedJournal) {
+  constexpr int64_t kNumSplits = 50;
+  std::string work_dir = testing::TmpDir();
+  ASSERT_TRUE(Env::Default()->CreateUniqueFileName(&work_dir, "work_dir"));
+  experimental::DispatcherConfig config;
+  config.set_protocol("grpc");
+  config.set_work_dir(work_dir);
+  config.set_fault_tolerant_mode(true);
+  config.set_job_gc_check_interval_ms(10);
+  config.set_journal_compaction_interval(10);
+
+  int64_t iteration_id = -1;
+  {
+    DataServiceDispatcherImpl dispatcher(config);
+    TF_ASSERT_OK(dispatcher.Start());
+
+    GetOrRegisterDatasetRequest dataset_request;
+    *dataset_request.mutable_dataset() = testing::RangeDataset(kNumSplits * 2);
+    GetOrRegisterDatasetResponse dataset_response;
+    TF_ASSERT_OK(
+        dispatcher.GetOrRegisterDataset(&dataset_request, &dataset_response));
+
+    GetOrCreateJobRequest job_request;
+    job_request.set_dataset_id(dataset_response.dataset_id());
+    job_request.mutable_processing_mode_def()->set_sharding_policy(
+        ProcessingModeDef::DYNAMIC);
+    GetOrCreateJobResponse job_response;
+    TF_ASSERT_OK(dispatcher.GetOrCreateJob(&job_request, &job_response));
+
+    GetOrCreateIterationRequest iteration_request;
+    iteration_request.set_job_id(job_response.job_id());
+    iteration_request.set_repetition(0);
+    GetOrCreateIterationResponse iteration_response;
+    TF_ASSERT_OK(dispatcher.GetOrCreateIteration(&iteration_request,
+                                                 &iteration_response));
+    DispatcherStateExport state = dispatcher.ExportState();
+    ASSERT_EQ(state.iterations_size(), 1);
+    iteration_id = state.iterations(0).iteration_id();
+
+    for (int64_t i = 0; i < kNumSplits; ++i) {
+      TF_ASSERT_OK_AND_ASSIGN(int64_t split,
+                              GetSplit(dispatcher, iteration_id));
+      EXPECT_EQ(split, i);
+    }
+
+    // Waits for the maintenance thread to compact the produced splits.
+    while (true) {
+      absl::StatusOr<int64_t> num_updates = NumJournalUpdates(work_dir);
+      if (num_updates.ok() && *num_updates < kNumSplits) {
+        break;
+      }
+      Env::Default()->SleepForMicroseconds(10 * 1000);
+    }
+  }
+
+  DataServiceDispatcherImpl restarted_dispatcher(config);
+  TF_ASSERT_OK(restarted_dispatcher.Start());
+  TF_ASSERT_OK_AND_ASSIGN(int64_t split,
+                          GetSplit(restarted_dispatcher, iteration_id));
+  EXPECT_EQ(split, kNumSplits);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -99,7 +99,8 @@ void DispatcherState::RegisterDataset(
     const RegisterDatasetUpdate& register_dataset) {
   std::string dataset_id = register_dataset.dataset_id();
   auto dataset =
-      std::make_shared<Dataset>(dataset_id, register_dataset.metadata());
+      std::make_shared<Dataset>(dataset_id, register_dataset.fingerprint(),
+                                register_dataset.metadata());
   DCHECK(!datasets_by_id_.contains(dataset_id));
   datasets_by_id_[dataset_id] = dataset;
   UpdateNextAvailableDatasetId();
@@ -126,7 +127,8 @@ void DispatcherState::CreateJob(const CreateJobUpdate& create_job) {
   auto job = std::make_shared<Job>(
       job_id, create_job.dataset_id(), create_job.processing_mode_def(),
       job_name, num_consumers, create_job.use_cross_trainer_cache(),
-      create_job.target_workers());
+      create_job.target_workers(), create_job.compression_codec(),
+      create_job.use_cross_job_cache());
   DCHECK(!jobs_by_id_.contains(job_id));
   jobs_by_id_[job_id] = job;
   DCHECK(!jobs_by_name_.contains(job_name));
@@ -184,6 +186,11 @@ void DispatcherState::ProduceSplit(const ProduceSplitUpdate& produce_split) {
   int64_t provider_index = produce_split.split_provider_index();
   DCHECK_GE(produce_split.repetition(), state.repetitions[provider_index]);
   state.repetitions[provider_index] = produce_split.repetition();
+  if (produce_split.optional_split_index_case() ==
+      ProduceSplitUpdate::kSplitIndex) {
+    state.indices[provider_index] = produce_split.split_index();
+    return;
+  }
   if (produce_split.finished()) {
     state.repetitions[provider_index]++;
     state.indices[provider_index] = 0;
@@ -75,11 +75,15 @@ class DispatcherState {
 
   // A dataset registered with the dispatcher.
   struct Dataset {
-    explicit Dataset(const std::string& dataset_id,
+    explicit Dataset(const std::string& dataset_id, uint64_t fingerprint,
                      const DataServiceMetadata& metadata)
-        : dataset_id(dataset_id), metadata(metadata) {}
+        : dataset_id(dataset_id),
+          fingerprint(fingerprint),
+          metadata(metadata) {}
 
     const std::string dataset_id;
+    // The fingerprint of the dataset graph.
+    const uint64_t fingerprint;
     const DataServiceMetadata metadata;
   };
 
@@ -153,14 +157,17 @@ class DispatcherState {
     explicit Job(int64_t id, const std::string& dataset_id,
                  const ProcessingModeDef& processing_mode, std::string job_name,
                  std::optional<int64_t> num_consumers,
-                 bool use_cross_trainer_cache, TargetWorkers target_workers)
+                 bool use_cross_trainer_cache, TargetWorkers target_workers,
+                 std::string compression_codec, bool use_cross_job_cache)
         : id(id),
           dataset_id(dataset_id),
           processing_mode(processing_mode),
           job_name(job_name),
           num_consumers(num_consumers),
           use_cross_trainer_cache(use_cross_trainer_cache),
-          target_workers(target_workers) {}
+          target_workers(target_workers),
+          compression_codec(std::move(compression_codec)),
+          use_cross_job_cache(use_cross_job_cache) {}
 
     const int64_t id;
     const std::string dataset_id;
@@ -169,6 +176,12 @@ class DispatcherState {
     const std::optional<int64_t> num_consumers;
     const bool use_cross_trainer_cache;
     const TargetWorkers target_workers;
+    // The element codec chosen for the job, or empty to use the dataset's
+    // compression.
+    const std::string compression_codec;
+    // Whether workers share the job's elements with other jobs that read a
+    // dataset with the same fingerprint.
+    const bool use_cross_job_cache;
   };
 
   // An iteration for processing a dataset.
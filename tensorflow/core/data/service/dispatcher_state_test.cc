@@ -660,5 +660,53 @@ TEST(DispatcherState, GetNumberOfRegisteredWorkers) {
   EXPECT_EQ(state.GetNumberOfRegisteredWorkers(), 2);
 }
 
+TEST(DispatcherState, ProduceSplitsFromCompactedJournal) {
+  const std::string dataset_id = "dataset_id";
+  const int64_t iteration_id = 3;
+  DispatcherState state;
+  TF_EXPECT_OK(RegisterDataset(dataset_id, state));
+  const int64_t job_id = state.NextAvailableJobId();
+  {
+    Update update;
+    CreateJobUpdate* create_job = update.mutable_create_job();
+    create_job->set_job_id(job_id);
+    create_job->set_dataset_id(dataset_id);
+    create_job->mutable_processing_mode_def()->set_sharding_policy(
+        ProcessingModeDef::DYNAMIC);
+    TF_EXPECT_OK(state.Apply(update));
+  }
+  {
+    Update update;
+    CreateIterationUpdate* create_iteration = update.mutable_create_iteration();
+    create_iteration->set_job_id(job_id);
+    create_iteration->set_iteration_id(iteration_id);
+    create_iteration->set_num_split_providers(1);
+    TF_EXPECT_OK(state.Apply(update));
+  }
+  {
+    Update update;
+    ProduceSplitUpdate* produce_split = update.mutable_produce_split();
+    produce_split->set_iteration_id(iteration_id);
+    produce_split->set_repetition(2);
+    produce_split->set_split_index(5);
+    TF_EXPECT_OK(state.Apply(update));
+  }
+  std::shared_ptr<const Iteration> iteration;
+  TF_EXPECT_OK(state.IterationFromId(iteration_id, iteration));
+  ASSERT_TRUE(iteration->distributed_epoch_state.has_value());
+  EXPECT_EQ(iteration->distributed_epoch_state->repetitions[0], 2);
+  EXPECT_EQ(iteration->distributed_epoch_state->indices[0], 5);
+
+  // Splits produced after the compacted journal continue from its position.
+  {
+    Update update;
+    ProduceSplitUpdate* produce_split = update.mutable_produce_split();
+    produce_split->set_iteration_id(iteration_id);
+    produce_split->set_repetition(2);
+    TF_EXPECT_OK(state.Apply(update));
+  }
+  EXPECT_EQ(iteration->distributed_epoch_state->indices[0], 6);
+}
+
 }  // namespace data
 }  // namespace tensorflow
@@ -16,12 +16,21 @@ limitations under the License.
 #include "tensorflow/core/data/service/journal.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
 #include "tensorflow/core/data/service/journal.pb.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/record_writer.h"
@@ -29,21 +38,123 @@ limitations under the License.
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/regexp.h"
+#include "tensorflow/core/platform/statusor.h"
 
 namespace tensorflow {
 namespace data {
 
 namespace {
 constexpr absl::string_view kJournal = "journal";
+constexpr absl::string_view kCompactedJournal = "compacted_journal";
+// Suffix of compacted journal files which are being written.
+constexpr absl::string_view kTempFileSuffix = ".tmp";
 
-absl::Status ParseSequenceNumber(const std::string& journal_file,
+absl::Status ParseSequenceNumber(absl::string_view journal_file,
                                  int64_t* sequence_number) {
-  if (!RE2::FullMatch(journal_file, ".*_(\\d+)", sequence_number)) {
+  const std::string name(absl::StripSuffix(journal_file, kTempFileSuffix));
+  if (!RE2::FullMatch(name, ".*_(\\d+)", sequence_number)) {
     return absl::InvalidArgumentError(
         absl::StrCat("Failed to parse journal file name: ", journal_file));
   }
   return absl::OkStatus();
 }
+
+bool IsCompactedJournalFile(absl::string_view journal_file) {
+  return absl::StartsWith(journal_file, kCompactedJournal) &&
+         !absl::EndsWith(journal_file, kTempFileSuffix);
+}
+
+// The position of a split provider in a compacted journal.
+struct SplitPosition {
+  int64_t repetition = 0;
+  int64_t split_index = 0;
+  // Index of the last split update of the split provider in the journal.
+  int64_t last_update = 0;
+};
+
+// Split providers are identified by iteration id and split provider index.
+using SplitPositions =
+    absl::flat_hash_map<std::pair<int64_t, int64_t>, SplitPosition>;
+
+// Reads the journal files in `journal_dir` before `sequence_number` and
+// returns the final position of each split provider. Sets `num_updates` to the
+// number of updates read.
+absl::StatusOr<SplitPositions> GetSplitPositions(
+    Env* env, const std::string& journal_dir, int64_t sequence_number,
+    int64_t& num_updates) {
+  SplitPositions split_positions;
+  FileJournalReader reader(env, journal_dir, sequence_number);
+  Update update;
+  bool end_of_journal = false;
+  num_updates = 0;
+  TF_RETURN_IF_ERROR(reader.Read(update, end_of_journal));
+  for (; !end_of_journal; ++num_updates) {
+    if (update.has_produce_split()) {
+      const ProduceSplitUpdate& produce_split = update.produce_split();
+      SplitPosition& position =
+          split_positions[{produce_split.iteration_id(),
+                           produce_split.split_provider_index()}];
+      // Mirrors `DispatcherState::ProduceSplit`.
+      position.repetition = produce_split.repetition();
+      if (produce_split.optional_split_index_case() ==
+          ProduceSplitUpdate::kSplitIndex) {
+        position.split_index = produce_split.split_index();
+      } else if (produce_split.finished()) {
+        ++position.repetition;
+        position.split_index = 0;
+      } else {
+        ++position.split_index;
+      }
+      position.last_update = num_updates;
+    }
+    TF_RETURN_IF_ERROR(reader.Read(update, end_of_journal));
+  }
+  return split_positions;
+}
+
+// Writes the compacted updates of the journal files in `journal_dir` before
+// `sequence_number` to `filename`. Returns the number of updates written.
+absl::StatusOr<int64_t> WriteCompactedJournal(
+    Env* env, const std::string& journal_dir, int64_t sequence_number,
+    const SplitPositions& split_positions, const std::string& filename) {
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(filename, &file));
+  io::RecordWriter writer(file.get());
+  FileJournalReader reader(env, journal_dir, sequence_number);
+  Update update;
+  bool end_of_journal = false;
+  int64_t num_compacted_updates = 0;
+  TF_RETURN_IF_ERROR(reader.Read(update, end_of_journal));
+  for (int64_t i = 0; !end_of_journal; ++i) {
+    if (update.has_produce_split()) {
+      const ProduceSplitUpdate& produce_split = update.produce_split();
+      const SplitPosition& position = split_positions.at(
+          {produce_split.iteration_id(), produce_split.split_provider_index()});
+      if (i == position.last_update) {
+        Update compacted_update;
+        ProduceSplitUpdate* compacted_produce_split =
+            compacted_update.mutable_produce_split();
+        compacted_produce_split->set_iteration_id(produce_split.iteration_id());
+        compacted_produce_split->set_split_provider_index(
+            produce_split.split_provider_index());
+        compacted_produce_split->set_repetition(position.repetition);
+        compacted_produce_split->set_split_index(position.split_index);
+        TF_RETURN_IF_ERROR(
+            writer.WriteRecord(compacted_update.SerializeAsString()));
+        ++num_compacted_updates;
+      }
+    } else {
+      TF_RETURN_IF_ERROR(writer.WriteRecord(update.SerializeAsString()));
+      ++num_compacted_updates;
+    }
+    TF_RETURN_IF_ERROR(reader.Read(update, end_of_journal));
+  }
+  TF_RETURN_IF_ERROR(writer.Flush());
+  TF_RETURN_IF_ERROR(file->Sync());
+  TF_RETURN_IF_ERROR(writer.Close());
+  TF_RETURN_IF_ERROR(file->Close());
+  return num_compacted_updates;
+}
 }  // namespace
 
 std::string DataServiceJournalFile(const std::string& journal_dir,
@@ -52,6 +163,49 @@ std::string DataServiceJournalFile(const std::string& journal_dir,
                       absl::StrCat(kJournal, "_", sequence_number));
 }
 
+std::string DataServiceCompactedJournalFile(const std::string& journal_dir,
+                                            int64_t sequence_number) {
+  return io::JoinPath(journal_dir,
+                      absl::StrCat(kCompactedJournal, "_", sequence_number));
+}
+
+absl::Status CompactJournal(Env* env, const std::string& journal_dir,
+                            int64_t sequence_number) {
+  int64_t num_updates = 0;
+  absl::StatusOr<SplitPositions> split_positions =
+      GetSplitPositions(env, journal_dir, sequence_number, num_updates);
+  if (absl::IsNotFound(split_positions.status())) {
+    VLOG(1) << "No journal to compact in " << journal_dir;
+    return absl::OkStatus();
+  }
+  TF_RETURN_IF_ERROR(split_positions.status());
+
+  // Writes the compacted journal to a temporary file first, so that a partial
+  // compacted journal is never read.
+  const std::string compacted_journal_file =
+      DataServiceCompactedJournalFile(journal_dir, sequence_number);
+  const std::string temp_file =
+      absl::StrCat(compacted_journal_file, kTempFileSuffix);
+  TF_ASSIGN_OR_RETURN(
+      int64_t num_compacted_updates,
+      WriteCompactedJournal(env, journal_dir, sequence_number,
+                            *split_positions, temp_file));
+  TF_RETURN_IF_ERROR(env->RenameFile(temp_file, compacted_journal_file));
+
+  std::vector<std::string> journal_files;
+  TF_RETURN_IF_ERROR(env->GetChildren(journal_dir, &journal_files));
+  for (const std::string& file : journal_files) {
+    int64_t file_sequence_number;
+    TF_RETURN_IF_ERROR(ParseSequenceNumber(file, &file_sequence_number));
+    if (file_sequence_number < sequence_number) {
+      TF_RETURN_IF_ERROR(env->DeleteFile(io::JoinPath(journal_dir, file)));
+    }
+  }
+  LOG(INFO) << "Compacted " << num_updates << " journal updates into "
+            << num_compacted_updates << " in " << compacted_journal_file;
+  return absl::OkStatus();
+}
+
 FileJournalWriter::FileJournalWriter(Env* env, const std::string& journal_dir)
     : env_(env), journal_dir_(journal_dir) {}
 
@@ -63,19 +217,44 @@ absl::Status FileJournalWriter::EnsureInitialized() {
   TF_RETURN_IF_ERROR(env_->RecursivelyCreateDir(journal_dir_));
   TF_RETURN_IF_ERROR(env_->GetChildren(journal_dir_, &journal_files));
   int64_t latest_sequence_number = -1;
+  // Journal files before the latest compacted journal may have been deleted.
+  int64_t compacted_sequence_number = 0;
   for (const auto& file : journal_files) {
+    if (absl::EndsWith(file, kTempFileSuffix)) {
+      continue;
+    }
     int64_t sequence_number;
     TF_RETURN_IF_ERROR(ParseSequenceNumber(file, &sequence_number));
-    latest_sequence_number = std::max(latest_sequence_number, sequence_number);
+    if (IsCompactedJournalFile(file)) {
+      compacted_sequence_number =
+          std::max(compacted_sequence_number, sequence_number);
+    } else {
+      latest_sequence_number =
+          std::max(latest_sequence_number, sequence_number);
+    }
   }
+  sequence_number_ =
+      std::max(latest_sequence_number + 1, compacted_sequence_number);
   std::string journal_file =
-      DataServiceJournalFile(journal_dir_, latest_sequence_number + 1);
+      DataServiceJournalFile(journal_dir_, sequence_number_);
   TF_RETURN_IF_ERROR(env_->NewAppendableFile(journal_file, &file_));
   writer_ = std::make_unique<io::RecordWriter>(file_.get());
   VLOG(1) << "Created journal writer to write to " << journal_file;
   return absl::OkStatus();
 }
 
+absl::StatusOr<int64_t> FileJournalWriter::Rotate() {
+  TF_RETURN_IF_ERROR(EnsureInitialized());
+  absl::Status status = writer_->Close();
+  status.Update(file_->Close());
+  writer_.reset();
+  file_.reset();
+  TF_RETURN_IF_ERROR(status);
+  // Starts a new file after the closed one.
+  TF_RETURN_IF_ERROR(EnsureInitialized());
+  return sequence_number_;
+}
+
 absl::Status FileJournalWriter::Write(const Update& update) {
   TF_RETURN_IF_ERROR(EnsureInitialized());
   std::string s = update.SerializeAsString();
@@ -95,11 +274,43 @@ absl::Status FileJournalWriter::Write(const Update& update) {
 FileJournalReader::FileJournalReader(Env* env, absl::string_view journal_dir)
     : env_(env), journal_dir_(journal_dir) {}
 
+FileJournalReader::FileJournalReader(Env* env, absl::string_view journal_dir,
+                                     int64_t end_sequence_number)
+    : env_(env),
+      journal_dir_(journal_dir),
+      end_sequence_number_(end_sequence_number) {}
+
 absl::Status FileJournalReader::EnsureInitialized() {
   if (reader_) {
     return absl::OkStatus();
   }
-  return UpdateFile(DataServiceJournalFile(journal_dir_, 0));
+  std::vector<std::string> journal_files;
+  absl::Status status = env_->GetChildren(journal_dir_, &journal_files);
+  if (!status.ok() && !absl::IsNotFound(status)) {
+    return status;
+  }
+  std::optional<int64_t> compacted_sequence_number;
+  for (const std::string& file : journal_files) {
+    if (!IsCompactedJournalFile(file)) {
+      continue;
+    }
+    int64_t sequence_number;
+    TF_RETURN_IF_ERROR(ParseSequenceNumber(file, &sequence_number));
+    if (end_sequence_number_.has_value() &&
+        sequence_number > *end_sequence_number_) {
+      continue;
+    }
+    compacted_sequence_number =
+        std::max(compacted_sequence_number.value_or(0), sequence_number);
+  }
+  if (!compacted_sequence_number.has_value()) {
+    return UpdateFile(DataServiceJournalFile(journal_dir_, 0));
+  }
+  // The compacted journal replaces the journal files before it.
+  sequence_number_ = *compacted_sequence_number;
+  reading_compacted_journal_ = true;
+  return UpdateFile(
+      DataServiceCompactedJournalFile(journal_dir_, sequence_number_));
 }
 
 absl::Status FileJournalReader::Read(Update& update, bool& end_of_journal) {
@@ -108,10 +319,16 @@ absl::Status FileJournalReader::Read(Update& update, bool& end_of_journal) {
     tstring record;
     absl::Status s = reader_->ReadRecord(&record);
     if (absl::IsOutOfRange(s)) {
-      sequence_number_++;
+      if (reading_compacted_journal_) {
+        reading_compacted_journal_ = false;
+      } else {
+        sequence_number_++;
+      }
       std::string next_journal_file =
           DataServiceJournalFile(journal_dir_, sequence_number_);
-      if (absl::IsNotFound(env_->FileExists(next_journal_file))) {
+      if ((end_sequence_number_.has_value() &&
+           sequence_number_ >= *end_sequence_number_) ||
+          absl::IsNotFound(env_->FileExists(next_journal_file))) {
         VLOG(3) << "Next journal file " << next_journal_file
                 << " does not exist. End of journal reached.";
         end_of_journal = true;
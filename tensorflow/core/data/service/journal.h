@@ -15,9 +15,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_JOURNAL_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_JOURNAL_H_
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
+#include "absl/status/statusor.h"
 #include "tensorflow/core/data/service/journal.pb.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/io/record_reader.h"
@@ -31,6 +34,21 @@ namespace data {
 std::string DataServiceJournalFile(const std::string& journal_dir,
                                    int64_t sequence_number);
 
+// Returns the location of the compacted journal file which replaces the journal
+// files before `sequence_number`.
+std::string DataServiceCompactedJournalFile(const std::string& journal_dir,
+                                            int64_t sequence_number);
+
+// Compacts the journal files in `journal_dir` before `sequence_number` into a
+// compacted journal file, then deletes them. The compacted journal restores
+// the same dispatcher state with fewer updates: the split updates of each split
+// provider are replaced with a single update recording its final position.
+//
+// The journal files before `sequence_number` must no longer be written to, see
+// `JournalWriter::Rotate`.
+absl::Status CompactJournal(Env* env, const std::string& journal_dir,
+                            int64_t sequence_number);
+
 // Interface for writing to a journal.
 class JournalWriter {
  public:
@@ -39,6 +57,10 @@ class JournalWriter {
   virtual absl::Status Write(const Update& update) = 0;
   // Initializes the writer if it is not yet initialized.
   virtual absl::Status EnsureInitialized() = 0;
+  // Closes the current journal file and writes subsequent updates to a new
+  // one. Returns the sequence number of the new file. The files before it are
+  // no longer written to and may be compacted.
+  virtual absl::StatusOr<int64_t> Rotate() = 0;
 };
 
 // FileJournalWriter is not thread-safe, requiring external synchronization when
@@ -57,6 +79,9 @@ class JournalWriter {
 // "journal_0", "journal_1", and "journal_2", the writer will write to
 // "journal_3". The writer will flush updates as they are written, so that they
 // can be stored durably in case of machine failure.
+//
+// After compaction, the journal files before sequence number N are replaced
+// with a "compacted_journal_N" file, which is read before "journal_N".
 class FileJournalWriter : public JournalWriter {
  public:
   // Creates a journal writer to write to the given journal directory.
@@ -68,10 +93,13 @@ class FileJournalWriter : public JournalWriter {
 
   absl::Status Write(const Update& update) override;
   absl::Status EnsureInitialized() override;
+  absl::StatusOr<int64_t> Rotate() override;
 
  private:
   Env* env_;
   const std::string journal_dir_;
+  // Sequence number of current journal file.
+  int64_t sequence_number_ = 0;
   std::unique_ptr<WritableFile> file_;
   std::unique_ptr<io::RecordWriter> writer_;
 };
@@ -89,10 +117,15 @@ class JournalReader {
 // used by multiple threads.
 //
 // The journal reader reads through all journal files in the configured journal
-// directory, in order of their sequence numbers. See FileJournalWriter above.
+// directory, in order of their sequence numbers, starting with the latest
+// compacted journal file if any. See FileJournalWriter above.
 class FileJournalReader : public JournalReader {
  public:
   explicit FileJournalReader(Env* env, absl::string_view journal_dir);
+  // Creates a reader which stops before the journal file with
+  // `end_sequence_number`.
+  FileJournalReader(Env* env, absl::string_view journal_dir,
+                    int64_t end_sequence_number);
   FileJournalReader(const FileJournalReader&) = delete;
   FileJournalReader& operator=(const FileJournalReader&) = delete;
 
@@ -106,8 +139,11 @@ class FileJournalReader : public JournalReader {
 
   Env* env_;
   const std::string journal_dir_;
+  const std::optional<int64_t> end_sequence_number_;
   // Sequence number of current journal file.
   int64_t sequence_number_ = 0;
+  // Whether the current file is a compacted journal file.
+  bool reading_compacted_journal_ = false;
   std::unique_ptr<RandomAccessFile> file_;
   std::unique_ptr<io::SequentialRecordReader> reader_;
 };
@@ -57,7 +57,7 @@ absl::Status DataServiceSplitProvider::GetNext(Tensor* split,
       [this, dispatcher, repetition, split, end_of_splits]() {
         return dispatcher->GetSplit(iteration_id_, repetition,
                                     split_provider_index_, *split,
-                                    *end_of_splits);
+                                    *end_of_splits, task_id_);
       },
       [this]() {
         mutex_lock l(mu_);
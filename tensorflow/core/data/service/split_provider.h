@@ -37,10 +37,12 @@ class DataServiceSplitProvider : public SplitProvider {
  public:
   DataServiceSplitProvider(const std::string& address,
                            const std::string& protocol, int64_t iteration_id,
-                           int64_t split_provider_index, int64_t timeout_ms)
+                           int64_t task_id, int64_t split_provider_index,
+                           int64_t timeout_ms)
       : address_(address),
         protocol_(protocol),
         iteration_id_(iteration_id),
+        task_id_(task_id),
         split_provider_index_(split_provider_index),
         timeout_ms_(timeout_ms) {}
 
@@ -56,6 +58,7 @@ class DataServiceSplitProvider : public SplitProvider {
   const std::string address_;
   const std::string protocol_;
   const int64_t iteration_id_;
+  const int64_t task_id_;
   const int64_t split_provider_index_;
   const int64_t timeout_ms_;
 
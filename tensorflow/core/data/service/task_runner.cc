@@ -15,12 +15,16 @@ limitations under the License.
 #include "tensorflow/core/data/service/task_runner.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <utility>
 #include <vector>
 
+#include "absl/time/time.h"
+#include "tensorflow/core/data/compression_utils.h"
 #include "tensorflow/core/data/metric_utils.h"
+#include "tensorflow/core/data/service/adaptive_compression.h"
 #include "tensorflow/core/data/service/byte_size.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/cross_trainer_cache.h"
@@ -30,10 +34,13 @@ limitations under the License.
 #include "tensorflow/core/data/standalone.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
@@ -94,6 +101,47 @@ void StandaloneTaskIterator::Cancel() {
   }
 }
 
+CompressingTaskIterator::CompressingTaskIterator(
+    std::unique_ptr<TaskIterator> iterator,
+    std::shared_ptr<CompressionCodecSelector> selector)
+    : iterator_(std::move(iterator)), selector_(std::move(selector)) {}
+
+absl::Status CompressingTaskIterator::GetNext(std::vector<Tensor>& element,
+                                              bool& end_of_sequence) {
+  const absl::Time start_time = absl::Now();
+  TF_RETURN_IF_ERROR(iterator_->GetNext(element, end_of_sequence));
+  if (end_of_sequence) {
+    return absl::OkStatus();
+  }
+  CompressedElement compressed;
+  TF_RETURN_IF_ERROR(CompressElement(element, selector_->Codec(), &compressed));
+  Tensor tensor(DT_VARIANT, TensorShape({}));
+  tensor.scalar<Variant>()() = std::move(compressed);
+  element.clear();
+  element.push_back(std::move(tensor));
+  selector_->RecordWorkerTime(absl::Now() - start_time);
+  return absl::OkStatus();
+}
+
+int64_t CompressingTaskIterator::Cardinality() const {
+  return iterator_->Cardinality();
+}
+
+absl::StatusOr<std::vector<Tensor>> CompressingTaskIterator::Save() {
+  return iterator_->Save();
+}
+
+absl::Status CompressingTaskIterator::Restore(
+    const std::vector<Tensor>& saved_iterator) {
+  return iterator_->Restore(saved_iterator);
+}
+
+std::shared_ptr<model::Model> CompressingTaskIterator::model() const {
+  return iterator_->model();
+}
+
+void CompressingTaskIterator::Cancel() { iterator_->Cancel(); }
+
 absl::Status TaskRunner::Create(const experimental::WorkerConfig& worker_config,
                                 const TaskDef& task_def,
                                 std::unique_ptr<TaskIterator> iterator,
@@ -119,14 +167,16 @@ absl::Status TaskRunner::Create(const experimental::WorkerConfig& worker_config,
     out = std::make_unique<CachingTaskRunner>(std::move(iterator),
                                               max_cache_size_bytes);
   } else {
-    out = std::make_unique<FirstComeFirstServedTaskRunner>(std::move(iterator));
+    out = std::make_unique<FirstComeFirstServedTaskRunner>(
+        std::move(iterator),
+        std::max<int64_t>(worker_config.task_buffer_size(), 1));
   }
   return absl::OkStatus();
 }
 
 FirstComeFirstServedTaskRunner::FirstComeFirstServedTaskRunner(
-    std::unique_ptr<TaskIterator> iterator)
-    : iterator_(std::move(iterator)), buffer_(/*buffer_size=*/1) {
+    std::unique_ptr<TaskIterator> iterator, int64_t buffer_size)
+    : iterator_(std::move(iterator)), buffer_(buffer_size) {
   RunPrefetchThread();
 }
 
@@ -198,6 +248,10 @@ std::shared_ptr<model::Model> FirstComeFirstServedTaskRunner::model() const {
   return model_;
 }
 
+int64_t FirstComeFirstServedTaskRunner::NumBufferedElements() const {
+  return buffer_.Size();
+}
+
 CachingTaskRunner::CachingTaskRunner(std::unique_ptr<TaskIterator> iterator,
                                      size_t max_cache_size_bytes)
     : fcfs_task_runner_(std::move(iterator)),
@@ -15,10 +15,12 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DATA_SERVICE_TASK_RUNNER_H_
 #define TENSORFLOW_CORE_DATA_SERVICE_TASK_RUNNER_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <vector>
 
+#include "tensorflow/core/data/service/adaptive_compression.h"
 #include "tensorflow/core/data/service/common.pb.h"
 #include "tensorflow/core/data/service/cross_trainer_cache.h"
 #include "tensorflow/core/data/service/data_transfer.h"
@@ -95,6 +97,27 @@ class StandaloneTaskIterator : public TaskIterator {
   std::unique_ptr<IteratorMetricsCollector> metrics_collector_;
 };
 
+// Implementation of TaskIterator which compresses the elements of another
+// iterator with the codec chosen by `selector`. Each element is replaced by a
+// scalar variant tensor holding a `CompressedElement`, as produced by the
+// compression map that tf.data service adds to compressed datasets.
+class CompressingTaskIterator : public TaskIterator {
+ public:
+  CompressingTaskIterator(std::unique_ptr<TaskIterator> iterator,
+                          std::shared_ptr<CompressionCodecSelector> selector);
+  absl::Status GetNext(std::vector<Tensor>& element,
+                       bool& end_of_sequence) override;
+  int64_t Cardinality() const override;
+  absl::StatusOr<std::vector<Tensor>> Save() override;
+  absl::Status Restore(const std::vector<Tensor>& saved_iterator) override;
+  std::shared_ptr<model::Model> model() const override;
+  void Cancel() override;
+
+ private:
+  const std::unique_ptr<TaskIterator> iterator_;
+  const std::shared_ptr<CompressionCodecSelector> selector_;
+};
+
 // Interface for providing elements to task consumers.
 class TaskRunner {
  public:
@@ -111,14 +134,18 @@ class TaskRunner {
   virtual void Cancel() = 0;
   // Returns the dataset model for performance analysis.
   virtual std::shared_ptr<model::Model> model() const = 0;
+  // Returns the number of elements prepared ahead of requests.
+  virtual int64_t NumBufferedElements() const { return 0; }
 };
 
 // A task runner which provides elements on a first-come first-served basis.
 // It does not consider which consumer is making the request.
 class FirstComeFirstServedTaskRunner : public TaskRunner {
  public:
+  // Creates a task runner that prefetches up to `buffer_size` elements.
+  // REQUIRES: buffer_size > 0
   explicit FirstComeFirstServedTaskRunner(
-      std::unique_ptr<TaskIterator> iterator);
+      std::unique_ptr<TaskIterator> iterator, int64_t buffer_size = 1);
   ~FirstComeFirstServedTaskRunner() override;
 
   // Gets the next element. It may block if the element is not ready yet.
@@ -130,6 +157,8 @@ class FirstComeFirstServedTaskRunner : public TaskRunner {
 
   std::shared_ptr<model::Model> model() const override;
 
+  int64_t NumBufferedElements() const override;
+
  private:
   // Function to continually prefetch the next element. Returns an error if the
   // task has been cancelled.
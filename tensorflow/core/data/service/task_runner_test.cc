@@ -23,12 +23,16 @@ limitations under the License.
 #include <vector>
 
 #include "absl/memory/memory.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/data/service/adaptive_compression.h"
 #include "tensorflow/core/data/service/data_transfer.h"
 #include "tensorflow/core/data/service/worker.pb.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
@@ -200,6 +204,35 @@ absl::Status RunConsumer(int64_t consumer_index, int64_t start_index,
 }
 }  // namespace
 
+TEST(CompressingTaskIteratorTest, CompressesElements) {
+  constexpr int64_t kRange = 10;
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<CompressionCodecSelector> selector,
+                          CompressionCodecSelector::Create("none"));
+  CompressingTaskIterator iterator(
+      std::make_unique<RangeIterator>(kRange, /*repeat=*/false),
+      std::move(selector));
+  EXPECT_EQ(iterator.Cardinality(), kRange);
+  for (int64_t i = 0; i < kRange; ++i) {
+    std::vector<Tensor> element;
+    bool end_of_sequence = true;
+    TF_ASSERT_OK(iterator.GetNext(element, end_of_sequence));
+    ASSERT_FALSE(end_of_sequence);
+    ASSERT_THAT(element, SizeIs(1));
+    ASSERT_EQ(element[0].dtype(), DT_VARIANT);
+    const CompressedElement* compressed =
+        element[0].scalar<Variant>()().get<CompressedElement>();
+    ASSERT_NE(compressed, nullptr);
+    EXPECT_EQ(compressed->codec(), "none");
+    std::vector<Tensor> uncompressed;
+    TF_ASSERT_OK(UncompressElement(*compressed, &uncompressed));
+    test::ExpectEqual(uncompressed[0], Tensor{i});
+  }
+  std::vector<Tensor> element;
+  bool end_of_sequence = false;
+  TF_ASSERT_OK(iterator.GetNext(element, end_of_sequence));
+  EXPECT_TRUE(end_of_sequence);
+}
+
 TEST(FirstComeFirstServedTaskRunnerTest, GetNext) {
   size_t range = 10;
   FirstComeFirstServedTaskRunner runner(
@@ -106,6 +106,7 @@ absl::Status TestCluster::AddWorker(
       port.has_value() ? absl::StrCat("localhost:", *port) : "localhost:%port%";
   config.set_worker_address(worker_address);
   config.set_heartbeat_interval_ms(config_.worker_heartbeat_interval_ms);
+  config.set_task_buffer_size(config_.worker_task_buffer_size);
   TF_RETURN_IF_ERROR(NewWorkerServer(config, worker));
   TF_RETURN_IF_ERROR(worker->Start());
   worker_addresses_.push_back(absl::StrCat("localhost:", worker->BoundPort()));
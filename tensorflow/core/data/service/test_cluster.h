@@ -55,6 +55,7 @@ class TestCluster {
     int64_t job_gc_check_interval_ms = 0;
     int64_t job_gc_timeout_ms = 0;
     int64_t worker_max_concurrent_snapshots = 0;
+    int64_t worker_task_buffer_size = 0;
     std::string work_dir;
   };
 
@@ -215,7 +216,8 @@ absl::StatusOr<int64_t> DatasetClient<T>::CreateIteration(
   TF_RETURN_IF_ERROR(dispatcher_client_->GetOrCreateJob(
       dataset_id, processing_mode_def, /*job_name=*/std::nullopt,
       /*num_consumers=*/std::nullopt, /*use_cross_trainer_cache=*/false,
-      target_workers, job_id));
+      /*use_cross_job_cache=*/false,
+      target_workers, /*compression_codec=*/"", job_id));
   int64_t iteration_client_id;
   TF_RETURN_IF_ERROR(dispatcher_client_->GetOrCreateIteration(
       job_id, /*repetition=*/0, iteration_client_id));
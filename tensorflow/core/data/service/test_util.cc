@@ -31,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/function_testlib.h"
 #include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/node_def.pb.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
@@ -80,6 +81,43 @@ FunctionDef XTimesX() {
       /*ret_def=*/{{"y", "y:z:0"}});
 }
 
+FunctionDef RangeOfSize(int64_t size) {
+  return FunctionDefHelper::Create(
+      /*function_name=*/"RangeOfSize",
+      /*in_def=*/{"x: int64"},
+      /*out_def=*/{"y: int64"},
+      /*attr_def=*/{},
+      /*node_def=*/
+      {{{"size"},
+        "Const",
+        {},
+        {{"value", AsScalar<int64_t>(size)}, {"dtype", DT_INT64}}},
+       {{"one"},
+        "Const",
+        {},
+        {{"value", AsScalar<int64_t>(1)}, {"dtype", DT_INT64}}},
+       {{"limit"}, "Add", {"x", "size:output:0"}, {{"T", DT_INT64}}},
+       {{"y"},
+        "Range",
+        {"x", "limit:z:0", "one:output:0"},
+        {{"Tidx", DT_INT64}}}},
+      /*ret_def=*/{{"y", "y:output:0"}});
+}
+
+FunctionDef Compress() {
+  return FunctionDefHelper::Create(
+      /*function_name=*/"Compress",
+      /*in_def=*/{"x: int64"},
+      /*out_def=*/{"y: variant"},
+      /*attr_def=*/{},
+      /*node_def=*/
+      {{{"y"},
+        "CompressElement",
+        {"x"},
+        {{"input_types", absl::Span<const DataType>{DT_INT64}}}}},
+      /*ret_def=*/{{"y", "y:compressed:0"}});
+}
+
 absl::Status CreateTestFiles(const std::vector<tstring>& filenames,
                              const std::vector<tstring>& contents) {
   if (filenames.size() != contents.size()) {
@@ -188,6 +226,41 @@ DatasetDef RangeDatasetWithShardHint(const int64_t range) {
   return dataset_def;
 }
 
+DatasetDef CompressedRangeDataset(int64_t range, int64_t element_size) {
+  DatasetDef dataset_def;
+  *dataset_def.mutable_graph() = GDef(
+      {NDef("start", "Const", /*inputs=*/{},
+            {{"value", AsScalar<int64_t>(0)}, {"dtype", DT_INT64}}),
+       NDef("stop", "Const", /*inputs=*/{},
+            {{"value", AsScalar<int64_t>(range)}, {"dtype", DT_INT64}}),
+       NDef("step", "Const", /*inputs=*/{},
+            {{"value", AsScalar<int64_t>(1)}, {"dtype", DT_INT64}}),
+       NDef("range", "RangeDataset", /*inputs=*/{"start", "stop", "step"},
+            {{"output_shapes", absl::Span<const TensorShape>{TensorShape()}},
+             {"output_types", absl::Span<const DataType>{DT_INT64}}}),
+       NDef("map", "MapDataset", /*inputs=*/{"range"},
+            {{"f", FunctionDefHelper::FunctionRef("RangeOfSize")},
+             {"Targuments", {}},
+             {"output_shapes",
+              absl::Span<const TensorShape>{TensorShape({element_size})}},
+             {"output_types", absl::Span<const DataType>{DT_INT64}}}),
+       NDef("num_parallel_calls", "Const", /*inputs=*/{},
+            {{"value", AsScalar<int64_t>(model::kAutotune)},
+             {"dtype", DT_INT64}}),
+       NDef("compress", "ParallelMapDatasetV2",
+            /*inputs=*/{"map", "num_parallel_calls"},
+            {{"f", FunctionDefHelper::FunctionRef("Compress")},
+             {"Targuments", {}},
+             {"output_shapes", absl::Span<const TensorShape>{TensorShape()}},
+             {"output_types", absl::Span<const DataType>{DT_VARIANT}},
+             {"deterministic", "true"},
+             {"preserve_cardinality", true}}),
+       NDef("dataset", "_Retval", /*inputs=*/{"compress"},
+            {{"T", DT_VARIANT}, {"index", 0}})},
+      {RangeOfSize(element_size), Compress()});
+  return dataset_def;
+}
+
 DatasetDef InfiniteDataset() {
   DatasetDef dataset_def;
   *dataset_def.mutable_graph() = GDef(
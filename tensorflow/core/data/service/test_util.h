@@ -55,6 +55,13 @@ DatasetDef RangeSquareDataset(int64_t range);
 // tf.data.Dataset.range(range).shard(SHARD_HINT, SHARD_HINT).
 DatasetDef RangeDatasetWithShardHint(int64_t range);
 
+// Returns a test dataset representing
+// tf.data.Dataset.range(range).map(
+//     lambda x: tf.range(x, x + element_size)).map(compress)
+// where `compress` is the compression function tf.data service adds to
+// compressed datasets.
+DatasetDef CompressedRangeDataset(int64_t range, int64_t element_size);
+
 // Returns a test dataset representing
 // tf.data.Dataset.range(100000000).repeat().
 DatasetDef InfiniteDataset();
@@ -182,6 +182,19 @@ TEST_P(ThreadSafeBufferTest, BlockWriterWhenBufferIsFull) {
   EXPECT_LE(pop_time, push_time);
 }
 
+TEST_P(ThreadSafeBufferTest, Size) {
+  ThreadSafeBuffer<int> buffer(GetBufferSize());
+  EXPECT_EQ(buffer.Size(), 0);
+  for (size_t i = 0; i < GetBufferSize(); ++i) {
+    ASSERT_THAT(buffer.Push(i), absl_testing::IsOk());
+    EXPECT_EQ(buffer.Size(), i + 1);
+  }
+  for (size_t i = GetBufferSize(); i > 0; --i) {
+    ASSERT_THAT(buffer.Pop(), absl_testing::IsOk());
+    EXPECT_EQ(buffer.Size(), i - 1);
+  }
+}
+
 TEST_P(ThreadSafeBufferTest, CancelReaders) {
   ThreadSafeBuffer<int> buffer(GetBufferSize());
   std::vector<std::unique_ptr<Thread>> threads;
@@ -144,27 +144,13 @@ class GrpcDataTransferClient : public DataTransferClient {
                                                    end_time_us - start_time_us);
     result.end_of_sequence = resp.end_of_sequence();
     result.skip = resp.skip_task();
-    switch (resp.element_case()) {
-      case GetElementResponse::kCompressed: {
-        Tensor tensor(DT_VARIANT, TensorShape{});
-        tensor.scalar<Variant>()() = std::move(resp.compressed());
-        result.components.push_back(tensor);
-        break;
-      }
-      case GetElementResponse::kUncompressed:
-        for (const auto& component : resp.uncompressed().components()) {
-          result.components.emplace_back();
-          bool success =
-              allocator_ != nullptr
-                  ? result.components.back().FromProto(allocator_, component)
-                  : result.components.back().FromProto(component);
-          if (!success) {
-            return absl::InternalError("Failed to parse tensor.");
-          }
-        }
-        break;
-      case GetElementResponse::ELEMENT_NOT_SET:
-        break;
+    TF_RETURN_IF_ERROR(ParseElement(resp, result.components));
+    result.additional_elements.reserve(resp.additional_elements_size());
+    for (const AdditionalElement& element : resp.additional_elements()) {
+      GetElementResult& additional_element =
+          result.additional_elements.emplace_back();
+      additional_element.element_index = element.element_index();
+      TF_RETURN_IF_ERROR(ParseElement(element, additional_element.components));
     }
     return absl::OkStatus();
   }
@@ -179,6 +165,29 @@ class GrpcDataTransferClient : public DataTransferClient {
   }
 
  private:
+  // Parses the element of `resp`, a `GetElementResponse` or an
+  // `AdditionalElement`, into `components`.
+  template <class ResponseT>
+  absl::Status ParseElement(const ResponseT& resp,
+                            std::vector<Tensor>& components) const {
+    if (resp.has_compressed()) {
+      Tensor tensor(DT_VARIANT, TensorShape{});
+      tensor.scalar<Variant>()() = resp.compressed();
+      components.push_back(tensor);
+      return absl::OkStatus();
+    }
+    for (const auto& component : resp.uncompressed().components()) {
+      components.emplace_back();
+      bool success = allocator_ != nullptr
+                         ? components.back().FromProto(allocator_, component)
+                         : components.back().FromProto(component);
+      if (!success) {
+        return absl::InternalError("Failed to parse tensor.");
+      }
+    }
+    return absl::OkStatus();
+  }
+
   Allocator* const allocator_;
   mutex mu_;
   std::unique_ptr<WorkerService::Stub> stub_;
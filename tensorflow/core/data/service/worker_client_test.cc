@@ -18,9 +18,11 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/substitute.h"
 #include "absl/types/optional.h"
 #include "tensorflow/core/data/service/common.h"
@@ -51,6 +53,8 @@ namespace {
 
 using ::tensorflow::data::testing::RangeSquareDataset;
 using ::tensorflow::testing::StatusIs;
+using ::testing::ElementsAreArray;
+using ::testing::HasSubstr;
 using ::testing::MatchesRegex;
 
 constexpr const char kProtocol[] = "grpc";
@@ -87,7 +91,8 @@ class WorkerClientTest : public ::testing::TestWithParam<std::string> {
     TF_RETURN_IF_ERROR(dispatcher_client_->GetOrCreateJob(
         dataset_id, processing_mode, /*job_name=*/std::nullopt,
         /*num_consumers=*/std::nullopt, /*use_cross_trainer_cache=*/false,
-        TARGET_WORKERS_AUTO, job_id));
+        /*use_cross_job_cache=*/false,
+        TARGET_WORKERS_AUTO, /*compression_codec=*/"", job_id));
     int64_t iteration_client_id = 0;
     TF_RETURN_IF_ERROR(dispatcher_client_->GetOrCreateIteration(
         job_id, /*repetition=*/0, iteration_client_id));
@@ -126,6 +131,34 @@ class WorkerClientTest : public ::testing::TestWithParam<std::string> {
     return result;
   }
 
+  // Reads the elements of task `task_id` with requests for up to
+  // `max_elements` elements.
+  absl::StatusOr<std::vector<int64_t>> ReadBatched(
+      DataServiceWorkerClient& client, const int64_t task_id,
+      const int64_t max_elements) {
+    std::vector<int64_t> elements;
+    while (true) {
+      GetElementRequest request;
+      GetElementResult result;
+      request.set_task_id(task_id);
+      request.set_max_elements(max_elements);
+      TF_RETURN_IF_ERROR(client.GetElement(request, result));
+      if (result.end_of_sequence) {
+        return elements;
+      }
+      if (static_cast<int64_t>(result.additional_elements.size()) >=
+          max_elements) {
+        return absl::InternalError(
+            absl::StrCat("Got ", result.additional_elements.size() + 1,
+                         " elements for a request of ", max_elements));
+      }
+      elements.push_back(result.components[0].scalar<int64_t>()());
+      for (const GetElementResult& element : result.additional_elements) {
+        elements.push_back(element.components[0].scalar<int64_t>()());
+      }
+    }
+  }
+
   std::string GetDispatcherAddress() const {
     return test_cluster_->DispatcherAddress();
   }
@@ -277,6 +310,101 @@ TEST_P(DataTransferProtocolWorkerClientTest, NetworkRead) {
   }
 }
 
+TEST_F(WorkerClientTest, BatchedLocalRead) {
+  const int64_t range = 100;
+  TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id, RegisterDataset(range));
+  TF_ASSERT_OK_AND_ASSIGN(const int64_t iteration_client_id,
+                          CreateIteration(dataset_id));
+  TF_ASSERT_OK_AND_ASSIGN(const int64_t task_id,
+                          GetTaskToRead(iteration_client_id));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<DataServiceWorkerClient> client,
+                          GetWorkerClient(kLocalTransferProtocol));
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < range; ++i) {
+    expected.push_back(i * i);
+  }
+  EXPECT_THAT(ReadBatched(*client, task_id, /*max_elements=*/8),
+              absl_testing::IsOkAndHolds(ElementsAreArray(expected)));
+}
+
+TEST_F(WorkerClientTest, BatchedGrpcRead) {
+  LocalWorkers::Remove(GetWorkerAddress());
+  const int64_t range = 100;
+  TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id, RegisterDataset(range));
+  TF_ASSERT_OK_AND_ASSIGN(const int64_t iteration_client_id,
+                          CreateIteration(dataset_id));
+  TF_ASSERT_OK_AND_ASSIGN(const int64_t task_id,
+                          GetTaskToRead(iteration_client_id));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<DataServiceWorkerClient> client,
+                          GetWorkerClient(kGrpcTransferProtocol));
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < range; ++i) {
+    expected.push_back(i * i);
+  }
+  EXPECT_THAT(ReadBatched(*client, task_id, /*max_elements=*/8),
+              absl_testing::IsOkAndHolds(ElementsAreArray(expected)));
+}
+
+TEST_F(WorkerClientTest, BatchedReadReturnsEndOfSequenceSeparately) {
+  // The task ends in the middle of the first batch.
+  const int64_t range = 5;
+  TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id, RegisterDataset(range));
+  TF_ASSERT_OK_AND_ASSIGN(const int64_t iteration_client_id,
+                          CreateIteration(dataset_id));
+  TF_ASSERT_OK_AND_ASSIGN(const int64_t task_id,
+                          GetTaskToRead(iteration_client_id));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<DataServiceWorkerClient> client,
+                          GetWorkerClient(kLocalTransferProtocol));
+  std::vector<int64_t> elements;
+  while (true) {
+    GetElementRequest request;
+    GetElementResult result;
+    request.set_task_id(task_id);
+    request.set_max_elements(8);
+    TF_ASSERT_OK(client->GetElement(request, result));
+    if (result.end_of_sequence) {
+      EXPECT_TRUE(result.additional_elements.empty());
+      break;
+    }
+    if (result.skip) {
+      continue;
+    }
+    elements.push_back(result.components[0].scalar<int64_t>()());
+    for (const GetElementResult& element : result.additional_elements) {
+      EXPECT_FALSE(element.end_of_sequence);
+      elements.push_back(element.components[0].scalar<int64_t>()());
+    }
+  }
+  EXPECT_THAT(elements, ElementsAreArray({0, 1, 4, 9, 16}));
+
+  // Later requests keep returning the end of sequence.
+  TF_ASSERT_OK_AND_ASSIGN(GetElementResult result,
+                          GetElement(*client, task_id));
+  EXPECT_TRUE(result.end_of_sequence);
+}
+
+TEST_F(WorkerClientTest, BatchedReadRejectsRoundRobinRequests) {
+  TF_ASSERT_OK_AND_ASSIGN(const std::string dataset_id,
+                          RegisterDataset(/*range=*/5));
+  TF_ASSERT_OK_AND_ASSIGN(const int64_t iteration_client_id,
+                          CreateIteration(dataset_id));
+  TF_ASSERT_OK_AND_ASSIGN(const int64_t task_id,
+                          GetTaskToRead(iteration_client_id));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<DataServiceWorkerClient> client,
+                          GetWorkerClient(kLocalTransferProtocol));
+  GetElementRequest request;
+  GetElementResult result;
+  request.set_task_id(task_id);
+  request.set_consumer_index(0);
+  request.set_round_index(0);
+  request.set_max_elements(2);
+  EXPECT_THAT(client->GetElement(request, result),
+              absl_testing::StatusIs(
+                  error::INVALID_ARGUMENT,
+                  HasSubstr("multiple elements per request are not supported "
+                            "for round-robin reads")));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     NetworkProtocols, DataTransferProtocolWorkerClientTest,
     ::testing::Values(kGrpcTransferProtocol, kAltTransferProtocol),
@@ -0,0 +1,229 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// Tests and benchmarks workers compressing elements with the codec of their
+// job. The benchmarks read elements over gRPC from an in-process cluster:
+//
+// bazel run -c opt :worker_compression_test -- --benchmark_filter=all
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/data/service/adaptive_compression.h"
+#include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/data/service/data_transfer.h"
+#include "tensorflow/core/data/service/dispatcher_client.h"
+#include "tensorflow/core/data/service/test_cluster.h"
+#include "tensorflow/core/data/service/test_util.h"
+#include "tensorflow/core/data/service/worker.pb.h"
+#include "tensorflow/core/data/service/worker_client.h"
+#include "tensorflow/core/framework/dataset.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/framework/variant.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/protobuf/data_service.pb.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::tensorflow::data::testing::CompressedRangeDataset;
+using ::testing::ValuesIn;
+
+constexpr int64_t kElementSize = 1024;
+
+// Reads the elements of one job from a single-worker cluster.
+class CompressedJobReader {
+ public:
+  explicit CompressedJobReader(const TestCluster& cluster)
+      : dispatcher_client_(cluster.DispatcherAddress(), "grpc"),
+        worker_client_(cluster.WorkerAddress(0), /*protocol=*/"grpc",
+                       /*transfer_protocol=*/"grpc",
+                       /*fall_back_to_grpc_at_get_element_time=*/true,
+                       /*accelerator_device_info=*/nullptr,
+                       /*allocator=*/nullptr) {}
+
+  // Starts reading `dataset` with `compression_codec`.
+  absl::Status Start(const DatasetDef& dataset,
+                     const std::string& compression_codec) {
+    DataServiceMetadata metadata;
+    metadata.set_compression(DataServiceMetadata::COMPRESSION_SNAPPY);
+    std::string dataset_id;
+    TF_RETURN_IF_ERROR(dispatcher_client_.RegisterDataset(
+        dataset, metadata, /*requested_dataset_id=*/std::nullopt, dataset_id));
+    ProcessingModeDef processing_mode;
+    processing_mode.set_sharding_policy(ProcessingModeDef::OFF);
+    int64_t job_id = 0;
+    TF_RETURN_IF_ERROR(dispatcher_client_.GetOrCreateJob(
+        dataset_id, processing_mode, /*job_name=*/std::nullopt,
+        /*num_consumers=*/std::nullopt, /*use_cross_trainer_cache=*/false,
+        /*use_cross_job_cache=*/false,
+        TARGET_WORKERS_ANY, compression_codec, job_id));
+    int64_t iteration_client_id = 0;
+    TF_RETURN_IF_ERROR(dispatcher_client_.GetOrCreateIteration(
+        job_id, /*repetition=*/0, iteration_client_id));
+    ClientHeartbeatRequest request;
+    ClientHeartbeatResponse response;
+    request.set_iteration_client_id(iteration_client_id);
+    TF_RETURN_IF_ERROR(dispatcher_client_.ClientHeartbeat(request, response));
+    if (response.task_info_size() != 1) {
+      return absl::InternalError(
+          absl::StrCat("Expected one task, got ", response.task_info_size()));
+    }
+    task_id_ = response.task_info(0).task_id();
+    return absl::OkStatus();
+  }
+
+  // Reads the next compressed element. Returns `std::nullopt` at the end of
+  // the sequence.
+  absl::StatusOr<std::optional<CompressedElement>> GetNext() {
+    GetElementRequest request;
+    request.set_task_id(task_id_);
+    GetElementResult result;
+    TF_RETURN_IF_ERROR(worker_client_.GetElement(request, result));
+    if (result.end_of_sequence) {
+      return std::nullopt;
+    }
+    if (result.components.size() != 1 ||
+        result.components[0].dtype() != DT_VARIANT) {
+      return absl::InternalError("Expected a compressed element.");
+    }
+    const CompressedElement* compressed =
+        result.components[0].scalar<Variant>()().get<CompressedElement>();
+    if (compressed == nullptr) {
+      return absl::InternalError("Expected a CompressedElement variant.");
+    }
+    return *compressed;
+  }
+
+ private:
+  DataServiceDispatcherClient dispatcher_client_;
+  DataServiceWorkerClient worker_client_;
+  int64_t task_id_ = 0;
+};
+
+void ExpectElement(const CompressedElement& compressed, int64_t i) {
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(UncompressElement(compressed, &element));
+  ASSERT_EQ(element.size(), 1);
+  Tensor expected(DT_INT64, TensorShape({kElementSize}));
+  for (int64_t j = 0; j < kElementSize; ++j) {
+    expected.flat<int64_t>()(j) = i + j;
+  }
+  test::ExpectEqual(element[0], expected);
+}
+
+class WorkerCompressionTest : public ::testing::TestWithParam<std::string> {};
+
+TEST_P(WorkerCompressionTest, ReadCompressedElements) {
+  constexpr int64_t kRange = 200;
+  const std::string codec = GetParam();
+  TestCluster cluster(/*num_workers=*/1);
+  TF_ASSERT_OK(cluster.Initialize());
+  CompressedJobReader reader(cluster);
+  TF_ASSERT_OK(reader.Start(CompressedRangeDataset(kRange, kElementSize),
+                            codec));
+  for (int64_t i = 0; i < kRange; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(std::optional<CompressedElement> compressed,
+                            reader.GetNext());
+    ASSERT_TRUE(compressed.has_value());
+    ExpectElement(*compressed, i);
+    if (codec.empty() || codec == kSnappyCodec) {
+      // Snappy elements keep the original format.
+      EXPECT_EQ(compressed->codec(), "");
+    } else if (codec == kAdaptiveCompressionCodec) {
+      EXPECT_TRUE(compressed->codec().empty() ||
+                  ElementCodec::IsRegistered(compressed->codec()));
+    } else {
+      EXPECT_EQ(compressed->codec(), codec);
+    }
+  }
+  TF_ASSERT_OK_AND_ASSIGN(std::optional<CompressedElement> compressed,
+                          reader.GetNext());
+  EXPECT_FALSE(compressed.has_value());
+}
+
+INSTANTIATE_TEST_SUITE_P(Codecs, WorkerCompressionTest,
+                         ValuesIn(std::vector<std::string>{
+                             "", "snappy", "none", "zstd-1", "zstd-19",
+                             kAdaptiveCompressionCodec}));
+
+// Reads elements of `element_size` int64 values compressed with `codec`.
+// Reports the uncompressed bytes read per second and the compression ratio.
+void ReadCompressedElementsBenchmarkLoop(::testing::benchmark::State& state,
+                                         const std::string& codec) {
+  const int64_t element_size = state.range(0);
+  TestCluster cluster(/*num_workers=*/1);
+  TF_CHECK_OK(cluster.Initialize());
+  CompressedJobReader reader(cluster);
+  TF_CHECK_OK(reader.Start(
+      CompressedRangeDataset(/*range=*/int64_t{1} << 40, element_size),
+      codec));
+  int64_t compressed_bytes = 0;
+  for (auto s : state) {
+    absl::StatusOr<std::optional<CompressedElement>> compressed =
+        reader.GetNext();
+    TF_CHECK_OK(compressed.status());
+    compressed_bytes += (*compressed)->data().size();
+  }
+  const int64_t uncompressed_bytes =
+      state.iterations() * element_size * sizeof(int64_t);
+  state.SetBytesProcessed(uncompressed_bytes);
+  state.counters["compression_ratio"] =
+      compressed_bytes > 0 ? static_cast<double>(uncompressed_bytes) /
+                                 static_cast<double>(compressed_bytes)
+                           : 0.0;
+}
+
+void BM_ReadNone(::testing::benchmark::State& state) {
+  ReadCompressedElementsBenchmarkLoop(state, "none");
+}
+
+void BM_ReadSnappy(::testing::benchmark::State& state) {
+  ReadCompressedElementsBenchmarkLoop(state, "snappy");
+}
+
+void BM_ReadZstd1(::testing::benchmark::State& state) {
+  ReadCompressedElementsBenchmarkLoop(state, "zstd-1");
+}
+
+void BM_ReadZstd9(::testing::benchmark::State& state) {
+  ReadCompressedElementsBenchmarkLoop(state, "zstd-9");
+}
+
+void BM_ReadAdaptive(::testing::benchmark::State& state) {
+  ReadCompressedElementsBenchmarkLoop(state, kAdaptiveCompressionCodec);
+}
+
+BENCHMARK(BM_ReadNone)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_ReadSnappy)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_ReadZstd1)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_ReadZstd9)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_ReadAdaptive)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -34,6 +34,7 @@ limitations under the License.
 #include "xla/tsl/platform/status_to_from_proto.h"
 #include "xla/tsl/platform/statusor.h"
 #include "xla/tsl/protobuf/status.pb.h"
+#include "tensorflow/core/data/service/adaptive_compression.h"
 #include "tensorflow/core/data/service/byte_size.h"
 #include "tensorflow/core/data/service/common.h"
 #include "tensorflow/core/data/service/common.pb.h"
@@ -77,14 +78,17 @@ namespace {
 constexpr absl::Duration kRetryInterval = absl::Seconds(5);
 constexpr absl::Duration kDefaultHeartBeatInterval = absl::Seconds(30);
 constexpr absl::Duration kDefaultDispatcherTimeout = absl::Hours(1);
+constexpr int64_t kDefaultCrossJobCacheSizeBytes = int64_t{1} << 30;  // 1GB
 
 using WorkerConfig = experimental::WorkerConfig;
 
-// Moves the element into the response. If the tensor contains a single
-// CompressedElement variant, the move will be zero-copy. Otherwise, the tensor
-// data will be serialized as TensorProtos.
+// Moves the element into the response, a `GetElementResponse` or an
+// `AdditionalElement`. If the tensor contains a single CompressedElement
+// variant, the move will be zero-copy. Otherwise, the tensor data will be
+// serialized as TensorProtos.
+template <class ResponseT>
 absl::Status MoveElementToResponse(std::vector<Tensor>&& element,
-                                   GetElementResponse& resp) {
+                                   ResponseT& resp) {
   if (element.size() != 1 || element[0].dtype() != DT_VARIANT ||
       !TensorShapeUtils::IsScalar(element[0].shape())) {
     for (const auto& component : element) {
@@ -105,6 +109,58 @@ absl::Status MoveElementToResponse(std::vector<Tensor>&& element,
   return absl::OkStatus();
 }
 
+// Returns an error if `request` asks for more than one element from a task
+// that does not support it.
+absl::Status ValidateMaxElements(const GetElementRequest& request) {
+  if (request.max_elements() < 0 || request.max_bytes() < 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "GetElement request for task ", request.task_id(),
+        " has a negative element limit: max_elements=", request.max_elements(),
+        ", max_bytes=", request.max_bytes()));
+  }
+  if (request.max_elements() > 1 &&
+      (request.optional_consumer_index_case() ==
+           GetElementRequest::kConsumerIndex ||
+       !request.trainer_id().empty())) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "GetElement request for task ", request.task_id(), " asks for ",
+        request.max_elements(), " elements, but multiple elements per request "
+        "are not supported for round-robin reads or cross-trainer caches."));
+  }
+  return absl::OkStatus();
+}
+
+// Appends the elements that `task_runner` has ready to `result`, until it
+// holds `request.max_elements()` elements or at least `request.max_bytes()`
+// bytes. Sets `end_of_sequence` if the task runner reached the end of its
+// sequence, in which case `result` keeps the elements collected so far and the
+// caller returns the end of sequence to the next request.
+absl::Status GetAdditionalElements(const GetElementRequest& request,
+                                   TaskRunner& task_runner,
+                                   GetElementResult& result,
+                                   bool& end_of_sequence) {
+  GetElementRequest next_request;
+  next_request.set_task_id(request.task_id());
+  next_request.set_allow_skip(true);
+  int64_t num_bytes = result.EstimatedMemoryUsageBytes();
+  while (static_cast<int64_t>(result.additional_elements.size()) + 1 <
+             request.max_elements() &&
+         (request.max_bytes() == 0 || num_bytes < request.max_bytes())) {
+    GetElementResult next;
+    TF_RETURN_IF_ERROR(task_runner.GetNext(next_request, next));
+    if (next.end_of_sequence) {
+      end_of_sequence = true;
+      break;
+    }
+    if (next.skip) {
+      break;
+    }
+    num_bytes += next.EstimatedMemoryUsageBytes();
+    result.additional_elements.push_back(std::move(next));
+  }
+  return absl::OkStatus();
+}
+
 WorkerConfig ApplyWorkerDefaults(const WorkerConfig& config) {
   WorkerConfig new_config(config);
   if (new_config.heartbeat_interval_ms() == 0) {
@@ -119,6 +175,9 @@ WorkerConfig ApplyWorkerDefaults(const WorkerConfig& config) {
     new_config.set_snapshot_max_chunk_size_bytes(
         kDefaultMaxChunkSize.ToUnsignedBytes());
   }
+  if (new_config.cross_job_cache_size_bytes() == 0) {
+    new_config.set_cross_job_cache_size_bytes(kDefaultCrossJobCacheSizeBytes);
+  }
   return new_config;
 }
 
@@ -160,7 +219,9 @@ LocalWorkers::AddressToWorkerMap* LocalWorkers::local_workers_ =
     new AddressToWorkerMap();
 
 DataServiceWorkerImpl::DataServiceWorkerImpl(const WorkerConfig& config)
-    : config_(ApplyWorkerDefaults(config)), worker_uid_(port::JobUid()) {
+    : config_(ApplyWorkerDefaults(config)),
+      worker_uid_(port::JobUid()),
+      cross_job_cache_(config_.cross_job_cache_size_bytes()) {
   metrics::RecordTFDataServiceWorkerCreated();
 }
 
@@ -258,6 +319,7 @@ DataServiceWorkerImpl::CreateDispatcherClient() const TF_LOCKS_EXCLUDED(mu_) {
 
 absl::Status DataServiceWorkerImpl::GetElementResult(
     const GetElementRequest* request, struct GetElementResult* result) {
+  TF_RETURN_IF_ERROR(ValidateMaxElements(*request));
   Task* task = nullptr;
   {
     mutex_lock l(mu_);
@@ -294,15 +356,53 @@ absl::Status DataServiceWorkerImpl::GetElementResult(
     }
     task = it->second.get();
     task->outstanding_requests++;
+    if (task->compression_codec_selector && task->last_element_time) {
+      // The time consumers take to receive and process an element before
+      // requesting the next one, which includes transferring it.
+      task->compression_codec_selector->RecordConsumerTime(
+          absl::Now() - *task->last_element_time);
+    }
   }
   auto cleanup = gtl::MakeCleanup([&] {
     mutex_lock l(mu_);
     task->outstanding_requests--;
+    if (task->compression_codec_selector) {
+      task->last_element_time = absl::Now();
+    }
     cv_.notify_all();
   });
   TF_RETURN_IF_ERROR(EnsureTaskInitialized(*task));
+  {
+    mutex_lock l(mu_);
+    if (task->end_of_sequence_pending) {
+      VLOG(3) << "Reached end_of_sequence for task " << request->task_id();
+      result->end_of_sequence = true;
+      result->skip = false;
+      pending_completed_tasks_.insert(request->task_id());
+      task_completion_cv_.notify_one();
+      return absl::OkStatus();
+    }
+  }
   TF_RETURN_IF_ERROR(task->task_runner->GetNext(*request, *result));
+  // The end of the sequence is only returned on its own, so a task runner that
+  // ends while filling a batch reports it to the next request.
+  // Tasks sharing elements across jobs wait for elements instead of skipping,
+  // so they return one element per request.
+  if (!result->end_of_sequence && !result->skip &&
+      request->max_elements() > 1 && !task->task_def.use_cross_job_cache()) {
+    bool end_of_sequence = false;
+    TF_RETURN_IF_ERROR(GetAdditionalElements(*request, *task->task_runner,
+                                             *result, end_of_sequence));
+    if (end_of_sequence) {
+      mutex_lock l(mu_);
+      task->end_of_sequence_pending = true;
+    }
+  }
 
+  if (!result->end_of_sequence && !result->skip) {
+    mutex_lock l(mu_);
+    task->num_elements_produced += result->additional_elements.size() + 1;
+  }
   if (result->end_of_sequence) {
     mutex_lock l(mu_);
     VLOG(3) << "Reached end_of_sequence for task " << request->task_id();
@@ -322,13 +422,20 @@ absl::Status DataServiceWorkerImpl::ProcessTask(
 
 absl::Status DataServiceWorkerImpl::ProcessTaskInternal(const TaskDef& task_def)
     TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-  std::shared_ptr<Task>& task = tasks_[task_def.task_id()];
-  if (task) {
+  if (tasks_.contains(task_def.task_id())) {
     VLOG(1) << "Received request to process already-processed task "
-            << task->task_def.task_id();
+            << task_def.task_id();
     return absl::OkStatus();
   }
+  std::shared_ptr<CompressionCodecSelector> compression_codec_selector;
+  if (!task_def.compression_codec().empty()) {
+    TF_ASSIGN_OR_RETURN(
+        compression_codec_selector,
+        CompressionCodecSelector::Create(task_def.compression_codec()));
+  }
+  std::shared_ptr<Task>& task = tasks_[task_def.task_id()];
   task = std::make_unique<Task>(task_def);
+  task->compression_codec_selector = std::move(compression_codec_selector);
   VLOG(3) << "Began processing for task " << task_def.task_id()
           << " with processing mode "
           << task_def.processing_mode_def().DebugString();
@@ -347,15 +454,46 @@ absl::Status DataServiceWorkerImpl::EnsureTaskInitialized(
   if (task.initialized) {
     return absl::OkStatus();
   }
-  TF_ASSIGN_OR_RETURN(DatasetDef dataset_def, GetDatasetDef(task.task_def));
-  TF_ASSIGN_OR_RETURN(std::unique_ptr<standalone::Dataset> dataset,
-                      MakeDataset(dataset_def, task.task_def));
-  TF_ASSIGN_OR_RETURN(std::unique_ptr<standalone::Iterator> iterator,
-                      MakeDatasetIterator(*dataset, task.task_def));
-  auto task_iterator = std::make_unique<StandaloneTaskIterator>(
-      std::move(dataset), std::move(iterator));
-  TF_RETURN_IF_ERROR(TaskRunner::Create(
-      config_, task.task_def, std::move(task_iterator), task.task_runner));
+  TF_ASSIGN_OR_RETURN(bool compression_disabled_at_runtime,
+                      DisableCompressionAtRuntime(task.task_def.dataset_id()));
+  // If the job chose a codec, the worker compresses the elements itself instead
+  // of the dataset's snappy compression map.
+  const bool compress_on_worker = !compression_disabled_at_runtime &&
+                                  task.compression_codec_selector != nullptr;
+  auto make_iterator =
+      [&]() -> absl::StatusOr<std::unique_ptr<TaskIterator>> {
+    TF_ASSIGN_OR_RETURN(DatasetDef dataset_def, GetDatasetDef(task.task_def));
+    TF_ASSIGN_OR_RETURN(
+        std::unique_ptr<standalone::Dataset> dataset,
+        MakeDataset(dataset_def, task.task_def,
+                    compression_disabled_at_runtime || compress_on_worker));
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<standalone::Iterator> iterator,
+                        MakeDatasetIterator(*dataset, task.task_def));
+    std::unique_ptr<TaskIterator> task_iterator =
+        std::make_unique<StandaloneTaskIterator>(std::move(dataset),
+                                                 std::move(iterator));
+    if (compress_on_worker) {
+      task_iterator = std::make_unique<CompressingTaskIterator>(
+          std::move(task_iterator), task.compression_codec_selector);
+    }
+    return task_iterator;
+  };
+  if (task.task_def.use_cross_job_cache()) {
+    // Tasks only share elements that the worker produces the same way.
+    const std::string key = absl::StrCat(
+        task.task_def.dataset_fingerprint(), ":",
+        compression_disabled_at_runtime ? "uncompressed" : "compressed", ":",
+        compress_on_worker ? task.task_def.compression_codec() : "");
+    TF_ASSIGN_OR_RETURN(
+        task.task_runner,
+        cross_job_cache_.CreateTaskRunner(key, task.task_def.task_id(),
+                                          make_iterator));
+  } else {
+    TF_ASSIGN_OR_RETURN(std::unique_ptr<TaskIterator> task_iterator,
+                        make_iterator());
+    TF_RETURN_IF_ERROR(TaskRunner::Create(
+        config_, task.task_def, std::move(task_iterator), task.task_runner));
+  }
 
   task.initialized = true;
   VLOG(3) << "Created iterator for task " << task.task_def.task_id();
@@ -412,16 +550,15 @@ absl::StatusOr<bool> DataServiceWorkerImpl::DisableCompressionAtRuntime(
 
 absl::StatusOr<std::unique_ptr<standalone::Dataset>>
 DataServiceWorkerImpl::MakeDataset(const DatasetDef& dataset_def,
-                                   const TaskDef& task_def) const {
-  TF_ASSIGN_OR_RETURN(bool compression_disabled_at_runtime,
-                      DisableCompressionAtRuntime(task_def.dataset_id()));
+                                   const TaskDef& task_def,
+                                   bool remove_compression_map) const {
   GraphDef graph = dataset_def.graph();
   if (VLOG_IS_ON(1)) {
     std::string prefix = absl::StrCat(task_def.dataset_id(), "_", worker_uid_);
     DumpGraphDefToFile(absl::StrCat(prefix, "-prerewrite_GraphDef"), graph);
     DumpProtoToFile(absl::StrCat(prefix, "-prerewrite_TaskDef"), task_def);
   }
-  if (compression_disabled_at_runtime) {
+  if (remove_compression_map) {
     RemoveCompressionMapRewriter remove_compression_map_rewriter;
     TF_ASSIGN_OR_RETURN(
         graph, remove_compression_map_rewriter.ApplyRemoveCompressionMapRewrite(
@@ -454,7 +591,8 @@ DataServiceWorkerImpl::MakeDatasetIterator(standalone::Dataset& dataset,
     for (int i = 0; i < task_def.num_split_providers(); ++i) {
       split_providers.push_back(std::make_unique<DataServiceSplitProvider>(
           config_.dispatcher_address(), config_.protocol(),
-          task_def.iteration_id(), i, config_.dispatcher_timeout_ms()));
+          task_def.iteration_id(), task_def.task_id(), i,
+          config_.dispatcher_timeout_ms()));
     }
     TF_RETURN_IF_ERROR(
         dataset.MakeIterator(std::move(split_providers), &iterator));
@@ -490,7 +628,15 @@ absl::Status DataServiceWorkerImpl::GetElement(const GetElementRequest* request,
   if (!response->end_of_sequence() && !response->skip_task()) {
     TF_RETURN_IF_ERROR(
         MoveElementToResponse(std::move(result.components), *response));
-    VLOG(3) << "Producing an element for task " << request->task_id();
+    for (struct GetElementResult& element : result.additional_elements) {
+      AdditionalElement* additional_element =
+          response->add_additional_elements();
+      additional_element->set_element_index(element.element_index);
+      TF_RETURN_IF_ERROR(MoveElementToResponse(std::move(element.components),
+                                               *additional_element));
+    }
+    VLOG(3) << "Producing " << result.additional_elements.size() + 1
+            << " element(s) for task " << request->task_id();
   }
   return absl::OkStatus();
 }
@@ -608,9 +754,15 @@ std::vector<ActiveTask> DataServiceWorkerImpl::GetActiveTasks() const
     TF_LOCKS_EXCLUDED(mu_) {
   std::vector<ActiveTask> active_tasks;
   absl::flat_hash_map<int64_t, std::shared_ptr<Task>> current_tasks;
+  absl::flat_hash_map<int64_t, int64_t> num_elements_produced;
   {
     mutex_lock l(mu_);
     current_tasks = tasks_;
+    for (const auto& [task_id, task] : tasks_) {
+      if (task != nullptr) {
+        num_elements_produced[task_id] = task->num_elements_produced;
+      }
+    }
   }
 
   for (const auto& [task_id, task] : current_tasks) {
@@ -620,6 +772,7 @@ std::vector<ActiveTask> DataServiceWorkerImpl::GetActiveTasks() const
     ActiveTask active_task;
     active_task.set_task_id(task_id);
     active_task.set_processing_time_nsec(0.0);
+    active_task.set_num_elements_produced(num_elements_produced[task_id]);
 
     bool task_initialized = false;
     {
@@ -627,6 +780,10 @@ std::vector<ActiveTask> DataServiceWorkerImpl::GetActiveTasks() const
       task_initialized = task->initialized;
     }
 
+    if (task_initialized && task->task_runner != nullptr) {
+      active_task.set_num_buffered_elements(
+          task->task_runner->NumBufferedElements());
+    }
     if (task_initialized && task->task_runner != nullptr &&
         task->task_runner->model() != nullptr) {
       std::shared_ptr<model::Model> model = task->task_runner->model();
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,7 +26,10 @@ limitations under the License.
 #include "absl/container/flat_hash_set.h"
 #include "absl/hash/hash.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/data/service/adaptive_compression.h"
 #include "tensorflow/core/data/service/common.pb.h"
+#include "tensorflow/core/data/service/cross_job_cache.h"
 #include "tensorflow/core/data/service/data_transfer.h"
 #include "tensorflow/core/data/service/dispatcher_client.h"
 #include "tensorflow/core/data/service/export.pb.h"
@@ -99,6 +103,20 @@ class DataServiceWorkerImpl {
     bool initialized TF_GUARDED_BY(mu) = false;
     int64_t outstanding_requests TF_GUARDED_BY(&DataServiceWorkerImpl::mu_) = 0;
     std::unique_ptr<TaskRunner> task_runner;
+    // Chooses the codec for the task's elements if the task is compressed by
+    // the worker instead of by the dataset.
+    std::shared_ptr<CompressionCodecSelector> compression_codec_selector;
+    // When the last element of the task was returned, if any.
+    std::optional<absl::Time> last_element_time
+        TF_GUARDED_BY(&DataServiceWorkerImpl::mu_);
+    // The number of elements the task has returned, reported to the dispatcher
+    // to measure the task's throughput.
+    int64_t num_elements_produced TF_GUARDED_BY(&DataServiceWorkerImpl::mu_) =
+        0;
+    // Whether the task runner reached the end of its sequence while filling a
+    // batch of elements. The end of sequence is returned by the next request.
+    bool end_of_sequence_pending TF_GUARDED_BY(&DataServiceWorkerImpl::mu_) =
+        false;
   };
 
   struct SnapshotTask {
@@ -166,9 +184,11 @@ class DataServiceWorkerImpl {
   std::vector<SnapshotTaskProgress> GetSnapshotTaskProgress() const;
   // Gets the DatasetDef for `task_def`.
   absl::StatusOr<DatasetDef> GetDatasetDef(const TaskDef& task_def) const;
-  // Creates a dataset from `dataset_def`.
+  // Creates a dataset from `dataset_def`. If `remove_compression_map` is true,
+  // removes the map that compresses the dataset's elements.
   absl::StatusOr<std::unique_ptr<standalone::Dataset>> MakeDataset(
-      const DatasetDef& dataset_def, const TaskDef& task_def) const;
+      const DatasetDef& dataset_def, const TaskDef& task_def,
+      bool remove_compression_map) const;
   // Creates an iterator for `dataset`.
   absl::StatusOr<std::unique_ptr<standalone::Iterator>> MakeDatasetIterator(
       standalone::Dataset& dataset, const TaskDef& task_def) const;
@@ -183,6 +203,10 @@ class DataServiceWorkerImpl {
   std::vector<DataTransferServerInfo> transfer_servers_;
   std::unique_ptr<DataServiceDispatcherClient> dispatcher_;
 
+  // Shares elements across the tasks of jobs that read the same dataset. It
+  // must outlive the task runners it creates.
+  CrossJobCache cross_job_cache_;
+
   mutable mutex mu_;
   condition_variable cv_;
   // Information about tasks, keyed by task ids. The tasks are updated based on
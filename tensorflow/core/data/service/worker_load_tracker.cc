@@ -0,0 +1,162 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/worker_load_tracker.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/data/service/dispatcher.pb.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// The weight of the latest heartbeat in the smoothed throughput.
+constexpr double kThroughputSmoothing = 0.5;
+
+}  // namespace
+
+void WorkerLoadTracker::ReportLoad(const std::string& worker_address,
+                                   const std::vector<ActiveTask>& active_tasks,
+                                   absl::Time time) TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  absl::flat_hash_set<int64_t>& task_ids = worker_tasks_[worker_address];
+  absl::flat_hash_set<int64_t> reported_task_ids;
+  for (const ActiveTask& active_task : active_tasks) {
+    reported_task_ids.insert(active_task.task_id());
+    TaskLoad& load = tasks_[active_task.task_id()];
+    const absl::Duration elapsed = time - load.report_time;
+    const int64_t num_new_elements =
+        active_task.num_elements_produced() - load.num_elements_produced;
+    if (!task_ids.contains(active_task.task_id()) || num_new_elements < 0) {
+      // The first report of the task, or the task has been restarted.
+      load.throughput = std::nullopt;
+    } else if (elapsed > absl::ZeroDuration()) {
+      const double throughput =
+          num_new_elements / absl::ToDoubleSeconds(elapsed);
+      load.throughput =
+          load.throughput.has_value()
+              ? kThroughputSmoothing * throughput +
+                    (1 - kThroughputSmoothing) * *load.throughput
+              : throughput;
+    }
+    load.report_time = time;
+    load.num_elements_produced = active_task.num_elements_produced();
+    load.num_buffered_elements = active_task.num_buffered_elements();
+  }
+  for (int64_t task_id : task_ids) {
+    if (!reported_task_ids.contains(task_id)) {
+      tasks_.erase(task_id);
+    }
+  }
+  task_ids = std::move(reported_task_ids);
+}
+
+void WorkerLoadTracker::RemoveWorker(const std::string& worker_address)
+    TF_LOCKS_EXCLUDED(mu_) {
+  mutex_lock l(mu_);
+  auto it = worker_tasks_.find(worker_address);
+  if (it == worker_tasks_.end()) {
+    return;
+  }
+  for (int64_t task_id : it->second) {
+    tasks_.erase(task_id);
+  }
+  worker_tasks_.erase(it);
+}
+
+std::optional<double> WorkerLoadTracker::RelativeThroughput(
+    int64_t task_id, absl::Span<const int64_t> peer_task_ids) const
+    TF_LOCKS_EXCLUDED(mu_) {
+  tf_shared_lock l(mu_);
+  return RelativeThroughputLocked(task_id, peer_task_ids);
+}
+
+bool WorkerLoadTracker::IsStraggler(
+    int64_t task_id, absl::Span<const int64_t> peer_task_ids) const
+    TF_LOCKS_EXCLUDED(mu_) {
+  tf_shared_lock l(mu_);
+  return IsStragglerLocked(task_id, peer_task_ids);
+}
+
+bool WorkerLoadTracker::ShouldHoldBackSplits(
+    int64_t task_id, absl::Span<const int64_t> peer_task_ids,
+    int64_t num_remaining_splits) const TF_LOCKS_EXCLUDED(mu_) {
+  tf_shared_lock l(mu_);
+  if (num_remaining_splits <= 0 || !IsStragglerLocked(task_id, peer_task_ids)) {
+    return false;
+  }
+  int64_t num_fast_peers = 0;
+  for (int64_t peer_task_id : peer_task_ids) {
+    if (peer_task_id != task_id &&
+        RelativeThroughputLocked(peer_task_id, peer_task_ids).has_value() &&
+        !IsStragglerLocked(peer_task_id, peer_task_ids)) {
+      ++num_fast_peers;
+    }
+  }
+  return num_remaining_splits <= num_fast_peers;
+}
+
+std::optional<double> WorkerLoadTracker::MeanThroughput(
+    absl::Span<const int64_t> peer_task_ids) const
+    TF_SHARED_LOCKS_REQUIRED(mu_) {
+  double total_throughput = 0.0;
+  int64_t num_known = 0;
+  for (int64_t peer_task_id : peer_task_ids) {
+    auto it = tasks_.find(peer_task_id);
+    if (it != tasks_.end() && it->second.throughput.has_value()) {
+      total_throughput += *it->second.throughput;
+      ++num_known;
+    }
+  }
+  if (num_known == 0 || total_throughput <= 0.0) {
+    return std::nullopt;
+  }
+  return total_throughput / num_known;
+}
+
+std::optional<double> WorkerLoadTracker::RelativeThroughputLocked(
+    int64_t task_id, absl::Span<const int64_t> peer_task_ids) const
+    TF_SHARED_LOCKS_REQUIRED(mu_) {
+  auto it = tasks_.find(task_id);
+  if (it == tasks_.end() || !it->second.throughput.has_value()) {
+    return std::nullopt;
+  }
+  std::optional<double> mean_throughput = MeanThroughput(peer_task_ids);
+  if (!mean_throughput.has_value()) {
+    return std::nullopt;
+  }
+  return *it->second.throughput / *mean_throughput;
+}
+
+bool WorkerLoadTracker::IsStragglerLocked(
+    int64_t task_id, absl::Span<const int64_t> peer_task_ids) const
+    TF_SHARED_LOCKS_REQUIRED(mu_) {
+  std::optional<double> relative_throughput =
+      RelativeThroughputLocked(task_id, peer_task_ids);
+  return relative_throughput.has_value() &&
+         *relative_throughput < kStragglerThroughput &&
+         tasks_.at(task_id).num_buffered_elements == 0;
+}
+
+}  // namespace data
+}  // namespace tensorflow
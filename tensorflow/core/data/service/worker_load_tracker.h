@@ -0,0 +1,118 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SERVICE_WORKER_LOAD_TRACKER_H_
+#define TENSORFLOW_CORE_DATA_SERVICE_WORKER_LOAD_TRACKER_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/data/service/dispatcher.pb.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// Tracks the load of the tasks of tf.data service workers, as reported in
+// worker heartbeats, so that the dispatcher can balance reads and dynamic
+// shards across workers.
+//
+// Glossary:
+// * Throughput: The number of elements a task returns per second, smoothed
+// across heartbeats.
+// * Buffered elements: The number of elements a task has prepared ahead of
+// requests. A task with buffered elements waits for its consumers, so it does
+// not slow them down.
+// * Peers: The tasks of the same iteration, one per worker.
+// * Straggler: A task without buffered elements whose throughput is less than
+// `kStragglerThroughput` times the mean throughput of its peers.
+//
+// WorkerLoadTracker is thread-safe.
+class WorkerLoadTracker {
+ public:
+  // The relative throughput below which a task without buffered elements is a
+  // straggler.
+  static constexpr double kStragglerThroughput = 0.5;
+
+  WorkerLoadTracker() = default;
+
+  // Records the load of the tasks of the worker at `worker_address` at `time`.
+  // Tasks of the worker that are not in `active_tasks` are forgotten.
+  void ReportLoad(const std::string& worker_address,
+                  const std::vector<ActiveTask>& active_tasks, absl::Time time)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Forgets the tasks of the worker at `worker_address`.
+  void RemoveWorker(const std::string& worker_address) TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns the throughput of `task_id` relative to the mean throughput of the
+  // tasks in `peer_task_ids`, or nullopt if either is unknown.
+  std::optional<double> RelativeThroughput(
+      int64_t task_id, absl::Span<const int64_t> peer_task_ids) const
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns whether `task_id` is a straggler among `peer_task_ids`.
+  bool IsStraggler(int64_t task_id,
+                   absl::Span<const int64_t> peer_task_ids) const
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns whether the last `num_remaining_splits` splits of a dynamically
+  // sharded epoch should be held back from `task_id`. This is the case if it is
+  // a straggler, and its peers that are not stragglers can take every
+  // remaining split.
+  bool ShouldHoldBackSplits(int64_t task_id,
+                            absl::Span<const int64_t> peer_task_ids,
+                            int64_t num_remaining_splits) const
+      TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  struct TaskLoad {
+    absl::Time report_time;
+    int64_t num_elements_produced = 0;
+    int64_t num_buffered_elements = 0;
+    // Elements per second. Unknown until the second report.
+    std::optional<double> throughput;
+  };
+
+  // Returns the mean throughput of the tasks in `peer_task_ids` with a known
+  // throughput, or nullopt if there are none.
+  std::optional<double> MeanThroughput(
+      absl::Span<const int64_t> peer_task_ids) const
+      TF_SHARED_LOCKS_REQUIRED(mu_);
+  std::optional<double> RelativeThroughputLocked(
+      int64_t task_id, absl::Span<const int64_t> peer_task_ids) const
+      TF_SHARED_LOCKS_REQUIRED(mu_);
+  bool IsStragglerLocked(int64_t task_id,
+                         absl::Span<const int64_t> peer_task_ids) const
+      TF_SHARED_LOCKS_REQUIRED(mu_);
+
+  mutable mutex mu_;
+  // Load of each task, keyed by task id.
+  absl::flat_hash_map<int64_t, TaskLoad> tasks_ TF_GUARDED_BY(mu_);
+  // Ids of the tasks of each worker, keyed by worker address.
+  absl::flat_hash_map<std::string, absl::flat_hash_set<int64_t>> worker_tasks_
+      TF_GUARDED_BY(mu_);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SERVICE_WORKER_LOAD_TRACKER_H_
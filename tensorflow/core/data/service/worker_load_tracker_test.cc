@@ -0,0 +1,157 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/service/worker_load_tracker.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "tensorflow/core/data/service/dispatcher.pb.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::DoubleNear;
+using ::testing::Optional;
+
+ActiveTask MakeActiveTask(int64_t task_id, int64_t num_elements_produced,
+                          int64_t num_buffered_elements = 0) {
+  ActiveTask active_task;
+  active_task.set_task_id(task_id);
+  active_task.set_num_elements_produced(num_elements_produced);
+  active_task.set_num_buffered_elements(num_buffered_elements);
+  return active_task;
+}
+
+absl::Time Seconds(int64_t seconds) {
+  return absl::UnixEpoch() + absl::Seconds(seconds);
+}
+
+// Reports tasks 1, 2, and 3 on workers "w1", "w2", and "w3", producing 100,
+// 100, and 10 elements per second respectively.
+void ReportOneFastAndOneSlowTask(WorkerLoadTracker& tracker,
+                                 int64_t slow_task_buffered_elements = 0) {
+  for (int64_t i = 0; i <= 2; ++i) {
+    tracker.ReportLoad("w1", {MakeActiveTask(1, 100 * i)}, Seconds(i));
+    tracker.ReportLoad("w2", {MakeActiveTask(2, 100 * i)}, Seconds(i));
+    tracker.ReportLoad(
+        "w3", {MakeActiveTask(3, 10 * i, slow_task_buffered_elements)},
+        Seconds(i));
+  }
+}
+
+TEST(WorkerLoadTrackerTest, UnknownThroughput) {
+  WorkerLoadTracker tracker;
+  EXPECT_EQ(tracker.RelativeThroughput(1, {1, 2}), std::nullopt);
+
+  // The throughput is unknown until the second report.
+  tracker.ReportLoad("w1", {MakeActiveTask(1, 100)}, Seconds(0));
+  tracker.ReportLoad("w2", {MakeActiveTask(2, 100)}, Seconds(0));
+  EXPECT_EQ(tracker.RelativeThroughput(1, {1, 2}), std::nullopt);
+  EXPECT_FALSE(tracker.IsStraggler(1, {1, 2}));
+}
+
+TEST(WorkerLoadTrackerTest, RelativeThroughput) {
+  WorkerLoadTracker tracker;
+  ReportOneFastAndOneSlowTask(tracker);
+  // The mean throughput is 70 elements per second.
+  EXPECT_THAT(tracker.RelativeThroughput(1, {1, 2, 3}),
+              Optional(DoubleNear(100.0 / 70.0, 1e-6)));
+  EXPECT_THAT(tracker.RelativeThroughput(3, {1, 2, 3}),
+              Optional(DoubleNear(10.0 / 70.0, 1e-6)));
+  EXPECT_THAT(tracker.RelativeThroughput(1, {1, 2}),
+              Optional(DoubleNear(1.0, 1e-6)));
+}
+
+TEST(WorkerLoadTrackerTest, SmoothedThroughput) {
+  WorkerLoadTracker tracker;
+  tracker.ReportLoad("w1", {MakeActiveTask(1, 0)}, Seconds(0));
+  tracker.ReportLoad("w2", {MakeActiveTask(2, 0)}, Seconds(0));
+  tracker.ReportLoad("w1", {MakeActiveTask(1, 100)}, Seconds(1));
+  tracker.ReportLoad("w2", {MakeActiveTask(2, 100)}, Seconds(1));
+  // Task 1 briefly stops producing elements.
+  tracker.ReportLoad("w1", {MakeActiveTask(1, 100)}, Seconds(2));
+  tracker.ReportLoad("w2", {MakeActiveTask(2, 200)}, Seconds(2));
+  // Task 1 produces 50 elements per second after smoothing.
+  EXPECT_THAT(tracker.RelativeThroughput(1, {1, 2}),
+              Optional(DoubleNear(50.0 / 75.0, 1e-6)));
+  EXPECT_FALSE(tracker.IsStraggler(1, {1, 2}));
+}
+
+TEST(WorkerLoadTrackerTest, Straggler) {
+  WorkerLoadTracker tracker;
+  ReportOneFastAndOneSlowTask(tracker);
+  EXPECT_FALSE(tracker.IsStraggler(1, {1, 2, 3}));
+  EXPECT_FALSE(tracker.IsStraggler(2, {1, 2, 3}));
+  EXPECT_TRUE(tracker.IsStraggler(3, {1, 2, 3}));
+}
+
+TEST(WorkerLoadTrackerTest, SlowTaskWithBufferedElementsIsNotStraggler) {
+  WorkerLoadTracker tracker;
+  ReportOneFastAndOneSlowTask(tracker, /*slow_task_buffered_elements=*/5);
+  EXPECT_FALSE(tracker.IsStraggler(3, {1, 2, 3}));
+}
+
+TEST(WorkerLoadTrackerTest, HoldBackSplits) {
+  WorkerLoadTracker tracker;
+  ReportOneFastAndOneSlowTask(tracker);
+  // The two fast tasks can take the last two splits.
+  EXPECT_TRUE(tracker.ShouldHoldBackSplits(3, {1, 2, 3},
+                                           /*num_remaining_splits=*/1));
+  EXPECT_TRUE(tracker.ShouldHoldBackSplits(3, {1, 2, 3},
+                                           /*num_remaining_splits=*/2));
+  EXPECT_FALSE(tracker.ShouldHoldBackSplits(3, {1, 2, 3},
+                                            /*num_remaining_splits=*/3));
+  EXPECT_FALSE(tracker.ShouldHoldBackSplits(3, {1, 2, 3},
+                                            /*num_remaining_splits=*/0));
+  EXPECT_FALSE(tracker.ShouldHoldBackSplits(1, {1, 2, 3},
+                                            /*num_remaining_splits=*/1));
+}
+
+TEST(WorkerLoadTrackerTest, RestartedTask) {
+  WorkerLoadTracker tracker;
+  ReportOneFastAndOneSlowTask(tracker);
+  // The element count of task 3 goes down, so its throughput is measured
+  // again.
+  tracker.ReportLoad("w3", {MakeActiveTask(3, 0)}, Seconds(3));
+  EXPECT_EQ(tracker.RelativeThroughput(3, {1, 2, 3}), std::nullopt);
+  EXPECT_FALSE(tracker.IsStraggler(3, {1, 2, 3}));
+}
+
+TEST(WorkerLoadTrackerTest, ForgetFinishedTasks) {
+  WorkerLoadTracker tracker;
+  ReportOneFastAndOneSlowTask(tracker);
+  tracker.ReportLoad("w3", {}, Seconds(3));
+  EXPECT_EQ(tracker.RelativeThroughput(3, {1, 2, 3}), std::nullopt);
+  EXPECT_THAT(tracker.RelativeThroughput(1, {1, 2, 3}),
+              Optional(DoubleNear(1.0, 1e-6)));
+}
+
+TEST(WorkerLoadTrackerTest, RemoveWorker) {
+  WorkerLoadTracker tracker;
+  ReportOneFastAndOneSlowTask(tracker);
+  tracker.RemoveWorker("w3");
+  EXPECT_EQ(tracker.RelativeThroughput(3, {1, 2, 3}), std::nullopt);
+  EXPECT_FALSE(tracker.ShouldHoldBackSplits(3, {1, 2, 3},
+                                            /*num_remaining_splits=*/1));
+  tracker.RemoveWorker("unknown");
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
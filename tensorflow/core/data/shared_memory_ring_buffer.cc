@@ -0,0 +1,405 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/shared_memory_ring_buffer.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/element_encoding.h"
+#include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Identifies the layout and its version.
+constexpr uint64_t kMagic = 0x3167726873617466ULL;
+constexpr int64_t kMaxConsumers = 64;
+// Reported by tensors that alias a slot.
+constexpr char kAllocatorName[] = "shared_memory_ring_buffer";
+// Bounds of the interval at which publishers and consumers poll the buffer.
+constexpr int64_t kMinPollMicros = 10;
+constexpr int64_t kMaxPollMicros = 1000;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared memory synchronization requires lock-free atomics.");
+
+// The start of the shared memory object, which is followed by the slots. Each
+// slot holds the number of components of its element, padded to the encoding
+// alignment, followed by the encoded components.
+struct Header {
+  // Set to `kMagic` once the other fields have been initialized.
+  std::atomic<uint64_t> magic;
+  uint64_t num_slots;
+  uint64_t slot_bytes;
+  uint64_t num_consumers;
+  // The number of elements that have been published.
+  std::atomic<uint64_t> num_published;
+  // Whether the publisher has closed the buffer.
+  std::atomic<uint64_t> closed;
+  // For each consumer, the number of elements that it has released, which are
+  // always the oldest ones.
+  std::atomic<uint64_t> num_released[kMaxConsumers];
+};
+
+Header* HeaderOf(char* data) { return reinterpret_cast<Header*>(data); }
+
+uint64_t HeaderBytes() { return AlignElementEncodingOffset(sizeof(Header)); }
+
+uint64_t RegionBytes(const Header& header) {
+  return HeaderBytes() + header.num_slots * header.slot_bytes;
+}
+
+char* Slot(char* data, uint64_t index) {
+  const Header* header = HeaderOf(data);
+  return data + HeaderBytes() +
+         (index % header->num_slots) * header->slot_bytes;
+}
+
+std::string SharedMemoryName(const std::string& name) {
+  return absl::StartsWith(name, "/") ? name : absl::StrCat("/", name);
+}
+
+// Sleeps for `*poll_micros` and doubles it, up to `kMaxPollMicros`.
+void Poll(int64_t* poll_micros) {
+  Env::Default()->SleepForMicroseconds(*poll_micros);
+  *poll_micros = std::min(2 * *poll_micros, kMaxPollMicros);
+}
+
+absl::StatusOr<char*> Map(int fd, uint64_t size) {
+  void* data =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, /*offset=*/0);
+  if (data == MAP_FAILED) {
+    return errors::IOError("Failed to map shared memory", errno);
+  }
+  return static_cast<char*>(data);
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<SharedMemoryElementPublisher>>
+SharedMemoryElementPublisher::Create(const Options& options) {
+  if (options.name.empty()) {
+    return absl::InvalidArgumentError(
+        "The name of a shared memory ring buffer must not be empty.");
+  }
+  if (options.num_slots <= 0 || options.slot_bytes <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("A shared memory ring buffer needs a positive number of "
+                     "slots of a positive size, got ",
+                     options.num_slots, " slots of ", options.slot_bytes,
+                     " bytes."));
+  }
+  if (options.num_consumers <= 0 || options.num_consumers > kMaxConsumers) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The number of consumers must be in [1, ", kMaxConsumers,
+                     "], got ", options.num_consumers, "."));
+  }
+  const std::string name = SharedMemoryName(options.name);
+  const uint64_t slot_bytes = AlignElementEncodingOffset(options.slot_bytes);
+  const uint64_t size = HeaderBytes() + options.num_slots * slot_bytes;
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    return errors::IOError(
+        absl::StrCat("Failed to create shared memory ", name), errno);
+  }
+  if (ftruncate(fd, size) != 0) {
+    const int error = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    return errors::IOError(absl::StrCat("Failed to resize shared memory ",
+                                        name, " to ", size, " bytes"),
+                           error);
+  }
+  absl::StatusOr<char*> data = Map(fd, size);
+  close(fd);
+  if (!data.ok()) {
+    shm_unlink(name.c_str());
+    return data.status();
+  }
+  Header* header = new (*data) Header;
+  header->num_slots = options.num_slots;
+  header->slot_bytes = slot_bytes;
+  header->num_consumers = options.num_consumers;
+  header->num_published.store(0);
+  header->closed.store(0);
+  for (int64_t i = 0; i < kMaxConsumers; ++i) {
+    header->num_released[i].store(0);
+  }
+  header->magic.store(kMagic, std::memory_order_release);
+  return absl::WrapUnique(new SharedMemoryElementPublisher(name, *data));
+}
+
+SharedMemoryElementPublisher::SharedMemoryElementPublisher(std::string name,
+                                                           char* data)
+    : name_(std::move(name)), data_(data) {}
+
+SharedMemoryElementPublisher::~SharedMemoryElementPublisher() {
+  Close();
+  munmap(data_, RegionBytes(*HeaderOf(data_)));
+  shm_unlink(name_.c_str());
+}
+
+absl::Status SharedMemoryElementPublisher::Publish(
+    const std::vector<Tensor>& element) {
+  if (closed_) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "The shared memory ring buffer ", name_, " has been closed."));
+  }
+  Header* header = HeaderOf(data_);
+  const uint64_t index = header->num_published.load(std::memory_order_relaxed);
+  auto slot_released = [header, index]() {
+    if (index < header->num_slots) {
+      return true;
+    }
+    for (uint64_t i = 0; i < header->num_consumers; ++i) {
+      if (header->num_released[i].load(std::memory_order_acquire) <=
+          index - header->num_slots) {
+        return false;
+      }
+    }
+    return true;
+  };
+  int64_t poll_micros = kMinPollMicros;
+  while (!slot_released()) {
+    Poll(&poll_micros);
+  }
+
+  char* slot = Slot(data_, index);
+  uint64_t offset = 0;
+  auto append = [header, slot, &offset](absl::string_view data) {
+    if (data.size() > header->slot_bytes - offset) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "The element does not fit in a shared memory slot of ",
+          header->slot_bytes, " bytes."));
+    }
+    std::memcpy(slot + offset, data.data(), data.size());
+    offset += data.size();
+    return absl::OkStatus();
+  };
+  std::string num_components;
+  core::PutFixed64(&num_components, element.size());
+  num_components.resize(kElementEncodingAlignment, '\0');
+  TF_RETURN_IF_ERROR(append(num_components));
+  for (const Tensor& component : element) {
+    TF_RETURN_IF_ERROR(EncodeComponent(component, append));
+  }
+  header->num_published.store(index + 1, std::memory_order_release);
+  return absl::OkStatus();
+}
+
+void SharedMemoryElementPublisher::Close() {
+  if (!closed_) {
+    HeaderOf(data_)->closed.store(1, std::memory_order_release);
+    closed_ = true;
+  }
+}
+
+// The mapping of a buffer by a consumer, which tracks the elements that the
+// consumer has released. Elements can be released in any order, but the
+// publisher only learns of a release once all older elements are released.
+class SharedMemoryElementConsumer::Cursor : public core::RefCounted {
+ public:
+  Cursor(char* data, int64_t consumer_index)
+      : data_(data),
+        consumer_index_(consumer_index),
+        next_(HeaderOf(data)->num_released[consumer_index].load(
+            std::memory_order_acquire)),
+        num_released_(next_) {}
+
+  ~Cursor() override { munmap(data_, RegionBytes(*header())); }
+
+  Header* header() const { return HeaderOf(data_); }
+  char* data() const { return data_; }
+
+  // The index of the next element to read.
+  uint64_t next() const { return next_; }
+  void Advance() { ++next_; }
+
+  void Release(uint64_t index) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    released_ahead_.insert(index);
+    while (!released_ahead_.empty() &&
+           *released_ahead_.begin() == num_released_) {
+      released_ahead_.erase(released_ahead_.begin());
+      ++num_released_;
+    }
+    header()->num_released[consumer_index_].store(num_released_,
+                                                   std::memory_order_release);
+  }
+
+ private:
+  char* const data_;
+  const int64_t consumer_index_;
+  // Only accessed by `GetNext`, which is not thread-safe.
+  uint64_t next_;
+  mutex mu_;
+  uint64_t num_released_ TF_GUARDED_BY(mu_);
+  // Released elements that are newer than an element that has not been
+  // released.
+  std::set<uint64_t> released_ahead_ TF_GUARDED_BY(mu_);
+};
+
+namespace {
+
+// Keeps an element's slot from being reused while tensors alias it.
+class SlotLease : public core::RefCounted {
+ public:
+  explicit SlotLease(std::function<void()> release)
+      : release_(std::move(release)) {}
+  ~SlotLease() override { release_(); }
+
+ private:
+  const std::function<void()> release_;
+};
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<SharedMemoryElementConsumer>>
+SharedMemoryElementConsumer::Open(const std::string& name,
+                                  int64_t consumer_index) {
+  if (consumer_index < 0 || consumer_index >= kMaxConsumers) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid consumer index: ", consumer_index));
+  }
+  const std::string shm_name = SharedMemoryName(name);
+  int fd = shm_open(shm_name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return absl::UnavailableError(absl::StrCat(
+          "The shared memory ring buffer ", shm_name, " does not exist yet."));
+    }
+    return errors::IOError(
+        absl::StrCat("Failed to open shared memory ", shm_name), errno);
+  }
+  struct stat stat_buffer;
+  if (fstat(fd, &stat_buffer) != 0) {
+    const int error = errno;
+    close(fd);
+    return errors::IOError(absl::StrCat("Failed to stat ", shm_name), error);
+  }
+  const uint64_t size = stat_buffer.st_size;
+  if (size < HeaderBytes()) {
+    close(fd);
+    return absl::UnavailableError(absl::StrCat(
+        "The shared memory ring buffer ", shm_name, " is not ready yet."));
+  }
+  absl::StatusOr<char*> data = Map(fd, size);
+  close(fd);
+  TF_RETURN_IF_ERROR(data.status());
+  const Header* header = HeaderOf(*data);
+  absl::Status status;
+  if (header->magic.load(std::memory_order_acquire) != kMagic) {
+    status = absl::UnavailableError(absl::StrCat(
+        "The shared memory ring buffer ", shm_name, " is not ready yet."));
+  } else if (RegionBytes(*header) != size) {
+    status = absl::DataLossError(absl::StrCat(
+        "The shared memory ring buffer ", shm_name, " is corrupted."));
+  } else if (consumer_index >= header->num_consumers) {
+    status = absl::InvalidArgumentError(absl::StrCat(
+        "Consumer index ", consumer_index, " is out of range for the ",
+        header->num_consumers, " consumers of ", shm_name, "."));
+  }
+  if (!status.ok()) {
+    munmap(*data, size);
+    return status;
+  }
+  return absl::WrapUnique(new SharedMemoryElementConsumer(
+      core::RefCountPtr<Cursor>(new Cursor(*data, consumer_index))));
+}
+
+SharedMemoryElementConsumer::SharedMemoryElementConsumer(
+    core::RefCountPtr<Cursor> cursor)
+    : cursor_(std::move(cursor)) {}
+
+SharedMemoryElementConsumer::~SharedMemoryElementConsumer() = default;
+
+absl::Status SharedMemoryElementConsumer::GetNext(
+    std::vector<Tensor>* element, bool* end_of_sequence,
+    CancellationManager* cancellation_manager) {
+  const Header* header = cursor_->header();
+  const uint64_t index = cursor_->next();
+  int64_t poll_micros = kMinPollMicros;
+  while (header->num_published.load(std::memory_order_acquire) <= index) {
+    // The publisher publishes its last element before it closes the buffer.
+    if (header->closed.load(std::memory_order_acquire) &&
+        header->num_published.load(std::memory_order_acquire) <= index) {
+      *end_of_sequence = true;
+      return absl::OkStatus();
+    }
+    if (cancellation_manager != nullptr &&
+        cancellation_manager->IsCancelled()) {
+      return absl::CancelledError(
+          "Cancelled while waiting for a shared memory element.");
+    }
+    Poll(&poll_micros);
+  }
+  *end_of_sequence = false;
+  cursor_->Advance();
+  Cursor* cursor = cursor_.get();
+  cursor->Ref();
+  core::RefCountPtr<SlotLease> lease(new SlotLease([cursor, index]() {
+    cursor->Release(index);
+    cursor->Unref();
+  }));
+
+  const char* slot = Slot(cursor_->data(), index);
+  const char* limit = slot + header->slot_bytes;
+  const uint64_t num_components = core::DecodeFixed64(slot);
+  const char* pos = slot + kElementEncodingAlignment;
+  if (num_components > header->slot_bytes / kElementEncodingAlignment) {
+    return absl::DataLossError("The shared memory ring buffer is corrupted.");
+  }
+  element->clear();
+  element->reserve(num_components);
+  for (uint64_t i = 0; i < num_components; ++i) {
+    element->emplace_back();
+    TF_RETURN_IF_ERROR(DecodeComponent(lease.get(), kAllocatorName, slot, &pos,
+                                       limit, &element->back()));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,125 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SHARED_MEMORY_RING_BUFFER_H_
+#define TENSORFLOW_CORE_DATA_SHARED_MEMORY_RING_BUFFER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/refcount.h"
+
+namespace tensorflow {
+namespace data {
+
+// A ring buffer in POSIX shared memory through which one process publishes
+// dataset elements to consumers in other processes on the same host, so that
+// several processes that read the same dataset run its input pipeline once.
+//
+// Every consumer receives every element, in the order in which they were
+// published. Elements are stored in fixed-size slots. Tensors of types that
+// can be copied with memcpy are not copied out of a slot but alias it, and the
+// slot is only reused once every consumer has destroyed the tensors of the
+// element it holds. Tensors of other types are copied.
+//
+// The publisher waits for the slowest consumer, so all `num_consumers`
+// consumers must keep reading. Consumers wait for elements by polling, and a
+// consumer whose publisher exits without closing the buffer waits forever.
+
+// Publishes elements to a new shared memory ring buffer, which is removed
+// when the publisher is destroyed. Not thread-safe.
+class SharedMemoryElementPublisher {
+ public:
+  struct Options {
+    // The name of the shared memory object, e.g. "/tf_data_train".
+    std::string name;
+    // The number of elements that the buffer holds.
+    int64_t num_slots = 16;
+    // The maximum size of an encoded element.
+    int64_t slot_bytes = 64 << 20;  // 64MB
+    // The number of consumers that read every element.
+    int64_t num_consumers = 1;
+  };
+
+  static absl::StatusOr<std::unique_ptr<SharedMemoryElementPublisher>> Create(
+      const Options& options);
+
+  // Closes the buffer if it has not been closed.
+  ~SharedMemoryElementPublisher();
+
+  SharedMemoryElementPublisher(const SharedMemoryElementPublisher&) = delete;
+  SharedMemoryElementPublisher& operator=(const SharedMemoryElementPublisher&) =
+      delete;
+
+  // Publishes `element`, waiting until its slot has been released by every
+  // consumer. Returns an `InvalidArgument` error if the element does not fit
+  // in a slot.
+  absl::Status Publish(const std::vector<Tensor>& element);
+
+  // Signals the end of the sequence to the consumers once they have read all
+  // published elements.
+  void Close();
+
+ private:
+  SharedMemoryElementPublisher(std::string name, char* data);
+
+  const std::string name_;
+  // The mapping of the shared memory object.
+  char* const data_;
+  bool closed_ = false;
+};
+
+// Reads the elements of a shared memory ring buffer as one of its consumers.
+// Not thread-safe.
+class SharedMemoryElementConsumer {
+ public:
+  // Opens the buffer `name` as the consumer `consumer_index`, which must be in
+  // [0, num_consumers). Returns an `Unavailable` error if the buffer has not
+  // been created yet.
+  static absl::StatusOr<std::unique_ptr<SharedMemoryElementConsumer>> Open(
+      const std::string& name, int64_t consumer_index);
+
+  ~SharedMemoryElementConsumer();
+
+  SharedMemoryElementConsumer(const SharedMemoryElementConsumer&) = delete;
+  SharedMemoryElementConsumer& operator=(const SharedMemoryElementConsumer&) =
+      delete;
+
+  // Returns the next element, waiting until it is published, or sets
+  // `end_of_sequence` once the publisher has closed the buffer and all of its
+  // elements have been read. The tensors of the element may keep its slot
+  // from being reused, and the buffer mapped, until they are destroyed.
+  // Returns a `Cancelled` error if `cancellation_manager` is cancelled while
+  // waiting.
+  absl::Status GetNext(std::vector<Tensor>* element, bool* end_of_sequence,
+                       CancellationManager* cancellation_manager = nullptr);
+
+ private:
+  class Cursor;
+
+  explicit SharedMemoryElementConsumer(core::RefCountPtr<Cursor> cursor);
+
+  const core::RefCountPtr<Cursor> cursor_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SHARED_MEMORY_RING_BUFFER_H_
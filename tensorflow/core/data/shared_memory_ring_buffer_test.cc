@@ -0,0 +1,246 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/shared_memory_ring_buffer.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Shared memory names are global to the host, so tests that run concurrently
+// must not share them.
+std::string TestName(const std::string& name) {
+  return absl::StrCat("/tf_data_shm_test_", getpid(), "_", name);
+}
+
+std::vector<Tensor> TestElement(int64_t i) {
+  Tensor strings(DT_STRING, TensorShape({2}));
+  strings.flat<tstring>()(0) = absl::StrCat("element ", i);
+  strings.flat<tstring>()(1) = "";
+  return {test::AsTensor<int64_t>({i, i + 1, i + 2}, TensorShape({3})),
+          test::AsScalar<float>(i / 2.0f), strings};
+}
+
+void ExpectElement(const std::vector<Tensor>& element, int64_t i) {
+  std::vector<Tensor> expected = TestElement(i);
+  ASSERT_EQ(element.size(), expected.size());
+  for (int j = 0; j < expected.size(); ++j) {
+    test::ExpectEqual(element[j], expected[j]);
+  }
+}
+
+SharedMemoryElementPublisher::Options TestOptions(const std::string& name,
+                                                  int64_t num_consumers) {
+  SharedMemoryElementPublisher::Options options;
+  options.name = TestName(name);
+  options.num_slots = 4;
+  options.slot_bytes = 4096;
+  options.num_consumers = num_consumers;
+  return options;
+}
+
+TEST(SharedMemoryRingBufferTest, EveryConsumerReadsEveryElement) {
+  constexpr int64_t kNumElements = 20;
+  constexpr int64_t kNumConsumers = 2;
+  const SharedMemoryElementPublisher::Options options =
+      TestOptions("every_consumer", kNumConsumers);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementPublisher> publisher,
+      SharedMemoryElementPublisher::Create(options));
+  std::vector<std::unique_ptr<Thread>> consumers;
+  for (int64_t c = 0; c < kNumConsumers; ++c) {
+    consumers.emplace_back(Env::Default()->StartThread(
+        ThreadOptions(), absl::StrCat("consumer_", c), [&options, c]() {
+          TF_ASSERT_OK_AND_ASSIGN(
+              std::unique_ptr<SharedMemoryElementConsumer> consumer,
+              SharedMemoryElementConsumer::Open(options.name, c));
+          for (int64_t i = 0; i < kNumElements; ++i) {
+            std::vector<Tensor> element;
+            bool end_of_sequence = true;
+            TF_ASSERT_OK(consumer->GetNext(&element, &end_of_sequence));
+            ASSERT_FALSE(end_of_sequence);
+            ExpectElement(element, i);
+          }
+          std::vector<Tensor> element;
+          bool end_of_sequence = false;
+          TF_ASSERT_OK(consumer->GetNext(&element, &end_of_sequence));
+          EXPECT_TRUE(end_of_sequence);
+        }));
+  }
+  // The buffer holds fewer elements than are published, so the publisher
+  // waits for the consumers.
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    TF_ASSERT_OK(publisher->Publish(TestElement(i)));
+  }
+  publisher->Close();
+  consumers.clear();
+}
+
+TEST(SharedMemoryRingBufferTest, TensorsHoldTheirSlot) {
+  const SharedMemoryElementPublisher::Options options =
+      TestOptions("hold_slot", /*num_consumers=*/1);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementPublisher> publisher,
+      SharedMemoryElementPublisher::Create(options));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementConsumer> consumer,
+      SharedMemoryElementConsumer::Open(options.name, /*consumer_index=*/0));
+  for (int64_t i = 0; i < options.num_slots; ++i) {
+    TF_ASSERT_OK(publisher->Publish(TestElement(i)));
+  }
+  std::vector<Tensor> first;
+  bool end_of_sequence = false;
+  TF_ASSERT_OK(consumer->GetNext(&first, &end_of_sequence));
+  // Reading the other elements does not release the first one's slot.
+  for (int64_t i = 1; i < options.num_slots; ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(consumer->GetNext(&element, &end_of_sequence));
+    ExpectElement(element, i);
+  }
+  std::atomic<bool> published = false;
+  std::unique_ptr<Thread> thread(Env::Default()->StartThread(
+      ThreadOptions(), "publisher", [&publisher, &options, &published]() {
+        TF_ASSERT_OK(publisher->Publish(TestElement(options.num_slots)));
+        published = true;
+      }));
+  Env::Default()->SleepForMicroseconds(100 * 1000);
+  EXPECT_FALSE(published);
+  ExpectElement(first, 0);
+  // The consumer tensors alias the slot, which is not reused until they are
+  // destroyed.
+  EXPECT_FALSE(first[0].RefCountIsOne());
+  first.clear();
+  thread.reset();
+  EXPECT_TRUE(published);
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(consumer->GetNext(&element, &end_of_sequence));
+  ExpectElement(element, options.num_slots);
+}
+
+TEST(SharedMemoryRingBufferTest, EmptySequence) {
+  const SharedMemoryElementPublisher::Options options =
+      TestOptions("empty", /*num_consumers=*/1);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementPublisher> publisher,
+      SharedMemoryElementPublisher::Create(options));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementConsumer> consumer,
+      SharedMemoryElementConsumer::Open(options.name, /*consumer_index=*/0));
+  publisher->Close();
+  std::vector<Tensor> element;
+  bool end_of_sequence = false;
+  TF_ASSERT_OK(consumer->GetNext(&element, &end_of_sequence));
+  EXPECT_TRUE(end_of_sequence);
+  EXPECT_EQ(publisher->Publish(TestElement(0)).code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+TEST(SharedMemoryRingBufferTest, CancelWhileWaiting) {
+  const SharedMemoryElementPublisher::Options options =
+      TestOptions("cancel", /*num_consumers=*/1);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementPublisher> publisher,
+      SharedMemoryElementPublisher::Create(options));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementConsumer> consumer,
+      SharedMemoryElementConsumer::Open(options.name, /*consumer_index=*/0));
+  CancellationManager cancellation_manager;
+  std::unique_ptr<Thread> thread(Env::Default()->StartThread(
+      ThreadOptions(), "cancel", [&cancellation_manager]() {
+        Env::Default()->SleepForMicroseconds(10 * 1000);
+        cancellation_manager.StartCancel();
+      }));
+  std::vector<Tensor> element;
+  bool end_of_sequence = false;
+  EXPECT_EQ(
+      consumer->GetNext(&element, &end_of_sequence, &cancellation_manager)
+          .code(),
+      absl::StatusCode::kCancelled);
+}
+
+TEST(SharedMemoryRingBufferTest, ElementTooLarge) {
+  const SharedMemoryElementPublisher::Options options =
+      TestOptions("too_large", /*num_consumers=*/1);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementPublisher> publisher,
+      SharedMemoryElementPublisher::Create(options));
+  Tensor large(DT_INT64, TensorShape({options.slot_bytes}));
+  EXPECT_EQ(publisher->Publish({large}).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(SharedMemoryRingBufferTest, InvalidOptions) {
+  SharedMemoryElementPublisher::Options options =
+      TestOptions("invalid", /*num_consumers=*/0);
+  EXPECT_EQ(SharedMemoryElementPublisher::Create(options).status().code(),
+            absl::StatusCode::kInvalidArgument);
+  options.num_consumers = 1;
+  options.num_slots = 0;
+  EXPECT_EQ(SharedMemoryElementPublisher::Create(options).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(SharedMemoryRingBufferTest, OpenMissingBuffer) {
+  EXPECT_EQ(SharedMemoryElementConsumer::Open(TestName("missing"),
+                                              /*consumer_index=*/0)
+                .status()
+                .code(),
+            absl::StatusCode::kUnavailable);
+}
+
+TEST(SharedMemoryRingBufferTest, ConsumerIndexOutOfRange) {
+  const SharedMemoryElementPublisher::Options options =
+      TestOptions("index_out_of_range", /*num_consumers=*/2);
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementPublisher> publisher,
+      SharedMemoryElementPublisher::Create(options));
+  EXPECT_EQ(SharedMemoryElementConsumer::Open(options.name, 2).status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(SharedMemoryRingBufferTest, BufferIsRemovedWithThePublisher) {
+  const SharedMemoryElementPublisher::Options options =
+      TestOptions("removed", /*num_consumers=*/1);
+  {
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<SharedMemoryElementPublisher> publisher,
+        SharedMemoryElementPublisher::Create(options));
+  }
+  EXPECT_EQ(SharedMemoryElementConsumer::Open(options.name, 0).status().code(),
+            absl::StatusCode::kUnavailable);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
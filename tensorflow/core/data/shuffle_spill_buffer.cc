@@ -0,0 +1,178 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/shuffle_spill_buffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/protobuf.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+constexpr char kSpillFilePrefix[] = "shuffle_spill_";
+// Size of the read-ahead buffer of each spill file.
+constexpr int64_t kReadBufferBytes = 1 << 20;
+
+}  // namespace
+
+ShuffleSpillBuffer::ShuffleSpillBuffer(Env* env, std::string directory,
+                                       int64_t num_components)
+    : env_(env),
+      directory_(std::move(directory)),
+      num_components_(num_components) {}
+
+ShuffleSpillBuffer::~ShuffleSpillBuffer() {
+  for (auto& file : files_) {
+    DeleteSpillFile(file.get());
+  }
+}
+
+void ShuffleSpillBuffer::Add(std::vector<Tensor> element) {
+  resident_bytes_ += GetTotalBytes(element);
+  resident_.push_back(std::move(element));
+}
+
+absl::Status ShuffleSpillBuffer::Spill(const RandomFn& random) {
+  if (resident_.empty()) {
+    return absl::OkStatus();
+  }
+  for (int64_t i = resident_.size() - 1; i > 0; --i) {
+    std::swap(resident_[i], resident_[random() % (i + 1)]);
+  }
+  auto file = std::make_unique<SpillFile>();
+  file->filename = io::JoinPath(
+      directory_, absl::StrCat(kSpillFilePrefix,
+                               absl::Hex(random::New64(), absl::kZeroPad16),
+                               ".tfrecord"));
+  absl::Status s = WriteSpillFile(file->filename);
+  if (!s.ok()) {
+    env_->DeleteFile(file->filename).IgnoreError();
+    return s;
+  }
+  file->num_remaining = resident_.size();
+  num_spilled_ += resident_.size();
+  files_.push_back(std::move(file));
+  resident_.clear();
+  resident_bytes_ = 0;
+  return absl::OkStatus();
+}
+
+absl::Status ShuffleSpillBuffer::Take(const RandomFn& random,
+                                      std::vector<Tensor>* element) {
+  TF_RETURN_IF_ERROR(read_status_);
+  if (size() == 0) {
+    return absl::FailedPreconditionError("The shuffle buffer is empty.");
+  }
+  int64_t index = random() % size();
+  if (index < static_cast<int64_t>(resident_.size())) {
+    std::swap(resident_[index], resident_.back());
+    *element = std::move(resident_.back());
+    resident_.pop_back();
+    resident_bytes_ -= GetTotalBytes(*element);
+    return absl::OkStatus();
+  }
+  index -= resident_.size();
+  auto it = files_.begin();
+  while (index >= (*it)->num_remaining) {
+    index -= (*it)->num_remaining;
+    ++it;
+  }
+  read_status_ = ReadNext(it->get(), element);
+  TF_RETURN_IF_ERROR(read_status_);
+  --num_spilled_;
+  if (--(*it)->num_remaining == 0) {
+    DeleteSpillFile(it->get());
+    files_.erase(it);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ShuffleSpillBuffer::WriteSpillFile(const std::string& filename) {
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(env_->NewWritableFile(filename, &file));
+  io::RecordWriter writer(file.get());
+  TensorProto proto;
+  std::string record;
+  for (const std::vector<Tensor>& element : resident_) {
+    for (const Tensor& tensor : element) {
+      tensor.AsProtoTensorContent(&proto);
+      if (!proto.SerializeToString(&record)) {
+        return absl::DataLossError(absl::StrCat(
+            "Failed to serialize tensor of shape ",
+            tensor.shape().DebugString(), " to shuffle spill file ",
+            filename));
+      }
+      TF_RETURN_IF_ERROR(writer.WriteRecord(record));
+    }
+  }
+  TF_RETURN_IF_ERROR(writer.Close());
+  return file->Close();
+}
+
+absl::Status ShuffleSpillBuffer::ReadNext(SpillFile* file,
+                                          std::vector<Tensor>* element) {
+  if (file->reader == nullptr) {
+    TF_RETURN_IF_ERROR(env_->NewRandomAccessFile(file->filename, &file->file));
+    io::RecordReaderOptions options;
+    options.buffer_size = kReadBufferBytes;
+    file->reader = std::make_unique<io::SequentialRecordReader>(
+        file->file.get(), options);
+  }
+  element->clear();
+  element->reserve(num_components_);
+  tstring record;
+  for (int64_t i = 0; i < num_components_; ++i) {
+    TF_RETURN_IF_ERROR(file->reader->ReadRecord(&record));
+    TensorProto proto;
+    Tensor tensor;
+    if (!ParseProtoUnlimited(&proto, record.data(), record.size()) ||
+        !tensor.FromProto(proto)) {
+      return absl::DataLossError(absl::StrCat(
+          "Failed to parse tensor from shuffle spill file ", file->filename));
+    }
+    element->push_back(std::move(tensor));
+  }
+  return absl::OkStatus();
+}
+
+void ShuffleSpillBuffer::DeleteSpillFile(SpillFile* file) {
+  file->reader.reset();
+  file->file.reset();
+  absl::Status s = env_->DeleteFile(file->filename);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to delete shuffle spill file " << file->filename
+                 << ": " << s;
+  }
+}
+
+}  // namespace data
+}  // namespace tensorflow
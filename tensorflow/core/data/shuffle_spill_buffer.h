@@ -0,0 +1,102 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_SHUFFLE_SPILL_BUFFER_H_
+#define TENSORFLOW_CORE_DATA_SHUFFLE_SPILL_BUFFER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/platform/env.h"
+
+namespace tensorflow {
+namespace data {
+
+// A shuffle buffer that keeps only some of its elements in memory and the rest
+// in files on local disk.
+//
+// `Spill` writes all elements held in memory to a new file in one sequential
+// pass, after putting them in random order. Reading a file front to back thus
+// yields its elements in random order, which lets `Take` remove a uniformly
+// random element without seeking: it picks memory or one of the files with
+// probability proportional to the number of elements they hold, and then
+// reads the next record of the file through a read-ahead buffer. Memory use is
+// the elements held in memory plus one read-ahead buffer per file.
+//
+// Not thread-safe.
+class ShuffleSpillBuffer {
+ public:
+  // Returns a uniformly distributed random number.
+  using RandomFn = std::function<uint64_t()>;
+
+  // Spill files are created in `directory`, which must exist, and are deleted
+  // once they have been read or when the buffer is destroyed.
+  ShuffleSpillBuffer(Env* env, std::string directory, int64_t num_components);
+  ~ShuffleSpillBuffer();
+
+  ShuffleSpillBuffer(const ShuffleSpillBuffer&) = delete;
+  ShuffleSpillBuffer& operator=(const ShuffleSpillBuffer&) = delete;
+
+  // Adds `element`, which must have `num_components` components, in memory.
+  void Add(std::vector<Tensor> element);
+
+  // Moves the elements held in memory to a new spill file.
+  absl::Status Spill(const RandomFn& random);
+
+  // Removes a uniformly random element. Once reading a spill file fails, the
+  // buffer no longer knows where the next record starts, so this and every
+  // later call return that error.
+  absl::Status Take(const RandomFn& random, std::vector<Tensor>* element);
+
+  // Number of elements, both in memory and spilled.
+  int64_t size() const { return resident_.size() + num_spilled_; }
+  int64_t num_spilled() const { return num_spilled_; }
+  int64_t num_files() const { return files_.size(); }
+  // Bytes of the elements held in memory.
+  int64_t resident_bytes() const { return resident_bytes_; }
+
+ private:
+  struct SpillFile {
+    std::string filename;
+    int64_t num_remaining = 0;
+    // Opened on the first read.
+    std::unique_ptr<RandomAccessFile> file;
+    std::unique_ptr<io::SequentialRecordReader> reader;
+  };
+
+  absl::Status WriteSpillFile(const std::string& filename);
+  absl::Status ReadNext(SpillFile* file, std::vector<Tensor>* element);
+  void DeleteSpillFile(SpillFile* file);
+
+  Env* const env_;
+  const std::string directory_;
+  const int64_t num_components_;
+  std::vector<std::vector<Tensor>> resident_;
+  int64_t resident_bytes_ = 0;
+  std::vector<std::unique_ptr<SpillFile>> files_;
+  int64_t num_spilled_ = 0;
+  // The first error from reading a spill file.
+  absl::Status read_status_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_SHUFFLE_SPILL_BUFFER_H_
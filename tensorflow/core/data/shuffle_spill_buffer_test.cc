@@ -0,0 +1,177 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/shuffle_spill_buffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::IsEmpty;
+using ::testing::SizeIs;
+using ::testing::UnorderedElementsAreArray;
+
+class ShuffleSpillBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = io::JoinPath(
+        testing::TmpDir(),
+        ::testing::UnitTest::GetInstance()->current_test_info()->name());
+    TF_ASSERT_OK(Env::Default()->RecursivelyCreateDir(directory_));
+  }
+
+  std::vector<std::string> SpillFiles() {
+    std::vector<std::string> files;
+    TF_CHECK_OK(Env::Default()->GetChildren(directory_, &files));
+    return files;
+  }
+
+  ShuffleSpillBuffer::RandomFn Random() {
+    return [this]() { return random_.Rand64(); };
+  }
+
+  std::string directory_;
+  random::PhiloxRandom philox_{/*seed_lo=*/1, /*seed_hi=*/2};
+  random::SimplePhilox random_{&philox_};
+};
+
+TEST_F(ShuffleSpillBufferTest, TakesEveryElementOnce) {
+  ShuffleSpillBuffer buffer(Env::Default(), directory_, /*num_components=*/1);
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < 100; ++i) {
+    buffer.Add({test::AsScalar<int64_t>(i)});
+    expected.push_back(i);
+    if (i % 30 == 29) {
+      TF_ASSERT_OK(buffer.Spill(Random()));
+    }
+  }
+  EXPECT_EQ(buffer.size(), 100);
+  EXPECT_EQ(buffer.num_spilled(), 90);
+  EXPECT_EQ(buffer.num_files(), 3);
+  EXPECT_THAT(SpillFiles(), SizeIs(3));
+
+  std::vector<int64_t> taken;
+  while (buffer.size() > 0) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(buffer.Take(Random(), &element));
+    ASSERT_EQ(element.size(), 1);
+    taken.push_back(element[0].scalar<int64_t>()());
+  }
+  EXPECT_THAT(taken, UnorderedElementsAreArray(expected));
+  EXPECT_NE(taken, expected);
+  // Files are deleted once they have been read.
+  EXPECT_EQ(buffer.num_files(), 0);
+  EXPECT_THAT(SpillFiles(), IsEmpty());
+}
+
+TEST_F(ShuffleSpillBufferTest, SpillReleasesMemory) {
+  ShuffleSpillBuffer buffer(Env::Default(), directory_, /*num_components=*/2);
+  buffer.Add({test::AsScalar<tstring>("abc"), test::AsScalar<int64_t>(1)});
+  buffer.Add({test::AsScalar<tstring>("def"), test::AsScalar<int64_t>(2)});
+  EXPECT_GT(buffer.resident_bytes(), 0);
+  TF_ASSERT_OK(buffer.Spill(Random()));
+  EXPECT_EQ(buffer.resident_bytes(), 0);
+  EXPECT_EQ(buffer.size(), 2);
+
+  std::vector<std::vector<Tensor>> taken(2);
+  TF_ASSERT_OK(buffer.Take(Random(), &taken[0]));
+  TF_ASSERT_OK(buffer.Take(Random(), &taken[1]));
+  if (taken[0][1].scalar<int64_t>()() == 2) {
+    std::swap(taken[0], taken[1]);
+  }
+  test::ExpectEqual(taken[0][0], test::AsScalar<tstring>("abc"));
+  test::ExpectEqual(taken[0][1], test::AsScalar<int64_t>(1));
+  test::ExpectEqual(taken[1][0], test::AsScalar<tstring>("def"));
+  test::ExpectEqual(taken[1][1], test::AsScalar<int64_t>(2));
+}
+
+TEST_F(ShuffleSpillBufferTest, DeletesFilesOnDestruction) {
+  {
+    ShuffleSpillBuffer buffer(Env::Default(), directory_,
+                              /*num_components=*/1);
+    for (int64_t i = 0; i < 10; ++i) {
+      buffer.Add({test::AsScalar<int64_t>(i)});
+    }
+    TF_ASSERT_OK(buffer.Spill(Random()));
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(buffer.Take(Random(), &element));
+    EXPECT_THAT(SpillFiles(), SizeIs(1));
+  }
+  EXPECT_THAT(SpillFiles(), IsEmpty());
+}
+
+TEST_F(ShuffleSpillBufferTest, TakeFromEmptyBuffer) {
+  ShuffleSpillBuffer buffer(Env::Default(), directory_, /*num_components=*/1);
+  std::vector<Tensor> element;
+  EXPECT_EQ(buffer.Take(Random(), &element).code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+// A record that fails to parse leaves the reader in the middle of an element,
+// so the buffer must not read past it and return misaligned components.
+TEST_F(ShuffleSpillBufferTest, FailedReadPoisonsBuffer) {
+  ShuffleSpillBuffer buffer(Env::Default(), directory_, /*num_components=*/2);
+  buffer.Add({test::AsScalar<int64_t>(1), test::AsScalar<int64_t>(2)});
+  buffer.Add({test::AsScalar<int64_t>(3), test::AsScalar<int64_t>(4)});
+  TF_ASSERT_OK(buffer.Spill(Random()));
+  std::vector<std::string> files = SpillFiles();
+  ASSERT_THAT(files, SizeIs(1));
+
+  // Rewrite the spill file so that the second record of the first element is
+  // corrupt and the second element is intact.
+  std::unique_ptr<WritableFile> file;
+  TF_ASSERT_OK(Env::Default()->NewWritableFile(
+      io::JoinPath(directory_, files[0]), &file));
+  io::RecordWriter writer(file.get());
+  auto write_tensor = [&writer](int64_t value) {
+    TensorProto proto;
+    test::AsScalar<int64_t>(value).AsProtoTensorContent(&proto);
+    return writer.WriteRecord(proto.SerializeAsString());
+  };
+  TF_ASSERT_OK(write_tensor(1));
+  TF_ASSERT_OK(writer.WriteRecord("\xff\xff\xff\xff"));
+  TF_ASSERT_OK(write_tensor(3));
+  TF_ASSERT_OK(write_tensor(4));
+  TF_ASSERT_OK(writer.Close());
+  TF_ASSERT_OK(file->Close());
+
+  std::vector<Tensor> element;
+  EXPECT_EQ(buffer.Take(Random(), &element).code(),
+            absl::StatusCode::kDataLoss);
+  EXPECT_EQ(buffer.Take(Random(), &element).code(),
+            absl::StatusCode::kDataLoss);
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
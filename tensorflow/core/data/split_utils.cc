@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/data/split_utils.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -60,6 +61,12 @@ absl::Status IndexSplitProvider::GetNext(Tensor* split, bool* end_of_splits) {
   return absl::OkStatus();
 }
 
+absl::Status IndexSplitProvider::Skip(int64_t num_splits) {
+  tsl::mutex_lock l(mu_);
+  i_ += std::min(num_splits, n_ - i_);
+  return absl::OkStatus();
+}
+
 absl::Status IndexSplitProvider::Reset() {
   tsl::mutex_lock l(mu_);
   i_ = 0;
@@ -112,6 +119,19 @@ absl::Status ShardingSplitProvider::GetNext(Tensor* split,
   return absl::OkStatus();
 }
 
+absl::Status ShardingSplitProvider::Skip(int64_t num_splits) {
+  if (num_splits <= 0) {
+    return absl::OkStatus();
+  }
+  tsl::mutex_lock l(mu_);
+  // Each returned split consumes `num_shards_` underlying splits, except the
+  // first, which consumes the `num_to_skip_` splits left before it.
+  TF_RETURN_IF_ERROR(split_provider_->Skip(
+      num_to_skip_ + (num_splits - 1) * num_shards_ + 1));
+  num_to_skip_ = num_shards_ - 1;
+  return absl::OkStatus();
+}
+
 absl::Status ShardingSplitProvider::Reset() {
   tsl::mutex_lock l(mu_);
   TF_RETURN_IF_ERROR(split_provider_->Reset());
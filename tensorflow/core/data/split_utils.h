@@ -37,6 +37,7 @@ class IndexSplitProvider : public SplitProvider {
  public:
   explicit IndexSplitProvider(int64_t n);
   absl::Status GetNext(Tensor* split, bool* end_of_splits) override;
+  absl::Status Skip(int64_t num_splits) override;
   absl::Status Reset() override;
   absl::Status Save(std::function<std::string(std::string)> full_name,
                     IteratorStateWriter* writer) override;
@@ -58,6 +59,7 @@ class ShardingSplitProvider : public SplitProvider {
                         std::shared_ptr<SplitProvider> split_provider);
 
   absl::Status GetNext(Tensor* split, bool* end_of_splits) override;
+  absl::Status Skip(int64_t num_splits) override;
   absl::Status Reset() override;
   absl::Status Save(std::function<std::string(std::string)> full_name,
                     IteratorStateWriter* writer) override;
@@ -95,6 +95,20 @@ TEST(IndexSplitProviderTest, SaveAndRestore) {
   EXPECT_TRUE(end_of_splits);
 }
 
+TEST(IndexSplitProviderTest, Skip) {
+  IndexSplitProvider split_provider(4);
+  TF_ASSERT_OK(split_provider.Skip(2));
+  TF_EXPECT_OK(CheckOutput(
+      &split_provider, CreateTensors<int64_t>(TensorShape({}), {{2}, {3}})));
+}
+
+TEST(IndexSplitProviderTest, SkipPastEnd) {
+  IndexSplitProvider split_provider(4);
+  TF_ASSERT_OK(split_provider.Skip(10));
+  TF_EXPECT_OK(CheckOutput(&split_provider,
+                           CreateTensors<int64_t>(TensorShape({}), {})));
+}
+
 TEST(ShardingSplitProviderTest, TwoWayShardZero) {
   auto base = std::make_shared<IndexSplitProvider>(4);
   ShardingSplitProvider split_provider(2, 0, base);
@@ -123,6 +137,27 @@ TEST(ShardingSplitProviderTest, Empty) {
                            CreateTensors<int64_t>(TensorShape({}), {})));
 }
 
+TEST(ShardingSplitProviderTest, Skip) {
+  auto base = std::make_shared<IndexSplitProvider>(10);
+  ShardingSplitProvider split_provider(3, 1, base);
+  TF_ASSERT_OK(split_provider.Skip(1));
+  TF_EXPECT_OK(CheckOutput(
+      &split_provider, CreateTensors<int64_t>(TensorShape({}), {{4}, {7}})));
+}
+
+TEST(ShardingSplitProviderTest, SkipAfterGetNext) {
+  auto base = std::make_shared<IndexSplitProvider>(10);
+  ShardingSplitProvider split_provider(3, 1, base);
+  Tensor split;
+  bool end_of_splits = true;
+  TF_ASSERT_OK(split_provider.GetNext(&split, &end_of_splits));
+  EXPECT_FALSE(end_of_splits);
+  test::ExpectEqual(split, CreateTensor<int64_t>(TensorShape({}), {1}));
+  TF_ASSERT_OK(split_provider.Skip(1));
+  TF_EXPECT_OK(CheckOutput(&split_provider,
+                           CreateTensors<int64_t>(TensorShape({}), {{7}})));
+}
+
 TEST(ShardingSplitProviderTest, SaveAndRestore) {
   auto base = std::make_shared<IndexSplitProvider>(6);
   std::vector<Tensor> expected =
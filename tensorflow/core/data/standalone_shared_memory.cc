@@ -0,0 +1,45 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/standalone_shared_memory.h"
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "xla/tsl/platform/errors.h"
+#include "tensorflow/core/data/shared_memory_ring_buffer.h"
+#include "tensorflow/core/data/standalone.h"
+#include "tensorflow/core/framework/tensor.h"
+
+namespace tensorflow {
+namespace data {
+namespace standalone {
+
+absl::Status PublishToSharedMemory(Iterator* iterator,
+                                   SharedMemoryElementPublisher* publisher) {
+  while (true) {
+    std::vector<Tensor> element;
+    bool end_of_input = false;
+    TF_RETURN_IF_ERROR(iterator->GetNext(&element, &end_of_input));
+    if (end_of_input) {
+      publisher->Close();
+      return absl::OkStatus();
+    }
+    TF_RETURN_IF_ERROR(publisher->Publish(element));
+  }
+}
+
+}  // namespace standalone
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,39 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_STANDALONE_SHARED_MEMORY_H_
+#define TENSORFLOW_CORE_DATA_STANDALONE_SHARED_MEMORY_H_
+
+#include "absl/status/status.h"
+#include "tensorflow/core/data/shared_memory_ring_buffer.h"
+#include "tensorflow/core/data/standalone.h"
+
+namespace tensorflow {
+namespace data {
+namespace standalone {
+
+// Publishes the elements of `iterator` to `publisher` until the end of the
+// input pipeline, and then closes `publisher`. This lets processes on the same
+// host that read the same dataset share one execution of its input pipeline,
+// by reading the elements with `SharedMemoryElementConsumer`s.
+//
+// This is only supported on POSIX platforms.
+absl::Status PublishToSharedMemory(Iterator* iterator,
+                                   SharedMemoryElementPublisher* publisher);
+
+}  // namespace standalone
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_STANDALONE_SHARED_MEMORY_H_
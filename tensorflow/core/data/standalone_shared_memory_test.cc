@@ -0,0 +1,74 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/standalone_shared_memory.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/data/service/test_util.h"
+#include "tensorflow/core/data/shared_memory_ring_buffer.h"
+#include "tensorflow/core/data/standalone.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace standalone {
+namespace {
+
+TEST(PublishToSharedMemory, Standalone) {
+  std::unique_ptr<Dataset> dataset;
+  TF_ASSERT_OK(Dataset::FromGraph(Dataset::Params(),
+                                  testing::RangeDataset(10).graph(), &dataset));
+  std::unique_ptr<Iterator> iterator;
+  TF_ASSERT_OK(dataset->MakeIterator(&iterator));
+  SharedMemoryElementPublisher::Options options;
+  options.name = absl::StrCat("/tf_data_standalone_test_", getpid());
+  options.num_slots = 4;
+  options.slot_bytes = 1024;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementPublisher> publisher,
+      SharedMemoryElementPublisher::Create(options));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SharedMemoryElementConsumer> consumer,
+      SharedMemoryElementConsumer::Open(options.name, /*consumer_index=*/0));
+  std::unique_ptr<Thread> thread(Env::Default()->StartThread(
+      ThreadOptions(), "publisher", [&iterator, &publisher]() {
+        TF_ASSERT_OK(PublishToSharedMemory(iterator.get(), publisher.get()));
+      }));
+
+  bool end_of_sequence = false;
+  for (int64_t i = 0; i < 10; ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(consumer->GetNext(&element, &end_of_sequence));
+    ASSERT_FALSE(end_of_sequence);
+    EXPECT_EQ(element[0].scalar<int64_t>()(), i);
+  }
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(consumer->GetNext(&element, &end_of_sequence));
+  EXPECT_TRUE(end_of_sequence);
+}
+
+}  // namespace
+}  // namespace standalone
+}  // namespace data
+}  // namespace tensorflow
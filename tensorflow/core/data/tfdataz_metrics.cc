@@ -15,18 +15,26 @@ limitations under the License.
 #include "tensorflow/core/data/tfdataz_metrics.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tsl/platform/thread_annotations.h"
 
 namespace tensorflow {
@@ -138,7 +146,60 @@ std::shared_ptr<model::Model> TfDatazMetricsCollector::GetModel() {
   return model_;
 }
 
+std::vector<model::Model::NodeStats> TfDatazMetricsCollector::GetNodeStats() {
+  if (!model_) {
+    return {};
+  }
+  return model_->CollectNodeStats();
+}
+
+std::string FormatNodeStats(const std::vector<model::Model::NodeStats>& stats) {
+  int64_t total_processing_time_nsec = 0;
+  for (const auto& node_stats : stats) {
+    total_processing_time_nsec += node_stats.processing_time_nsec;
+  }
+  std::string result;
+  for (const auto& node_stats : stats) {
+    const double processing_time_share =
+        total_processing_time_nsec > 0
+            ? 100.0 * node_stats.processing_time_nsec /
+                  total_processing_time_nsec
+            : 0.0;
+    const double get_next_latency_usec =
+        node_stats.num_elements > 0
+            ? node_stats.get_next_time_nsec / 1000.0 / node_stats.num_elements
+            : 0.0;
+    absl::StrAppendFormat(
+        &result,
+        "%s: elements: %d, processing time: %.3f ms (%.1f%%), GetNext time: "
+        "%.3f ms (%.1f us per element), bytes produced: %d, bytes buffered: "
+        "%d\n",
+        node_stats.name, node_stats.num_elements,
+        node_stats.processing_time_nsec / 1.0e6, processing_time_share,
+        node_stats.get_next_time_nsec / 1.0e6, get_next_latency_usec,
+        node_stats.bytes_produced, node_stats.buffered_bytes);
+  }
+  return result;
+}
+
 namespace {
+
+constexpr char kNodeStatsLogIntervalEnvVar[] =
+    "TF_DATA_NODE_STATS_LOG_INTERVAL_SECS";
+
+// Returns the interval at which node statistics are logged, or 0 if they are
+// not logged.
+int64_t NodeStatsLogIntervalSecs() {
+  int64_t interval_secs = 0;
+  absl::Status s =
+      ReadInt64FromEnvVar(kNodeStatsLogIntervalEnvVar, 0, &interval_secs);
+  if (!s.ok() || interval_secs < 0) {
+    LOG(WARNING) << "Ignoring " << kNodeStatsLogIntervalEnvVar << ": " << s;
+    return 0;
+  }
+  return interval_secs;
+}
+
 static mutex* get_tfdataz_metrics_registry_lock() {
   static mutex tfdataz_metrics_registry_lock(LINKER_INITIALIZED);
   return &tfdataz_metrics_registry_lock;
@@ -150,18 +211,88 @@ TfDatazMetricsCollectors& tfdataz_metric_collectors() {
   static auto& collectors = *new TfDatazMetricsCollectors();
   return collectors;
 }
+
+// Logs the node statistics of the registered iterators periodically until it
+// is destroyed.
+class NodeStatsLogger {
+ public:
+  explicit NodeStatsLogger(int64_t interval_secs)
+      : interval_secs_(interval_secs) {
+    thread_ = absl::WrapUnique(Env::Default()->StartThread(
+        ThreadOptions(), "tf_data_node_stats_logger", [this]() { Run(); }));
+  }
+
+  ~NodeStatsLogger() {
+    {
+      mutex_lock l(mu_);
+      cancelled_ = true;
+      cv_.notify_all();
+    }
+    thread_.reset();
+  }
+
+ private:
+  void Run() {
+    while (true) {
+      {
+        mutex_lock l(mu_);
+        const int64_t deadline_micros =
+            Env::Default()->NowMicros() + interval_secs_ * 1000000;
+        while (!cancelled_ && Env::Default()->NowMicros() < deadline_micros) {
+          cv_.wait_for(l, std::chrono::microseconds(
+                              deadline_micros - Env::Default()->NowMicros()));
+        }
+        if (cancelled_) {
+          return;
+        }
+      }
+      for (const auto& collector :
+           TfDatazMetricsRegistry::GetIteratorMetricCollectors()) {
+        std::vector<model::Model::NodeStats> stats = collector->GetNodeStats();
+        if (!stats.empty()) {
+          LOG(INFO) << "tf.data node statistics:\n" << FormatNodeStats(stats);
+        }
+      }
+    }
+  }
+
+  const int64_t interval_secs_;
+  mutex mu_;
+  condition_variable cv_;
+  bool cancelled_ TF_GUARDED_BY(mu_) = false;
+  std::unique_ptr<Thread> thread_;
+};
+
+// The node statistics logger, which runs while iterators are registered.
+std::unique_ptr<NodeStatsLogger>& node_stats_logger() {
+  static auto& logger = *new std::unique_ptr<NodeStatsLogger>();
+  return logger;
+}
 }  // namespace
 
 void TfDatazMetricsRegistry::Register(
     std::shared_ptr<TfDatazMetricsCollector> collector) {
+  static const int64_t interval_secs = NodeStatsLogIntervalSecs();
   mutex_lock l(*get_tfdataz_metrics_registry_lock());
   tfdataz_metric_collectors().insert(collector);
+  if (interval_secs > 0 && !node_stats_logger()) {
+    node_stats_logger() = std::make_unique<NodeStatsLogger>(interval_secs);
+  }
 }
 
 void TfDatazMetricsRegistry::Deregister(
     std::shared_ptr<TfDatazMetricsCollector> collector) {
-  mutex_lock l(*get_tfdataz_metrics_registry_lock());
-  tfdataz_metric_collectors().erase(collector);
+  std::unique_ptr<NodeStatsLogger> logger;
+  {
+    mutex_lock l(*get_tfdataz_metrics_registry_lock());
+    tfdataz_metric_collectors().erase(collector);
+    if (tfdataz_metric_collectors().empty()) {
+      logger = std::move(node_stats_logger());
+    }
+  }
+  // Stops the logger outside the lock, which its thread acquires to read the
+  // registered iterators.
+  logger.reset();
 }
 
 absl::flat_hash_set<std::shared_ptr<TfDatazMetricsCollector>>
@@ -19,6 +19,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/time/time.h"
@@ -120,12 +121,20 @@ class TfDatazMetricsCollector {
 
   std::shared_ptr<model::Model> GetModel();
 
+  // Returns the cumulative statistics of the nodes of the iterator's model,
+  // or an empty vector if the iterator is not modeled.
+  std::vector<model::Model::NodeStats> GetNodeStats();
+
  private:
   DatasetBaseIterator* iterator_;  // not owned
   std::shared_ptr<model::Model> model_;
   ApproximateLatencyEstimator latency_estimator_;
 };
 
+// Returns a human-readable report of `stats`, with one line per node that
+// shows how much of the pipeline's processing time the node accounts for.
+std::string FormatNodeStats(const std::vector<model::Model::NodeStats>& stats);
+
 // Thread-safe global registry for the /tfdataz metrics. All callers to
 // `TfDatazMetricsRegistry` use the same instance to register and deregister
 // iterator's `TfDatazMetricsCollector`.
@@ -133,6 +142,11 @@ class TfDatazMetricsRegistry {
  public:
   // Registers the iterator specific `TfDatazMetricsCollector` in the global
   // TfDatazMetricsRegistry.
+  //
+  // If the TF_DATA_NODE_STATS_LOG_INTERVAL_SECS environment variable is set
+  // to a positive number, the node statistics of all registered iterators are
+  // logged at that interval. The logging thread is stopped when the last
+  // iterator is deregistered.
   static void Register(std::shared_ptr<TfDatazMetricsCollector> collector);
 
   // Deregisters the iterator specific `TfDatazMetricsCollector` from the global
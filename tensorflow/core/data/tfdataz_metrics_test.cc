@@ -15,10 +15,13 @@ limitations under the License.
 #include "tensorflow/core/data/tfdataz_metrics.h"
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/time/time.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/util/fake_clock_env.h"
@@ -27,6 +30,8 @@ namespace tensorflow {
 namespace data {
 namespace {
 
+using ::testing::HasSubstr;
+
 static int64_t k1MinutesInMicros = absl::ToInt64Microseconds(absl::Minutes(1));
 static int64_t k2MinutesInMicros = absl::ToInt64Microseconds(absl::Minutes(2));
 static int64_t k5MinutesInMicros = absl::ToInt64Microseconds(absl::Minutes(5));
@@ -179,6 +184,46 @@ TEST_F(TfDatazMetricsTest, GetAverageLatencyWithZeroGetNextCalls) {
                   0);
 }
 
+TEST_F(TfDatazMetricsTest, GetNodeStatsWithoutModel) {
+  EXPECT_TRUE(tfdataz_metrics_->GetNodeStats().empty());
+}
+
+TEST(TfDatazNodeStatsTest, GetNodeStats) {
+  auto model = std::make_shared<model::Model>();
+  std::shared_ptr<model::Node> root =
+      model::MakeUnknownNode({0, "unknown0", nullptr});
+  model->AddNode([&root](model::Node::Args args) { return root; },
+                 root->name(), nullptr, &root);
+  root->record_get_next_time(1000);
+  std::unique_ptr<DatasetBaseIterator> iterator;
+  TfDatazMetricsCollector collector(*Env::Default(), iterator.get(), model);
+  std::vector<model::Model::NodeStats> stats = collector.GetNodeStats();
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_EQ(stats[0].name, root->long_name());
+  EXPECT_EQ(stats[0].get_next_time_nsec, 1000);
+}
+
+TEST(TfDatazNodeStatsTest, FormatNodeStats) {
+  model::Model::NodeStats map_stats;
+  map_stats.name = "ParallelMapV2(id:1)";
+  map_stats.num_elements = 10;
+  map_stats.processing_time_nsec = 3000000;
+  map_stats.get_next_time_nsec = 50000;
+  map_stats.bytes_produced = 1024;
+  model::Model::NodeStats source_stats;
+  source_stats.name = "TFRecordDataset(id:2)";
+  source_stats.num_elements = 10;
+  source_stats.processing_time_nsec = 1000000;
+  std::string report = FormatNodeStats({map_stats, source_stats});
+  EXPECT_THAT(report,
+              HasSubstr("ParallelMapV2(id:1): elements: 10, processing time: "
+                        "3.000 ms (75.0%), GetNext time: 0.050 ms (5.0 us per "
+                        "element), bytes produced: 1024"));
+  EXPECT_THAT(report, HasSubstr("TFRecordDataset(id:2): elements: 10, "
+                                "processing time: 1.000 ms (25.0%)"));
+  EXPECT_EQ(FormatNodeStats({}), "");
+}
+
 class ScopedTfDataMetricsRegistration {
  public:
   explicit ScopedTfDataMetricsRegistration(
@@ -0,0 +1,154 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// Registers zstd element codecs: "zstd" at the default compression level, and
+// "zstd-<level>" for levels 1 to 19. Higher levels trade worker CPU for fewer
+// transferred bytes. All levels are uncompressed the same way.
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/platform/snappy.h"
+// NOTE: The way zstd is packaged in TF, we cannot include it as <zstd.h>.
+#include "zstd.h"  // NOLINT(build/include)
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// The highest level that does not need extra memory to uncompress.
+constexpr int kMaxLevel = 19;
+
+absl::Status ZstdError(absl::string_view operation, size_t code) {
+  return absl::InternalError(absl::StrCat("Failed to ", operation,
+                                          " with zstd: ",
+                                          ZSTD_getErrorName(code)));
+}
+
+class ZstdCodec : public ElementCodec {
+ public:
+  explicit ZstdCodec(int level) : level_(level) {}
+
+  absl::Status Compress(const iovec* iov, size_t num_pieces, size_t num_bytes,
+                        std::string* out) const override {
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context(
+        ZSTD_createCCtx(), ZSTD_freeCCtx);
+    if (context == nullptr) {
+      return absl::InternalError("Failed to create a zstd context.");
+    }
+    size_t code = ZSTD_CCtx_setParameter(context.get(),
+                                         ZSTD_c_compressionLevel, level_);
+    if (ZSTD_isError(code)) {
+      return ZstdError("set the compression level", code);
+    }
+    code = ZSTD_CCtx_setPledgedSrcSize(context.get(), num_bytes);
+    if (ZSTD_isError(code)) {
+      return ZstdError("set the element size", code);
+    }
+    // With `ZSTD_compressBound` bytes of output, every call consumes all of
+    // its input.
+    out->resize(ZSTD_compressBound(num_bytes));
+    ZSTD_outBuffer output = {out->data(), out->size(), 0};
+    for (size_t i = 0; i < num_pieces; ++i) {
+      ZSTD_inBuffer input = {iov[i].iov_base, iov[i].iov_len, 0};
+      while (input.pos < input.size) {
+        code = ZSTD_compressStream2(context.get(), &output, &input,
+                                    ZSTD_e_continue);
+        if (ZSTD_isError(code)) {
+          return ZstdError("compress", code);
+        }
+      }
+    }
+    ZSTD_inBuffer input = {nullptr, 0, 0};
+    do {
+      code = ZSTD_compressStream2(context.get(), &output, &input, ZSTD_e_end);
+      if (ZSTD_isError(code)) {
+        return ZstdError("compress", code);
+      }
+    } while (code != 0);
+    out->resize(output.pos);
+    return absl::OkStatus();
+  }
+
+  absl::Status Uncompress(absl::string_view compressed, const iovec* iov,
+                          size_t num_pieces, size_t num_bytes) const override {
+    const unsigned long long content_size =  // NOLINT(runtime/int)
+        ZSTD_getFrameContentSize(compressed.data(), compressed.size());
+    if (content_size != num_bytes) {
+      return absl::InternalError(absl::StrCat(
+          "Uncompressed size mismatch. zstd expects ", content_size,
+          " whereas the tensor metadata suggests ", num_bytes));
+    }
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(
+        ZSTD_createDCtx(), ZSTD_freeDCtx);
+    if (context == nullptr) {
+      return absl::InternalError("Failed to create a zstd context.");
+    }
+    ZSTD_inBuffer input = {compressed.data(), compressed.size(), 0};
+    // Nonzero until the end of the frame has been decoded.
+    size_t code = 1;
+    for (size_t i = 0; i < num_pieces; ++i) {
+      ZSTD_outBuffer output = {iov[i].iov_base, iov[i].iov_len, 0};
+      while (output.pos < output.size) {
+        const size_t input_pos = input.pos;
+        const size_t output_pos = output.pos;
+        code = ZSTD_decompressStream(context.get(), &output, &input);
+        if (ZSTD_isError(code)) {
+          return ZstdError("uncompress", code);
+        }
+        if (input.pos == input_pos && output.pos == output_pos) {
+          return absl::InternalError(
+              "Failed to uncompress with zstd: the data is truncated.");
+        }
+      }
+    }
+    if (code != 0) {
+      // Every byte has been written, so the frame must end here.
+      ZSTD_outBuffer output = {nullptr, 0, 0};
+      code = ZSTD_decompressStream(context.get(), &output, &input);
+      if (ZSTD_isError(code)) {
+        return ZstdError("uncompress", code);
+      }
+    }
+    if (code != 0 || input.pos != input.size) {
+      return absl::InternalError(
+          "Failed to uncompress with zstd: unexpected trailing data.");
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  const int level_;
+};
+
+bool RegisterZstdCodecs() {
+  ElementCodec::Register("zstd",
+                         std::make_unique<ZstdCodec>(ZSTD_CLEVEL_DEFAULT));
+  for (int level = 1; level <= kMaxLevel; ++level) {
+    ElementCodec::Register(absl::StrCat("zstd-", level),
+                           std::make_unique<ZstdCodec>(level));
+  }
+  return true;
+}
+
+[[maybe_unused]] const bool zstd_codecs_registered = RegisterZstdCodecs();
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -396,6 +396,15 @@ bool GraphDefBuilderWrapper::HasAttr(const std::string& name,
   return HasAttr(op_def, attr_name);
 }
 
+absl::Status SplitProvider::Skip(int64_t num_splits) {
+  Tensor unused_split;
+  bool end_of_splits = false;
+  for (int64_t i = 0; i < num_splits && !end_of_splits; ++i) {
+    TF_RETURN_IF_ERROR(GetNext(&unused_split, &end_of_splits));
+  }
+  return absl::OkStatus();
+}
+
 int32_t GetRunnerThreadpoolSizeFromOpKernelContext(OpKernelContext* ctx) {
   thread::ThreadPool* thread_pool =
       ctx->device()->tensorflow_device_thread_pool();
@@ -1151,12 +1160,13 @@ absl::Status DatasetBaseIterator::GetNext(IteratorContext* ctx,
   auto model = ctx->model();
   bool output_was_recording =
       node_ && node_->output() && node_->output()->is_recording();
+  int64_t start_nanos = 0;
   if (collect_resource_usage(ctx)) {
-    int64_t now_nanos = EnvTime::NowNanos();
+    start_nanos = EnvTime::NowNanos();
     if (output_was_recording) {
-      node_->output()->record_stop(now_nanos);
+      node_->output()->record_stop(start_nanos);
     }
-    node_->record_start(now_nanos);
+    node_->record_start(start_nanos);
   }
   out_tensors->clear();
   absl::Status s = GetNextInternal(ctx, out_tensors, end_of_sequence);
@@ -1184,6 +1194,9 @@ absl::Status DatasetBaseIterator::GetNext(IteratorContext* ctx,
   if (collect_resource_usage(ctx)) {
     int64_t now_nanos = EnvTime::NowNanos();
     node_->record_stop(now_nanos);
+    if (start_nanos > 0) {
+      node_->record_get_next_time(now_nanos - start_nanos);
+    }
     if (output_was_recording) {
       node_->output()->record_start(now_nanos);
     }
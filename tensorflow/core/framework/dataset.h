@@ -431,6 +431,10 @@ class SplitProvider {
   // Stores the next split in `*split`, setting `*end_of_splits` to indicate
   // whether there were any splits left.
   virtual absl::Status GetNext(Tensor* split, bool* end_of_splits) = 0;
+  // Advances the split provider past the next `num_splits` splits, stopping
+  // early at the end of the splits. The default implementation calls
+  // `GetNext` once per split; subclasses that can seek should override it.
+  virtual absl::Status Skip(int64_t num_splits);
   // Resets the split provider to its beginning.
   virtual absl::Status Reset() = 0;
   // Saves the state of this split provider.
@@ -64,6 +64,24 @@ auto* graph_pending_queue_length_histogram = tsl::monitoring::Sampler<0>::New(
     // Power of 1.5 with bucket count 30 (> 191k)
     {tsl::monitoring::Buckets::Exponential(1, 1.5, 30)});
 
+auto* step_arena_bytes_served = tsl::monitoring::Counter<0>::New(
+    "/tensorflow/core/step_arena_bytes_served",
+    "The number of bytes served by per-step arena allocators.");
+
+auto* step_arena_allocations = tsl::monitoring::Counter<0>::New(
+    "/tensorflow/core/step_arena_allocations",
+    "The number of allocations served by per-step arena allocators.");
+
+auto* step_arena_fallbacks = tsl::monitoring::Counter<0>::New(
+    "/tensorflow/core/step_arena_fallbacks",
+    "The number of allocations that per-step arena allocators forwarded to "
+    "the device allocator.");
+
+auto* step_arena_skipped_steps = tsl::monitoring::Counter<0>::New(
+    "/tensorflow/core/step_arena_skipped_steps",
+    "The number of steps that ran without a per-step arena because too much "
+    "arena memory was retained by tensors that outlived their step.");
+
 auto* graph_run_input_tensor_bytes = tsl::monitoring::Sampler<0>::New(
     {"/tensorflow/core/graph_run_input_tensor_bytes",
      "The size of input tensors in bytes."},
@@ -876,6 +894,21 @@ void UpdateGraphPendingQueueLength(uint64_t len) {
   graph_pending_queue_length_cell->Add(len);
 }
 
+void RecordStepArenaUsage(int64_t bytes_served, int64_t num_served,
+                          int64_t num_fallbacks) {
+  static auto* bytes_served_cell = step_arena_bytes_served->GetCell();
+  static auto* allocations_cell = step_arena_allocations->GetCell();
+  static auto* fallbacks_cell = step_arena_fallbacks->GetCell();
+  bytes_served_cell->IncrementBy(bytes_served);
+  allocations_cell->IncrementBy(num_served);
+  fallbacks_cell->IncrementBy(num_fallbacks);
+}
+
+void RecordStepArenaSkipped() {
+  static auto* skipped_steps_cell = step_arena_skipped_steps->GetCell();
+  skipped_steps_cell->IncrementBy(1);
+}
+
 void UpdateGraphBuildTime(const uint64_t running_time_usecs) {
   if (running_time_usecs > 0) {
     static auto* build_graph_calls_cell = build_graph_calls->GetCell();
@@ -292,6 +292,16 @@ void RecordTPUXlaSpmdCoresPerReplica(int64_t cores_per_replica);
 void UpdateGraphExecTime(const uint64_t running_time_usecs);
 void UpdateGraphPendingQueueLength(uint64_t len);
 
+// Records the usage of a per-step arena allocator when its step ends: the
+// bytes and number of allocations it served, and the number of allocations it
+// forwarded to the underlying allocator because the arena was full.
+void RecordStepArenaUsage(int64_t bytes_served, int64_t num_served,
+                          int64_t num_fallbacks);
+
+// Records that a step ran without a per-step arena because the arenas of
+// earlier steps were still kept alive by tensors that outlived them.
+void RecordStepArenaSkipped();
+
 // Records that one output of an op of type `op_name` was unused.
 void RecordUnusedOutput(const std::string& op_name);
 
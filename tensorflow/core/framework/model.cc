@@ -774,7 +774,7 @@ class AsyncInterleaveMany : public Node {
         return 0.0;
       }
     }
-    return (*parameter)->value * AverageBufferedElementSizeLocked();
+    return (*parameter)->value * BudgetedElementSizeLocked();
   }
 
   absl::Status ToProto(ModelProto::Node* node_proto) const override {
@@ -1105,12 +1105,12 @@ class AsyncRatio : public Node {
 
     if (parameter) {
       if (memory_ratio_ == 0) {
-        result += (*parameter)->value * AverageBufferedElementSizeLocked();
+        result += (*parameter)->value * BudgetedElementSizeLocked();
       } else {
         // The estimation is currently not accurate for MapAndBatchDataset for
         // the maximum buffer size does not match `num_parallel_calls`
         // parameter.
-        result += (*parameter)->value * AverageBufferedElementSizeLocked() /
+        result += (*parameter)->value * BudgetedElementSizeLocked() /
                   memory_ratio_;
       }
     }
@@ -1812,6 +1812,38 @@ double Node::AverageBufferedElementSizeLocked() const {
          2.0;
 }
 
+double Node::BudgetedElementSizeLocked() const {
+  const double average_element_size = AverageBufferedElementSizeLocked();
+  if (element_size_stddevs_ <= 0) {
+    return average_element_size;
+  }
+  mutex_lock l(element_size_mu_);
+  if (num_element_sizes_ == 0) {
+    return average_element_size;
+  }
+  const double budgeted_element_size =
+      std::min(element_size_mean_ + element_size_stddevs_ *
+                                        std::sqrt(element_size_variance_),
+               max_element_size_);
+  return std::max(average_element_size, budgeted_element_size);
+}
+
+void Node::record_element_size(double element_size) {
+  mutex_lock l(element_size_mu_);
+  max_element_size_ = std::max(max_element_size_, element_size);
+  if (num_element_sizes_++ == 0) {
+    element_size_mean_ = element_size;
+    return;
+  }
+  // Exponentially weighted moving average and variance, so that the estimate
+  // follows changes in the distribution of element sizes.
+  const double delta = element_size - element_size_mean_;
+  element_size_mean_ += kElementSizeEmaWeight * delta;
+  element_size_variance_ = (1.0 - kElementSizeEmaWeight) *
+                           (element_size_variance_ +
+                            kElementSizeEmaWeight * delta * delta);
+}
+
 double Node::OutputTimeForInputs(const Node::NodeValues& output_times) const {
   double sum = 0;
   for (auto& input : inputs_) {
@@ -2090,6 +2122,15 @@ std::shared_ptr<Node> Node::SnapshotHelper(
       cloned_current->previous_processing_time_ = previous_processing_time_;
       cloned_current->processing_time_ema_ = processing_time_ema_;
     }
+    {
+      mutex_lock l2(element_size_mu_);
+      mutex_lock l3(cloned_current->element_size_mu_);
+      cloned_current->num_element_sizes_ = num_element_sizes_;
+      cloned_current->element_size_mean_ = element_size_mean_;
+      cloned_current->element_size_variance_ = element_size_variance_;
+      cloned_current->max_element_size_ = max_element_size_;
+    }
+    cloned_current->element_size_stddevs_.store(element_size_stddevs_);
   }
 
   for (auto& input : inputs_) {
@@ -2306,6 +2347,9 @@ void Model::AddNode(Node::Factory factory, const std::string& name,
   auto node_name = str_util::Split(name, ':', str_util::SkipEmpty()).back();
   mutex_lock l(mu_);
   std::shared_ptr<Node> node = factory({id_counter_++, node_name, parent});
+  if (experiments_.contains(kElementSizeAwareRamBudgetExperiment)) {
+    node->set_record_element_sizes(true);
+  }
   if (!output_) {
     output_ = node;
   }
@@ -2351,6 +2395,14 @@ void Model::Optimize(AutotuneAlgorithm algorithm,
     snapshot = output_->Snapshot();
   }
   MaybeSyncStateValuesToValues(snapshot);
+  if (experiments_.contains(kElementSizeAwareRamBudgetExperiment)) {
+    Node::NodeVector nodes =
+        snapshot->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+    nodes.push_back(snapshot);
+    for (auto& node : nodes) {
+      node->set_element_size_stddevs(kElementSizeStddevs);
+    }
+  }
   int64_t total_ram_budget;
   if (fixed_ram_budget.has_value()) {
     total_ram_budget = fixed_ram_budget.value();
@@ -2693,6 +2745,14 @@ void Model::OptimizeHillClimbHelper(
            "every "
            "10 minutes).";
   }
+  // When element sizes are taken into account, each step is chosen by the
+  // output time it saves relative to the share of the RAM budget it uses, and
+  // steps that do not fit in the budget are skipped instead of ending the
+  // optimization.
+  const bool element_size_aware =
+      experiments_.contains(kElementSizeAwareRamBudgetExperiment);
+  std::vector<Decision> decision_trace;
+
   // Initialize the parameter values to minimal before tuning.
   for (auto& pair : parameters) {
     if (skip_buffer_sizes && (pair.second->name == kBufferSize)) {
@@ -2701,6 +2761,7 @@ void Model::OptimizeHillClimbHelper(
     pair.second->value = pair.second->min;
   }
   Parameter* best_parameter = nullptr;
+  std::string best_node_name;
   while (!cancellation_manager->IsCancelled()) {
     const double output_time =
         OutputTime(snapshot, optimization_params.model_input_time(),
@@ -2729,10 +2790,23 @@ void Model::OptimizeHillClimbHelper(
           OutputTime(snapshot, optimization_params.model_input_time(),
                      /*gradients=*/nullptr);
       double delta = output_time - new_output_time;
+      if (element_size_aware &&
+          (delta > kBufferSizeMinDelta || pair.second->name != kBufferSize)) {
+        const double step_buffered_bytes = TotalMaximumBufferedBytes(snapshot);
+        if (step_buffered_bytes > ram_budget) {
+          pair.second->value--;
+          continue;
+        }
+        const double added_bytes =
+            std::max(step_buffered_bytes - new_buffered_bytes, 0.0);
+        delta /=
+            1.0 + added_bytes / std::max(static_cast<double>(ram_budget), 1.0);
+      }
       if (delta > best_delta &&
           (delta > kBufferSizeMinDelta || pair.second->name != kBufferSize)) {
         best_delta = delta;
         best_parameter = pair.second.get();
+        best_node_name = pair.first;
       }
       pair.second->value--;
     }
@@ -2746,6 +2820,21 @@ void Model::OptimizeHillClimbHelper(
     }
     // Take a hill-climb step
     best_parameter->value++;
+    if (decision_trace.size() < kMaxDecisionTraceSize) {
+      Decision decision;
+      decision.node_name = best_node_name;
+      decision.parameter_name = best_parameter->name;
+      decision.value = best_parameter->value;
+      decision.output_time =
+          OutputTime(snapshot, optimization_params.model_input_time(),
+                     /*gradients=*/nullptr);
+      decision.buffered_bytes = TotalMaximumBufferedBytes(snapshot);
+      VLOG(3) << "Autotune decision: " << decision.node_name << " "
+              << decision.parameter_name << "=" << decision.value
+              << ", output time: " << decision.output_time
+              << ", maximum buffered bytes: " << decision.buffered_bytes;
+      decision_trace.push_back(std::move(decision));
+    }
   }
   if (ram_budget_manager.RequestModelAllocation(
           TotalMaximumBufferedBytes(snapshot))) {
@@ -2755,6 +2844,8 @@ void Model::OptimizeHillClimbHelper(
     // as `ram_budget` might be outdated
     UpdateStateValues(&parameters);
   }
+  mutex_lock l(mu_);
+  decision_trace_ = std::move(decision_trace);
 }
 void Model::RecordIteratorGapTime(uint64_t duration_usec) {
   mutex_lock l(gap_mu_);
@@ -3190,6 +3281,14 @@ absl::Status Model::ToProto(ModelProto* model_proto) {
   if (dataset_name_.has_value()) {
     model_proto->set_dataset_name(dataset_name_.value());
   }
+  for (const Decision& decision : decision_trace_) {
+    ModelProto::Decision* decision_proto = model_proto->add_decision_trace();
+    decision_proto->set_node_name(decision.node_name);
+    decision_proto->set_parameter_name(decision.parameter_name);
+    decision_proto->set_value(decision.value);
+    decision_proto->set_output_time(decision.output_time);
+    decision_proto->set_buffered_bytes(decision.buffered_bytes);
+  }
   tf_shared_lock gap_lock(gap_mu_);
   *model_proto->mutable_gap_times() = {gap_times_usec_.begin(),
                                        gap_times_usec_.end()};
@@ -3203,6 +3302,16 @@ absl::Status Model::FromProto(ModelProto model_proto,
   TF_RETURN_IF_ERROR(
       ModelFromProtoHelper(model_proto, &restored_model->output_));
   restored_model->id_counter_ = model_proto.id_counter();
+  for (const ModelProto::Decision& decision_proto :
+       model_proto.decision_trace()) {
+    Decision decision;
+    decision.node_name = decision_proto.node_name();
+    decision.parameter_name = decision_proto.parameter_name();
+    decision.value = decision_proto.value();
+    decision.output_time = decision_proto.output_time();
+    decision.buffered_bytes = decision_proto.buffered_bytes();
+    restored_model->decision_trace_.push_back(std::move(decision));
+  }
   *model = std::move(restored_model);
   return absl::OkStatus();
 }
@@ -3237,6 +3346,34 @@ absl::Status Model::Load(const std::string& fname,
   return absl::OkStatus();
 }
 
+std::vector<Model::NodeStats> Model::CollectNodeStats() const {
+  std::shared_ptr<Node> output;
+  {
+    tf_shared_lock l(mu_);
+    output = output_;
+  }
+  std::vector<NodeStats> stats;
+  if (!output) {
+    return stats;
+  }
+  Node::NodeVector nodes = {output};
+  Node::NodeVector inputs =
+      output->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+  nodes.insert(nodes.end(), inputs.begin(), inputs.end());
+  stats.reserve(nodes.size());
+  for (const auto& node : nodes) {
+    NodeStats node_stats;
+    node_stats.name = node->long_name();
+    node_stats.num_elements = node->num_elements();
+    node_stats.processing_time_nsec = node->processing_time();
+    node_stats.get_next_time_nsec = node->get_next_time();
+    node_stats.bytes_produced = node->bytes_produced();
+    node_stats.buffered_bytes = node->buffered_bytes();
+    stats.push_back(std::move(node_stats));
+  }
+  return stats;
+}
+
 std::string Model::DebugString() {
   constexpr int64_t kMinSecondsBetweenCalls = 30;
   if (absl::Now() < cache_until_) return cached_debug_string_;
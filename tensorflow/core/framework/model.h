@@ -16,6 +16,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_FRAMEWORK_MODEL_H_
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <deque>
 #include <functional>
@@ -73,6 +74,20 @@ constexpr double kRamBudgetShare = 0.5;
 // average of processing time per element.
 constexpr double kProcessingTimeEmaWeight = 0.1;
 
+// Weight of the latest element size used in computing the exponential moving
+// average and variance of the size of buffered elements.
+constexpr double kElementSizeEmaWeight = 0.1;
+
+// Name of the experiment that makes the autotuner account for the variance of
+// element sizes when estimating the memory used by buffers, and trade off
+// output time against memory when choosing which parameter to increase.
+constexpr char kElementSizeAwareRamBudgetExperiment[] =
+    "autotune_element_size_aware_ram_budget";
+
+// Number of standard deviations of the element size that buffers are budgeted
+// for on top of the average element size, when running the experiment above.
+constexpr double kElementSizeStddevs = 2.0;
+
 enum class TraversalOrder {
   BFS = 0,
   REVERSE_BFS = 1,
@@ -310,6 +325,7 @@ class Node {
         bytes_produced_(0),
         num_elements_(0),
         processing_time_(0),
+        get_next_time_(0),
         record_metrics_(true),
         metrics_(name_),
         output_(args.output.get()),
@@ -438,6 +454,17 @@ class Node {
     return processing_time_;
   }
 
+  // Returns the aggregate time that callers of `GetNext` spent waiting for
+  // this node, including the time spent in its inputs.
+  int64_t get_next_time() const TF_LOCKS_EXCLUDED(mu_) {
+    return get_next_time_;
+  }
+
+  // Records that a call to `GetNext` of this node took the given time.
+  void record_get_next_time(int64_t time_nanos) TF_LOCKS_EXCLUDED(mu_) {
+    get_next_time_ += time_nanos;
+  }
+
   // Records that the node consumed the given number of bytes.
   void record_bytes_consumed(int64_t num_bytes) {
     bytes_consumed_ += num_bytes;
@@ -450,6 +477,10 @@ class Node {
 
   // Records the change in this node's buffer.
   void record_buffer_event(int64_t bytes_delta, int64_t elements_delta) {
+    if (record_element_sizes_ && bytes_delta > 0 && elements_delta > 0) {
+      record_element_size(static_cast<double>(bytes_delta) /
+                          static_cast<double>(elements_delta));
+    }
     buffered_bytes_ += bytes_delta;
     peak_buffered_bytes_.store(std::max(peak_buffered_bytes_, buffered_bytes_));
     buffered_elements_ += elements_delta;
@@ -644,6 +675,39 @@ class Node {
     estimated_element_size_ = estimated_element_size;
   }
 
+  // Returns the exponential moving average of the size of elements added to
+  // this node's buffer.
+  double ElementSizeMean() const TF_LOCKS_EXCLUDED(element_size_mu_) {
+    mutex_lock l(element_size_mu_);
+    return element_size_mean_;
+  }
+
+  // Returns the standard deviation that corresponds to the exponential moving
+  // variance of the size of elements added to this node's buffer.
+  double ElementSizeStddev() const TF_LOCKS_EXCLUDED(element_size_mu_) {
+    mutex_lock l(element_size_mu_);
+    return std::sqrt(element_size_variance_);
+  }
+
+  // Returns the size of the largest element added to this node's buffer.
+  double MaxElementSize() const TF_LOCKS_EXCLUDED(element_size_mu_) {
+    mutex_lock l(element_size_mu_);
+    return max_element_size_;
+  }
+
+  // Sets the number of standard deviations of the element size that the
+  // buffers of this node are budgeted for on top of the average element size.
+  void set_element_size_stddevs(double element_size_stddevs) {
+    element_size_stddevs_ = element_size_stddevs;
+  }
+
+  // Sets whether the sizes of elements added to this node's buffer are
+  // recorded. Recording them takes a lock on the `GetNext()` path, so it is
+  // only enabled when the autotuner uses them.
+  void set_record_element_sizes(bool record_element_sizes) {
+    record_element_sizes_ = record_element_sizes;
+  }
+
  protected:
   // Used for (incrementally) recording metrics. The class is thread-safe.
   class Metrics {
@@ -727,6 +791,15 @@ class Node {
   // Returns the average size of an element buffered in this node.
   double AverageBufferedElementSizeLocked() const TF_SHARED_LOCKS_REQUIRED(mu_);
 
+  // Returns the size to budget for each element buffered in this node. This is
+  // the average element size plus `element_size_stddevs_` standard deviations,
+  // but no more than the largest element seen.
+  double BudgetedElementSizeLocked() const TF_SHARED_LOCKS_REQUIRED(mu_);
+
+  // Updates the moving average and variance of the element size.
+  void record_element_size(double element_size)
+      TF_LOCKS_EXCLUDED(element_size_mu_);
+
   // Returns the sum of per-element output time for the tunable inputs of this
   // node.
   double OutputTimeForInputs(const NodeValues& output_times) const
@@ -846,6 +919,7 @@ class Node {
   std::atomic<int64_t> bytes_produced_;
   std::atomic<int64_t> num_elements_;
   std::atomic<int64_t> processing_time_;
+  std::atomic<int64_t> get_next_time_;
   std::atomic<bool> record_metrics_;
   Metrics metrics_;
   absl::flat_hash_map<std::string, std::shared_ptr<Parameter>> parameters_
@@ -871,6 +945,16 @@ class Node {
   std::weak_ptr<Node> output_weak_ptr_;
   std::optional<int64_t> estimated_element_size_ TF_GUARDED_BY(mu_) =
       std::nullopt;
+
+  // Distribution of the size of elements added to the buffer. It is guarded
+  // by its own mutex because it is updated on the `GetNext()` path.
+  mutable mutex element_size_mu_;
+  int64_t num_element_sizes_ TF_GUARDED_BY(element_size_mu_) = 0;
+  double element_size_mean_ TF_GUARDED_BY(element_size_mu_) = 0.0;
+  double element_size_variance_ TF_GUARDED_BY(element_size_mu_) = 0.0;
+  double max_element_size_ TF_GUARDED_BY(element_size_mu_) = 0.0;
+  std::atomic<double> element_size_stddevs_ = 0.0;
+  std::atomic<bool> record_element_sizes_ = false;
 };
 
 // InterleaveMany is used to model datasets whose inputs are used to create
@@ -950,11 +1034,31 @@ class Model {
     return output_;
   }
 
+  // A parameter change made by the last optimization, in the order in which
+  // the changes were made. Exported as `ModelProto::Decision`.
+  struct Decision {
+    // Long name of the node that owns the parameter.
+    std::string node_name;
+    std::string parameter_name;
+    double value = 0.0;
+    // Estimated output time and maximum buffered bytes of the model after the
+    // change.
+    double output_time = 0.0;
+    double buffered_bytes = 0.0;
+  };
+
   // Set the experiment that this job is part of.
   void AddExperiment(const std::string& experiment) {
     experiments_.insert(experiment);
   }
 
+  // Returns the parameter changes made by the last hill-climb optimization,
+  // which explain how the RAM budget was spent.
+  std::vector<Decision> DecisionTrace() const TF_LOCKS_EXCLUDED(mu_) {
+    tf_shared_lock l(mu_);
+    return decision_trace_;
+  }
+
   // Adds a node with the given name and given parent.
   void AddNode(Node::Factory factory, const std::string& name,
                std::shared_ptr<Node> parent, std::shared_ptr<Node>* out_node)
@@ -1009,6 +1113,28 @@ class Model {
   // Removes the given node.
   void RemoveNode(std::shared_ptr<Node> node) TF_LOCKS_EXCLUDED(mu_);
 
+  // Cumulative statistics of a node, used to attribute the time spent in the
+  // input pipeline to its transformations.
+  struct NodeStats {
+    // Long name of the node.
+    std::string name;
+    int64_t num_elements = 0;
+    // Time spent in the node itself by all of its threads, excluding its
+    // inputs.
+    int64_t processing_time_nsec = 0;
+    // Time callers of `GetNext` spent waiting for the node, including its
+    // inputs. For asynchronous nodes, this is the time spent waiting for the
+    // node's buffer.
+    int64_t get_next_time_nsec = 0;
+    int64_t bytes_produced = 0;
+    int64_t buffered_bytes = 0;
+  };
+
+  // Returns the statistics of all nodes, in breadth-first order from the
+  // output node. The statistics are read from counters that the nodes
+  // maintain anyway, so collecting them does not pause the pipeline.
+  std::vector<NodeStats> CollectNodeStats() const TF_LOCKS_EXCLUDED(mu_);
+
   // Produces a proto for this model.
   absl::Status ToProto(ModelProto* model_proto);
 
@@ -1053,6 +1179,8 @@ class Model {
       std::function<bool(const ModelParameters&, double, double, double)>;
 
   static constexpr int64_t kOptimizationPeriodMinMs = 10;
+  // Maximum number of decisions kept in the decision trace.
+  static constexpr int64_t kMaxDecisionTraceSize = 1000;
   static constexpr int64_t kOptimizationPeriodMaxMs =
       60 * EnvTime::kSecondsToMillis;
 
@@ -1221,6 +1349,8 @@ class Model {
   std::shared_ptr<Node> snapshot_ TF_GUARDED_BY(mu_);
   // Stores the optimization parameters used by autotune.
   OptimizationParams optimization_params_ TF_GUARDED_BY(mu_);
+  // Stores the parameter changes made by the last hill-climb optimization.
+  std::vector<Decision> decision_trace_ TF_GUARDED_BY(mu_);
   // Stores the model id in the string format
   std::string model_id_;
 };
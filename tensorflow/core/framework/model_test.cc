@@ -26,6 +26,7 @@ limitations under the License.
 #include <utility>
 
 #include <gtest/gtest.h>
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/model.pb.h"
@@ -687,6 +688,40 @@ TEST(BufferedBytesTest, Node) {
   EXPECT_EQ(node->inputs().size(), 0);
 }
 
+TEST(BufferedBytesTest, ElementSizeDistribution) {
+  std::shared_ptr<Node> node = model::MakeAsyncKnownRatioNode(
+      {-1, "TestNode", nullptr}, 1,
+      {model::MakeParameter(
+          "parallelism",
+          std::make_shared<SharedState>(/*value=*/4, nullptr, nullptr),
+          /*min=*/1, /*max=*/8)});
+  // Element sizes are only recorded when the autotuner uses them.
+  node->record_buffer_event(100, 1);
+  EXPECT_EQ(node->MaxElementSize(), 0);
+  node->set_record_element_sizes(true);
+  for (int i = 0; i < 9; ++i) {
+    node->record_buffer_event(100, 1);
+  }
+  EXPECT_EQ(node->ElementSizeMean(), 100);
+  EXPECT_EQ(node->ElementSizeStddev(), 0);
+  EXPECT_EQ(node->MaxElementSize(), 100);
+  // Without a margin, the average element size is budgeted for.
+  EXPECT_EQ(node->TotalMaximumBufferedBytes(), 400);
+  node->set_element_size_stddevs(2.0);
+  EXPECT_EQ(node->TotalMaximumBufferedBytes(), 400);
+
+  // A spike in the element size is budgeted for, up to the largest element.
+  node->record_buffer_event(1000, 1);
+  EXPECT_GT(node->ElementSizeMean(), 100);
+  EXPECT_GT(node->ElementSizeStddev(), 0);
+  EXPECT_EQ(node->MaxElementSize(), 1000);
+  const double average_element_size = 2000.0 / 11;
+  EXPECT_GT(node->TotalMaximumBufferedBytes(), 4 * average_element_size);
+  EXPECT_LE(node->TotalMaximumBufferedBytes(), 4 * 1000);
+  node->set_element_size_stddevs(0.0);
+  EXPECT_DOUBLE_EQ(node->TotalMaximumBufferedBytes(), 4 * average_element_size);
+}
+
 // Returns a weighted sum of a prior and the actual processing time.
 double weighted_processing_time(int64_t num_elements, double processing_time,
                                 double prior) {
@@ -1387,6 +1422,82 @@ TEST_P(OptimizeZeroRamBudgetTest, Model) {
 INSTANTIATE_TEST_SUITE_P(Test, OptimizeZeroRamBudgetTest,
                          ::testing::Values(0, 1, 2, 3));
 
+TEST(ModelTest, ElementSizeAwareHillClimb) {
+  auto make_node = [](int64_t id, std::shared_ptr<Node> output) {
+    return model::MakeAsyncKnownRatioNode(
+        {id, absl::StrCat(id), output}, 1,
+        {model::MakeParameter("parallelism",
+                              std::make_shared<SharedState>(
+                                  /*value=*/model::kAutotune,
+                                  std::make_shared<mutex>(),
+                                  std::make_shared<condition_variable>()),
+                              /*min=*/1, /*max=*/16)});
+  };
+  std::shared_ptr<Node> node1 = make_node(1, nullptr);
+  std::shared_ptr<Node> node2 = make_node(2, node1);
+  model::Model model;
+  model.AddExperiment(model::kElementSizeAwareRamBudgetExperiment);
+  model.AddNode([&node1](model::Node::Args args) { return node1; }, "1",
+                nullptr, &node1);
+  model.AddNode([&node2](model::Node::Args args) { return node2; }, "2", node1,
+                &node2);
+
+  // Node 1 buffers small elements, node 2 buffers elements whose size spikes.
+  node1->record_buffer_event(10, 1);
+  node1->record_element();
+  node1->add_processing_time(100);
+  for (int64_t size : {100, 100, 100, 1000}) {
+    node2->record_buffer_event(size, 1);
+  }
+  node2->record_element();
+  node2->add_processing_time(100);
+  EXPECT_EQ(node2->MaxElementSize(), 1000);
+
+  constexpr int64_t kRamBudget = 3000;
+  CancellationManager cancellation_manager;
+  RamBudgetManager ram_budget_manager(0);
+  model.Optimize(AutotuneAlgorithm::HILL_CLIMB, CpuBudgetFunc(64),
+                 /*ram_budget_share=*/1.0,
+                 /*fixed_ram_budget=*/kRamBudget,
+                 /*model_input_time=*/0, ram_budget_manager,
+                 &cancellation_manager);
+
+  std::vector<model::Model::Decision> trace = model.DecisionTrace();
+  ASSERT_FALSE(trace.empty());
+  absl::flat_hash_map<std::string, double> last_values;
+  for (const auto& decision : trace) {
+    EXPECT_EQ(decision.parameter_name, "parallelism");
+    EXPECT_LE(decision.buffered_bytes, kRamBudget);
+    last_values[decision.node_name] = decision.value;
+  }
+  for (const auto& node : {node1, node2}) {
+    if (last_values.contains(node->long_name())) {
+      EXPECT_EQ(node->parameter_value("parallelism"),
+                last_values[node->long_name()]);
+    }
+  }
+  // The parallelism of the node with small elements is cheaper, so it is
+  // increased further.
+  EXPECT_GT(node1->parameter_value("parallelism"),
+            node2->parameter_value("parallelism"));
+
+  // The trace is exported with the model.
+  ModelProto model_proto;
+  TF_ASSERT_OK(model.ToProto(&model_proto));
+  ASSERT_EQ(model_proto.decision_trace_size(), trace.size());
+  for (int i = 0; i < trace.size(); ++i) {
+    const ModelProto::Decision& decision = model_proto.decision_trace(i);
+    EXPECT_EQ(decision.node_name(), trace[i].node_name);
+    EXPECT_EQ(decision.parameter_name(), trace[i].parameter_name);
+    EXPECT_EQ(decision.value(), trace[i].value);
+    EXPECT_EQ(decision.output_time(), trace[i].output_time);
+    EXPECT_EQ(decision.buffered_bytes(), trace[i].buffered_bytes);
+  }
+  std::unique_ptr<model::Model> restored_model;
+  TF_ASSERT_OK(model::Model::FromProto(model_proto, &restored_model));
+  EXPECT_EQ(restored_model->DecisionTrace().size(), trace.size());
+}
+
 TEST(RecordTimeTest, RecordTimeTest) {
   std::shared_ptr<Node> source = model::MakeSourceNode({});
   EXPECT_FALSE(source->is_recording());
@@ -1408,6 +1519,39 @@ TEST(ModelTest, ModelMetrics) {
                     HasSubstr("autotune: true")));
 }
 
+TEST(ModelTest, CollectNodeStats) {
+  model::Model model;
+  EXPECT_TRUE(model.CollectNodeStats().empty());
+  std::shared_ptr<Node> root = model::MakeUnknownNode({0, "unknown0", nullptr});
+  model.AddNode([&root](model::Node::Args args) { return root; }, root->name(),
+                nullptr, &root);
+  std::shared_ptr<Node> input = model::MakeSourceNode({1, "source", root});
+  model.AddNode([&input](model::Node::Args args) { return input; },
+                input->name(), root, &input);
+  root->record_element();
+  root->record_start(100);
+  root->record_stop(150);
+  root->record_get_next_time(500);
+  root->record_bytes_produced(64);
+  input->record_element();
+  input->record_start(200);
+  input->record_stop(350);
+  input->record_get_next_time(20);
+  input->record_buffer_event(128, 1);
+
+  std::vector<model::Model::NodeStats> stats = model.CollectNodeStats();
+  ASSERT_EQ(stats.size(), 2);
+  EXPECT_EQ(stats[0].name, root->long_name());
+  EXPECT_EQ(stats[0].num_elements, 1);
+  EXPECT_EQ(stats[0].processing_time_nsec, 50);
+  EXPECT_EQ(stats[0].get_next_time_nsec, 500);
+  EXPECT_EQ(stats[0].bytes_produced, 64);
+  EXPECT_EQ(stats[1].name, input->long_name());
+  EXPECT_EQ(stats[1].processing_time_nsec, 150);
+  EXPECT_EQ(stats[1].get_next_time_nsec, 20);
+  EXPECT_EQ(stats[1].buffered_bytes, 128);
+}
+
 TEST(ModelTest, ModelCollectOptimizationMetrics) {
   CellReader<std::string> cell_reader("/tensorflow/data/model");
   model::Model model;
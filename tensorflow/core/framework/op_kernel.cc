@@ -45,6 +45,7 @@ limitations under the License.
 #include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/node_properties.h"
 #include "tensorflow/core/framework/op_def_util.h"
+#include "tensorflow/core/framework/step_arena_allocator.h"
 #include "tensorflow/core/framework/tensor_reference.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/errors.h"
@@ -780,7 +781,20 @@ absl::Status OpKernelContext::allocate_output(absl::string_view name,
 absl::Status OpKernelContext::allocate_tensor(
     DataType type, const TensorShape& shape, Tensor* out_tensor,
     AllocatorAttributes attr, const AllocationAttributes& allocation_attr) {
-  Allocator* a = get_allocator(attr);
+  Allocator* a = nullptr;
+  // The arena only replaces the plain host allocator: pinned, NIC-compatible
+  // and scoped allocations, and tracked ones, keep their usual allocator.
+  AllocatorAttributes host_attr;
+  host_attr.set_on_host(true);
+  if (params_->step_arena != nullptr &&
+      attr.IsEqualOrLessRestrictiveThan(host_attr) && attr.scope_id == 0 &&
+      !track_allocations() && DataTypeCanUseMemcpy(type) &&
+      params_->step_arena->ShouldAllocate(shape.num_elements() *
+                                          DataTypeSize(type))) {
+    a = params_->step_arena;
+  } else {
+    a = get_allocator(attr);
+  }
   Tensor new_tensor(
       a, type, shape,
       AllocationAttributes(
@@ -841,7 +855,22 @@ absl::Status OpKernelContext::allocate_output(int index,
       op_kernel().name_view(), step_id(), "output", type,
       [&shape]() { return shape.DebugString(); });
   auto output_tensor = std::make_unique<Tensor>();
-  absl::Status s = allocate_tensor(type, shape, output_tensor.get(), attr);
+  bool planned = false;
+  if (params_->planned_outputs != nullptr &&
+      params_->planned_output_slots != nullptr &&
+      params_->planned_output_slots[index] >= 0 && attr.scope_id == 0 &&
+      !attr.gpu_compatible() && !attr.nic_compatible() &&
+      !track_allocations()) {
+    planned = params_->planned_outputs->Allocate(
+        params_->planned_output_slots[index], type, shape, output_tensor.get());
+  }
+  absl::Status s;
+  if (!planned) {
+    s = allocate_tensor(type, shape, output_tensor.get(), attr);
+  } else if (params_->log_memory) {
+    LogMemory::RecordTensorAllocation(params_->op_kernel->name(),
+                                      params_->step_id, *output_tensor);
+  }
   if (s.ok()) {
     outputs_[index] = TensorValue(output_tensor.release());
     *output = outputs_[index].tensor;
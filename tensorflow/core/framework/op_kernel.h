@@ -95,6 +95,7 @@ class OpRegistryInterface;
 class ResourceMgr;
 class ScopedStepContainer;
 class CollectiveExecutor;
+class StepArenaAllocator;
 class StepStatsCollectorInterface;
 
 // A label that is added to kernels that are JIT compiled. These labels will be
@@ -569,6 +570,19 @@ struct GraphCollector {
   }
 };
 
+// Memory assigned to kernel outputs ahead of execution, e.g. by a static
+// memory plan for the step.
+class PlannedOutputAllocator {
+ public:
+  virtual ~PlannedOutputAllocator() = default;
+
+  // Sets `*tensor` to a tensor of `type` and `shape` backed by the memory of
+  // `slot`. Returns false if the slot cannot hold the tensor or is still in
+  // use, in which case the caller allocates the output as usual.
+  virtual bool Allocate(int slot, DataType type, const TensorShape& shape,
+                        Tensor* tensor) = 0;
+};
+
 class OpKernelContext {
  public:
   // The first element of a WrappedAllocator is a "base" Allocator and
@@ -626,6 +640,17 @@ class OpKernelContext {
     bool track_allocations = false;
     bool log_memory = false;
 
+    // If not null, small host tensors allocated by allocate_output() and
+    // allocate_temp() with default allocator attributes come from this
+    // per-step arena. Not owned.
+    StepArenaAllocator* step_arena = nullptr;
+
+    // If both are not null, allocate_output(i) first tries the slot
+    // `planned_output_slots[i]` of `planned_outputs`, unless it is negative.
+    // Not owned.
+    PlannedOutputAllocator* planned_outputs = nullptr;
+    const int* planned_output_slots = nullptr;
+
     // Array indexed by output number for this node
     const AllocatorAttributes* output_attr_array = nullptr;
 
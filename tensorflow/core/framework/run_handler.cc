@@ -21,6 +21,7 @@ limitations under the License.
 #include <cmath>
 #include <list>
 #include <memory>
+#include <set>
 
 #include "absl/strings/str_cat.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
@@ -736,18 +737,30 @@ class RunHandler::Impl {
   // Stores now time (in microseconds) since unix epoch when the handler is
   // requested via RunHandlerPool::Get().
   uint64_t start_time_us() const { return start_time_us_; }
+  // Time in microseconds since unix epoch by which the request should finish,
+  // or 0 if it has no deadline.
+  uint64_t deadline_us() const { return deadline_us_; }
   int64_t step_id() const { return step_id_; }
   void ScheduleInterOpClosure(std::function<void()> fn);
   void ScheduleIntraOpClosure(std::function<void()> fn);
 
-  void Reset(int64_t step_id,
+  void Reset(int64_t step_id, int64_t timeout_in_ms,
              const RunOptions::Experimental::RunHandlerPoolOptions& options);
 
   RunHandlerPool::Impl* pool_impl() { return pool_impl_; }
 
   internal::ThreadWorkSource* tws() { return &tws_; }
 
-  int64_t priority() { return options_.priority(); }
+  int64_t priority() const { return options_.priority(); }
+
+  // Returns true if the work of this request should be run before the work of
+  // `other`: higher priorities come first, then earlier deadlines, and requests
+  // without a deadline come last.
+  bool RunsBefore(const Impl& other) const {
+    if (priority() != other.priority()) return priority() > other.priority();
+    return deadline_us_ != 0 &&
+           (other.deadline_us_ == 0 || deadline_us_ < other.deadline_us_);
+  }
 
  private:
   class ThreadPoolInterfaceWrapper : public thread::ThreadPoolInterface {
@@ -765,6 +778,7 @@ class RunHandler::Impl {
 
   RunHandlerPool::Impl* pool_impl_;  // NOT OWNED.
   uint64_t start_time_us_;
+  uint64_t deadline_us_;
   int64_t step_id_;
   std::unique_ptr<thread::ThreadPoolInterface> thread_pool_interface_;
   internal::ThreadWorkSource tws_;
@@ -830,6 +844,13 @@ class RunHandlerPool::Impl {
     return !free_handlers_.empty();
   }
 
+  // Returns true if a request with `priority` may take a free handler, i.e. no
+  // request with a higher priority is waiting for one.
+  bool can_take_handler(int64_t priority) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return has_free_handler() && (waiting_priorities_.empty() ||
+                                  priority >= *waiting_priorities_.rbegin());
+  }
+
   std::unique_ptr<RunHandler> Get(
       int64_t step_id, int64_t timeout_in_ms,
       const RunOptions::Experimental::RunHandlerPoolOptions& options)
@@ -844,10 +865,12 @@ class RunHandlerPool::Impl {
                     kMaxConcurrentHandlers)));
     uint64_t version;
     int num_active_requests;
+    int num_top_priority_requests;
     RunHandler::Impl* handler_impl;
+    const int64_t priority = options.priority();
     {
       mutex_lock l(mu_);
-      if (!has_free_handler()) {
+      if (!can_take_handler(priority)) {
         tsl::profiler::TraceMe activity(
             [&] {
               return absl::StrCat("WaitingForHandler#step_id=", step_id, "#");
@@ -857,39 +880,51 @@ class RunHandlerPool::Impl {
             absl::StrCat("RunHandlerPool::Impl::Get waiting for a handler "
                          "with timeout in millisecond",
                          timeout_in_ms));
+        // Higher priority requests are handed the next free handler first.
+        auto waiting = waiting_priorities_.insert(priority);
+        auto can_take = [this, priority]() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+          return can_take_handler(priority);
+        };
+        bool acquired = true;
         if (timeout_in_ms == 0) {
-          mu_.Await(Condition(this, &Impl::has_free_handler));
-        } else if (!mu_.AwaitWithDeadline(
-                       Condition(this, &Impl::has_free_handler),
-                       EnvTime::NowNanos() + timeout_in_ms * 1000 * 1000)) {
-          return nullptr;
+          mu_.Await(Condition(&can_take));
+        } else {
+          acquired = mu_.AwaitWithDeadline(
+              Condition(&can_take),
+              EnvTime::NowNanos() + timeout_in_ms * 1000 * 1000);
         }
+        waiting_priorities_.erase(waiting);
+        if (!acquired) return nullptr;
       }
-      // Remove the last entry from free_handlers_ and add to the end of
-      // sorted_active_handlers_.
+      // Remove the last entry from free_handlers_ and add it to
+      // sorted_active_handlers_, after the handlers it should not preempt.
       handler_impl = free_handlers_.back();
-      handler_impl->Reset(step_id, options);
+      handler_impl->Reset(step_id, timeout_in_ms, options);
       free_handlers_.pop_back();
 
       num_active_requests = sorted_active_handlers_.size() + 1;
       thread_work_sources->resize(num_active_requests);
-      int priority = options.priority();
       auto it = sorted_active_handlers_.cbegin();
       bool new_handler_inserted = false;
+      num_top_priority_requests = 0;
       for (int i = 0; i < num_active_requests; ++i) {
         if (!new_handler_inserted && (it == sorted_active_handlers_.cend() ||
-                                      priority > (*it)->priority())) {
+                                      handler_impl->RunsBefore(**it))) {
           sorted_active_handlers_.insert(it, handler_impl);
           new_handler_inserted = true;
           // Point to the newly added handler.
           --it;
         }
         (*thread_work_sources)[i] = (*it)->tws();
+        if ((*it)->priority() == sorted_active_handlers_.front()->priority()) {
+          ++num_top_priority_requests;
+        }
         ++it;
       }
       version = ++version_;
     }
-    RecomputePoolStats(num_active_requests, version, *thread_work_sources);
+    RecomputePoolStats(num_active_requests, num_top_priority_requests, version,
+                       *thread_work_sources);
     return std::unique_ptr<RunHandler>(new RunHandler(handler_impl));
   }
 
@@ -934,9 +969,22 @@ class RunHandlerPool::Impl {
     return ret;
   }
 
+  std::vector<int64_t> GetActiveHandlerStepIdsForTesting()
+      TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(mu_);
+    std::vector<int64_t> ret;
+    for (const auto& handler_impl : sorted_active_handlers_) {
+      ret.push_back(handler_impl->step_id());
+    }
+    return ret;
+  }
+
  private:
+  // `thread_work_sources` holds the sources of all active requests in the
+  // order of sorted_active_handlers_, the first `num_top_priority_requests` of
+  // which have the highest priority.
   void RecomputePoolStats(
-      int num_active_requests, uint64_t version,
+      int num_active_requests, int num_top_priority_requests, uint64_t version,
       const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
           thread_work_sources);
 
@@ -953,14 +1001,15 @@ class RunHandlerPool::Impl {
 
   std::unique_ptr<internal::RunHandlerThreadPool> run_handler_thread_pool_;
   // Thread compatible part used only by lock under RunHandlerPool.
-  // Handlers are sorted by start time.
-  // TODO(azaks): sort by the remaining latency budget.
+  // Handlers are sorted by priority, then by deadline, then by start time.
   // TODO(chaox): Consider other data structure for maintaining the sorted
   // active handlers if the searching overhead(currently O(n)) becomes the
   // bottleneck.
   std::list<RunHandler::Impl*> sorted_active_handlers_ TF_GUARDED_BY(mu_);
   std::vector<RunHandler::Impl*> free_handlers_ TF_GUARDED_BY(mu_);
   std::vector<std::unique_ptr<RunHandler::Impl>> handlers_ TF_GUARDED_BY(mu_);
+  // Priorities of the requests blocked in Get() waiting for a free handler.
+  std::multiset<int64_t> waiting_priorities_ TF_GUARDED_BY(mu_);
 
   // Histogram of elapsed runtime of every handler (in ms).
   histogram::Histogram time_hist_ TF_GUARDED_BY(mu_);
@@ -972,7 +1021,7 @@ class RunHandlerPool::Impl {
 };
 
 void RunHandlerPool::Impl::RecomputePoolStats(
-    int num_active_requests, uint64_t version,
+    int num_active_requests, int num_top_priority_requests, uint64_t version,
     const Eigen::MaxSizeVector<internal::ThreadWorkSource*>&
         thread_work_sources) {
   if (num_active_requests == 0) return;
@@ -995,8 +1044,11 @@ void RunHandlerPool::Impl::RecomputePoolStats(
   int num_blocking_threads = run_handler_thread_pool()->NumBlockingThreads();
   int num_non_blocking_threads = num_threads - num_blocking_threads;
 
+  // Every thread starts from a request of the highest active priority, and
+  // only runs the work of lower priority requests when those have none. With a
+  // single priority this spreads the threads over all requests.
   std::vector<int> request_idx_list = ChooseRequestsWithExponentialDistribution(
-      num_active_requests, num_blocking_threads);
+      num_top_priority_requests, num_blocking_threads);
   for (int i = 0; i < num_blocking_threads; ++i) {
     VLOG(2) << "Set work for tid=" << i
             << " with start_request_idx=" << request_idx_list[i];
@@ -1005,7 +1057,7 @@ void RunHandlerPool::Impl::RecomputePoolStats(
   }
 
   request_idx_list = ChooseRequestsWithExponentialDistribution(
-      num_active_requests, num_non_blocking_threads);
+      num_top_priority_requests, num_non_blocking_threads);
   for (int i = 0; i < num_non_blocking_threads; ++i) {
     VLOG(2) << "Set work for tid=" << (i + num_blocking_threads)
             << " with start_request_idx=" << request_idx_list[i];
@@ -1059,7 +1111,7 @@ void RunHandler::Impl::ThreadPoolInterfaceWrapper::Schedule(
 RunHandler::Impl::Impl(RunHandlerPool::Impl* pool_impl)
     : pool_impl_(pool_impl) {
   thread_pool_interface_ = std::make_unique<ThreadPoolInterfaceWrapper>(this);
-  Reset(0, RunOptions::Experimental::RunHandlerPoolOptions());
+  Reset(0, 0, RunOptions::Experimental::RunHandlerPoolOptions());
 }
 
 void RunHandler::Impl::ScheduleInterOpClosure(std::function<void()> fn) {
@@ -1075,9 +1127,10 @@ void RunHandler::Impl::ScheduleIntraOpClosure(std::function<void()> fn) {
 }
 
 void RunHandler::Impl::Reset(
-    int64_t step_id,
+    int64_t step_id, int64_t timeout_in_ms,
     const RunOptions::Experimental::RunHandlerPoolOptions& options) {
   start_time_us_ = tensorflow::Env::Default()->NowMicros();
+  deadline_us_ = timeout_in_ms > 0 ? start_time_us_ + timeout_in_ms * 1000 : 0;
   step_id_ = step_id;
   options_ = options;
   tws_.SetTracemeId(step_id);
@@ -1103,6 +1156,11 @@ std::vector<int64_t> RunHandlerPool::GetActiveHandlerPrioritiesForTesting()
   return impl_->GetActiveHandlerPrioritiesForTesting();
 }
 
+std::vector<int64_t> RunHandlerPool::GetActiveHandlerStepIdsForTesting()
+    const {
+  return impl_->GetActiveHandlerStepIdsForTesting();
+}
+
 RunHandler::RunHandler(Impl* impl) : impl_(impl) {}
 
 void RunHandler::ScheduleInterOpClosure(std::function<void()> fn) {
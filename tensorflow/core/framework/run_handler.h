@@ -62,7 +62,16 @@ class RunHandlerPool {
   // and is being used by a client.  It becomes 'inactive' once more when the
   // unique_ptr is destroyed.
   //
-  // Will block unless there is an inactive handler.
+  // Will block unless there is an inactive handler. Blocked requests with a
+  // higher `options.priority()` get a handler first. If `timeout_in_ms` is
+  // positive, returns nullptr if no handler becomes available in time, and
+  // otherwise uses `timeout_in_ms` after the call as the deadline of the
+  // request.
+  //
+  // The work of active requests is run in order of priority, then deadline,
+  // then time of the Get() call. While requests of several priorities are
+  // active, every thread looks for work in the requests of the highest
+  // priority first.
   std::unique_ptr<RunHandler> Get(
       int64_t step_id = 0, int64_t timeout_in_ms = 0,
       const RunOptions::Experimental::RunHandlerPoolOptions& options =
@@ -72,6 +81,9 @@ class RunHandlerPool {
   // order of the active handler list.
   std::vector<int64_t> GetActiveHandlerPrioritiesForTesting() const;
 
+  // Get the step ids of the active handlers, in the same order.
+  std::vector<int64_t> GetActiveHandlerStepIdsForTesting() const;
+
  private:
   class Impl;
   friend class RunHandler;
@@ -82,7 +94,7 @@ class RunHandlerPool {
 // RunHandler can be used to schedule inter/intra-op closures to run on a global
 // pool shared across all Session::Run(s). The closures are enqueued to a
 // handler specific queue, from which the work is stolen in a priority order
-// (time of the Get() call).
+// (priority, deadline and time of the Get() call).
 //
 // It can only be created via RunHandlerPool::Get().
 //
@@ -28,11 +28,14 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/lib/histogram/histogram.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -113,6 +116,62 @@ TEST(RunHandlerUtilTest, PrioritySchedulingTest) {
   EXPECT_EQ(sorted_active_list[3], 1);
 }
 
+TEST(RunHandlerUtilTest, DeadlineSchedulingTest) {
+  std::unique_ptr<RunHandlerPool> pool(new RunHandlerPool(2, 2));
+
+  RunOptions::Experimental::RunHandlerPoolOptions options;
+  options.set_priority(1);
+  auto handler1 = pool->Get(/*step_id=*/1, /*timeout_in_ms=*/0, options);
+  auto handler2 = pool->Get(/*step_id=*/2, /*timeout_in_ms=*/60000, options);
+  auto handler3 = pool->Get(/*step_id=*/3, /*timeout_in_ms=*/1000, options);
+  auto handler4 = pool->Get(/*step_id=*/4, /*timeout_in_ms=*/0, options);
+  options.set_priority(2);
+  auto handler5 = pool->Get(/*step_id=*/5, /*timeout_in_ms=*/0, options);
+
+  // Higher priorities come first, then earlier deadlines, then requests
+  // without a deadline in arrival order.
+  EXPECT_EQ(pool->GetActiveHandlerStepIdsForTesting(),
+            std::vector<int64_t>({5, 3, 2, 1, 4}));
+}
+
+TEST(RunHandlerUtilTest, HigherPriorityWaiterGetsHandlerFirst) {
+  std::unique_ptr<RunHandlerPool> pool(new RunHandlerPool(1, 1));
+  std::vector<std::unique_ptr<RunHandler>> blocking_handles;
+  const int32_t kMaxConcurrentHandlers = 128;  // Copied from run_handler.cc.
+  for (int i = 0; i < kMaxConcurrentHandlers; ++i) {
+    blocking_handles.push_back(pool->Get(i));
+  }
+
+  auto tp = std::make_unique<thread::ThreadPool>(Env::Default(), "test", 2);
+  RunOptions::Experimental::RunHandlerPoolOptions options;
+  Notification low_acquired;
+  Notification high_acquired;
+  std::unique_ptr<RunHandler> low_handle;
+  std::unique_ptr<RunHandler> high_handle;
+  options.set_priority(1);
+  tp->Schedule([&, options]() {
+    low_handle = pool->Get(/*step_id=*/1000, /*timeout_in_ms=*/0, options);
+    low_acquired.Notify();
+  });
+  Env::Default()->SleepForMicroseconds(10000);
+  options.set_priority(2);
+  tp->Schedule([&, options]() {
+    high_handle = pool->Get(/*step_id=*/1001, /*timeout_in_ms=*/0, options);
+    high_acquired.Notify();
+  });
+  Env::Default()->SleepForMicroseconds(10000);
+
+  // The request that arrived later gets the first free handler.
+  blocking_handles[0].reset();
+  high_acquired.WaitForNotification();
+  Env::Default()->SleepForMicroseconds(10000);
+  EXPECT_FALSE(low_acquired.HasBeenNotified());
+
+  blocking_handles[1].reset();
+  low_acquired.WaitForNotification();
+  tp.reset();
+}
+
 TEST(RunHandlerThreadPool, EnqueueTask) {
   Eigen::MaxSizeVector<mutex> waiters_mu(2);
   waiters_mu.resize(2);
@@ -811,5 +870,69 @@ TEST_F(RunHandlerTest, TestWaitTimeout) {
   EXPECT_NE(next_handle.get(), nullptr);
 }
 
+// Keeps the calling thread busy for `micros`.
+void Spin(int64_t micros) {
+  const uint64_t end = Env::Default()->NowMicros() + micros;
+  while (Env::Default()->NowMicros() < end) {
+  }
+}
+
+// Measures the latency of small requests while large background requests keep
+// every thread of the pool busy. With state.range(0) == 1 the small requests
+// have a higher priority than the background ones, otherwise both have the
+// same priority. The label reports the median and 99th percentile latency.
+void BM_RunHandlerMixedLoad(::testing::benchmark::State& state) {
+  const bool prioritize = state.range(0);
+  const int kNumThreads = 4;
+  const int kNumBackgroundRequests = 4;
+  RunHandlerPool pool(kNumThreads, kNumThreads);
+
+  std::atomic<bool> done(false);
+  auto background = std::make_unique<thread::ThreadPool>(
+      Env::Default(), "background", kNumBackgroundRequests);
+  for (int i = 0; i < kNumBackgroundRequests; ++i) {
+    background->Schedule([&pool, &done, i]() {
+      RunOptions::Experimental::RunHandlerPoolOptions options;
+      options.set_priority(0);
+      for (int64_t step = 0; !done; ++step) {
+        auto handler = pool.Get(i * 1000000 + step, 0, options);
+        BlockingCounter counter(64);
+        for (int j = 0; j < 64; ++j) {
+          handler->ScheduleInterOpClosure([&counter]() {
+            Spin(100);
+            counter.DecrementCount();
+          });
+        }
+        counter.Wait();
+      }
+    });
+  }
+
+  RunOptions::Experimental::RunHandlerPoolOptions options;
+  options.set_priority(prioritize ? 1 : 0);
+  histogram::Histogram latency_us;
+  int64_t step = -1;
+  for (auto s : state) {
+    const uint64_t start = Env::Default()->NowMicros();
+    {
+      auto handler = pool.Get(step--, 0, options);
+      BlockingCounter counter(kNumThreads);
+      for (int j = 0; j < kNumThreads; ++j) {
+        handler->ScheduleInterOpClosure([&counter]() {
+          Spin(10);
+          counter.DecrementCount();
+        });
+      }
+      counter.Wait();
+    }
+    latency_us.Add(Env::Default()->NowMicros() - start);
+  }
+  done = true;
+  background.reset();
+  state.SetLabel(strings::StrCat("p50_us=", latency_us.Median(),
+                                 " p99_us=", latency_us.Percentile(99)));
+}
+BENCHMARK(BM_RunHandlerMixedLoad)->Arg(0)->Arg(1)->UseRealTime();
+
 }  // namespace
 }  // namespace tensorflow
@@ -0,0 +1,116 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/step_arena_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "tensorflow/core/framework/metrics.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace {
+
+// The total size of the regions of released arenas that are still in use.
+std::atomic<int64_t> retained_bytes{0};
+
+}  // namespace
+
+StepArenaAllocator::StepArenaAllocator(Allocator* base, size_t capacity,
+                                       size_t max_allocation_size)
+    : base_(base),
+      capacity_(capacity),
+      max_allocation_size_(std::min(capacity, max_allocation_size)) {
+  if (capacity_ > 0) {
+    region_ = static_cast<char*>(
+        base_->AllocateRaw(Allocator::kAllocatorAlignment, capacity_));
+  }
+}
+
+StepArenaAllocator::~StepArenaAllocator() {
+  DCHECK_EQ(region_refs_.load(), 0);
+}
+
+void* StepArenaAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  if (region_ != nullptr && alignment <= Allocator::kAllocatorAlignment &&
+      num_bytes <= max_allocation_size_) {
+    // Keep every buffer aligned, and never hand out the end of the region.
+    const size_t rounded_bytes =
+        std::max<size_t>(1, (num_bytes + Allocator::kAllocatorAlignment - 1) /
+                                Allocator::kAllocatorAlignment) *
+        Allocator::kAllocatorAlignment;
+    const size_t offset =
+        next_offset_.fetch_add(rounded_bytes, std::memory_order_relaxed);
+    if (offset < capacity_ && rounded_bytes <= capacity_ - offset) {
+      region_refs_.fetch_add(1, std::memory_order_relaxed);
+      refs_.fetch_add(1, std::memory_order_relaxed);
+      bytes_served_.fetch_add(num_bytes, std::memory_order_relaxed);
+      num_served_.fetch_add(1, std::memory_order_relaxed);
+      return region_ + offset;
+    }
+  }
+  void* ptr = base_->AllocateRaw(alignment, num_bytes);
+  if (ptr != nullptr) {
+    refs_.fetch_add(1, std::memory_order_relaxed);
+    num_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return ptr;
+}
+
+void StepArenaAllocator::DeallocateRaw(void* ptr) {
+  // Fallback buffers were allocated while the region was still live, so they
+  // cannot alias it even if the region has since been freed.
+  if (InRegion(ptr)) {
+    UnrefRegion();
+  } else {
+    base_->DeallocateRaw(ptr);
+  }
+  Unref();
+}
+
+void StepArenaAllocator::Release() {
+  metrics::RecordStepArenaUsage(bytes_served_.load(), num_served_.load(),
+                                num_fallbacks_.load());
+  // The region is retained until its last buffer is deallocated. It can only
+  // be freed from now on, since the step held a reference to it.
+  if (region_ != nullptr) {
+    retained_bytes.fetch_add(capacity_, std::memory_order_relaxed);
+  }
+  UnrefRegion();
+  Unref();
+}
+
+int64_t StepArenaAllocator::RetainedBytes() {
+  return retained_bytes.load(std::memory_order_relaxed);
+}
+
+void StepArenaAllocator::UnrefRegion() {
+  if (region_refs_.fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+      region_ != nullptr) {
+    base_->DeallocateRaw(region_);
+    retained_bytes.fetch_sub(capacity_, std::memory_order_relaxed);
+  }
+}
+
+void StepArenaAllocator::Unref() {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,108 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_FRAMEWORK_STEP_ARENA_ALLOCATOR_H_
+#define TENSORFLOW_CORE_FRAMEWORK_STEP_ARENA_ALLOCATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "tensorflow/core/framework/allocator.h"
+
+namespace tensorflow {
+
+// An allocator for the small host tensors of one step. Allocations of at most
+// `max_allocation_size` bytes are carved out of a single region of `capacity`
+// bytes with an atomic bump pointer, so concurrent kernels of the step do not
+// contend on the underlying allocator. Allocations that do not fit are
+// forwarded to `base` and counted as fallbacks.
+//
+// The executor creates one StepArenaAllocator per step and calls Release() when
+// the step ends, instead of deleting it. The region is returned to `base` in
+// one piece once the step has ended and every buffer carved out of it has been
+// deallocated, so tensors that outlive the step stay valid. The allocator
+// object itself lives until all of its allocations, including fallbacks, are
+// gone.
+//
+// As a consequence, a single small tensor that outlives its step, such as a
+// fetched output or a tensor stored in a queue, keeps the whole region of
+// `capacity` bytes alive. RetainedBytes() reports the size of such regions
+// across the process, so that callers can stop creating arenas when it grows
+// too large.
+class StepArenaAllocator : public Allocator {
+ public:
+  // `base` must outlive the allocator.
+  StepArenaAllocator(Allocator* base, size_t capacity,
+                     size_t max_allocation_size);
+
+  // Ends the step. Reports usage to the metrics in
+  // "tensorflow/core/framework/metrics.h".
+  void Release();
+
+  // Returns true if the arena may serve `num_bytes` from its region. Callers
+  // should send larger requests to the underlying allocator directly.
+  bool ShouldAllocate(size_t num_bytes) const {
+    return num_bytes <= max_allocation_size_;
+  }
+
+  std::string Name() override { return "step_arena"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+  AllocatorMemoryType GetMemoryType() const override {
+    return base_->GetMemoryType();
+  }
+
+  // Usage counters, for tests.
+  int64_t bytes_served() const { return bytes_served_.load(); }
+  int64_t num_fallbacks() const { return num_fallbacks_.load(); }
+
+  // Returns the total size of the regions of all released arenas that are
+  // still kept alive by buffers carved out of them.
+  static int64_t RetainedBytes();
+
+ private:
+  ~StepArenaAllocator() override;
+
+  bool InRegion(const void* ptr) const {
+    return ptr >= region_ && ptr < region_ + capacity_;
+  }
+
+  // Drop a reference on the region or on the allocator, freeing it when the
+  // last reference is gone. Both start with one reference held by the step.
+  void UnrefRegion();
+  void Unref();
+
+  Allocator* const base_;
+  const size_t capacity_;
+  const size_t max_allocation_size_;
+  char* region_ = nullptr;
+
+  std::atomic<size_t> next_offset_{0};
+  std::atomic<int64_t> region_refs_{1};
+  std::atomic<int64_t> refs_{1};
+
+  std::atomic<int64_t> bytes_served_{0};
+  std::atomic<int64_t> num_served_{0};
+  std::atomic<int64_t> num_fallbacks_{0};
+
+  StepArenaAllocator(const StepArenaAllocator&) = delete;
+  void operator=(const StepArenaAllocator&) = delete;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_STEP_ARENA_ALLOCATOR_H_
@@ -0,0 +1,124 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/step_arena_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/mem.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Counts the buffers that are currently allocated.
+class CountingAllocator : public Allocator {
+ public:
+  std::string Name() override { return "counting"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    ++num_live_;
+    return port::AlignedMalloc(num_bytes, alignment);
+  }
+  void DeallocateRaw(void* ptr) override {
+    --num_live_;
+    port::AlignedFree(ptr);
+  }
+  int num_live() const { return num_live_; }
+
+ private:
+  int num_live_ = 0;
+};
+
+TEST(StepArenaAllocatorTest, ServesSmallAllocationsFromOneRegion) {
+  CountingAllocator base;
+  auto* arena = new StepArenaAllocator(&base, /*capacity=*/4096,
+                                       /*max_allocation_size=*/1024);
+  EXPECT_EQ(base.num_live(), 1);
+  EXPECT_TRUE(arena->ShouldAllocate(1024));
+  EXPECT_FALSE(arena->ShouldAllocate(1025));
+
+  void* p1 = arena->AllocateRaw(Allocator::kAllocatorAlignment, 10);
+  void* p2 = arena->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  ASSERT_NE(p1, nullptr);
+  ASSERT_NE(p2, nullptr);
+  EXPECT_NE(p1, p2);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p1) % Allocator::kAllocatorAlignment,
+            0);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p2) % Allocator::kAllocatorAlignment,
+            0);
+  std::memset(p1, 1, 10);
+  std::memset(p2, 2, 100);
+  EXPECT_EQ(base.num_live(), 1);
+  EXPECT_EQ(arena->bytes_served(), 110);
+  EXPECT_EQ(arena->num_fallbacks(), 0);
+
+  arena->DeallocateRaw(p1);
+  arena->DeallocateRaw(p2);
+  EXPECT_EQ(base.num_live(), 1);
+  arena->Release();
+  EXPECT_EQ(base.num_live(), 0);
+}
+
+TEST(StepArenaAllocatorTest, FallsBackWhenFull) {
+  CountingAllocator base;
+  auto* arena = new StepArenaAllocator(&base, /*capacity=*/256,
+                                       /*max_allocation_size=*/256);
+  void* served[4];
+  for (int i = 0; i < 4; ++i) {
+    served[i] = arena->AllocateRaw(Allocator::kAllocatorAlignment, 1);
+  }
+  EXPECT_EQ(base.num_live(), 1);
+  void* fallback = arena->AllocateRaw(Allocator::kAllocatorAlignment, 1);
+  ASSERT_NE(fallback, nullptr);
+  EXPECT_EQ(base.num_live(), 2);
+  EXPECT_EQ(arena->num_fallbacks(), 1);
+
+  for (void* ptr : served) {
+    arena->DeallocateRaw(ptr);
+  }
+  arena->DeallocateRaw(fallback);
+  EXPECT_EQ(base.num_live(), 1);
+  arena->Release();
+  EXPECT_EQ(base.num_live(), 0);
+}
+
+TEST(StepArenaAllocatorTest, BuffersOutliveTheStep) {
+  CountingAllocator base;
+  auto* arena = new StepArenaAllocator(&base, /*capacity=*/4096,
+                                       /*max_allocation_size=*/1024);
+  Tensor small(arena, DT_FLOAT, TensorShape({4}));
+  Tensor large(arena, DT_FLOAT, TensorShape({4096}));
+  small.flat<float>().setConstant(1.0f);
+  large.flat<float>().setConstant(2.0f);
+  const int64_t retained_bytes = StepArenaAllocator::RetainedBytes();
+  arena->Release();
+
+  // The region stays alive while `small` references it.
+  EXPECT_EQ(base.num_live(), 2);
+  EXPECT_EQ(StepArenaAllocator::RetainedBytes(), retained_bytes + 4096);
+  EXPECT_EQ(small.flat<float>()(3), 1.0f);
+  small = Tensor();
+  EXPECT_EQ(base.num_live(), 1);
+  EXPECT_EQ(StepArenaAllocator::RetainedBytes(), retained_bytes);
+  EXPECT_EQ(large.flat<float>()(4095), 2.0f);
+  large = Tensor();
+  EXPECT_EQ(base.num_live(), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,129 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/batch_and_parse_example_fusion.h"
+
+#include "absl/container/flat_hash_set.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/mutable_graph_view.h"
+#include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/lib/gtl/map_util.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kFusedOpName[] = "BatchAndParseExampleDataset";
+constexpr char kBatch[] = "BatchDataset";
+constexpr char kBatchV2[] = "BatchDatasetV2";
+constexpr char kParseExampleV2[] = "ParseExampleDatasetV2";
+
+// Returns true if `batch_node` stacks scalar strings into a vector, i.e. its
+// output is what `BatchAndParseExampleDataset` expects as its input.
+bool BatchesScalarStrings(const NodeDef& batch_node) {
+  const AttrValue* types = gtl::FindOrNull(batch_node.attr(), "output_types");
+  const AttrValue* shapes = gtl::FindOrNull(batch_node.attr(), "output_shapes");
+  if (types == nullptr || shapes == nullptr ||
+      types->list().type_size() != 1 || shapes->list().shape_size() != 1) {
+    return false;
+  }
+  const TensorShapeProto& shape = shapes->list().shape(0);
+  return types->list().type(0) == DT_STRING && !shape.unknown_rank() &&
+         shape.dim_size() == 1;
+}
+
+NodeDef MakeBatchAndParseExampleNode(const NodeDef& batch_node,
+                                     const NodeDef& parse_node,
+                                     MutableGraphView* graph) {
+  NodeDef new_node;
+  new_node.set_op(kFusedOpName);
+  graph_utils::SetUniqueGraphNodeName(kFusedOpName, graph->graph(), &new_node);
+
+  // Set the `input_dataset` and `batch_size` input arguments.
+  new_node.add_input(batch_node.input(0));
+  new_node.add_input(batch_node.input(1));
+
+  // Set the `drop_remainder` input argument.
+  if (batch_node.op() == kBatchV2) {
+    new_node.add_input(batch_node.input(2));
+  } else {
+    NodeDef* tmp = graph_utils::AddScalarConstNode<bool>(false, graph);
+    new_node.add_input(tmp->name());
+  }
+
+  // Set the `num_parallel_calls` and `dense_defaults` input arguments.
+  for (int i = 1; i < parse_node.input_size(); ++i) {
+    if (IsControlInput(parse_node.input(i))) break;
+    new_node.add_input(parse_node.input(i));
+  }
+
+  // The fused op takes the same attributes as `ParseExampleDatasetV2`.
+  *new_node.mutable_attr() = parse_node.attr();
+  graph_utils::MaybeSetFusedMetadata(batch_node, parse_node, &new_node);
+  return new_node;
+}
+
+}  // namespace
+
+absl::Status BatchAndParseExampleFusion::OptimizeAndCollectStats(
+    Cluster* cluster, const GrapplerItem& item, GraphDef* output,
+    OptimizationStats* stats) {
+  *output = item.graph;
+  MutableGraphView graph(output);
+  absl::flat_hash_set<std::string> nodes_to_delete;
+  for (const NodeDef& node : item.graph.node()) {
+    if (node.op() != kParseExampleV2) {
+      continue;
+    }
+
+    // Use a more descriptive variable name now that we know the node type.
+    const NodeDef& parse_node = node;
+    NodeDef* batch_node = graph_utils::GetInputNode(parse_node, graph);
+    if (batch_node == nullptr ||
+        (batch_node->op() != kBatch && batch_node->op() != kBatchV2) ||
+        !BatchesScalarStrings(*batch_node)) {
+      continue;
+    }
+    // The batched strings cannot be skipped if anything else consumes them.
+    if (graph.NumFanouts(*batch_node, /*include_controlled_nodes=*/true) != 1) {
+      continue;
+    }
+
+    auto* new_node = graph.AddNode(
+        MakeBatchAndParseExampleNode(*batch_node, parse_node, &graph));
+    TF_RETURN_IF_ERROR(
+        graph.UpdateFanouts(parse_node.name(), new_node->name()));
+
+    // Mark the `Batch` and `ParseExample` nodes for removal.
+    nodes_to_delete.insert(batch_node->name());
+    nodes_to_delete.insert(parse_node.name());
+    stats->num_changes++;
+  }
+
+  TF_RETURN_IF_ERROR(graph.DeleteNodes(nodes_to_delete));
+  return absl::OkStatus();
+}
+
+REGISTER_GRAPH_OPTIMIZER_AS(BatchAndParseExampleFusion,
+                            "batch_and_parse_example_fusion");
+
+}  // namespace grappler
+}  // namespace tensorflow
@@ -0,0 +1,142 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/data/batch_and_parse_example_fusion.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/framework/attr_value_util.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/optimizers/data/graph_utils.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+// Adds a `BatchDatasetV2` node that batches elements of shape `element_shape`
+// from a `TFRecordDataset`.
+NodeDef *AddBatchNode(const PartialTensorShape &element_shape,
+                      MutableGraphView *graph) {
+  NodeDef *filenames_node =
+      graph_utils::AddScalarConstNode<absl::string_view>("file", graph);
+  NodeDef *records_node = graph_utils::AddNode(
+      "", "TFRecordDataset", {filenames_node->name()}, {}, graph);
+  NodeDef *batch_size_node =
+      graph_utils::AddScalarConstNode<int64_t>(32, graph);
+  NodeDef *drop_remainder_node =
+      graph_utils::AddScalarConstNode<bool>(true, graph);
+
+  AttrValue shapes_attr;
+  SetAttrValue(std::vector<PartialTensorShape>(
+                   {PartialTensorShape({-1}).Concatenate(element_shape)}),
+               &shapes_attr);
+  AttrValue types_attr;
+  SetAttrValue(std::vector<DataType>({DT_STRING}), &types_attr);
+  return graph_utils::AddNode(
+      "", "BatchDatasetV2",
+      {records_node->name(), batch_size_node->name(),
+       drop_remainder_node->name()},
+      {{"output_shapes", shapes_attr}, {"output_types", types_attr}}, graph);
+}
+
+NodeDef *AddParseNode(const NodeDef &batch_node, MutableGraphView *graph) {
+  NodeDef *num_parallel_calls_node =
+      graph_utils::AddScalarConstNode<int64_t>(4, graph);
+  NodeDef *dense_default_node =
+      graph_utils::AddScalarConstNode<float>(0.0f, graph);
+  AttrValue dense_keys_attr;
+  SetAttrValue(std::vector<std::string>({"a"}), &dense_keys_attr);
+  AttrValue dense_types_attr;
+  SetAttrValue(std::vector<DataType>({DT_FLOAT}), &dense_types_attr);
+  AttrValue deterministic_attr;
+  SetAttrValue("true", &deterministic_attr);
+  return graph_utils::AddNode(
+      "", "ParseExampleDatasetV2",
+      {batch_node.name(), num_parallel_calls_node->name(),
+       dense_default_node->name()},
+      {{"dense_keys", dense_keys_attr},
+       {"Tdense", dense_types_attr},
+       {"deterministic", deterministic_attr}},
+      graph);
+}
+
+TEST(BatchAndParseExampleFusionTest, FuseBatchAndParseExampleIntoOne) {
+  GrapplerItem item;
+  MutableGraphView graph(&item.graph);
+  NodeDef *batch_node = AddBatchNode(PartialTensorShape({}), &graph);
+  NodeDef *parse_node = AddParseNode(*batch_node, &graph);
+
+  BatchAndParseExampleFusion optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  EXPECT_FALSE(
+      graph_utils::ContainsGraphNodeWithName(batch_node->name(), output));
+  EXPECT_FALSE(
+      graph_utils::ContainsGraphNodeWithName(parse_node->name(), output));
+  ASSERT_TRUE(
+      graph_utils::ContainsNodeWithOp("BatchAndParseExampleDataset", output));
+  NodeDef fused_node = output.node(
+      graph_utils::FindGraphNodeWithOp("BatchAndParseExampleDataset", output));
+  ASSERT_EQ(fused_node.input_size(), 5);
+  EXPECT_EQ(fused_node.input(0), batch_node->input(0));
+  EXPECT_EQ(fused_node.input(1), batch_node->input(1));
+  EXPECT_EQ(fused_node.input(2), batch_node->input(2));
+  EXPECT_EQ(fused_node.input(3), parse_node->input(1));
+  EXPECT_EQ(fused_node.input(4), parse_node->input(2));
+  for (const char *key : {"dense_keys", "Tdense", "deterministic"}) {
+    EXPECT_TRUE(AreAttrValuesEqual(fused_node.attr().at(key),
+                                   parse_node->attr().at(key)));
+  }
+}
+
+TEST(BatchAndParseExampleFusionTest, DoesNotFuseNonScalarElements) {
+  GrapplerItem item;
+  MutableGraphView graph(&item.graph);
+  NodeDef *batch_node = AddBatchNode(PartialTensorShape({2}), &graph);
+  AddParseNode(*batch_node, &graph);
+
+  BatchAndParseExampleFusion optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_FALSE(
+      graph_utils::ContainsNodeWithOp("BatchAndParseExampleDataset", output));
+  EXPECT_TRUE(
+      graph_utils::ContainsGraphNodeWithName(batch_node->name(), output));
+}
+
+TEST(BatchAndParseExampleFusionTest, DoesNotFuseSharedBatch) {
+  GrapplerItem item;
+  MutableGraphView graph(&item.graph);
+  NodeDef *batch_node = AddBatchNode(PartialTensorShape({}), &graph);
+  AddParseNode(*batch_node, &graph);
+  graph_utils::AddNode("", "PrefetchDataset", {batch_node->name()}, {},
+                       &graph);
+
+  BatchAndParseExampleFusion optimizer;
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+  EXPECT_FALSE(
+      graph_utils::ContainsNodeWithOp("BatchAndParseExampleDataset", output));
+}
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
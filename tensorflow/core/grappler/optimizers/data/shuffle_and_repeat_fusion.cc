@@ -40,6 +40,8 @@ constexpr char kShuffleAndRepeatDataset[] = "ShuffleAndRepeatDataset";
 constexpr char kShuffleAndRepeatDatasetV2[] = "ShuffleAndRepeatDatasetV2";
 
 constexpr char kReshuffleEachIteration[] = "reshuffle_each_iteration";
+constexpr char kSpillDirectory[] = "spill_directory";
+constexpr char kSpillMemoryBytes[] = "spill_memory_bytes";
 
 absl::Status FuseShuffleV1AndRepeat(const NodeDef& shuffle_node,
                                     const NodeDef& repeat_node,
@@ -146,6 +148,14 @@ absl::Status FuseShuffleV3AndRepeat(const NodeDef& shuffle_node,
   graph_utils::CopyShapesAndTypesAttrs(shuffle_node, fused_node);
   graph_utils::CopyAttribute(kReshuffleEachIteration, shuffle_node, fused_node);
 
+  // Copy the spill attributes, which graphs from before they were added do
+  // not set.
+  for (const char* attr : {kSpillDirectory, kSpillMemoryBytes}) {
+    if (shuffle_node.attr().contains(attr)) {
+      graph_utils::CopyAttribute(attr, shuffle_node, fused_node);
+    }
+  }
+
   // Optionally set the `metadata` attribute.
   graph_utils::MaybeSetFusedMetadata(shuffle_node, repeat_node, fused_node);
 
@@ -28,6 +28,8 @@ namespace {
 constexpr char kOutputShapes[] = "output_shapes";
 constexpr char kOutputTypes[] = "output_types";
 constexpr char kReshuffleEachIteration[] = "reshuffle_each_iteration";
+constexpr char kSpillDirectory[] = "spill_directory";
+constexpr char kSpillMemoryBytes[] = "spill_memory_bytes";
 
 TEST(ShuffleAndRepeatFusionTest, FuseShuffleV1AndRepeat) {
   GrapplerItem item;
@@ -202,6 +204,8 @@ TEST(ShuffleAndRepeatFusionTest, FuseShuffleV3AndRepeat) {
   NodeDef *shuffle_node = graph_utils::AddNode(
       "", "ShuffleDatasetV3", shuffle_inputs, common_attrs, &graph);
   (*shuffle_node->mutable_attr())[kReshuffleEachIteration].set_b(true);
+  (*shuffle_node->mutable_attr())[kSpillDirectory].set_s("/tmp/spill");
+  (*shuffle_node->mutable_attr())[kSpillMemoryBytes].set_i(1 << 20);
 
   NodeDef *count_node = graph_utils::AddScalarConstNode<int64_t>(-1, &graph);
   std::vector<std::string> repeat_inputs(2);
@@ -230,7 +234,8 @@ TEST(ShuffleAndRepeatFusionTest, FuseShuffleV3AndRepeat) {
   EXPECT_EQ(shuffle_and_repeat_node.input(4), repeat_node->input(1));
   EXPECT_EQ(shuffle_and_repeat_node.input(5), shuffle_node->input(4));
   for (const auto &attr :
-       {kOutputShapes, kOutputTypes, kReshuffleEachIteration}) {
+       {kOutputShapes, kOutputTypes, kReshuffleEachIteration, kSpillDirectory,
+        kSpillMemoryBytes}) {
     EXPECT_TRUE(AreAttrValuesEqual(shuffle_and_repeat_node.attr().at(attr),
                                    shuffle_node->attr().at(attr)));
   }
@@ -14,22 +14,28 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/cache_dataset_ops.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "tensorflow/core/data/global_shuffle_utils.h"
+#include "tensorflow/core/data/mmap_cache_file.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -69,6 +75,8 @@ constexpr char kCreatedAt[] = "Created at";
 constexpr char kMemoryDatasetPrefix[] = "Memory";
 constexpr char kMemoryCache[] = "MemoryCache";
 constexpr char kCacheCompleted[] = "cache_completed";
+constexpr char kCacheCompressed[] = "cache_compressed";
+constexpr char kMmapFormat[] = "mmap_format";
 constexpr char kIndex[] = "index";
 constexpr char kImpl[] = "Impl";
 constexpr char kCacheDataset[] = "CacheDataset";
@@ -78,6 +86,50 @@ constexpr char kIncompleteCacheErrorMessage[] =
     "contents of the dataset  will be discarded. This can happen if you have "
     "an input pipeline similar to `dataset.cache().take(k).repeat()`. You "
     "should use `dataset.take(k).cache().repeat()` instead.";
+
+// Returns whether in-memory caches hold their elements compressed, trading
+// CPU time on every read for being able to cache larger datasets.
+bool CompressMemoryCache(IteratorContext* ctx) {
+  return ctx->options() != nullptr && ctx->options()->compress_memory_cache();
+}
+
+// Returns whether file caches are written in the mmap cache file format, which
+// supports random access and is read through a memory mapping, instead of as
+// a tensor bundle. Readers detect the format from the files on disk.
+bool MmapFileCache(IteratorContext* ctx) {
+  return ctx->options() != nullptr && ctx->options()->mmap_file_cache();
+}
+
+// Writes the elements of `arena` to the checkpoint as serialized
+// `CompressedElement`s, without uncompressing them.
+absl::Status WriteCompressedElementsToCheckpoint(
+    IteratorStateWriter* writer, const std::string& key_prefix,
+    const CompressedElementArena& arena) {
+  std::vector<std::vector<Tensor>> elements;
+  elements.reserve(arena.size());
+  for (int64_t i = 0; i < arena.size(); ++i) {
+    elements.push_back({Tensor(tstring(arena.GetCompressed(i)))});
+  }
+  return WriteElementsToCheckpoint(writer, key_prefix, elements);
+}
+
+absl::Status ReadCompressedElementsFromCheckpoint(
+    IteratorContext* ctx, IteratorStateReader* reader,
+    const std::string& key_prefix, CompressedElementArena* arena) {
+  std::vector<std::vector<Tensor>> elements;
+  TF_RETURN_IF_ERROR(
+      ReadElementsFromCheckpoint(ctx, reader, key_prefix, &elements));
+  arena->Clear();
+  for (const std::vector<Tensor>& element : elements) {
+    if (element.size() != 1 || element[0].dtype() != DT_STRING ||
+        element[0].NumElements() != 1) {
+      return absl::DataLossError(
+          "Expected a serialized compressed element in the checkpoint.");
+    }
+    arena->AddCompressed(element[0].scalar<tstring>()());
+  }
+  return absl::OkStatus();
+}
 }  // namespace
 
 class DatasetRandomAccessCache {
@@ -184,6 +236,9 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         item_index_padding_size_(StringPaddingSize(kMaxItems)) {
     input_->Ref();
     DCHECK_EQ(item_index_padding_size_, 7);
+    // The format of the cache is only known once it has been written, so
+    // `Get` checks that it supports random access.
+    random_indexing_compatible_ = input_->RandomIndexingCompatible();
   }
 
   ~FileDatasetBase() override { input_->Unref(); }
@@ -224,11 +279,72 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
     return input_->CheckExternalState();
   }
 
+  // Reads the element from the cache, which must have been completely written
+  // in the mmap format. Random access, which also backs global shuffling,
+  // does not write the cache.
+  absl::Status Get(OpKernelContext* ctx, int64_t index,
+                   std::vector<Tensor>* out_tensors) const override {
+    return GetFromCache(index, out_tensors);
+  }
+
+  absl::Status Get(AnyContext ctx, int64_t index,
+                   std::vector<Tensor>* out_tensors) const override {
+    return GetFromCache(index, out_tensors);
+  }
+
+  absl::Status RandomIndexingCompatible() const override {
+    return random_indexing_compatible_;
+  }
+
  protected:
   const DatasetBase* const input_;
   const tstring filename_;
 
  private:
+  // Returns whether the cache has been completely written, in either format.
+  bool CacheExists() const {
+    return env_->FileExists(MetaFilename(filename_)).ok() ||
+           MmapCacheExists();
+  }
+
+  bool MmapCacheExists() const {
+    return env_->FileExists(MmapCacheFilename(filename_)).ok();
+  }
+
+  // Returns a reader of the cache file shared by all iterators, or nullptr if
+  // the cache has not been written in the mmap format.
+  absl::StatusOr<std::shared_ptr<MmapCacheFileReader>> GetMmapCacheFileReader()
+      const {
+    mutex_lock l(mu_);
+    if (!mmap_reader_ && MmapCacheExists()) {
+      TF_ASSIGN_OR_RETURN(
+          mmap_reader_,
+          MmapCacheFileReader::Open(env_, MmapCacheFilename(filename_)));
+    }
+    return mmap_reader_;
+  }
+
+  absl::Status GetFromCache(int64_t index,
+                            std::vector<Tensor>* out_tensors) const {
+    TF_ASSIGN_OR_RETURN(std::shared_ptr<MmapCacheFileReader> reader,
+                        GetMmapCacheFileReader());
+    if (!reader && env_->FileExists(MetaFilename(filename_)).ok()) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          type_string(), " only supports random access if the cache is "
+          "written in the mmap format, but ", filename_, " was written as a "
+          "tensor bundle. Delete it and rewrite it with "
+          "`tf.data.Options.experimental_mmap_file_cache` set."));
+    }
+    if (!reader) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          type_string(), " only supports random access, such as global "
+          "shuffling, once its cache file ", MmapCacheFilename(filename_),
+          " has been completely written. Iterate over the dataset once "
+          "without global shuffling to write the cache."));
+    }
+    return reader->Get(index, out_tensors);
+  }
+
   static size_t StringPaddingSize(size_t num_tensors) {
     return absl::StrFormat(kPaddingSizeStrFormat, num_tensors - 1).size();
   }
@@ -241,10 +357,9 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
   class FileIterator : public DatasetIterator<FileDatasetBase> {
    public:
     explicit FileIterator(const Params& params)
-        : DatasetIterator<FileDatasetBase>(params) {
-      if (params.dataset->env_
-              ->FileExists(MetaFilename(params.dataset->filename_))
-              .ok()) {
+        : DatasetIterator<FileDatasetBase>(params),
+          global_shuffle_iterator_(params.dataset) {
+      if (params.dataset->CacheExists()) {
         mode_ = Mode::read;
       } else {
         mode_ = Mode::write;
@@ -259,6 +374,10 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
     absl::Status GetNextInternal(IteratorContext* ctx,
                                  std::vector<Tensor>* out_tensors,
                                  bool* end_of_sequence) override {
+      if (ctx->index_mapper() != nullptr) {
+        return global_shuffle_iterator_.GetNext(ctx, out_tensors,
+                                                end_of_sequence);
+      }
       mutex_lock l(mu_);
       return iterator_->GetNext(ctx, out_tensors, end_of_sequence);
     }
@@ -274,25 +393,26 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
                               IteratorStateWriter* writer) override {
       mutex_lock l(mu_);
       TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kMode, mode_));
+      TF_RETURN_IF_ERROR(global_shuffle_iterator_.Save(prefix(), ctx, writer));
       return SaveInput(ctx, writer, iterator_);
     }
     absl::Status RestoreInternal(IteratorContext* ctx,
                                  IteratorStateReader* reader) override {
+      if (ctx->restored_element_count().has_value()) {
+        return global_shuffle_iterator_.Restore(prefix(), ctx, reader);
+      }
       mutex_lock l(mu_);
       {
         int64_t temp;
         TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kMode, &temp));
         mode_ = static_cast<Mode>(temp);
       }
-      if (mode_ == Mode::write &&
-          dataset()
-              ->env_->FileExists(MetaFilename(dataset()->filename_))
-              .ok()) {
+      if (mode_ == Mode::write && dataset()->CacheExists()) {
         // This could happen if the cache was completely written after the
         // checkpoint was saved.
         LOG(WARNING)
             << "It looks like the cache was already completely written("
-            << MetaFilename(dataset()->filename_)
+            << dataset()->filename_
             << ") after the last checkpoint was saved. Attempting to read "
             << "the cache instead of continuing to write. If this is a "
             << "mistake, please remove the above file and try running again.";
@@ -319,6 +439,9 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
     // partial cache gets flushed to disk in files with prefix
     // <filename>_<shard_id> where shard_id is unique for each checkpoint.
     // When all elements have been produced, these shards get coalesced.
+    // If the dataset uses the mmap format, each shard is written with an
+    // `MmapCacheFileWriter` instead and the shards are merged into a single
+    // mmap cache file.
     class FileWriterIterator : public DatasetIterator<FileDatasetBase> {
      public:
       explicit FileWriterIterator(const Params& params)
@@ -331,7 +454,7 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
             iteration_completed_(false) {}
 
       ~FileWriterIterator() override {
-        if (!dataset()->env_->FileExists(MetaFilename(filename_)).ok()) {
+        if (!ShardWritten()) {
           LOG(WARNING) << kIncompleteCacheErrorMessage;
           std::vector<std::string> cache_files;
           absl::Status s = dataset()->env_->GetMatchingPaths(
@@ -351,6 +474,8 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
       }
 
       absl::Status Initialize(IteratorContext* ctx) override {
+        mutex_lock l(mu_);
+        mmap_format_ = MmapFileCache(ctx);
         return dataset()->input_->MakeIterator(ctx, this, prefix(),
                                                &input_impl_);
       }
@@ -364,7 +489,9 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         if (*end_of_sequence) {
           return absl::OkStatus();
         }
-        TF_RETURN_IF_ERROR(writer_->status());
+        if (!mmap_format_) {
+          TF_RETURN_IF_ERROR(writer_->status());
+        }
         if (cur_index_ >= kMaxItems) {
           // As a courtesy, close the [truncated] cache file.
           absl::Status s = Finish();
@@ -389,11 +516,16 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
               "Expected ",
               dataset()->num_tensors_, " got: ", out_tensors->size()));
         }
-        size_t tensor_index = 0;
-        for (const Tensor& t : *out_tensors) {
-          DCHECK_LT(tensor_index, dataset()->num_tensors_);
-          std::string key = dataset()->FormatName(cur_index_, tensor_index++);
-          TF_RETURN_IF_ERROR(writer_->Add(key, t));
+        if (mmap_format_) {
+          TF_RETURN_IF_ERROR(mmap_writer_->Add(*out_tensors));
+        } else {
+          size_t tensor_index = 0;
+          for (const Tensor& t : *out_tensors) {
+            DCHECK_LT(tensor_index, dataset()->num_tensors_);
+            std::string key =
+                dataset()->FormatName(cur_index_, tensor_index++);
+            TF_RETURN_IF_ERROR(writer_->Add(key, t));
+          }
         }
         if (*end_of_sequence) {
           TF_RETURN_IF_ERROR(Finish());
@@ -414,6 +546,9 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         mutex_lock l(mu_);
         TF_RETURN_IF_ERROR(
             writer->WriteScalar(prefix(), kCurIndex, cur_index_));
+        if (mmap_format_) {
+          TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kMmapFormat, ""));
+        }
 
         if (iteration_completed_) {
           TF_RETURN_IF_ERROR(
@@ -427,8 +562,8 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         // about flushing the current shard. This ensures that we never write
         // empty shards.
         if (lockfile_created_) {
-          // Flush the current bundle.
-          TF_RETURN_IF_ERROR(writer_->Finish());
+          // Flush the current shard.
+          TF_RETURN_IF_ERROR(FinishShard());
 
           // Note: We do not delete the lockfile here. We keep lockfiles of
           // all shards around until the entire cache has been written to
@@ -459,6 +594,8 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
                 absl::StrCat("Invalid value for cur_index ", temp));
           }
         }
+        // Continues writing the cache in the format of its earlier shards.
+        mmap_format_ = reader->Contains(prefix(), kMmapFormat);
 
         if (reader->Contains(prefix(), kIterationCompleted)) {
           iteration_completed_ = true;
@@ -479,11 +616,31 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         }
         filename_ = absl::StrCat(dataset()->filename_, "_", shard_id_);
         lockfile_ = absl::StrCat(filename_, kLockFileSuffix);
-        writer_ = std::make_unique<BundleWriter>(dataset()->env_, filename_);
+        if (!mmap_format_) {
+          writer_ =
+              std::make_unique<BundleWriter>(dataset()->env_, filename_);
+        }
         return absl::OkStatus();
       }
 
      private:
+      // Returns whether the current shard has been completely written.
+      bool ShardWritten() const {
+        if (mmap_format_) {
+          return dataset()->env_->FileExists(MmapCacheFilename(filename_)).ok();
+        }
+        return dataset()->env_->FileExists(MetaFilename(filename_)).ok();
+      }
+
+      absl::Status FinishShard() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (mmap_format_) {
+          TF_RETURN_IF_ERROR(mmap_writer_->Finish());
+          mmap_writer_.reset();
+          return absl::OkStatus();
+        }
+        return writer_->Finish();
+      }
+
       absl::Status EnsureLockFileExists(bool* end_of_sequence)
           TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         if (iteration_completed_) {
@@ -499,6 +656,11 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
 
         // 1. Check that a checkpoint for the shard has not already been
         // written.
+        if (mmap_format_ && ShardWritten()) {
+          return absl::AlreadyExistsError(absl::StrCat(
+              "Existing cache files found: \n", MmapCacheFilename(filename_),
+              "\n", "To continue delete the above files."));
+        }
         if (dataset()->env_->FileExists(MetaFilename(filename_)).ok()) {
           return absl::AlreadyExistsError(absl::StrCat(
               "Existing cache files found: \n", MetaFilename(filename_), "\n",
@@ -542,23 +704,41 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
         // conditions are not met since BundleWriter's constructor creates
         // new temp files which can delete the temp files created by a
         // BundleWriter in another Session.
-        writer_ = std::make_unique<BundleWriter>(dataset()->env_, filename_);
+        if (mmap_format_) {
+          TF_ASSIGN_OR_RETURN(
+              mmap_writer_,
+              MmapCacheFileWriter::Create(dataset()->env_,
+                                          MmapCacheFilename(filename_)));
+        } else {
+          writer_ =
+              std::make_unique<BundleWriter>(dataset()->env_, filename_);
+        }
         lockfile_created_ = true;
         return absl::OkStatus();
       }
 
       absl::Status Finish() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
         iteration_completed_ = true;
-        // Flush the current bundle.
-        TF_RETURN_IF_ERROR(writer_->Finish());
-        // Merge all the bundles.
+        // Flush the current shard.
+        TF_RETURN_IF_ERROR(FinishShard());
+        // Merge all the shards.
         // Currently there are `shard_id_ + 1` bundles, one for each
         // checkpoint. Each bundle has prefix <filename>_<id> where `id` is an
         // integer starting at 0 and incremented by 1 for each new checkpoint.
         // We merge all these bundles into a bundle with prefix <filename> so
         // that the next call to `MakeIterator` can build a
         // `FileReaderIterator`.
-        {
+        if (mmap_format_) {
+          std::vector<std::string> filenames;
+          filenames.reserve(shard_id_ + 1);
+          for (size_t i = 0; i <= shard_id_; ++i) {
+            filenames.push_back(MmapCacheFilename(
+                absl::StrCat(dataset()->filename_, "_", i)));
+          }
+          TF_RETURN_IF_ERROR(
+              MergeMmapCacheFiles(dataset()->env_, filenames,
+                                  MmapCacheFilename(dataset()->filename_)));
+        } else {
           std::vector<tstring> prefixes;
           prefixes.reserve(shard_id_ + 1);
           for (size_t i = 0; i <= shard_id_; ++i) {
@@ -584,7 +764,11 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
       // The current prefix for the cache file. This is equal to
       // `StrCat(dataset()->filename_, "_", shard_id_)`.
       std::string filename_;
+      // Whether the cache is written in the mmap cache file format.
+      bool mmap_format_ = false;
       std::unique_ptr<BundleWriter> writer_ TF_GUARDED_BY(mu_);
+      // Used instead of `writer_` if the cache is written in the mmap format.
+      std::unique_ptr<MmapCacheFileWriter> mmap_writer_ TF_GUARDED_BY(mu_);
       std::string lockfile_ TF_GUARDED_BY(mu_);
       bool lockfile_created_ TF_GUARDED_BY(mu_);
       bool iteration_completed_ TF_GUARDED_BY(mu_);
@@ -680,6 +864,63 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
       bool iterator_restored_ TF_GUARDED_BY(mu_);
     };  // FileReaderIterator
 
+    // Reads a cache written in the mmap format. Elements are read directly
+    // from the mapped file, so iterators of the same dataset share its pages.
+    class MmapFileReaderIterator : public DatasetIterator<FileDatasetBase> {
+     public:
+      explicit MmapFileReaderIterator(const Params& params)
+          : DatasetIterator<FileDatasetBase>(params) {}
+
+      absl::Status Initialize(IteratorContext* ctx) override {
+        mutex_lock l(mu_);
+        TF_ASSIGN_OR_RETURN(reader_, dataset()->GetMmapCacheFileReader());
+        if (!reader_) {
+          return absl::NotFoundError(absl::StrCat(
+              "Cache file ", MmapCacheFilename(dataset()->filename_),
+              " not found."));
+        }
+        return absl::OkStatus();
+      }
+
+      absl::Status GetNextInternal(IteratorContext* ctx,
+                                   std::vector<Tensor>* out_tensors,
+                                   bool* end_of_sequence) override {
+        mutex_lock l(mu_);
+        if (cur_index_ >= reader_->size()) {
+          *end_of_sequence = true;
+          return absl::OkStatus();
+        }
+        *end_of_sequence = false;
+        return reader_->Get(cur_index_++, out_tensors);
+      }
+
+     protected:
+      std::shared_ptr<model::Node> CreateNode(
+          IteratorContext* ctx, model::Node::Args args) const override {
+        return model::MakeKnownRatioNode(std::move(args),
+                                         /*ratio=*/1);
+      }
+
+      absl::Status SaveInternal(SerializationContext* ctx,
+                                IteratorStateWriter* writer) override {
+        mutex_lock l(mu_);
+        return writer->WriteScalar(prefix(), kCurIndex, cur_index_);
+      }
+
+      absl::Status RestoreInternal(
+          IteratorContext* ctx,
+          IteratorStateReader* iterator_state_reader) override {
+        mutex_lock l(mu_);
+        return iterator_state_reader->ReadScalar(prefix(), kCurIndex,
+                                                 &cur_index_);
+      }
+
+     private:
+      mutex mu_;
+      int64_t cur_index_ TF_GUARDED_BY(mu_) = 0;
+      std::shared_ptr<MmapCacheFileReader> reader_ TF_GUARDED_BY(mu_);
+    };  // MmapFileReaderIterator
+
     absl::Status InitializeIterator(IteratorContext* ctx)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       // We intentionally use the same prefix for both `FileReaderIterator` and
@@ -692,9 +933,15 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
       // `cur_index`.
       switch (mode_) {
         case Mode::read:
-          iterator_ =
-              std::make_unique<FileReaderIterator>(FileReaderIterator::Params{
-                  dataset(), absl::StrCat(prefix(), kImpl)});
+          if (dataset()->MmapCacheExists()) {
+            iterator_ = std::make_unique<MmapFileReaderIterator>(
+                MmapFileReaderIterator::Params{
+                    dataset(), absl::StrCat(prefix(), kImpl)});
+          } else {
+            iterator_ = std::make_unique<FileReaderIterator>(
+                FileReaderIterator::Params{dataset(),
+                                           absl::StrCat(prefix(), kImpl)});
+          }
           break;
         case Mode::write:
           iterator_ =
@@ -709,6 +956,7 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
     enum Mode { read, write };
     Mode mode_ TF_GUARDED_BY(mu_);
     std::unique_ptr<IteratorBase> iterator_ TF_GUARDED_BY(mu_);
+    GlobalShuffleIterator global_shuffle_iterator_;
   };  // FileIterator
 
   Env* const env_;
@@ -716,6 +964,10 @@ class CacheDatasetOp::FileDatasetBase : public DatasetBase {
   const size_t tensor_index_padding_size_;
   static constexpr size_t kMaxItems = 10000000;  // 10 million
   const size_t item_index_padding_size_;
+  absl::Status random_indexing_compatible_ = absl::OkStatus();
+
+  mutable mutex mu_;
+  mutable std::shared_ptr<MmapCacheFileReader> mmap_reader_ TF_GUARDED_BY(mu_);
 };  // FileDatasetBase
 
 class CacheDatasetOp::FileDataset : public CacheDatasetOp::FileDatasetBase {
@@ -799,6 +1051,22 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
     return name_utils::DatasetDebugString(kDatasetType, params);
   }
 
+  // Returns the bytes held by the cache once it is completed, which for a
+  // compressed cache are the bytes of its arena.
+  int64_t AllocatedBytes() const override {
+    if (!cache_->IsCompleted()) {
+      return 0;
+    }
+    if (cache_->IsCompressed()) {
+      return cache_->compressed_data().AllocatedBytes();
+    }
+    int64_t allocated_bytes = 0;
+    for (const auto& element : cache_->data()) {
+      allocated_bytes += GetAllocatedBytes(element);
+    }
+    return allocated_bytes;
+  }
+
   int64_t CardinalityInternal(CardinalityOptions options) const override {
     return input_->Cardinality(options);
   };
@@ -894,8 +1162,15 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       mutex_lock l(mu_);
       if (cache_->IsCompleted()) {
         TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kCacheCompleted, ""));
-        TF_RETURN_IF_ERROR(
-            WriteElementsToCheckpoint(writer, prefix(), cache_->data()));
+        if (cache_->IsCompressed()) {
+          TF_RETURN_IF_ERROR(
+              writer->WriteScalar(prefix(), kCacheCompressed, ""));
+          TF_RETURN_IF_ERROR(WriteCompressedElementsToCheckpoint(
+              writer, prefix(), cache_->compressed_data()));
+        } else {
+          TF_RETURN_IF_ERROR(
+              WriteElementsToCheckpoint(writer, prefix(), cache_->data()));
+        }
       }
       TF_RETURN_IF_ERROR(global_shuffle_iterator_.Save(prefix(), ctx, writer));
       return SaveInput(ctx, writer, iterator_);
@@ -910,10 +1185,17 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       iterator_.reset();
       cache_->Reset();
       if (reader->Contains(prefix(), kCacheCompleted)) {
-        std::vector<std::vector<Tensor>> temp_cache;
-        TF_RETURN_IF_ERROR(
-            ReadElementsFromCheckpoint(ctx, reader, prefix(), &temp_cache));
-        cache_->Complete(std::move(temp_cache));
+        if (reader->Contains(prefix(), kCacheCompressed)) {
+          CompressedElementArena temp_cache;
+          TF_RETURN_IF_ERROR(ReadCompressedElementsFromCheckpoint(
+              ctx, reader, prefix(), &temp_cache));
+          cache_->Complete(std::move(temp_cache));
+        } else {
+          std::vector<std::vector<Tensor>> temp_cache;
+          TF_RETURN_IF_ERROR(
+              ReadElementsFromCheckpoint(ctx, reader, prefix(), &temp_cache));
+          cache_->Complete(std::move(temp_cache));
+        }
       }
       TF_RETURN_IF_ERROR(InitializeIterator(ctx));
       return RestoreInput(ctx, reader, iterator_);
@@ -923,17 +1205,21 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
     class MemoryWriterIterator : public DatasetIterator<MemoryDatasetBase> {
      public:
       explicit MemoryWriterIterator(const Params& params, MemoryCache* cache)
-          : DatasetIterator<MemoryDatasetBase>(params), cache_(cache) {}
+          : DatasetIterator<MemoryDatasetBase>(params),
+            cache_(cache) {}
 
       ~MemoryWriterIterator() override {
         mutex_lock l(mu_);
-        if (!temp_cache_.empty() && !cache_->IsCompleted()) {
+        if ((!temp_cache_.empty() || compressed_temp_cache_.size() > 0) &&
+            !cache_->IsCompleted()) {
           LOG(WARNING) << kIncompleteCacheErrorMessage;
           cache_->Reset();
         }
       }
 
       absl::Status Initialize(IteratorContext* ctx) override {
+        mutex_lock l(mu_);
+        compress_ = CompressMemoryCache(ctx);
         return dataset()->input_->MakeIterator(ctx, this, prefix(),
                                                &input_impl_);
       }
@@ -947,16 +1233,29 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
         if (*end_of_sequence) {
           if (!cache_->IsCompleted()) {
             VLOG(2) << "Finalizing the cache because EOF has been reached.";
-            cache_->Complete(std::move(temp_cache_));
+            CompleteCache();
           }
           return absl::OkStatus();
         }
-        RecordBufferEnqueue(ctx, *out_tensors);
-        temp_cache_.emplace_back(*out_tensors);
-        if (temp_cache_.size() == dataset()->input_->Cardinality()) {
+        int64_t num_cached;
+        if (compress_) {
+          const int64_t allocated_bytes =
+              compressed_temp_cache_.AllocatedBytes();
+          TF_RETURN_IF_ERROR(compressed_temp_cache_.Add(*out_tensors));
+          if (ctx->model() && node_) {
+            node_->record_buffer_event(
+                compressed_temp_cache_.AllocatedBytes() - allocated_bytes, 1);
+          }
+          num_cached = compressed_temp_cache_.size();
+        } else {
+          RecordBufferEnqueue(ctx, *out_tensors);
+          temp_cache_.emplace_back(*out_tensors);
+          num_cached = temp_cache_.size();
+        }
+        if (num_cached == dataset()->input_->Cardinality()) {
           VLOG(2) << "Finalizing the cache because its size matches the "
                      "expected input cardinality.";
-          cache_->Complete(std::move(temp_cache_));
+          CompleteCache();
         }
         return absl::OkStatus();
       }
@@ -972,8 +1271,15 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
                                 IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
         if (!cache_->IsCompleted()) {
-          TF_RETURN_IF_ERROR(
-              WriteElementsToCheckpoint(writer, prefix(), temp_cache_));
+          if (compress_) {
+            TF_RETURN_IF_ERROR(
+                writer->WriteScalar(prefix(), kCacheCompressed, ""));
+            TF_RETURN_IF_ERROR(WriteCompressedElementsToCheckpoint(
+                writer, prefix(), compressed_temp_cache_));
+          } else {
+            TF_RETURN_IF_ERROR(
+                WriteElementsToCheckpoint(writer, prefix(), temp_cache_));
+          }
         }
         return SaveInput(ctx, writer, input_impl_);
       }
@@ -982,17 +1288,34 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
                                    IteratorStateReader* reader) override {
         mutex_lock l(mu_);
         if (!reader->Contains(prefix(), kCacheCompleted)) {
-          TF_RETURN_IF_ERROR(
-              ReadElementsFromCheckpoint(ctx, reader, prefix(), &temp_cache_));
+          // Continue caching in the form the checkpoint was written in.
+          compress_ = reader->Contains(prefix(), kCacheCompressed);
+          if (compress_) {
+            TF_RETURN_IF_ERROR(ReadCompressedElementsFromCheckpoint(
+                ctx, reader, prefix(), &compressed_temp_cache_));
+          } else {
+            TF_RETURN_IF_ERROR(ReadElementsFromCheckpoint(ctx, reader, prefix(),
+                                                          &temp_cache_));
+          }
         }
         return RestoreInput(ctx, reader, input_impl_);
       }
 
      private:
+      void CompleteCache() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (compress_) {
+          cache_->Complete(std::move(compressed_temp_cache_));
+        } else {
+          cache_->Complete(std::move(temp_cache_));
+        }
+      }
+
       mutex mu_;
       std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
       MemoryCache* const cache_ TF_GUARDED_BY(mu_);  // not owned.
+      bool compress_ TF_GUARDED_BY(mu_) = false;
       std::vector<std::vector<Tensor>> temp_cache_ TF_GUARDED_BY(mu_);
+      CompressedElementArena compressed_temp_cache_ TF_GUARDED_BY(mu_);
     };  // MemoryWriterIterator
 
     class MemoryReaderIterator : public DatasetIterator<MemoryDatasetBase> {
@@ -1000,15 +1323,31 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       explicit MemoryReaderIterator(const Params& params, MemoryCache* cache)
           : DatasetIterator<MemoryDatasetBase>(params),
             cache_(cache),
-            index_(0) {}
+            index_(0),
+            next_to_uncompress_(0) {}
+
+      ~MemoryReaderIterator() override {
+        CancelThreads();
+        if (deregister_fn_) deregister_fn_();
+      }
 
       absl::Status Initialize(IteratorContext* ctx) override {
+        TF_RETURN_IF_ERROR(RegisterCancellationCallback(
+            ctx->cancellation_manager(), [this]() { CancelThreads(); },
+            &deregister_fn_));
         // The memory allocated for the cache is owned by the parent
         // dataset but performance modeling uses the iterator abstraction and
         // thus we record the memory allocated for the cache here. The caveat
         // is that this is incorrect if there are concurrent instances of this
         // iterator.
-        tf_shared_lock l(mu_);
+        mutex_lock l(mu_);
+        if (cache_->IsCompressed()) {
+          if (ctx->model() && node_) {
+            node_->record_buffer_event(
+                cache_->compressed_data().AllocatedBytes(), cache_->size());
+          }
+          return absl::OkStatus();
+        }
         for (size_t i = 0; i < cache_->size(); ++i) {
           RecordBufferEnqueue(ctx, cache_->at(i));
         }
@@ -1019,6 +1358,9 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
                                    std::vector<Tensor>* out_tensors,
                                    bool* end_of_sequence) override {
         mutex_lock l(mu_);
+        if (cache_->IsCompressed()) {
+          return GetNextCompressed(ctx, l, out_tensors, end_of_sequence);
+        }
         if (index_ < cache_->size()) {
           const std::vector<Tensor>& cache_tensors = cache_->at(index_);
           out_tensors->insert(out_tensors->begin(), cache_tensors.begin(),
@@ -1058,13 +1400,122 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
           }
           index_ = static_cast<size_t>(temp);
         }
+        next_to_uncompress_ = index_;
+        uncompressed_.clear();
         return absl::OkStatus();
       }
 
      private:
+      struct UncompressedElement {
+        absl::Status status;
+        std::vector<Tensor> tensors;
+      };
+
+      // Returns the element at `index_` of a compressed cache. With a single
+      // runner thread the element is uncompressed inline. Otherwise
+      // background threads uncompress the elements following `index_`, and
+      // this waits for theirs without occupying the runner.
+      absl::Status GetNextCompressed(IteratorContext* ctx, mutex_lock& l,
+                                     std::vector<Tensor>* out_tensors,
+                                     bool* end_of_sequence)
+          TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        const CompressedElementArena& arena = cache_->compressed_data();
+        if (index_ >= arena.size()) {
+          *end_of_sequence = true;
+          return absl::OkStatus();
+        }
+        if (ctx->runner_threadpool_size() <= 1) {
+          TF_RETURN_IF_ERROR(arena.Get(index_, out_tensors));
+          index_++;
+          *end_of_sequence = false;
+          return absl::OkStatus();
+        }
+        EnsureThreadsStarted(ctx);
+        while (!cancelled_ && !uncompressed_.contains(index_)) {
+          cond_var_.wait(l);
+        }
+        if (cancelled_) {
+          return absl::CancelledError("Iterator was cancelled");
+        }
+        auto it = uncompressed_.find(index_);
+        UncompressedElement element = std::move(it->second);
+        uncompressed_.erase(it);
+        index_++;
+        // A slot of the uncompress window is free again.
+        cond_var_.notify_all();
+        TF_RETURN_IF_ERROR(element.status);
+        *out_tensors = std::move(element.tensors);
+        *end_of_sequence = false;
+        return absl::OkStatus();
+      }
+
+      void EnsureThreadsStarted(IteratorContext* ctx)
+          TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (!uncompress_threads_.empty()) {
+          return;
+        }
+        num_uncompress_threads_ = ctx->runner_threadpool_size();
+        for (int i = 0; i < num_uncompress_threads_; ++i) {
+          uncompress_threads_.push_back(ctx->StartThread(
+              "tf_data_cache_uncompress", [this]() { UncompressThread(); }));
+        }
+      }
+
+      void CancelThreads() TF_LOCKS_EXCLUDED(mu_) {
+        mutex_lock l(mu_);
+        cancelled_ = true;
+        cond_var_.notify_all();
+      }
+
+      // Uncompresses elements ahead of `index_` into `uncompressed_`, keeping
+      // at most two per thread ahead of the consumer.
+      void UncompressThread() TF_LOCKS_EXCLUDED(mu_) {
+        while (true) {
+          size_t index;
+          const CompressedElementArena* arena;
+          {
+            mutex_lock l(mu_);
+            arena = &cache_->compressed_data();
+            while (!cancelled_ &&
+                   (next_to_uncompress_ >= arena->size() ||
+                    next_to_uncompress_ >=
+                        index_ + 2 * num_uncompress_threads_)) {
+              cond_var_.wait(l);
+            }
+            if (cancelled_) {
+              return;
+            }
+            // After a restore, resume from the restored position.
+            next_to_uncompress_ = std::max(next_to_uncompress_, index_);
+            index = next_to_uncompress_++;
+          }
+          UncompressedElement element;
+          element.status = arena->Get(index, &element.tensors);
+          mutex_lock l(mu_);
+          // Elements before `index_` were consumed or skipped by a restore.
+          if (index >= index_) {
+            uncompressed_.emplace(index, std::move(element));
+            cond_var_.notify_all();
+          }
+        }
+      }
+
       mutex mu_;
+      condition_variable cond_var_;
       MemoryCache* const cache_ TF_GUARDED_BY(mu_);  // not owned.
       size_t index_ TF_GUARDED_BY(mu_);
+      // The next element for the background threads to uncompress.
+      size_t next_to_uncompress_ TF_GUARDED_BY(mu_);
+      int num_uncompress_threads_ TF_GUARDED_BY(mu_) = 0;
+      bool cancelled_ TF_GUARDED_BY(mu_) = false;
+      // Elements at or after `index_` that have already been uncompressed.
+      absl::flat_hash_map<size_t, UncompressedElement> uncompressed_
+          TF_GUARDED_BY(mu_);
+      std::function<void()> deregister_fn_;
+      // Declared last, so that the threads are joined before the state they
+      // use is destroyed.
+      std::vector<std::unique_ptr<Thread>> uncompress_threads_
+          TF_GUARDED_BY(mu_);
     };  // MemoryReaderIterator
 
     absl::Status InitializeIterator(IteratorContext* ctx)
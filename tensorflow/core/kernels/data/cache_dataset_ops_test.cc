@@ -11,6 +11,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/cache_dataset_ops.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -18,8 +20,12 @@ limitations under the License.
 
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/data/mmap_cache_file.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/framework/dataset_options.pb.h"
+#include "tensorflow/core/kernels/data/cache_ops.h"
 #include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/util/tensor_bundle/naming.h"
 
 namespace tensorflow {
 namespace data {
@@ -385,6 +391,268 @@ TEST_F(CacheDatasetOpTest, NegativeIndexTest) {
   EXPECT_EQ(status.message(), "Index out of range [0, 3):-1");
 }
 
+// Reads `iterator` to the end.
+absl::Status ReadToEnd(IteratorBase* iterator, IteratorContext* ctx,
+                       std::vector<Tensor>* out_tensors) {
+  bool end_of_sequence = false;
+  while (!end_of_sequence) {
+    std::vector<Tensor> next;
+    TF_RETURN_IF_ERROR(iterator->GetNext(ctx, &next, &end_of_sequence));
+    out_tensors->insert(out_tensors->end(), next.begin(), next.end());
+  }
+  return absl::OkStatus();
+}
+
+TEST_F(CacheDatasetOpTest, CompressedMemoryCache) {
+  // Zeros compress well, so the compressed cache is much smaller than the
+  // elements it holds.
+  constexpr int64_t kElementSize = 1 << 16;
+  auto dataset_params = CacheDatasetParams(
+      TensorSliceDatasetParams(
+          /*components=*/{CreateTensor<int64_t>(
+              TensorShape{3, kElementSize},
+              std::vector<int64_t>(3 * kElementSize, 0))},
+          /*node_name=*/"tensor_slice"),
+      /*filename=*/"",
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({kElementSize})}, kNodeName);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  std::vector<Tensor> expected_outputs(
+      3, CreateTensor<int64_t>(TensorShape({kElementSize}),
+                               std::vector<int64_t>(kElementSize, 0)));
+  Options options;
+  options.set_compress_memory_cache(true);
+  IteratorContext::Params params(iterator_ctx_.get());
+  params.options = &options;
+  IteratorContext ctx(std::move(params));
+
+  // Write mode.
+  TF_ASSERT_OK(dataset_->MakeIterator(&ctx, /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator_));
+  std::vector<Tensor> out_tensors;
+  TF_ASSERT_OK(ReadToEnd(iterator_.get(), &ctx, &out_tensors));
+  TF_EXPECT_OK(ExpectEqual(out_tensors, expected_outputs,
+                           /*compare_order=*/true));
+  EXPECT_GT(dataset_->AllocatedBytes(), 0);
+  EXPECT_LT(dataset_->AllocatedBytes(), GetAllocatedBytes(out_tensors) / 4);
+
+  // Read mode, checkpointed after the first element.
+  TF_ASSERT_OK(dataset_->MakeIterator(&ctx, /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator_));
+  out_tensors.clear();
+  bool end_of_sequence = false;
+  TF_ASSERT_OK(iterator_->GetNext(&ctx, &out_tensors, &end_of_sequence));
+  std::unique_ptr<SerializationContext> serialization_ctx;
+  TF_ASSERT_OK(CreateSerializationContext(&serialization_ctx));
+  VariantTensorDataWriter writer;
+  TF_ASSERT_OK(iterator_->Save(serialization_ctx.get(), &writer));
+  std::vector<const VariantTensorData*> data;
+  writer.GetData(&data);
+  VariantTensorDataReader reader(data);
+  TF_ASSERT_OK(RestoreIterator(&ctx, &reader, dataset_params.iterator_prefix(),
+                               *dataset_, &iterator_));
+  TF_ASSERT_OK(ReadToEnd(iterator_.get(), &ctx, &out_tensors));
+  TF_EXPECT_OK(ExpectEqual(out_tensors, expected_outputs,
+                           /*compare_order=*/true));
+}
+
+TEST_F(CacheDatasetOpTest, CompressedMemoryCacheSingleRunnerThread) {
+  auto dataset_params = CacheDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  Options options;
+  options.set_compress_memory_cache(true);
+  IteratorContext::Params params(iterator_ctx_.get());
+  params.options = &options;
+  // With a single runner thread, elements are uncompressed inline.
+  params.runner_threadpool_size = 1;
+  IteratorContext ctx(std::move(params));
+
+  std::vector<Tensor> expected_outputs;
+  for (int mode = 0; mode < 2; ++mode) {
+    // Write mode, then read mode.
+    TF_ASSERT_OK(dataset_->MakeIterator(&ctx, /*parent=*/nullptr,
+                                        dataset_params.iterator_prefix(),
+                                        &iterator_));
+    std::vector<Tensor> out_tensors;
+    TF_ASSERT_OK(ReadToEnd(iterator_.get(), &ctx, &out_tensors));
+    if (mode == 0) {
+      expected_outputs = out_tensors;
+    } else {
+      TF_EXPECT_OK(ExpectEqual(out_tensors, expected_outputs,
+                               /*compare_order=*/true));
+    }
+  }
+}
+
+TEST_F(CacheDatasetOpTest, UncompressedMemoryCacheByDefault) {
+  auto dataset_params = CacheDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  std::vector<Tensor> out_tensors;
+  TF_ASSERT_OK(ReadToEnd(iterator_.get(), iterator_ctx_.get(), &out_tensors));
+  EXPECT_EQ(dataset_->AllocatedBytes(), GetAllocatedBytes(out_tensors));
+}
+
+TEST_F(CacheDatasetOpTest, MmapFileCache) {
+  auto dataset_params = CacheDatasetParams1();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(dataset_->RandomIndexingCompatible());
+  std::vector<Tensor> expected_outputs = CreateTensors<int64_t>(
+      TensorShape({3, 1}), {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}});
+  Options options;
+  options.set_mmap_file_cache(true);
+  IteratorContext::Params params(iterator_ctx_.get());
+  params.options = &options;
+  IteratorContext ctx(std::move(params));
+
+  // Write mode.
+  TF_ASSERT_OK(dataset_->MakeIterator(&ctx, /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator_));
+  std::vector<Tensor> out_tensors;
+  TF_ASSERT_OK(ReadToEnd(iterator_.get(), &ctx, &out_tensors));
+  TF_EXPECT_OK(ExpectEqual(out_tensors, expected_outputs,
+                           /*compare_order=*/true));
+  TF_EXPECT_OK(device_->env()->FileExists(
+      MmapCacheFilename(dataset_params.filename())));
+  EXPECT_FALSE(
+      device_->env()->FileExists(MetaFilename(dataset_params.filename())).ok());
+
+  // Random access reads from the cache file.
+  for (int64_t index : {2, 0, 1}) {
+    out_tensors.clear();
+    TF_ASSERT_OK(
+        dataset_->Get(AnyContext(iterator_ctx_.get()), index, &out_tensors));
+    TF_EXPECT_OK(ExpectEqual(out_tensors, {expected_outputs[index]},
+                             /*compare_order=*/true));
+  }
+  EXPECT_EQ(dataset_->Get(AnyContext(iterator_ctx_.get()), 3, &out_tensors)
+                .code(),
+            absl::StatusCode::kOutOfRange);
+
+  // Read mode detects the format from the cache file, whatever the options.
+  TF_ASSERT_OK(dataset_->MakeIterator(iterator_ctx_.get(), /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator_));
+  out_tensors.clear();
+  TF_ASSERT_OK(ReadToEnd(iterator_.get(), iterator_ctx_.get(), &out_tensors));
+  TF_EXPECT_OK(ExpectEqual(out_tensors, expected_outputs,
+                           /*compare_order=*/true));
+}
+
+TEST_F(CacheDatasetOpTest, BundleFileCacheRejectsRandomAccess) {
+  auto dataset_params = CacheDatasetParams1();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  std::vector<Tensor> out_tensors;
+  TF_ASSERT_OK(ReadToEnd(iterator_.get(), iterator_ctx_.get(), &out_tensors));
+  TF_EXPECT_OK(
+      device_->env()->FileExists(MetaFilename(dataset_params.filename())));
+  EXPECT_FALSE(device_->env()
+                   ->FileExists(MmapCacheFilename(dataset_params.filename()))
+                   .ok());
+  EXPECT_EQ(dataset_->Get(AnyContext(iterator_ctx_.get()), 0, &out_tensors)
+                .code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+TEST_F(CacheDatasetOpTest, MmapFileCacheGlobalShuffle) {
+  auto dataset_params = CacheDatasetParams1();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  std::vector<Tensor> expected_outputs = CreateTensors<int64_t>(
+      TensorShape({3, 1}), {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}});
+  // Reverses the order of the elements.
+  IteratorContext::Params params(iterator_ctx_.get());
+  params.index_mapper = [](size_t index) -> absl::StatusOr<size_t> {
+    if (index >= 3) {
+      return absl::OutOfRangeError("End of dataset");
+    }
+    return 2 - index;
+  };
+  IteratorContext global_shuffle_ctx(std::move(params));
+
+  // Global shuffling does not write the cache, so it fails until the cache
+  // has been written.
+  std::vector<Tensor> out_tensors;
+  EXPECT_EQ(dataset_->Get(AnyContext(iterator_ctx_.get()), 0, &out_tensors)
+                .code(),
+            absl::StatusCode::kFailedPrecondition);
+  TF_ASSERT_OK(dataset_->MakeIterator(&global_shuffle_ctx, /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator_));
+  bool end_of_sequence = false;
+  EXPECT_EQ(iterator_
+                ->GetNext(&global_shuffle_ctx, &out_tensors, &end_of_sequence)
+                .code(),
+            absl::StatusCode::kFailedPrecondition);
+  EXPECT_FALSE(device_->env()
+                   ->FileExists(MmapCacheFilename(dataset_params.filename()))
+                   .ok());
+
+  // Write the cache.
+  Options options;
+  options.set_mmap_file_cache(true);
+  IteratorContext::Params write_params(iterator_ctx_.get());
+  write_params.options = &options;
+  IteratorContext write_ctx(std::move(write_params));
+  TF_ASSERT_OK(dataset_->MakeIterator(&write_ctx, /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator_));
+  out_tensors.clear();
+  TF_ASSERT_OK(ReadToEnd(iterator_.get(), &write_ctx, &out_tensors));
+
+  // Global shuffling reads from the cache.
+  TF_ASSERT_OK(dataset_->MakeIterator(&global_shuffle_ctx, /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator_));
+  out_tensors.clear();
+  TF_ASSERT_OK(
+      ReadToEnd(iterator_.get(), &global_shuffle_ctx, &out_tensors));
+  std::reverse(expected_outputs.begin(), expected_outputs.end());
+  TF_EXPECT_OK(ExpectEqual(out_tensors, expected_outputs,
+                           /*compare_order=*/true));
+}
+
+TEST(CompressedElementArenaTest, AddAndGet) {
+  CompressedElementArena arena;
+  std::vector<std::vector<Tensor>> elements = {
+      {CreateTensor<int64_t>(TensorShape({2}), {1, 2}),
+       CreateTensor<tstring>(TensorShape({}), {"a"})},
+      {CreateTensor<int64_t>(TensorShape({1}), {3}),
+       CreateTensor<tstring>(TensorShape({}), {"b"})},
+      // Larger than a chunk of the arena.
+      {CreateTensor<int64_t>(TensorShape({4 << 20})),
+       CreateTensor<tstring>(TensorShape({}), {"c"})}};
+  elements[2][0].flat<int64_t>().setRandom();
+  // Small elements share a small first chunk.
+  TF_ASSERT_OK(arena.Add(elements[0]));
+  TF_ASSERT_OK(arena.Add(elements[1]));
+  EXPECT_EQ(arena.AllocatedBytes(), 64 << 10);
+  // The large element gets a chunk of its own.
+  TF_ASSERT_OK(arena.Add(elements[2]));
+  ASSERT_EQ(arena.size(), elements.size());
+  EXPECT_GT(arena.AllocatedBytes(), (64 << 10) + (32 << 20));
+
+  CompressedElementArena copy;
+  for (int64_t i = 0; i < arena.size(); ++i) {
+    copy.AddCompressed(arena.GetCompressed(i));
+  }
+  for (int64_t i = 0; i < arena.size(); ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(arena.Get(i, &element));
+    TF_EXPECT_OK(DatasetOpsTestBase::ExpectEqual(
+        element, elements[i], /*compare_order=*/true));
+    element.clear();
+    TF_ASSERT_OK(copy.Get(i, &element));
+    TF_EXPECT_OK(DatasetOpsTestBase::ExpectEqual(
+        element, elements[i], /*compare_order=*/true));
+  }
+
+  arena.Clear();
+  EXPECT_EQ(arena.size(), 0);
+  EXPECT_EQ(arena.AllocatedBytes(), 0);
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
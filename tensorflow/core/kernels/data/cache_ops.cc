@@ -14,8 +14,10 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/cache_ops.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -23,23 +25,84 @@ limitations under the License.
 
 #include "absl/log/check.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/compression_utils.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/dataset.pb.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
+#include "tensorflow/core/platform/errors.h"
 
 namespace tensorflow {
 namespace data {
 namespace {
 
 constexpr char kMemoryCache[] = "MemoryCache";
+// Chunks start small so that caching a handful of elements stays cheap, and
+// double in size up to `kMaxArenaChunkBytes`.
+constexpr int64_t kMinArenaChunkBytes = 64 << 10;  // 64KB
+constexpr int64_t kMaxArenaChunkBytes = 16 << 20;  // 16MB
 
 }  // namespace
 
+absl::Status CompressedElementArena::Add(const std::vector<Tensor>& element) {
+  CompressedElement compressed;
+  TF_RETURN_IF_ERROR(CompressElement(element, &compressed));
+  AddCompressed(compressed.SerializeAsString());
+  return absl::OkStatus();
+}
+
+void CompressedElementArena::AddCompressed(absl::string_view compressed) {
+  const int64_t size = compressed.size();
+  if (chunks_.empty() || chunk_used_ + size > chunk_capacity_) {
+    // Elements larger than a chunk get a chunk of their own.
+    const int64_t next_capacity =
+        chunks_.empty()
+            ? kMinArenaChunkBytes
+            : std::min(2 * chunk_capacity_, kMaxArenaChunkBytes);
+    chunk_capacity_ = std::max(next_capacity, size);
+    chunks_.push_back(std::make_unique<char[]>(chunk_capacity_));
+    chunk_used_ = 0;
+    allocated_bytes_ += chunk_capacity_;
+  }
+  std::memcpy(chunks_.back().get() + chunk_used_, compressed.data(), size);
+  locations_.push_back(Location{static_cast<int64_t>(chunks_.size()) - 1,
+                                chunk_used_, size});
+  chunk_used_ += size;
+}
+
+absl::Status CompressedElementArena::Get(int64_t index,
+                                         std::vector<Tensor>* element) const {
+  absl::string_view serialized = GetCompressed(index);
+  CompressedElement compressed;
+  if (!compressed.ParseFromArray(serialized.data(), serialized.size())) {
+    return absl::DataLossError(
+        absl::StrCat("Failed to parse cached element ", index));
+  }
+  return UncompressElement(compressed, element);
+}
+
+absl::string_view CompressedElementArena::GetCompressed(int64_t index) const {
+  DCHECK_LT(index, size());
+  const Location& location = locations_[index];
+  return absl::string_view(chunks_[location.chunk].get() + location.offset,
+                           location.size);
+}
+
+void CompressedElementArena::Clear() {
+  chunks_.clear();
+  chunk_used_ = 0;
+  chunk_capacity_ = 0;
+  locations_.clear();
+  allocated_bytes_ = 0;
+}
+
 std::string MemoryCacheManager::DebugString() const { return kMemoryCache; }
 
 void MemoryCache::Complete(std::vector<std::vector<Tensor>>&& cache) {
@@ -50,26 +113,43 @@ void MemoryCache::Complete(std::vector<std::vector<Tensor>>&& cache) {
   }
 }
 
+void MemoryCache::Complete(CompressedElementArena&& cache) {
+  mutex_lock l(mu_);
+  if (!completed_) {
+    compressed_cache_ = std::move(cache);
+    compressed_ = true;
+    completed_ = true;
+  }
+}
+
 bool MemoryCache::IsCompleted() {
   tf_shared_lock l(mu_);
   return completed_;
 }
 
+bool MemoryCache::IsCompressed() {
+  tf_shared_lock l(mu_);
+  return compressed_;
+}
+
 void MemoryCache::Reset() {
   mutex_lock l(mu_);
   completed_ = false;
+  compressed_ = false;
   cache_.clear();
+  compressed_cache_.Clear();
 }
 
 const std::vector<Tensor>& MemoryCache::at(int64_t index) {
   tf_shared_lock l(mu_);
+  DCHECK(!compressed_);
   DCHECK(index < cache_.size());
   return cache_[index];
 }
 
 size_t MemoryCache::size() {
   tf_shared_lock l(mu_);
-  return cache_.size();
+  return compressed_ ? compressed_cache_.size() : cache_.size();
 }
 
 const std::vector<std::vector<Tensor>>& MemoryCache::data() {
@@ -77,6 +157,11 @@ const std::vector<std::vector<Tensor>>& MemoryCache::data() {
   return cache_;
 }
 
+const CompressedElementArena& MemoryCache::compressed_data() {
+  tf_shared_lock l(mu_);
+  return compressed_cache_;
+}
+
 AnonymousMemoryCacheHandleOp::AnonymousMemoryCacheHandleOp(
     OpKernelConstruction* ctx)
     : AnonymousResourceOp<MemoryCacheManager>(ctx,
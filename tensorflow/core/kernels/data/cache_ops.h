@@ -16,18 +16,74 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_DATA_CACHE_OPS_H_
 #define TENSORFLOW_CORE_KERNELS_DATA_CACHE_OPS_H_
 
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/tensor.h"
 
 namespace tensorflow {
 namespace data {
 
+// An append-only sequence of compressed dataset elements.
+//
+// Elements are stored back to back in large chunks, so that caching many
+// small elements does not pay for one allocation (and its bookkeeping) per
+// tensor. Not thread-safe for concurrent `Add`s, but `Get`s may run
+// concurrently with each other.
+class CompressedElementArena {
+ public:
+  CompressedElementArena() = default;
+  CompressedElementArena(CompressedElementArena&&) = default;
+  CompressedElementArena& operator=(CompressedElementArena&&) = default;
+
+  // Compresses `element` and appends it.
+  absl::Status Add(const std::vector<Tensor>& element);
+
+  // Appends a serialized `CompressedElement`, as returned by `GetCompressed`.
+  void AddCompressed(absl::string_view compressed);
+
+  // Uncompresses the element at `index`.
+  absl::Status Get(int64_t index, std::vector<Tensor>* element) const;
+
+  // Returns the serialized `CompressedElement` at `index`. The returned view
+  // is valid until the arena is destroyed.
+  absl::string_view GetCompressed(int64_t index) const;
+
+  int64_t size() const { return locations_.size(); }
+
+  // Bytes of memory allocated for the compressed elements.
+  int64_t AllocatedBytes() const { return allocated_bytes_; }
+
+  void Clear();
+
+ private:
+  struct Location {
+    int64_t chunk;
+    int64_t offset;
+    int64_t size;
+  };
+
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  // Bytes used in the last chunk, and its capacity.
+  int64_t chunk_used_ = 0;
+  int64_t chunk_capacity_ = 0;
+  std::vector<Location> locations_;
+  int64_t allocated_bytes_ = 0;
+};
+
 // A thread-safe data structure for caching dataset elements.
 //
 // The expected use is that a single `MemoryWriterIterator` populates the
 // cache with dataset elements. Once all elements are cached, the cache can
 // be used by one or more `MemoryReaderIterator`s.
+//
+// The elements are held either as tensors or, if the cache was completed
+// with a `CompressedElementArena`, compressed.
 class MemoryCache {
  public:
   MemoryCache() = default;
@@ -35,13 +91,20 @@ class MemoryCache {
   // Marks the cache as completed.
   void Complete(std::vector<std::vector<Tensor>>&& cache);
 
+  // Marks the cache as completed with compressed elements.
+  void Complete(CompressedElementArena&& cache);
+
+  // Returns whether the cache holds compressed elements.
+  bool IsCompressed();
+
   // Returns whether the cache is completed.
   bool IsCompleted();
 
   // Resets the cache.
   void Reset();
 
-  // Returns the element at the given index.
+  // Returns the element at the given index. Must not be called if the cache
+  // is compressed.
   const std::vector<Tensor>& at(int64_t index);
 
   // Returns the size of the cache.
@@ -51,11 +114,17 @@ class MemoryCache {
   // invalidated by any call to Reset().
   const std::vector<std::vector<Tensor>>& data();
 
+  // Returns a reference to the cache's compressed data. The returned reference
+  // will be invalidated by any call to Reset().
+  const CompressedElementArena& compressed_data();
+
  private:
   mutex mu_;
   // Determines whether all elements of the dataset have been cached.
   bool completed_ TF_GUARDED_BY(mu_) = false;
+  bool compressed_ TF_GUARDED_BY(mu_) = false;
   std::vector<std::vector<Tensor>> cache_ TF_GUARDED_BY(mu_);
+  CompressedElementArena compressed_cache_ TF_GUARDED_BY(mu_);
 };
 
 // A resource wrapping a shared instance of a memory cache.
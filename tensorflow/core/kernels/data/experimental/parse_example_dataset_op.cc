@@ -12,6 +12,7 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
@@ -41,6 +42,7 @@ namespace data {
 namespace experimental {
 namespace {
 
+constexpr char kBatchAndParseExampleDataset[] = "BatchAndParseExampleDataset";
 constexpr char kInvocationResults[] = "invocation_results";
 constexpr char kSizeSuffix[] = ".size";
 constexpr char kEndOfInputSuffix[] = ".end_of_input";
@@ -53,11 +55,13 @@ constexpr int kStatsReportingPeriodMillis = 1000;
 class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
  public:
   static constexpr const char* const kDatasetType = "ParseExample";
+  static constexpr const char* const kFusedDatasetType = "BatchAndParseExample";
 
   explicit ParseExampleDatasetOp(OpKernelConstruction* ctx)
       : UnaryDatasetOpKernel(ctx),
         graph_def_version_(ctx->graph_def_version()),
-        op_version_(ctx->HasAttr("deterministic") ? 2 : 1) {
+        op_version_(ctx->HasAttr("deterministic") ? 2 : 1),
+        fused_batch_(ctx->def().op() == kBatchAndParseExampleDataset) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("sparse_keys", &sparse_keys_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("dense_keys", &dense_keys_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("sparse_types", &sparse_types_));
@@ -126,6 +130,19 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
  protected:
   void MakeDataset(OpKernelContext* ctx, DatasetBase* input,
                    DatasetBase** output) override {
+    // A batch size of zero means that the input elements are already batched.
+    int64_t batch_size = 0;
+    bool drop_remainder = false;
+    if (fused_batch_) {
+      OP_REQUIRES_OK(ctx,
+                     ParseScalarArgument(ctx, "batch_size", &batch_size));
+      OP_REQUIRES(ctx, batch_size > 0,
+                  absl::InvalidArgumentError(
+                      "batch_size must be greater than zero."));
+      OP_REQUIRES_OK(ctx, ParseScalarArgument(ctx, "drop_remainder",
+                                              &drop_remainder));
+    }
+
     int64_t num_parallel_calls = 0;
     OP_REQUIRES_OK(ctx, ParseScalarArgument(ctx, "num_parallel_calls",
                                             &num_parallel_calls));
@@ -212,7 +229,8 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
         std::move(key_to_output_index), std::move(config), num_parallel_calls,
         sparse_types_, dense_types_, dense_shapes_, output_types_,
         output_shapes_, deterministic_, has_ragged_keys_, ragged_keys_,
-        ragged_value_types_, ragged_split_types_, op_version_);
+        ragged_value_types_, ragged_split_types_, op_version_, batch_size,
+        drop_remainder);
   }
 
  private:
@@ -232,7 +250,8 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
             const DeterminismPolicy& deterministic, bool has_ragged_keys,
             std::vector<std::string> ragged_keys,
             const DataTypeVector& ragged_value_types,
-            const DataTypeVector& ragged_split_types, int op_version)
+            const DataTypeVector& ragged_split_types, int op_version,
+            int64_t batch_size, bool drop_remainder)
         : DatasetBase(DatasetContext(ctx)),
           input_(input),
           dense_defaults_(std::move(dense_defaults)),
@@ -251,18 +270,24 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
           output_shapes_(output_shapes),
           deterministic_(deterministic),
           has_ragged_keys_(has_ragged_keys),
-          op_version_(op_version) {
+          op_version_(op_version),
+          batch_size_(batch_size),
+          drop_remainder_(drop_remainder) {
       input_->Ref();
     }
 
     ~Dataset() override { input_->Unref(); }
 
+    const char* type_string() const {
+      return batch_size_ > 0 ? kFusedDatasetType : kDatasetType;
+    }
+
     std::unique_ptr<IteratorBase> MakeIteratorInternal(
         const std::string& prefix) const override {
       name_utils::IteratorPrefixParams params;
       params.op_version = op_version_;
       return std::make_unique<Iterator>(Iterator::Params{
-          this, name_utils::IteratorPrefix(kDatasetType, prefix, params)});
+          this, name_utils::IteratorPrefix(type_string(), prefix, params)});
     }
 
     const DataTypeVector& output_dtypes() const override {
@@ -276,11 +301,20 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
     std::string DebugString() const override {
       name_utils::DatasetDebugStringParams params;
       params.op_version = op_version_;
-      return name_utils::DatasetDebugString(kDatasetType, params);
+      if (batch_size_ > 0) {
+        params.set_args(batch_size_);
+      }
+      return name_utils::DatasetDebugString(type_string(), params);
     }
 
     int64_t CardinalityInternal(CardinalityOptions options) const override {
-      return input_->Cardinality(options);
+      int64_t n = input_->Cardinality(options);
+      if (batch_size_ == 0 || n == kInfiniteCardinality ||
+          n == kUnknownCardinality) {
+        return n;
+      }
+      return n / batch_size_ +
+             (n % batch_size_ == 0 || drop_remainder_ ? 0 : 1);
     }
 
     absl::Status InputDatasets(
@@ -300,12 +334,23 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
       Node* input_graph_node = nullptr;
       TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_graph_node));
 
+      std::vector<std::pair<size_t, Node*>> inputs = {{0, input_graph_node}};
+      if (batch_size_ > 0) {
+        Node* batch_size_node;
+        TF_RETURN_IF_ERROR(b->AddScalar(batch_size_, &batch_size_node));
+        inputs.emplace_back(1, batch_size_node);
+        Node* drop_remainder_node;
+        TF_RETURN_IF_ERROR(b->AddScalar(drop_remainder_, &drop_remainder_node));
+        inputs.emplace_back(2, drop_remainder_node);
+      }
+
       Node* num_parallel_calls_node;
       std::vector<Node*> dense_defaults_nodes;
       dense_defaults_nodes.reserve(dense_defaults_.size());
 
       TF_RETURN_IF_ERROR(
           b->AddScalar(num_parallel_calls_, &num_parallel_calls_node));
+      inputs.emplace_back(inputs.size(), num_parallel_calls_node);
 
       for (const Tensor& dense_default : dense_defaults_) {
         Node* node;
@@ -360,13 +405,9 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
         attrs.emplace_back("ragged_split_types", ragged_split_types_attr);
       }
 
-      TF_RETURN_IF_ERROR(b->AddDataset(this,
-                                       {
-                                           {0, input_graph_node},
-                                           {1, num_parallel_calls_node},
-                                       },
-                                       {{2, dense_defaults_nodes}}, attrs,
-                                       output));
+      TF_RETURN_IF_ERROR(b->AddDataset(this, inputs,
+                                       {{inputs.size(), dense_defaults_nodes}},
+                                       attrs, output));
       return absl::OkStatus();
     }
 
@@ -432,7 +473,7 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
           IteratorContext* ctx, model::Node::Args args) const override {
         return model::MakeAsyncKnownRatioNode(
             std::move(args),
-            /*ratio=*/1,
+            /*ratio=*/std::max<int64_t>(dataset()->batch_size_, 1),
             {model::MakeParameter("parallelism", num_parallel_calls_, /*min=*/1,
                                   /*max=*/ctx->runner_threadpool_size())});
       }
@@ -595,10 +636,17 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
           return tsl::profiler::TraceMeEncode("ParseExampleProduce",
                                               {{"element_id", result->id}});
         });
-        // Get the next input element.
+        // Get the next input element, or the next batch of serialized
+        // examples when batching is fused into this dataset.
         std::vector<Tensor> input_element;
-        result->status = input_impl_->GetNext(ctx.get(), &input_element,
-                                              &result->end_of_input);
+        std::vector<tstring> serialized;
+        if (dataset()->batch_size_ > 0) {
+          result->status =
+              GetNextBatch(ctx.get(), &serialized, &result->end_of_input);
+        } else {
+          result->status = input_impl_->GetNext(ctx.get(), &input_element,
+                                                &result->end_of_input);
+        }
         if (result->end_of_input || !result->status.ok()) {
           CallCompleted(ctx, result);
           return;
@@ -612,11 +660,16 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
         // We schedule the `ParseExample` function using `ctx->runner()` to
         // enable applying it concurrently over different input elements.
         auto fn = std::bind(
-            [this, ctx, result](std::vector<Tensor> input_element) {
+            [this, ctx, result](std::vector<Tensor> input_element,
+                                const std::vector<tstring>& serialized) {
+              if (dataset()->batch_size_ > 0) {
+                return ParseSerialized(ctx.get(), serialized,
+                                       &result->return_values);
+              }
               return ParseExample(ctx.get(), std::move(input_element),
                                   &result->return_values);
             },
-            std::move(input_element));
+            std::move(input_element), std::move(serialized));
         auto node = model_node();
         const bool collect_usage = node && ctx->model();
         // `ctx->runner()` may execute its logic synchronous so we wrap it in
@@ -656,10 +709,60 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
         return absl::OkStatus();
       }
 
+      // Pulls up to `batch_size_` scalar examples from the input. The strings
+      // are moved out of input tensors that nothing else references, so an
+      // example is not copied between being read and being parsed.
+      absl::Status GetNextBatch(IteratorContext* ctx,
+                                std::vector<tstring>* serialized,
+                                bool* end_of_input) {
+        const int64_t batch_size = dataset()->batch_size_;
+        serialized->reserve(batch_size);
+        std::vector<Tensor> element;
+        bool end_of_sequence = false;
+        while (serialized->size() < static_cast<size_t>(batch_size) &&
+               !end_of_sequence) {
+          element.clear();
+          TF_RETURN_IF_ERROR(
+              input_impl_->GetNext(ctx, &element, &end_of_sequence));
+          if (end_of_sequence) {
+            break;
+          }
+          if (element.size() != 1) {
+            return absl::InvalidArgumentError(absl::StrCat(
+                "Expected the input of ", kBatchAndParseExampleDataset,
+                " to have a single component, but got ", element.size(), "."));
+          }
+          if (element[0].dtype() != DT_STRING || element[0].dims() != 0) {
+            return absl::InvalidArgumentError(absl::StrCat(
+                "Expected the input of ", kBatchAndParseExampleDataset,
+                " to consist of scalar strings, but got a ",
+                DataTypeString(element[0].dtype()), " tensor of shape ",
+                element[0].shape().DebugString(), "."));
+          }
+          Tensor& t = element[0];
+          if (t.RefCountIsOne()) {
+            serialized->push_back(std::move(t.scalar<tstring>()()));
+          } else {
+            serialized->push_back(t.scalar<tstring>()());
+          }
+        }
+        *end_of_input =
+            serialized->empty() ||
+            (dataset()->drop_remainder_ &&
+             serialized->size() < static_cast<size_t>(batch_size));
+        return absl::OkStatus();
+      }
+
       absl::Status ParseExample(IteratorContext* ctx, std::vector<Tensor> input,
                                 std::vector<Tensor>* output) {
-        thread::ThreadPool* device_threadpool =
-            ctx->flr()->device()->tensorflow_cpu_worker_threads()->workers;
+        if (input.size() == 1) {
+          auto serialized_t = input[0].flat<tstring>();
+          return ParseSerialized(
+              ctx,
+              absl::Span<const tstring>(serialized_t.data(),
+                                        serialized_t.size()),
+              output);
+        }
         std::vector<tstring> slice_vec;
         for (const Tensor& t : input) {
           auto serialized_t = t.flat<tstring>();
@@ -668,6 +771,14 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
           for (auto it = slice.begin(); it != slice.end(); it++)
             slice_vec.push_back(*it);
         }
+        return ParseSerialized(ctx, slice_vec, output);
+      }
+
+      absl::Status ParseSerialized(IteratorContext* ctx,
+                                   absl::Span<const tstring> serialized,
+                                   std::vector<Tensor>* output) {
+        thread::ThreadPool* device_threadpool =
+            ctx->flr()->device()->tensorflow_cpu_worker_threads()->workers;
         example::FastParseExampleConfig config = dataset()->config_;
         // local copy of config_ for modification.
         auto stats_aggregator = ctx->stats_aggregator();
@@ -676,7 +787,7 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
         }
         example::Result example_result;
         TF_RETURN_IF_ERROR(FastParseExample(
-            config, slice_vec, {}, device_threadpool, &example_result));
+            config, serialized, {}, device_threadpool, &example_result));
         (*output).resize(dataset()->key_to_output_index_.size());
         for (int d = 0; d < dataset()->dense_keys_.size(); ++d) {
           int output_index =
@@ -944,6 +1055,10 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
     const DeterminismPolicy deterministic_;
     const bool has_ragged_keys_;
     const int op_version_;
+    // Number of input examples per output element, or zero if the input
+    // elements are already batched.
+    const int64_t batch_size_;
+    const bool drop_remainder_;
   };
 
   const int graph_def_version_;
@@ -962,6 +1077,7 @@ class ParseExampleDatasetOp : public UnaryDatasetOpKernel {
   std::vector<std::size_t> elements_per_stride_;
   bool has_ragged_keys_;
   const int op_version_;
+  const bool fused_batch_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("ParseExampleDataset").Device(DEVICE_CPU),
@@ -971,6 +1087,8 @@ REGISTER_KERNEL_BUILDER(Name("ParseExampleDatasetV2").Device(DEVICE_CPU),
 REGISTER_KERNEL_BUILDER(
     Name("ExperimentalParseExampleDataset").Device(DEVICE_CPU),
     ParseExampleDatasetOp);
+REGISTER_KERNEL_BUILDER(Name(kBatchAndParseExampleDataset).Device(DEVICE_CPU),
+                        ParseExampleDatasetOp);
 
 }  // namespace
 }  // namespace experimental
@@ -0,0 +1,422 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/dataset_test_base.h"
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/example/example.pb.h"
+#include "tensorflow/core/example/feature.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/framework/variant.h"
+#include "tensorflow/core/kernels/ragged_tensor_variant.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+namespace {
+
+constexpr char kNodeName[] = "batch_and_parse_example_dataset";
+constexpr char kParseExample[] = "ParseExample";
+constexpr char kBatchAndParseExample[] = "BatchAndParseExample";
+
+// The features of the test examples. Outputs are ordered by key, so the
+// element is (dense "a", ragged "r", sparse "s").
+constexpr char kDenseKey[] = "a";
+constexpr char kRaggedKey[] = "r";
+constexpr char kSparseKey[] = "s";
+
+// Parameters for `BatchAndParseExampleDataset`, or for the unfused
+// `ParseExampleDatasetV2` when `batch_size` is zero.
+class ParseExampleDatasetParams : public DatasetParams {
+ public:
+  template <typename T>
+  ParseExampleDatasetParams(T input_dataset_params, int64_t batch_size,
+                            bool drop_remainder, int64_t num_parallel_calls,
+                            bool with_sparse_and_ragged, std::string node_name)
+      : DatasetParams(OutputDtypes(with_sparse_and_ragged),
+                      OutputShapes(with_sparse_and_ragged),
+                      std::move(node_name)),
+        batch_size_(batch_size),
+        drop_remainder_(drop_remainder),
+        num_parallel_calls_(num_parallel_calls),
+        with_sparse_and_ragged_(with_sparse_and_ragged) {
+    input_dataset_params_.push_back(std::make_unique<T>(input_dataset_params));
+    op_version_ = 2;
+    iterator_prefix_ =
+        name_utils::IteratorPrefix(input_dataset_params.dataset_type(),
+                                   input_dataset_params.iterator_prefix());
+  }
+
+  std::vector<Tensor> GetInputTensors() const override {
+    std::vector<Tensor> inputs;
+    if (batch_size_ != 0) {
+      inputs.push_back(CreateTensor<int64_t>(TensorShape({}), {batch_size_}));
+      inputs.push_back(CreateTensor<bool>(TensorShape({}), {drop_remainder_}));
+    }
+    inputs.push_back(
+        CreateTensor<int64_t>(TensorShape({}), {num_parallel_calls_}));
+    inputs.push_back(CreateTensor<float>(TensorShape({2}), {-1.0f, -1.0f}));
+    return inputs;
+  }
+
+  absl::Status GetInputNames(
+      std::vector<std::string>* input_names) const override {
+    input_names->clear();
+    input_names->emplace_back("input_dataset");
+    if (batch_size_ != 0) {
+      input_names->emplace_back("batch_size");
+      input_names->emplace_back("drop_remainder");
+    }
+    input_names->emplace_back("num_parallel_calls");
+    input_names->emplace_back("dense_defaults_0");
+    return absl::OkStatus();
+  }
+
+  absl::Status GetAttributes(AttributeVector* attr_vector) const override {
+    std::vector<std::string> sparse_keys;
+    DataTypeVector sparse_types;
+    std::vector<std::string> ragged_keys;
+    DataTypeVector ragged_value_types;
+    DataTypeVector ragged_split_types;
+    if (with_sparse_and_ragged_) {
+      sparse_keys = {kSparseKey};
+      sparse_types = {DT_INT64};
+      ragged_keys = {kRaggedKey};
+      ragged_value_types = {DT_FLOAT};
+      ragged_split_types = {DT_INT64};
+    }
+    *attr_vector = {
+        {"sparse_keys", sparse_keys},
+        {"dense_keys", std::vector<std::string>{kDenseKey}},
+        {"sparse_types", sparse_types},
+        {"Tdense", DataTypeVector{DT_FLOAT}},
+        {"dense_shapes",
+         std::vector<PartialTensorShape>{PartialTensorShape({2})}},
+        {"output_types", output_dtypes_},
+        {"output_shapes", output_shapes_},
+        {"deterministic", "default"},
+        {"ragged_keys", ragged_keys},
+        {"ragged_value_types", ragged_value_types},
+        {"ragged_split_types", ragged_split_types}};
+    return absl::OkStatus();
+  }
+
+  std::string dataset_type() const override {
+    return batch_size_ != 0 ? kBatchAndParseExample : kParseExample;
+  }
+
+  std::string op_name() const override {
+    return batch_size_ != 0 ? "BatchAndParseExampleDataset"
+                           : "ParseExampleDatasetV2";
+  }
+
+ private:
+  static DataTypeVector OutputDtypes(bool with_sparse_and_ragged) {
+    if (!with_sparse_and_ragged) return {DT_FLOAT};
+    return {DT_FLOAT, DT_VARIANT, DT_VARIANT};
+  }
+
+  static std::vector<PartialTensorShape> OutputShapes(
+      bool with_sparse_and_ragged) {
+    if (!with_sparse_and_ragged) return {PartialTensorShape({-1, 2})};
+    return {PartialTensorShape({-1, 2}), PartialTensorShape({}),
+            PartialTensorShape({3})};
+  }
+
+  int64_t batch_size_;
+  bool drop_remainder_;
+  int64_t num_parallel_calls_;
+  bool with_sparse_and_ragged_;
+};
+
+class BatchAndParseExampleDatasetOpTest : public DatasetOpsTestBase {};
+
+// Returns five serialized examples. Examples 1 and 4 have no dense feature
+// and so take the default value.
+std::vector<tstring> SerializedExamples() {
+  const std::vector<std::vector<float>> dense = {
+      {1, 2}, {}, {5, 6}, {7, 8}, {}};
+  const std::vector<std::vector<int64_t>> sparse = {
+      {10}, {}, {11, 12}, {13}, {14, 15, 16}};
+  const std::vector<std::vector<float>> ragged = {
+      {1}, {2, 3}, {}, {4}, {5, 6, 7}};
+  std::vector<tstring> serialized;
+  for (int i = 0; i < dense.size(); ++i) {
+    Example example;
+    auto& features = *example.mutable_features()->mutable_feature();
+    for (float v : dense[i]) {
+      features[kDenseKey].mutable_float_list()->add_value(v);
+    }
+    auto* sparse_values = features[kSparseKey].mutable_int64_list();
+    for (int64_t v : sparse[i]) sparse_values->add_value(v);
+    auto* ragged_values = features[kRaggedKey].mutable_float_list();
+    for (float v : ragged[i]) ragged_values->add_value(v);
+    serialized.push_back(example.SerializeAsString());
+  }
+  return serialized;
+}
+
+TensorSliceDatasetParams ExamplesDatasetParams() {
+  std::vector<tstring> serialized = SerializedExamples();
+  const int64_t n = serialized.size();
+  return TensorSliceDatasetParams(
+      /*components=*/{CreateTensor<tstring>(TensorShape({n}), serialized)},
+      /*node_name=*/"tensor_slice_dataset");
+}
+
+ParseExampleDatasetParams FusedParams(int64_t batch_size,
+                                      bool drop_remainder,
+                                      int64_t num_parallel_calls,
+                                      bool with_sparse_and_ragged) {
+  return ParseExampleDatasetParams(ExamplesDatasetParams(), batch_size,
+                                   drop_remainder, num_parallel_calls,
+                                   with_sparse_and_ragged, kNodeName);
+}
+
+// The unfused `batch` followed by `parse_example` that the fused dataset
+// replaces.
+ParseExampleDatasetParams UnfusedParams(int64_t batch_size,
+                                        bool drop_remainder,
+                                        bool with_sparse_and_ragged) {
+  auto batch_dataset_params = BatchDatasetParams(
+      ExamplesDatasetParams(), batch_size, drop_remainder,
+      /*parallel_copy=*/false, /*output_dtypes=*/{DT_STRING},
+      /*output_shapes=*/{PartialTensorShape({-1})},
+      /*node_name=*/"batch_dataset");
+  return ParseExampleDatasetParams(std::move(batch_dataset_params),
+                                   /*batch_size=*/0, /*drop_remainder=*/false,
+                                   /*num_parallel_calls=*/1,
+                                   with_sparse_and_ragged,
+                                   "parse_example_dataset");
+}
+
+// Dense-only, full batches.
+ParseExampleDatasetParams BatchAndParseExampleDatasetParams1() {
+  return FusedParams(/*batch_size=*/2, /*drop_remainder=*/true,
+                     /*num_parallel_calls=*/1,
+                     /*with_sparse_and_ragged=*/false);
+}
+
+// Dense-only, with a partial final batch.
+ParseExampleDatasetParams BatchAndParseExampleDatasetParams2() {
+  return FusedParams(/*batch_size=*/2, /*drop_remainder=*/false,
+                     /*num_parallel_calls=*/2,
+                     /*with_sparse_and_ragged=*/false);
+}
+
+// Dense-only, a single batch larger than the input.
+ParseExampleDatasetParams BatchAndParseExampleDatasetParams3() {
+  return FusedParams(/*batch_size=*/8, /*drop_remainder=*/false,
+                     /*num_parallel_calls=*/model::kAutotune,
+                     /*with_sparse_and_ragged=*/false);
+}
+
+// Dense-only, a single batch larger than the input that is dropped.
+ParseExampleDatasetParams BatchAndParseExampleDatasetParams4() {
+  return FusedParams(/*batch_size=*/8, /*drop_remainder=*/true,
+                     /*num_parallel_calls=*/1,
+                     /*with_sparse_and_ragged=*/false);
+}
+
+ParseExampleDatasetParams InvalidBatchSizeParams() {
+  return FusedParams(/*batch_size=*/-2, /*drop_remainder=*/false,
+                     /*num_parallel_calls=*/1,
+                     /*with_sparse_and_ragged=*/false);
+}
+
+std::vector<GetNextTestCase<ParseExampleDatasetParams>> GetNextTestCases() {
+  return {{/*dataset_params=*/BatchAndParseExampleDatasetParams1(),
+           /*expected_outputs=*/
+           CreateTensors<float>(TensorShape({2, 2}),
+                                {{1, 2, -1, -1}, {5, 6, 7, 8}})},
+          {/*dataset_params=*/BatchAndParseExampleDatasetParams2(),
+           /*expected_outputs=*/
+           {CreateTensor<float>(TensorShape({2, 2}), {1, 2, -1, -1}),
+            CreateTensor<float>(TensorShape({2, 2}), {5, 6, 7, 8}),
+            CreateTensor<float>(TensorShape({1, 2}), {-1, -1})}},
+          {/*dataset_params=*/BatchAndParseExampleDatasetParams3(),
+           /*expected_outputs=*/
+           {CreateTensor<float>(TensorShape({5, 2}),
+                                {1, 2, -1, -1, 5, 6, 7, 8, -1, -1})}},
+          {/*dataset_params=*/BatchAndParseExampleDatasetParams4(),
+           /*expected_outputs=*/{}}};
+}
+
+ITERATOR_GET_NEXT_TEST_P(BatchAndParseExampleDatasetOpTest,
+                         ParseExampleDatasetParams, GetNextTestCases())
+
+TEST_F(BatchAndParseExampleDatasetOpTest, DatasetTypeString) {
+  auto dataset_params = BatchAndParseExampleDatasetParams1();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckDatasetTypeString("BatchAndParseExampleDataset"));
+}
+
+std::vector<CardinalityTestCase<ParseExampleDatasetParams>>
+CardinalityTestCases() {
+  return {{/*dataset_params=*/BatchAndParseExampleDatasetParams1(),
+           /*expected_cardinality=*/2},
+          {/*dataset_params=*/BatchAndParseExampleDatasetParams2(),
+           /*expected_cardinality=*/3},
+          {/*dataset_params=*/BatchAndParseExampleDatasetParams3(),
+           /*expected_cardinality=*/1},
+          {/*dataset_params=*/BatchAndParseExampleDatasetParams4(),
+           /*expected_cardinality=*/0}};
+}
+
+DATASET_CARDINALITY_TEST_P(BatchAndParseExampleDatasetOpTest,
+                           ParseExampleDatasetParams, CardinalityTestCases())
+
+std::vector<IteratorSaveAndRestoreTestCase<ParseExampleDatasetParams>>
+IteratorSaveAndRestoreTestCases() {
+  return {{/*dataset_params=*/BatchAndParseExampleDatasetParams1(),
+           /*breakpoints=*/{0, 1, 4},
+           /*expected_outputs=*/
+           CreateTensors<float>(TensorShape({2, 2}),
+                                {{1, 2, -1, -1}, {5, 6, 7, 8}})},
+          {/*dataset_params=*/BatchAndParseExampleDatasetParams2(),
+           /*breakpoints=*/{0, 1, 2, 4},
+           /*expected_outputs=*/
+           {CreateTensor<float>(TensorShape({2, 2}), {1, 2, -1, -1}),
+            CreateTensor<float>(TensorShape({2, 2}), {5, 6, 7, 8}),
+            CreateTensor<float>(TensorShape({1, 2}), {-1, -1})}}};
+}
+
+ITERATOR_SAVE_AND_RESTORE_TEST_P(BatchAndParseExampleDatasetOpTest,
+                                 ParseExampleDatasetParams,
+                                 IteratorSaveAndRestoreTestCases())
+
+TEST_F(BatchAndParseExampleDatasetOpTest, InvalidBatchSize) {
+  auto dataset_params = InvalidBatchSizeParams();
+  EXPECT_EQ(Initialize(dataset_params).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+// Compares one component of a parsed element. Sparse components are
+// (indices, values, dense_shape) variant vectors and ragged components are
+// scalar `RaggedTensorVariant`s, which `ExpectEqual` cannot compare directly.
+absl::Status ExpectSameComponent(const Tensor& a, const Tensor& b) {
+  if (a.dtype() != DT_VARIANT || b.dtype() != DT_VARIANT) {
+    return DatasetOpsTestBase::ExpectEqual(a, b);
+  }
+  if (a.shape() != b.shape()) {
+    return absl::InternalError(absl::StrCat("Shapes don't match: ",
+                                            a.shape().DebugString(), " vs ",
+                                            b.shape().DebugString()));
+  }
+  if (a.dims() == 1) {
+    for (int i = 0; i < a.NumElements(); ++i) {
+      const Tensor* a_part = a.vec<Variant>()(i).get<Tensor>();
+      const Tensor* b_part = b.vec<Variant>()(i).get<Tensor>();
+      if (a_part == nullptr || b_part == nullptr) {
+        return absl::InternalError("Expected a serialized sparse tensor.");
+      }
+      TF_RETURN_IF_ERROR(DatasetOpsTestBase::ExpectEqual(*a_part, *b_part));
+    }
+    return absl::OkStatus();
+  }
+  const auto* a_ragged = a.scalar<Variant>()().get<RaggedTensorVariant>();
+  const auto* b_ragged = b.scalar<Variant>()().get<RaggedTensorVariant>();
+  if (a_ragged == nullptr || b_ragged == nullptr) {
+    return absl::InternalError("Expected a RaggedTensorVariant.");
+  }
+  TF_RETURN_IF_ERROR(
+      DatasetOpsTestBase::ExpectEqual(a_ragged->values(), b_ragged->values()));
+  if (a_ragged->ragged_rank() != b_ragged->ragged_rank()) {
+    return absl::InternalError("Ragged ranks don't match.");
+  }
+  for (int i = 0; i < a_ragged->ragged_rank(); ++i) {
+    TF_RETURN_IF_ERROR(DatasetOpsTestBase::ExpectEqual(
+        a_ragged->nested_splits()[i], b_ragged->nested_splits()[i]));
+  }
+  return absl::OkStatus();
+}
+
+class BatchAndParseExampleEquivalenceTest
+    : public BatchAndParseExampleDatasetOpTest,
+      public ::testing::WithParamInterface<bool> {
+ protected:
+  absl::Status GetAll(const ParseExampleDatasetParams& params,
+                      std::vector<std::vector<Tensor>>* elements) {
+    std::unique_ptr<TestDataset> dataset;
+    TF_RETURN_IF_ERROR(MakeDataset(params, &dataset));
+    std::unique_ptr<TestIterator> iterator;
+    TF_RETURN_IF_ERROR(MakeIterator(params, *dataset, &iterator));
+    bool end_of_sequence = false;
+    while (true) {
+      std::vector<Tensor> element;
+      TF_RETURN_IF_ERROR(iterator->GetNext(&element, &end_of_sequence));
+      if (end_of_sequence) break;
+      elements->push_back(std::move(element));
+    }
+    return absl::OkStatus();
+  }
+};
+
+// The fused dataset must produce exactly what `batch` followed by
+// `parse_example` produces, including the sparse and ragged components and
+// the partial final batch.
+TEST_P(BatchAndParseExampleEquivalenceTest, MatchesBatchThenParse) {
+  const bool drop_remainder = GetParam();
+  auto fused_params = FusedParams(/*batch_size=*/2, drop_remainder,
+                                  /*num_parallel_calls=*/2,
+                                  /*with_sparse_and_ragged=*/true);
+  auto unfused_params = UnfusedParams(/*batch_size=*/2, drop_remainder,
+                                      /*with_sparse_and_ragged=*/true);
+  TF_ASSERT_OK(InitializeRuntime(fused_params));
+
+  std::vector<std::vector<Tensor>> fused;
+  TF_ASSERT_OK(GetAll(fused_params, &fused));
+  std::vector<std::vector<Tensor>> unfused;
+  TF_ASSERT_OK(GetAll(unfused_params, &unfused));
+
+  ASSERT_EQ(fused.size(), drop_remainder ? 2 : 3);
+  ASSERT_EQ(fused.size(), unfused.size());
+  for (int i = 0; i < fused.size(); ++i) {
+    ASSERT_EQ(fused[i].size(), 3);
+    ASSERT_EQ(unfused[i].size(), 3);
+    for (int j = 0; j < fused[i].size(); ++j) {
+      TF_EXPECT_OK(ExpectSameComponent(fused[i][j], unfused[i][j]))
+          << "batch " << i << ", component " << j;
+    }
+  }
+
+  // Spot-check the sparse and ragged values of the second batch, which
+  // holds examples 2 and 3.
+  const Tensor* sparse_values = fused[1][2].vec<Variant>()(1).get<Tensor>();
+  ASSERT_NE(sparse_values, nullptr);
+  TF_EXPECT_OK(ExpectEqual(*sparse_values,
+                           CreateTensor<int64_t>(TensorShape({3}),
+                                                 {11, 12, 13})));
+  const auto* ragged =
+      fused[1][1].scalar<Variant>()().get<RaggedTensorVariant>();
+  ASSERT_NE(ragged, nullptr);
+  TF_EXPECT_OK(ExpectEqual(ragged->values(),
+                           CreateTensor<float>(TensorShape({1}), {4})));
+  TF_EXPECT_OK(ExpectEqual(ragged->nested_splits()[0],
+                           CreateTensor<int64_t>(TensorShape({3}), {0, 0, 1})));
+}
+
+INSTANTIATE_TEST_SUITE_P(DropRemainder, BatchAndParseExampleEquivalenceTest,
+                         ::testing::Bool());
+
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,212 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/shared_memory_dataset_op.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/data/dataset_utils.h"
+#include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/shared_memory_ring_buffer.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+
+// Constants declared in shared_memory_dataset_op.h and used both here and in
+// test cases.
+/* static */ constexpr const char* const SharedMemoryDatasetOp::kDatasetType;
+/* static */ constexpr const char* const SharedMemoryDatasetOp::kBufferName;
+/* static */ constexpr const char* const SharedMemoryDatasetOp::kConsumerIndex;
+/* static */ constexpr const char* const SharedMemoryDatasetOp::kOutputTypes;
+/* static */ constexpr const char* const SharedMemoryDatasetOp::kOutputShapes;
+
+namespace {
+
+// How long to wait before trying again to open a buffer that the publisher
+// has not created yet.
+constexpr int64_t kOpenRetryMicros = 10 * 1000;  // 10ms
+
+}  // namespace
+
+class SharedMemoryDatasetOp::Dataset : public DatasetBase {
+ public:
+  Dataset(OpKernelContext* ctx, std::string buffer_name,
+          int64_t consumer_index, const DataTypeVector& output_types,
+          const std::vector<PartialTensorShape>& output_shapes)
+      : DatasetBase(DatasetContext(ctx)),
+        buffer_name_(std::move(buffer_name)),
+        consumer_index_(consumer_index),
+        output_types_(output_types),
+        output_shapes_(output_shapes) {}
+
+  std::unique_ptr<IteratorBase> MakeIteratorInternal(
+      const std::string& prefix) const override {
+    return std::make_unique<Iterator>(Iterator::Params{
+        this, name_utils::IteratorPrefix(kDatasetType, prefix)});
+  }
+
+  const DataTypeVector& output_dtypes() const override { return output_types_; }
+
+  const std::vector<PartialTensorShape>& output_shapes() const override {
+    return output_shapes_;
+  }
+
+  std::string DebugString() const override {
+    return name_utils::DatasetDebugString(kDatasetType);
+  }
+
+  int64_t CardinalityInternal(CardinalityOptions options) const override {
+    return kUnknownCardinality;
+  }
+
+  absl::Status InputDatasets(
+      std::vector<const DatasetBase*>* inputs) const override {
+    return absl::OkStatus();
+  }
+
+  absl::Status CheckExternalState() const override { return absl::OkStatus(); }
+
+ protected:
+  absl::Status AsGraphDefInternal(SerializationContext* ctx,
+                                  DatasetGraphDefBuilder* b,
+                                  Node** output) const override {
+    Node* buffer_name = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(buffer_name_, &buffer_name));
+    Node* consumer_index = nullptr;
+    TF_RETURN_IF_ERROR(b->AddScalar(consumer_index_, &consumer_index));
+    return b->AddDataset(this, {buffer_name, consumer_index}, output);
+  }
+
+ private:
+  class Iterator : public DatasetIterator<Dataset> {
+   public:
+    explicit Iterator(const Params& params)
+        : DatasetIterator<Dataset>(params) {}
+
+    absl::Status GetNextInternal(IteratorContext* ctx,
+                                 std::vector<Tensor>* out_tensors,
+                                 bool* end_of_sequence) override {
+      mutex_lock l(mu_);
+      if (!consumer_) {
+        TF_RETURN_IF_ERROR(OpenConsumer(ctx));
+      }
+      TF_RETURN_IF_ERROR(consumer_->GetNext(out_tensors, end_of_sequence,
+                                            ctx->cancellation_manager()));
+      if (*end_of_sequence) {
+        return absl::OkStatus();
+      }
+      TF_RETURN_IF_ERROR(
+          VerifyTypesMatch(dataset()->output_types_, *out_tensors));
+      return VerifyShapesCompatible(dataset()->output_shapes_, *out_tensors);
+    }
+
+   protected:
+    std::shared_ptr<model::Node> CreateNode(
+        IteratorContext* ctx, model::Node::Args args) const override {
+      return model::MakeSourceNode(std::move(args));
+    }
+
+    // The publisher does not keep elements that every consumer has read, so
+    // the position of the consumer cannot be restored.
+    absl::Status SaveInternal(SerializationContext* ctx,
+                              IteratorStateWriter* writer) override {
+      return absl::UnimplementedError(
+          "SharedMemoryDataset does not support checkpointing.");
+    }
+
+    absl::Status RestoreInternal(IteratorContext* ctx,
+                                 IteratorStateReader* reader) override {
+      return absl::UnimplementedError(
+          "SharedMemoryDataset does not support checkpointing.");
+    }
+
+   private:
+    // Opens the buffer as its consumer, waiting until the publisher has
+    // created it.
+    absl::Status OpenConsumer(IteratorContext* ctx)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      while (true) {
+        absl::StatusOr<std::unique_ptr<SharedMemoryElementConsumer>> consumer =
+            SharedMemoryElementConsumer::Open(dataset()->buffer_name_,
+                                              dataset()->consumer_index_);
+        if (!absl::IsUnavailable(consumer.status())) {
+          TF_RETURN_IF_ERROR(consumer.status());
+          consumer_ = std::move(*consumer);
+          return absl::OkStatus();
+        }
+        if (ctx->cancellation_manager() != nullptr &&
+            ctx->cancellation_manager()->IsCancelled()) {
+          return absl::CancelledError(
+              "Cancelled while waiting for a shared memory ring buffer.");
+        }
+        VLOG(2) << consumer.status();
+        ctx->env()->SleepForMicroseconds(kOpenRetryMicros);
+      }
+    }
+
+    mutex mu_;
+    std::unique_ptr<SharedMemoryElementConsumer> consumer_ TF_GUARDED_BY(mu_);
+  };
+
+  const std::string buffer_name_;
+  const int64_t consumer_index_;
+  const DataTypeVector output_types_;
+  const std::vector<PartialTensorShape> output_shapes_;
+};
+
+SharedMemoryDatasetOp::SharedMemoryDatasetOp(OpKernelConstruction* ctx)
+    : DatasetOpKernel(ctx) {
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kOutputTypes, &output_types_));
+  OP_REQUIRES_OK(ctx, ctx->GetAttr(kOutputShapes, &output_shapes_));
+}
+
+void SharedMemoryDatasetOp::MakeDataset(OpKernelContext* ctx,
+                                        DatasetBase** output) {
+  tstring buffer_name;
+  OP_REQUIRES_OK(ctx,
+                 ParseScalarArgument<tstring>(ctx, kBufferName, &buffer_name));
+  int64_t consumer_index;
+  OP_REQUIRES_OK(ctx, ParseScalarArgument<int64_t>(ctx, kConsumerIndex,
+                                                   &consumer_index));
+  OP_REQUIRES(ctx, consumer_index >= 0,
+              absl::InvalidArgumentError(
+                  "`consumer_index` must be greater than or equal to 0."));
+  *output = new Dataset(ctx, buffer_name, consumer_index, output_types_,
+                        output_shapes_);
+}
+
+namespace {
+
+REGISTER_KERNEL_BUILDER(Name("SharedMemoryDataset").Device(DEVICE_CPU),
+                        SharedMemoryDatasetOp);
+
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,150 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/experimental/shared_memory_dataset_op.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/dataset_test_base.h"
+#include "tensorflow/core/data/shared_memory_ring_buffer.h"
+
+namespace tensorflow {
+namespace data {
+namespace experimental {
+namespace {
+
+constexpr char kNodeName[] = "shared_memory_dataset";
+constexpr int64_t kNumElements = 3;
+
+class SharedMemoryDatasetParams : public DatasetParams {
+ public:
+  SharedMemoryDatasetParams(std::string buffer_name, int64_t consumer_index,
+                            DataTypeVector output_dtypes,
+                            std::vector<PartialTensorShape> output_shapes,
+                            std::string node_name)
+      : DatasetParams(std::move(output_dtypes), std::move(output_shapes),
+                      std::move(node_name)),
+        buffer_name_(std::move(buffer_name)),
+        consumer_index_(consumer_index) {}
+
+  std::vector<Tensor> GetInputTensors() const override {
+    return {CreateTensor<tstring>(TensorShape({}), {buffer_name_}),
+            CreateTensor<int64_t>(TensorShape({}), {consumer_index_})};
+  }
+
+  absl::Status GetInputNames(
+      std::vector<std::string>* input_names) const override {
+    *input_names = {SharedMemoryDatasetOp::kBufferName,
+                    SharedMemoryDatasetOp::kConsumerIndex};
+    return absl::OkStatus();
+  }
+
+  absl::Status GetAttributes(AttributeVector* attributes) const override {
+    *attributes = {{"output_types", output_dtypes_},
+                   {"output_shapes", output_shapes_},
+                   {"metadata", ""}};
+    return absl::OkStatus();
+  }
+
+  std::string dataset_type() const override {
+    return SharedMemoryDatasetOp::kDatasetType;
+  }
+
+ private:
+  std::string buffer_name_;
+  int64_t consumer_index_;
+};
+
+// Shared memory names are global to the host, so tests that run concurrently
+// must not share them.
+std::string BufferName(const std::string& name) {
+  return absl::StrCat("/tf_data_shm_dataset_test_", getpid(), "_", name);
+}
+
+SharedMemoryDatasetParams Int64DatasetParams(const std::string& buffer_name) {
+  return {buffer_name,
+          /*consumer_index=*/0,
+          /*output_dtypes=*/{DT_INT64},
+          /*output_shapes=*/{PartialTensorShape({})},
+          /*node_name=*/kNodeName};
+}
+
+class SharedMemoryDatasetOpTest : public DatasetOpsTestBase {
+ protected:
+  // Publishes `kNumElements` scalars to a new buffer and closes it.
+  void PublishElements(const std::string& buffer_name) {
+    SharedMemoryElementPublisher::Options options;
+    options.name = buffer_name;
+    options.num_slots = kNumElements + 1;
+    options.slot_bytes = 4096;
+    TF_ASSERT_OK_AND_ASSIGN(publisher_,
+                            SharedMemoryElementPublisher::Create(options));
+    for (int64_t i = 0; i < kNumElements; ++i) {
+      TF_ASSERT_OK(publisher_->Publish(
+          {CreateTensor<int64_t>(TensorShape({}), {i})}));
+    }
+    publisher_->Close();
+  }
+
+  std::unique_ptr<SharedMemoryElementPublisher> publisher_;
+};
+
+TEST_F(SharedMemoryDatasetOpTest, ReadsPublishedElements) {
+  const std::string buffer_name = BufferName("reads_published");
+  PublishElements(buffer_name);
+  TF_ASSERT_OK(Initialize(Int64DatasetParams(buffer_name)));
+  TF_ASSERT_OK(CheckIteratorGetNext(
+      CreateTensors<int64_t>(TensorShape({}), {{0}, {1}, {2}}),
+      /*compare_order=*/true));
+}
+
+TEST_F(SharedMemoryDatasetOpTest, RejectsMismatchedTypes) {
+  const std::string buffer_name = BufferName("mismatched_types");
+  PublishElements(buffer_name);
+  TF_ASSERT_OK(Initialize({buffer_name,
+                           /*consumer_index=*/0,
+                           /*output_dtypes=*/{DT_FLOAT},
+                           /*output_shapes=*/{PartialTensorShape({})},
+                           /*node_name=*/kNodeName}));
+  std::vector<Tensor> out_tensors;
+  bool end_of_sequence = false;
+  EXPECT_EQ(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                               &end_of_sequence)
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(SharedMemoryDatasetOpTest, DoesNotSupportCheckpointing) {
+  const std::string buffer_name = BufferName("checkpointing");
+  PublishElements(buffer_name);
+  TF_ASSERT_OK(Initialize(Int64DatasetParams(buffer_name)));
+  std::unique_ptr<SerializationContext> serialization_ctx;
+  TF_ASSERT_OK(CreateSerializationContext(&serialization_ctx));
+  VariantTensorDataWriter writer;
+  EXPECT_EQ(iterator_->Save(serialization_ctx.get(), &writer).code(),
+            absl::StatusCode::kUnimplemented);
+}
+
+}  // namespace
+}  // namespace experimental
+}  // namespace data
+}  // namespace tensorflow
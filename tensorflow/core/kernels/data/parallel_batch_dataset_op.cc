@@ -78,6 +78,65 @@ constexpr char kCallFinished[] = "call_finished";
 constexpr char kOutputAllocated[] = "output_allocated";
 constexpr char kStatus[] = "status";
 
+// Streamed batches are copied in chunks of about this many bytes, so that the
+// copies of large elements run in parallel with fetching the next elements.
+constexpr int64_t kStreamingCopyChunkBytes = 1 << 20;  // 1MB
+
+// Allocates a batch of `batch_size` elements shaped like `element`.
+absl::Status AllocateBatch(IteratorContext* ctx, int64_t batch_size,
+                           const std::vector<Tensor>& element,
+                           std::vector<Tensor>* batch) {
+  AllocatorAttributes attr;
+  attr.set_gpu_compatible(true);
+  batch->reserve(element.size());
+  for (size_t i = 0; i < element.size(); ++i) {
+    TensorShape batch_component_shape({batch_size});
+    batch_component_shape.AppendShape(element[i].shape());
+    batch->emplace_back(ctx->allocator(attr), element[i].dtype(),
+                        batch_component_shape);
+    if (!batch->back().IsInitialized()) {
+      return absl::ResourceExhaustedError(absl::StrCat(
+          "Failed to allocate memory for the batch of component ", i));
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Copies `elements` into the rows of `batch` starting at row `start`, and
+// releases each element once it has been copied.
+absl::Status CopyElementsToBatch(int64_t start,
+                                 std::vector<std::vector<Tensor>>& elements,
+                                 std::vector<Tensor>* batch) {
+  for (size_t i = 0; i < elements.size(); ++i) {
+    if (elements[i].size() != batch->size()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Cannot batch elements with different numbers of components. First "
+          "element had ",
+          batch->size(), " components and element ", start + i, " had ",
+          elements[i].size(), "."));
+    }
+    for (size_t component_index = 0; component_index < batch->size();
+         ++component_index) {
+      Tensor& batch_component = (*batch)[component_index];
+      const Tensor& element = elements[i][component_index];
+      TensorShape element_shape(batch_component.shape());
+      element_shape.RemoveDim(0);
+      if (element.shape() != element_shape) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Cannot batch tensors with different shapes in component ",
+            component_index, ". First element had shape ",
+            element_shape.DebugString(), " and element ", start + i,
+            " had shape ", element.shape().DebugString(), "."));
+      }
+      TF_RETURN_IF_ERROR(batch_util::CopyElementToSlice(
+          std::move(elements[i][component_index]), &batch_component,
+          start + i));
+    }
+    elements[i].clear();
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 class ParallelBatchDatasetOp::Dataset : public DatasetBase {
@@ -108,6 +167,15 @@ class ParallelBatchDatasetOp::Dataset : public DatasetBase {
     input_->Ref();
 
     const auto& input_shapes = input_->output_shapes();
+    // Batches are streamed if every batch can be allocated up front, which
+    // requires static element shapes and a batch size that is not only used to
+    // stack the whole dataset.
+    stream_batches_ =
+        reserve_size_ == batch_size_ &&
+        std::all_of(input_shapes.begin(), input_shapes.end(),
+                    [](const PartialTensorShape& shape) {
+                      return shape.IsFullyDefined();
+                    });
     output_shapes_.reserve(input_shapes.size());
     for (const auto& input_shape : input_shapes) {
       if (drop_remainder_ || input_->Cardinality() == kInfiniteCardinality) {
@@ -375,6 +443,11 @@ class ParallelBatchDatasetOp::Dataset : public DatasetBase {
       absl::Status status TF_GUARDED_BY(mu);
       bool call_finished TF_GUARDED_BY(&Iterator::mu_);
       bool output_allocated TF_GUARDED_BY(mu);
+      // Number of copies into `output` that are in flight, and whether all
+      // elements of the batch have been fetched. Only used if batches are
+      // streamed.
+      int64_t pending_copies TF_GUARDED_BY(mu) = 0;
+      bool fetching_finished TF_GUARDED_BY(mu) = false;
       const int64_t uid = -1;
       MemoryCheckpoint checkpoint;
     };
@@ -404,6 +477,11 @@ class ParallelBatchDatasetOp::Dataset : public DatasetBase {
         return;
       }
 
+      if (dataset()->stream_batches_) {
+        CallStreamingBatching(ctx, result);
+        return;
+      }
+
       // Each row of `batch_elements` is a tuple of tensors from the input
       // iterator.
       std::vector<std::vector<Tensor>> batch_elements;
@@ -460,6 +538,112 @@ class ParallelBatchDatasetOp::Dataset : public DatasetBase {
       (*ctx->runner())(std::move(copy_elements_fn));
     }
 
+    // Like `CallBatching`, but allocates the batch when its first element is
+    // fetched and copies elements into it while the rest of the batch is being
+    // fetched, instead of holding on to all elements and concatenating them at
+    // the end. Copies are scheduled on the runner in chunks of
+    // `kStreamingCopyChunkBytes`.
+    void CallStreamingBatching(const std::shared_ptr<IteratorContext>& ctx,
+                               const std::shared_ptr<BatchResult>& result)
+        TF_LOCKS_EXCLUDED(*mu_) {
+      std::vector<Tensor> batch;
+      std::vector<std::vector<Tensor>> chunk;
+      int64_t chunk_start = 0;
+      int64_t chunk_bytes = 0;
+      bool end_of_input = false;
+      for (int64_t i = 0; i < dataset()->batch_size_ && !end_of_input; ++i) {
+        std::vector<Tensor> batch_element_tuple;
+        absl::Status status = input_impl_->GetNext(
+            ctx.get(), &batch_element_tuple, &end_of_input);
+        {
+          mutex_lock l(result->mu);
+          result->end_of_input = result->end_of_input || end_of_input;
+          result->status.Update(status);
+          result->checkpoint.Merge(ctx->checkpoint());
+          if (result->end_of_input || !result->status.ok()) break;
+        }
+        if (batch.empty()) {
+          status = AllocateBatch(ctx.get(), dataset()->batch_size_,
+                                 batch_element_tuple, &batch);
+          mutex_lock l(result->mu);
+          result->status.Update(status);
+          if (!result->status.ok()) break;
+          result->output = batch;
+        }
+        chunk_bytes += GetAllocatedBytes(batch_element_tuple);
+        chunk.push_back(std::move(batch_element_tuple));
+        {
+          mutex_lock l(result->mu);
+          result->num_elements++;
+        }
+        if (chunk_bytes >= kStreamingCopyChunkBytes) {
+          ScheduleStreamingCopy(ctx, result, batch, chunk_start,
+                                std::move(chunk));
+          chunk.clear();
+          chunk_start = i + 1;
+          chunk_bytes = 0;
+        }
+      }
+      if (!chunk.empty()) {
+        ScheduleStreamingCopy(ctx, result, batch, chunk_start,
+                              std::move(chunk));
+      }
+      bool copies_finished;
+      {
+        mutex_lock l(result->mu);
+        result->fetching_finished = true;
+        copies_finished = result->pending_copies == 0;
+      }
+      if (copies_finished) {
+        StreamingBatchingCompleted(ctx, result);
+      }
+    }
+
+    // Copies `elements` into rows of `batch` starting at `start` on the
+    // runner. `batch` shares its buffers with `result->output`.
+    void ScheduleStreamingCopy(const std::shared_ptr<IteratorContext>& ctx,
+                               const std::shared_ptr<BatchResult>& result,
+                               std::vector<Tensor> batch, int64_t start,
+                               std::vector<std::vector<Tensor>> elements)
+        TF_LOCKS_EXCLUDED(*mu_) {
+      {
+        mutex_lock l(result->mu);
+        result->pending_copies++;
+      }
+      auto copy_elements_fn = [this, ctx, result, batch = std::move(batch),
+                               start,
+                               elements = std::move(elements)]() mutable {
+        absl::Status status = CopyElementsToBatch(start, elements, &batch);
+        bool batching_finished;
+        {
+          mutex_lock l(result->mu);
+          result->status.Update(status);
+          batching_finished =
+              --result->pending_copies == 0 && result->fetching_finished;
+        }
+        if (batching_finished) {
+          StreamingBatchingCompleted(ctx, result);
+        }
+      };
+      (*ctx->runner())(std::move(copy_elements_fn));
+    }
+
+    void StreamingBatchingCompleted(const std::shared_ptr<IteratorContext>& ctx,
+                                    const std::shared_ptr<BatchResult>& result)
+        TF_LOCKS_EXCLUDED(*mu_) {
+      {
+        mutex_lock l(result->mu);
+        if (result->status.ok() && !result->output.empty()) {
+          result->output_allocated = true;
+          RecordBufferEnqueue(ctx.get(), result->output);
+        } else {
+          result->output.clear();
+          result->output_allocated = false;
+        }
+      }
+      CallCompleted(ctx, result);
+    }
+
     void CancelThreads(bool wait) TF_LOCKS_EXCLUDED(mu_) {
       if (cancellation_manager_ != nullptr) {
         cancellation_manager_->StartCancel();
@@ -668,6 +852,8 @@ class ParallelBatchDatasetOp::Dataset : public DatasetBase {
   const bool parallel_copy_;
   const DatasetBase* const input_;
   std::vector<PartialTensorShape> output_shapes_;
+  // Whether elements are copied into a preallocated batch as they are fetched.
+  bool stream_batches_ = false;
   const DeterminismPolicy deterministic_;
   const TraceMeMetadata traceme_metadata_;
 };
@@ -14,6 +14,11 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/parallel_batch_dataset_op.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
 #include "tensorflow/core/data/dataset_test_base.h"
 
 namespace tensorflow {
@@ -482,6 +487,49 @@ TEST_F(ParallelBatchDatasetOpTest, InvalidParallelBatchSize) {
             absl::StatusCode::kInvalidArgument);
 }
 
+// Elements with static shapes are copied into the batch as they are produced,
+// in several chunks per batch if the elements are large.
+TEST_F(ParallelBatchDatasetOpTest, StreamLargeElements) {
+  constexpr int64_t kNumElements = 5;
+  constexpr int64_t kElementSize = 200000;
+  std::vector<int64_t> values(kNumElements * kElementSize);
+  std::iota(values.begin(), values.end(), 0);
+  auto parallel_batch_dataset_params = ParallelBatchDatasetParams(
+      TensorSliceDatasetParams(
+          /*components=*/{CreateTensor<int64_t>(
+              TensorShape({kNumElements, kElementSize}), values)},
+          /*node_name=*/"tensor_slice"),
+      /*batch_size=*/2,
+      /*num_parallel_calls=*/2,
+      /*drop_remainder=*/false,
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({-1, kElementSize})},
+      /*parallel_copy=*/false,
+      /*deterministic=*/DeterminismPolicy::kDeterministic,
+      /*node_name=*/kNodeName);
+  TF_ASSERT_OK(Initialize(parallel_batch_dataset_params));
+
+  std::vector<Tensor> out_tensors;
+  bool end_of_sequence = false;
+  while (!end_of_sequence) {
+    std::vector<Tensor> next;
+    TF_ASSERT_OK(
+        iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+    out_tensors.insert(out_tensors.end(), next.begin(), next.end());
+  }
+  std::vector<Tensor> expected_outputs;
+  for (int64_t begin = 0; begin < kNumElements; begin += 2) {
+    const int64_t batch_size = std::min<int64_t>(2, kNumElements - begin);
+    expected_outputs.push_back(CreateTensor<int64_t>(
+        TensorShape({batch_size, kElementSize}),
+        std::vector<int64_t>(
+            values.begin() + begin * kElementSize,
+            values.begin() + (begin + batch_size) * kElementSize)));
+  }
+  TF_EXPECT_OK(ExpectEqual(out_tensors, expected_outputs,
+                           /*compare_order=*/true));
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -27,6 +27,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_format.h"
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/common_runtime/input_colocation_exemption_registry.h"
@@ -44,7 +45,9 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/lib/random/random_distributions.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/blocking_counter.h"
@@ -86,6 +89,10 @@ namespace data {
 /* static */ constexpr const char* const
     ParallelInterleaveDatasetOp::kDeterministic;
 /* static */ constexpr const char* const ParallelInterleaveDatasetOp::kSloppy;
+/* static */ constexpr const char* const
+    ParallelInterleaveDatasetOp::kReorderWindow;
+/* static */ constexpr const char* const
+    ParallelInterleaveDatasetOp::kReorderSeed;
 
 namespace {
 
@@ -99,10 +106,16 @@ constexpr char kCurrentElements[] = "current_elements";
 constexpr char kCurrentElementsSize[] = "current_elements.size";
 constexpr char kFutureElements[] = "future_elements";
 constexpr char kFutureElementsSize[] = "future_elements.size";
+constexpr char kReorderBuffer[] = "reorder_buffer";
+constexpr char kReorderBufferSize[] = "reorder_buffer.size";
+constexpr char kNumResultsConsumed[] = "num_results_consumed";
+constexpr char kNumResultsReturned[] = "num_results_returned";
+constexpr char kNumRandomSamples[] = "num_random_samples";
 constexpr char kResultsSuffix[] = ".results";
 constexpr char kCodeSuffix[] = ".code";
 constexpr char kErrorMessageSuffix[] = ".error_message";
 constexpr char kIdSuffix[] = ".id";
+constexpr char kPositionSuffix[] = ".position";
 constexpr char kSizeSuffix[] = ".size";
 constexpr char kInputsSuffix[] = ".inputs";
 constexpr char kIsReadySuffix[] = ".is_ready";
@@ -205,7 +218,8 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
           std::unique_ptr<CapturedFunction> captured_func, int64_t cycle_length,
           int64_t block_length, int64_t buffer_output_elements,
           int64_t prefetch_input_elements, int64_t num_parallel_calls,
-          DeterminismPolicy deterministic, const DataTypeVector& output_types,
+          DeterminismPolicy deterministic, int64_t reorder_window,
+          int64_t reorder_seed, const DataTypeVector& output_types,
           const std::vector<PartialTensorShape>& output_shapes, int op_version)
       : DatasetBase(DatasetContext(ctx)),
         input_(input),
@@ -219,6 +233,8 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
             prefetch_input_elements, cycle_length_)),
         num_parallel_calls_(num_parallel_calls),
         deterministic_(deterministic),
+        reorder_window_(reorder_window),
+        reorder_seed_(reorder_seed),
         output_types_(output_types),
         output_shapes_(output_shapes),
         op_version_(op_version),
@@ -354,6 +370,14 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       b->BuildAttrValue(deterministic_.String(), &deterministic_attr);
       attrs.emplace_back(kDeterministic, deterministic_attr);
     }
+    if (op_version_ >= 4) {
+      AttrValue reorder_window_attr;
+      b->BuildAttrValue(reorder_window_, &reorder_window_attr);
+      attrs.emplace_back(kReorderWindow, reorder_window_attr);
+      AttrValue reorder_seed_attr;
+      b->BuildAttrValue(reorder_seed_, &reorder_seed_attr);
+      attrs.emplace_back(kReorderSeed, reorder_seed_attr);
+    }
 
     TF_RETURN_IF_ERROR(b->AddDataset(this, inputs, list_inputs, attrs, output));
     return absl::OkStatus();
@@ -370,12 +394,15 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
               params.dataset->num_parallel_calls_, mu_,
               num_parallel_calls_cond_var_)),
           deterministic_(deterministic),
+          reorder_window_(deterministic ? params.dataset->reorder_window_ : 0),
+          parent_generator_(params.dataset->reorder_seed_, 0),
+          generator_(&parent_generator_),
           current_elements_(params.dataset->cycle_length_) {}
 
     ~ParallelInterleaveIterator() override { CancelThreads(/*wait=*/true); }
 
     bool SymbolicCheckpointCompatible() const override {
-      return deterministic_;
+      return deterministic_ && reorder_window_ == 0;
     }
 
     // TODO(jsimsa): Register cancellation callback once the implementation is
@@ -431,19 +458,11 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         mutex_lock l(*mu_);
         EnsureInitialElementsCreated(ctx);
         EnsureThreadsStarted(ctx);
-        while (!cancelled_ && !Consume(ctx, &result)) {
-          RecordStop(ctx);
-          if (deterministic_) {
-            VLOG(3) << "Blocked waiting for element "
-                    << current_elements_[cycle_index_]->id;
-            current_elements_[cycle_index_]->cond_var.wait(l);
-          } else {
-            any_element_available_cond_var_.wait(l);
-          }
-          RecordStart(ctx);
-        }
-        if (cancelled_) {
-          return absl::CancelledError("Iterator was cancelled");
+        if (reorder_window_ > 0) {
+          TF_RETURN_IF_ERROR(ConsumeReordered(ctx, l, &result));
+        } else {
+          TF_RETURN_IF_ERROR(
+              ConsumeNext(ctx, l, &result, /*element_id=*/nullptr));
         }
         if (result) {
           checkpoint_->Merge(&result->checkpoint);
@@ -532,6 +551,9 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
                                              element_id_counter_));
       TF_RETURN_IF_ERROR(WriteCurrentElements(ctx, writer));
       TF_RETURN_IF_ERROR(WriteFutureElements(ctx, writer));
+      if (reorder_window_ > 0) {
+        TF_RETURN_IF_ERROR(WriteReorderBuffer(writer));
+      }
       // Wake workers back up.
       current_workers_cond_var_.notify_all();
       future_workers_cond_var_.notify_all();
@@ -555,6 +577,10 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
         TF_RETURN_IF_ERROR(
             reader->ReadScalar(prefix(), kEndOfInput, &end_of_input));
         end_of_input_ = static_cast<bool>(end_of_input);
+        if (reorder_window_ > 0) {
+          TF_RETURN_IF_ERROR(ReadReorderBuffer(ctx, reader));
+          ResetRngs();
+        }
       }
       TF_RETURN_IF_ERROR(ReadCurrentElements(ctx, reader));
       TF_RETURN_IF_ERROR(ReadFutureElements(ctx, reader));
@@ -761,19 +787,171 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       }
     }
 
+    // Waits for a result and consumes it. `result` is set to null if end of
+    // input has been reached. If `element_id` is not null, it is set to the id
+    // of the element that produced the result.
+    absl::Status ConsumeNext(IteratorContext* ctx, mutex_lock& l,
+                             std::shared_ptr<Result>* result,
+                             int64_t* element_id)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      while (!cancelled_ && !Consume(ctx, result, element_id)) {
+        RecordStop(ctx);
+        if (deterministic_) {
+          VLOG(3) << "Blocked waiting for element "
+                  << current_elements_[cycle_index_]->id;
+          current_elements_[cycle_index_]->cond_var.wait(l);
+        } else {
+          any_element_available_cond_var_.wait(l);
+        }
+        RecordStart(ctx);
+      }
+      if (cancelled_) {
+        return absl::CancelledError("Iterator was cancelled");
+      }
+      return absl::OkStatus();
+    }
+
+    // Consumes the next result when results are reordered. `reorder_buffer_`
+    // holds the next `reorder_window_ + 1` positions of the deterministic
+    // order. A position whose element has not produced its result yet is moved
+    // past and filled in once the result is ready, so a slow element does not
+    // hold up the others. The result to return is chosen among the ready ones
+    // with the seeded generator. Only results with no earlier result of the
+    // same element in the buffer can be chosen, and the oldest position is
+    // waited for once it is `reorder_window_` positions late. So the results of
+    // each element keep their order and every result is returned at most
+    // `reorder_window_` positions away from its place in the deterministic
+    // order.
+    absl::Status ConsumeReordered(IteratorContext* ctx, mutex_lock& l,
+                                  std::shared_ptr<Result>* result)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      while (!cancelled_) {
+        FillReorderBuffer(ctx);
+        if (reorder_buffer_.empty()) {
+          result->reset();
+          return absl::OkStatus();
+        }
+        const int64_t index = ChooseReordered();
+        if (index >= 0) {
+          *result = std::move(reorder_buffer_[index].result);
+          reorder_buffer_.erase(reorder_buffer_.begin() + index);
+          ++num_results_returned_;
+          return absl::OkStatus();
+        }
+        RecordStop(ctx);
+        any_element_available_cond_var_.wait(l);
+        RecordStart(ctx);
+      }
+      return absl::CancelledError("Iterator was cancelled");
+    }
+
+    // Fills `reorder_buffer_` with the next positions of the deterministic
+    // order without waiting for any element.
+    void FillReorderBuffer(IteratorContext* ctx)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      // Results of elements with pending positions go to those positions
+      // first, so `ConsumeHelper` only takes results that are not owed.
+      ResolvePendingResults();
+      while (static_cast<int64_t>(reorder_buffer_.size()) <=
+             reorder_window_) {
+        ReorderedResult next;
+        if (!ConsumeHelper(ctx, &next.result, &next.element_id)) {
+          // The element at this position is still producing its result.
+          next.element_id = current_elements_[cycle_index_]->id;
+          AdvancePosition();
+        } else if (!next.result) {
+          break;
+        }
+        next.position = num_results_consumed_++;
+        reorder_buffer_.push_back(std::move(next));
+      }
+    }
+
+    // Moves the results that elements produced into their pending positions
+    // in `reorder_buffer_`, oldest first. Drops the pending positions of
+    // elements that finished without producing a result for them.
+    void ResolvePendingResults() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      for (auto it = reorder_buffer_.begin(); it != reorder_buffer_.end();) {
+        if (it->result) {
+          ++it;
+          continue;
+        }
+        std::shared_ptr<Element> element = FindCurrentElement(it->element_id);
+        if (element && !element->results.empty()) {
+          it->result = std::move(element->results.front());
+          element->results.pop_front();
+          if (!element->active) {
+            elements_to_process_.push_back(element->cycle_index);
+            current_workers_cond_var_.notify_one();
+          }
+          ++it;
+        } else if (!element || (element->initialized && !element->iterator)) {
+          it = reorder_buffer_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    // Returns the index in `reorder_buffer_` of the result to return next, or
+    // -1 if no result can be returned yet.
+    int64_t ChooseReordered() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      const ReorderedResult& oldest = reorder_buffer_.front();
+      if (num_results_returned_ - oldest.position >= reorder_window_) {
+        return oldest.result ? 0 : -1;
+      }
+      std::vector<int64_t> candidates;
+      absl::flat_hash_set<int64_t> element_ids;
+      for (size_t i = 0; i < reorder_buffer_.size(); ++i) {
+        if (element_ids.insert(reorder_buffer_[i].element_id).second &&
+            reorder_buffer_[i].result) {
+          candidates.push_back(i);
+        }
+      }
+      if (candidates.empty()) {
+        return -1;
+      }
+      return candidates[Random() % candidates.size()];
+    }
+
+    // Returns the element with the given id in the current cycle, or nullptr
+    // if there is none.
+    std::shared_ptr<Element> FindCurrentElement(int64_t id)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      for (const std::shared_ptr<Element>& element : current_elements_) {
+        if (element && element->id == id) {
+          return element;
+        }
+      }
+      return nullptr;
+    }
+
+    uint32_t Random() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      ++num_random_samples_;
+      return generator_();
+    }
+
+    void ResetRngs() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      // Reset the generators based on the current iterator seeds.
+      parent_generator_ = random::PhiloxRandom(dataset()->reorder_seed_, 0);
+      generator_ =
+          random::SingleSampleAdapter<random::PhiloxRandom>(&parent_generator_);
+      generator_.Skip(num_random_samples_);
+    }
+
     // Consumes a result (if available), returning an indication of whether
     // a result is available. If `true` is returned, `result` either
     // points to a valid result or is null if end of input has been reached.
-    bool Consume(IteratorContext* ctx, std::shared_ptr<Result>* result)
-        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    bool Consume(IteratorContext* ctx, std::shared_ptr<Result>* result,
+                 int64_t* element_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       if (deterministic_) {
-        return ConsumeHelper(ctx, result);
+        return ConsumeHelper(ctx, result, element_id);
       }
       // If we are allowed to be nondeterministic (i.e. return results out of
       // order), try to find an element in the cycle that has a result
       // available.
       for (int i = 0; i < dataset()->cycle_length_; ++i) {
-        if (ConsumeHelper(ctx, result)) {
+        if (ConsumeHelper(ctx, result, element_id)) {
           return true;
         }
         AdvanceToNextInCycle();
@@ -784,8 +962,8 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
     // Consumes a result (if available), returning an indication of whether
     // a result is available. If `true` is returned, `result` either
     // points to a valid result or is null if end of input has been reached.
-    bool ConsumeHelper(IteratorContext* ctx, std::shared_ptr<Result>* result)
-        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    bool ConsumeHelper(IteratorContext* ctx, std::shared_ptr<Result>* result,
+                       int64_t* element_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       while (true) {
         if (last_valid_current_element_ == -1) {
           // Reached end of input.
@@ -808,6 +986,9 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
           // We found a result.
           std::swap(*result, element->results.front());
           element->results.pop_front();
+          if (element_id != nullptr) {
+            *element_id = element->id;
+          }
           if (!element->active) {
             elements_to_process_.push_back(cycle_index_);
             current_workers_cond_var_.notify_one();
@@ -1194,7 +1375,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
 
     void NotifyElementUpdate(Element& element)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-      if (deterministic_) {
+      if (deterministic_ && reorder_window_ == 0) {
         element.cond_var.notify_one();
       } else {
         any_element_available_cond_var_.notify_one();
@@ -1412,6 +1593,97 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       return absl::OkStatus();
     }
 
+    absl::Status WriteReorderBuffer(IteratorStateWriter* writer)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kNumResultsConsumed,
+                                             num_results_consumed_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kNumResultsReturned,
+                                             num_results_returned_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kNumRandomSamples,
+                                             num_random_samples_));
+      TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kReorderBufferSize,
+                                             reorder_buffer_.size()));
+      const std::string key_prefix =
+          absl::StrCat(prefix(), "::", kReorderBuffer);
+      for (size_t i = 0; i < reorder_buffer_.size(); ++i) {
+        const ReorderedResult& reordered = reorder_buffer_[i];
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            key_prefix,
+            absl::StrCat(kResultsSuffix, "[", i, "]", kPositionSuffix),
+            reordered.position));
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            key_prefix, absl::StrCat(kResultsSuffix, "[", i, "]", kIdSuffix),
+            reordered.element_id));
+        if (!reordered.result) {
+          continue;
+        }
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            key_prefix,
+            absl::StrCat(kResultsSuffix, "[", i, "]", kIsReadySuffix), ""));
+        TF_RETURN_IF_ERROR(WriteStatusLocked(writer, key_prefix, i,
+                                             reordered.result->status));
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            key_prefix, absl::StrCat(kResultsSuffix, "[", i, "]", kSizeSuffix),
+            reordered.result->return_values.size()));
+        for (size_t j = 0; j < reordered.result->return_values.size(); j++) {
+          TF_RETURN_IF_ERROR(writer->WriteTensor(
+              key_prefix, absl::StrCat(kResultsSuffix, "[", i, "][", j, "]"),
+              reordered.result->return_values[j]));
+        }
+      }
+      return absl::OkStatus();
+    }
+
+    absl::Status ReadReorderBuffer(IteratorContext* ctx,
+                                   IteratorStateReader* reader)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kNumResultsConsumed,
+                                            &num_results_consumed_));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kNumResultsReturned,
+                                            &num_results_returned_));
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kNumRandomSamples,
+                                            &num_random_samples_));
+      int64_t reorder_buffer_size;
+      TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kReorderBufferSize,
+                                            &reorder_buffer_size));
+      const std::string key_prefix =
+          absl::StrCat(prefix(), "::", kReorderBuffer);
+      reorder_buffer_.clear();
+      for (size_t i = 0; i < reorder_buffer_size; ++i) {
+        ReorderedResult reordered;
+        TF_RETURN_IF_ERROR(reader->ReadScalar(
+            key_prefix,
+            absl::StrCat(kResultsSuffix, "[", i, "]", kPositionSuffix),
+            &reordered.position));
+        TF_RETURN_IF_ERROR(reader->ReadScalar(
+            key_prefix, absl::StrCat(kResultsSuffix, "[", i, "]", kIdSuffix),
+            &reordered.element_id));
+        if (!reader->Contains(
+                key_prefix,
+                absl::StrCat(kResultsSuffix, "[", i, "]", kIsReadySuffix))) {
+          reorder_buffer_.push_back(std::move(reordered));
+          continue;
+        }
+        reordered.result = std::make_shared<Result>(ctx);
+        TF_RETURN_IF_ERROR(ReadStatusLocked(reader, key_prefix, i,
+                                            &reordered.result->status));
+        int64_t num_return_values;
+        TF_RETURN_IF_ERROR(reader->ReadScalar(
+            key_prefix, absl::StrCat(kResultsSuffix, "[", i, "]", kSizeSuffix),
+            &num_return_values));
+        reordered.result->return_values.reserve(num_return_values);
+        for (size_t j = 0; j < num_return_values; j++) {
+          reordered.result->return_values.emplace_back();
+          TF_RETURN_IF_ERROR(reader->ReadTensor(
+              ctx->flr(), key_prefix,
+              absl::StrCat(kResultsSuffix, "[", i, "][", j, "]"),
+              &reordered.result->return_values.back()));
+        }
+        reorder_buffer_.push_back(std::move(reordered));
+      }
+      return absl::OkStatus();
+    }
+
     absl::Status ReadElement(IteratorContext* ctx, IteratorStateReader* reader,
                              int idx, const std::string& key_prefix,
                              std::shared_ptr<Element>* out) {
@@ -1676,12 +1948,36 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
     int num_current_workers_ TF_GUARDED_BY(mu_) = 0;
 
     // Condition variable to signal that a result has been produced by some
-    // element thread. Only used when `deterministic` is false.
+    // element thread. Only used when `deterministic` is false or results are
+    // reordered.
     condition_variable any_element_available_cond_var_;
 
     // Determines whether outputs can be produced in deterministic order.
     const bool deterministic_;
 
+    // A position in the deterministic order whose result has not been
+    // returned yet, because results are reordered.
+    struct ReorderedResult {
+      // Position of the result in the deterministic order.
+      int64_t position = 0;
+      // Id of the element that produces the result.
+      int64_t element_id = -1;
+      // Null until the element has produced the result.
+      std::shared_ptr<Result> result;
+    };
+
+    // In deterministic mode, the number of positions by which a result may be
+    // moved from its place in the deterministic order. 0 disables reordering.
+    const int64_t reorder_window_;
+    std::deque<ReorderedResult> reorder_buffer_ TF_GUARDED_BY(mu_);
+    int64_t num_results_consumed_ TF_GUARDED_BY(mu_) = 0;
+    int64_t num_results_returned_ TF_GUARDED_BY(mu_) = 0;
+    // Generators of the reordering, seeded with the `reorder_seed` attr.
+    random::PhiloxRandom parent_generator_ TF_GUARDED_BY(mu_);
+    random::SingleSampleAdapter<random::PhiloxRandom> generator_
+        TF_GUARDED_BY(mu_);
+    int64_t num_random_samples_ TF_GUARDED_BY(mu_) = 0;
+
     // Controls cancellation of `input_impl_`. Must be ordered before
     // `input_impl_` so that `input_impl_` is destroyed first.
     std::unique_ptr<CancellationManager> cancellation_manager_;
@@ -1757,6 +2053,8 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
   const int64_t prefetch_input_elements_;
   const int64_t num_parallel_calls_;
   const DeterminismPolicy deterministic_;
+  const int64_t reorder_window_;
+  const int64_t reorder_seed_;
   const DataTypeVector output_types_;
   const std::vector<PartialTensorShape> output_shapes_;
   const int op_version_;
@@ -1787,6 +2085,13 @@ ParallelInterleaveDatasetOp::ParallelInterleaveDatasetOp(
     OP_REQUIRES_OK(
         ctx, DeterminismPolicy::FromString(deterministic, &deterministic_));
   }
+  if (ctx->HasAttr(kReorderWindow)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kReorderWindow, &reorder_window_));
+    OP_REQUIRES(ctx, reorder_window_ >= 0,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "`reorder_window` must be >= 0 but is ", reorder_window_)));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kReorderSeed, &reorder_seed_));
+  }
 }
 
 void ParallelInterleaveDatasetOp::MakeDataset(OpKernelContext* ctx,
@@ -1856,7 +2161,8 @@ void ParallelInterleaveDatasetOp::MakeDataset(OpKernelContext* ctx,
   *output = new Dataset(
       ctx, input, std::move(captured_func), cycle_length, block_length,
       buffer_output_elements, prefetch_input_elements, num_parallel_calls,
-      deterministic_, output_types_, output_shapes_, op_version_);
+      deterministic_, reorder_window_, reorder_seed_, output_types_,
+      output_shapes_, op_version_);
 }
 
 namespace {
@@ -15,6 +15,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_DATA_PARALLEL_INTERLEAVE_DATASET_OP_H_
 #define TENSORFLOW_CORE_KERNELS_DATA_PARALLEL_INTERLEAVE_DATASET_OP_H_
 
+#include <cstdint>
+
 #include "tensorflow/core/data/captured_function.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -40,6 +42,8 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
   static constexpr const char* const kOutputShapes = "output_shapes";
   static constexpr const char* const kDeterministic = "deterministic";
   static constexpr const char* const kSloppy = "sloppy";
+  static constexpr const char* const kReorderWindow = "reorder_window";
+  static constexpr const char* const kReorderSeed = "reorder_seed";
 
   explicit ParallelInterleaveDatasetOp(OpKernelConstruction* ctx);
 
@@ -54,6 +58,8 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
   DataTypeVector output_types_;
   std::vector<PartialTensorShape> output_shapes_;
   DeterminismPolicy deterministic_;
+  int64_t reorder_window_ = 0;
+  int64_t reorder_seed_ = 0;
 };
 
 }  // namespace data
@@ -12,8 +12,13 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/parallel_interleave_dataset_op.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
+#include <numeric>
+#include <vector>
 
+#include "absl/strings/str_cat.h"
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/graph/graph_def_builder.h"
 
@@ -36,7 +41,8 @@ class ParallelInterleaveDatasetParams : public DatasetParams {
       std::vector<FunctionDef> func_lib, DataTypeVector type_arguments,
       const DataTypeVector& output_dtypes,
       const std::vector<PartialTensorShape>& output_shapes,
-      const std::string& deterministic, const std::string& node_name)
+      const std::string& deterministic, const std::string& node_name,
+      int64_t reorder_window = 0, int64_t reorder_seed = 0)
       : DatasetParams(std::move(output_dtypes), std::move(output_shapes),
                       std::move(node_name)),
         other_arguments_(std::move(other_arguments)),
@@ -48,7 +54,9 @@ class ParallelInterleaveDatasetParams : public DatasetParams {
         func_(std::move(func)),
         func_lib_(std::move(func_lib)),
         type_arguments_(std::move(type_arguments)),
-        deterministic_(deterministic) {
+        deterministic_(deterministic),
+        reorder_window_(reorder_window),
+        reorder_seed_(reorder_seed) {
     input_dataset_params_.push_back(std::make_unique<T>(input_dataset_params));
     op_version_ = kOpVersion;
     name_utils::IteratorPrefixParams params;
@@ -96,7 +104,9 @@ class ParallelInterleaveDatasetParams : public DatasetParams {
                     {"Targuments", type_arguments_},
                     {"output_shapes", output_shapes_},
                     {"output_types", output_dtypes_},
-                    {"metadata", ""}};
+                    {"metadata", ""},
+                    {"reorder_window", reorder_window_},
+                    {"reorder_seed", reorder_seed_}};
     return absl::OkStatus();
   }
 
@@ -117,6 +127,8 @@ class ParallelInterleaveDatasetParams : public DatasetParams {
   std::vector<FunctionDef> func_lib_;
   DataTypeVector type_arguments_;
   std::string deterministic_;
+  int64_t reorder_window_;
+  int64_t reorder_seed_;
 };
 
 class ParallelInterleaveDatasetOpTest : public DatasetOpsTestBase {};
@@ -730,6 +742,101 @@ TEST_F(ParallelInterleaveDatasetOpTest, InputCycleLengthPreservedInGraphDef) {
   unsetenv("TF_DATA_EXPERIMENT_OPT_IN");
 }
 
+constexpr int64_t kReorderWindow = 2;
+constexpr int64_t kReorderNumInputs = 4;
+constexpr int64_t kReorderInputSize = 4;
+
+// Interleaves `kReorderNumInputs` inputs of `kReorderInputSize` elements each,
+// where the value of the element at `index` in `input` is
+// `input * kReorderInputSize + index`.
+ParallelInterleaveDatasetParams ReorderWindowParams(int64_t reorder_window,
+                                                    int64_t reorder_seed) {
+  std::vector<int64_t> values(kReorderNumInputs * kReorderInputSize);
+  std::iota(values.begin(), values.end(), 0);
+  auto tensor_slice_dataset_params = TensorSliceDatasetParams(
+      /*components=*/{CreateTensor<int64_t>(
+          TensorShape{kReorderNumInputs, kReorderInputSize, 1}, values)},
+      /*node_name=*/"tensor_slice");
+  return ParallelInterleaveDatasetParams(
+      tensor_slice_dataset_params,
+      /*other_arguments=*/{},
+      /*cycle_length=*/kReorderNumInputs,
+      /*block_length=*/1,
+      /*buffer_output_elements=*/1,
+      /*prefetch_input_elements=*/0,
+      /*num_parallel_calls=*/kReorderNumInputs,
+      /*func=*/
+      MakeTensorSliceDatasetFunc(
+          DataTypeVector({DT_INT64}),
+          std::vector<PartialTensorShape>({PartialTensorShape({1})})),
+      /*func_lib=*/{test::function::MakeTensorSliceDataset()},
+      /*type_arguments=*/{},
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({1})},
+      /*deterministic=*/DeterminismPolicy::kDeterministic,
+      /*node_name=*/kNodeName,
+      /*reorder_window=*/reorder_window,
+      /*reorder_seed=*/reorder_seed);
+}
+
+// Reads `iterator` to the end.
+absl::Status ReadToEnd(IteratorBase* iterator, IteratorContext* ctx,
+                       std::vector<Tensor>* out_tensors) {
+  bool end_of_sequence = false;
+  while (!end_of_sequence) {
+    std::vector<Tensor> next;
+    TF_RETURN_IF_ERROR(iterator->GetNext(ctx, &next, &end_of_sequence));
+    out_tensors->insert(out_tensors->end(), next.begin(), next.end());
+  }
+  return absl::OkStatus();
+}
+
+TEST_F(ParallelInterleaveDatasetOpTest, ReorderWindow) {
+  TF_ASSERT_OK(Initialize(ReorderWindowParams(kReorderWindow,
+                                              /*reorder_seed=*/42)));
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(ReadToEnd(iterator_.get(), iterator_ctx_.get(), &outputs));
+  ASSERT_EQ(outputs.size(), kReorderNumInputs * kReorderInputSize);
+
+  std::vector<int64_t> next_in_input(kReorderNumInputs, 0);
+  for (int64_t position = 0; position < kReorderNumInputs * kReorderInputSize;
+       ++position) {
+    const int64_t value = outputs[position].flat<int64_t>()(0);
+    const int64_t input = value / kReorderInputSize;
+    const int64_t index = value % kReorderInputSize;
+    // The elements of each input are produced in order.
+    EXPECT_EQ(index, next_in_input[input]++);
+    // Each element is produced at most `kReorderWindow` positions away from
+    // its position in the deterministic order.
+    const int64_t deterministic_position = index * kReorderNumInputs + input;
+    EXPECT_LE(std::abs(deterministic_position - position), kReorderWindow);
+  }
+}
+
+TEST_F(ParallelInterleaveDatasetOpTest, ReorderWindowSaveAndRestore) {
+  auto dataset_params = ReorderWindowParams(kReorderWindow,
+                                            /*reorder_seed=*/42);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  std::vector<Tensor> expected_outputs;
+  TF_ASSERT_OK(
+      ReadToEnd(iterator_.get(), iterator_ctx_.get(), &expected_outputs));
+
+  TF_ASSERT_OK(Initialize(dataset_params));
+  // Which results are ready first depends on timing, so the order may differ
+  // between runs.
+  TF_EXPECT_OK(CheckIteratorSaveAndRestore(dataset_params.iterator_prefix(),
+                                           expected_outputs,
+                                           /*breakpoints=*/{0, 3, 7, 20},
+                                           /*compare_order=*/false));
+}
+
+TEST_F(ParallelInterleaveDatasetOpTest, InvalidReorderWindow) {
+  EXPECT_EQ(Initialize(ReorderWindowParams(/*reorder_window=*/-1,
+                                           /*reorder_seed=*/0))
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
 TEST_F(ParallelInterleaveDatasetOpTest, DatasetNodeName) {
   auto dataset_params = ParallelInterleaveDatasetParams1();
   TF_ASSERT_OK(Initialize(dataset_params));
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/range_dataset_op.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -121,6 +122,18 @@ class RangeCounter {
     return result;
   }
 
+  // Advances the counter past the next `num_values` values, stopping at the
+  // end of the counter.
+  void Skip(int64_t num_values) {
+    mutex_lock l(mu_);
+    int64_t remaining = RangeCardinality(next_, stop_, step_);
+    if (remaining == kInfiniteCardinality) {
+      next_ += num_values * step_;
+      return;
+    }
+    next_ += std::min(num_values, remaining) * step_;
+  }
+
   int64_t Peek() const {
     mutex_lock l(mu_);
     return next_;
@@ -165,6 +178,11 @@ class RangeDatasetOp::RangeSplitProvider : public SplitProvider {
     return absl::OkStatus();
   }
 
+  absl::Status Skip(int64_t num_splits) override {
+    counter_.Skip(num_splits);
+    return absl::OkStatus();
+  }
+
   absl::Status Reset() override {
     counter_.Reset();
     return absl::OkStatus();
@@ -31,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/data/shuffle_spill_buffer.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -85,7 +86,39 @@ constexpr char kShuffleAndRepeatDatasetV1[] = "ShuffleAndRepeatDataset";
 constexpr char kShuffleAndRepeatDatasetV2[] = "ShuffleAndRepeatDatasetV2";
 
 ShuffleDatasetOpBase::ShuffleDatasetOpBase(OpKernelConstruction* ctx)
-    : UnaryDatasetOpKernel(ctx) {}
+    : UnaryDatasetOpKernel(ctx) {
+  if (ctx->HasAttr(kSpillDirectory)) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kSpillDirectory, &spill_directory_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr(kSpillMemoryBytes, &spill_memory_bytes_));
+    OP_REQUIRES(ctx, spill_directory_.empty() || spill_memory_bytes_ > 0,
+                absl::InvalidArgumentError(absl::StrCat(
+                    kSpillMemoryBytes, " must be greater than zero, but got ",
+                    spill_memory_bytes_, ".")));
+  }
+}
+
+absl::Status ShuffleDatasetOpBase::CheckSpillable(const DatasetBase* input,
+                                                  int64_t buffer_size) const {
+  if (spill_directory_.empty()) {
+    return absl::OkStatus();
+  }
+  if (buffer_size == kUnknownCardinality) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("A shuffle buffer of unknown size cannot be spilled to ",
+                     spill_directory_, "."));
+  }
+  // Spilled elements are serialized as `TensorProto`s, which cannot hold
+  // variant or resource tensors.
+  for (DataType dtype : input->output_dtypes()) {
+    if (dtype == DT_VARIANT || dtype == DT_RESOURCE) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "A shuffle buffer of ", DataTypeString(dtype),
+          " elements cannot be spilled to disk. Clear ", kSpillDirectory,
+          " to shuffle this dataset in memory."));
+    }
+  }
+  return absl::OkStatus();
+}
 
 // Abstract base dataset that implements a shuffling iterator.
 class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
@@ -93,12 +126,15 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
   ShuffleDatasetBase(OpKernelContext* ctx, const DatasetBase* input,
                      int64_t buffer_size,
                      std::shared_ptr<SeedGenerator> seed_generator,
-                     int64_t count)
+                     int64_t count, std::string spill_directory = "",
+                     int64_t spill_memory_bytes = 0)
       : DatasetBase(DatasetContext(ctx)),
         input_(input),
         buffer_size_(buffer_size),
         seed_generator_(std::move(seed_generator)),
         count_(count),
+        spill_directory_(std::move(spill_directory)),
+        spill_memory_bytes_(spill_memory_bytes),
         traceme_metadata_(
             {{"buffer_size",
               absl::StrFormat("%lld", static_cast<long long>(buffer_size))}}) {
@@ -195,7 +231,8 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
           seed_generator_(seed_generator),
           parent_generator_(seed_generator->seed(), seed_generator->seed2()),
           generator_(&parent_generator_) {
-      if (params.dataset->buffer_size_ == kUnknownCardinality) {
+      if (params.dataset->buffer_size_ == kUnknownCardinality ||
+          !params.dataset->spill_directory_.empty()) {
         buffer_ = std::make_unique<std::vector<std::vector<Tensor>>>();
       } else {
         buffer_ = std::make_unique<std::vector<std::vector<Tensor>>>(
@@ -209,6 +246,10 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       mutex_lock l(mu_);
       seed_generator_->GenerateSeeds(&seed_, &seed2_);
       ResetRngs();
+      if (IsSpilling()) {
+        TF_RETURN_IF_ERROR(
+            ctx->env()->RecursivelyCreateDir(dataset()->spill_directory_));
+      }
       // Initialize checkpoint_indices_ to the entire buffer.
       if (ctx->symbolic_checkpoint()) {
         for (int64_t i = 0; i < buffer_->size(); ++i) {
@@ -232,6 +273,14 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       *end_of_sequence = false;
       ClearEmptySlices();
       DCHECK(!slices_.empty());
+      if (IsSpilling()) {
+        TF_RETURN_IF_ERROR(spill_buffers_.front()->Take(
+            [this]() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) { return Random(); },
+            out_tensors));
+        slices_.front()->start++;
+        num_elements_--;
+        return absl::OkStatus();
+      }
       // Choose an element to produce uniformly at random from the first
       // slice, and then remove the element from the slice.
       int64_t offset =
@@ -266,6 +315,9 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
     absl::Status SaveInternal(SerializationContext* ctx,
                               IteratorStateWriter* writer) override {
       mutex_lock l(mu_);
+      if (IsSpilling()) {
+        return SpillCheckpointError();
+      }
       // Save state needed to restore the random number generators.
       TF_RETURN_IF_ERROR(
           writer->WriteScalar(prefix(), kEpochNumRandomSamples,
@@ -326,6 +378,9 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
     absl::Status RestoreInternal(IteratorContext* ctx,
                                  IteratorStateReader* reader) override {
       mutex_lock l(mu_);
+      if (IsSpilling()) {
+        return SpillCheckpointError();
+      }
       // Restore the random number generators.
       int64_t num_random_samples;
       TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kEpochNumRandomSamples,
@@ -453,6 +508,17 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       return dataset()->buffer_size_ == kUnknownCardinality;
     }
 
+    // Returns if the buffered elements are held in `spill_buffers_` rather
+    // than `buffer_`.
+    bool IsSpilling() const { return !dataset()->spill_directory_.empty(); }
+
+    absl::Status SpillCheckpointError() const {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "Checkpointing a shuffle buffer that spills to disk is not "
+          "supported. Clear ",
+          kSpillDirectory, " to checkpoint this iterator."));
+    }
+
     // Fills the shuffle buffer, preparing the buffer for sampling.
     absl::Status FillBuffer(IteratorContext* ctx)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -478,7 +544,11 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
           slices_.back()->reached_end_of_sequence = true;
         }
         if (!end_of_input_sequence) {
-          AddToShuffleBuffer(ctx, std::move(input_element));
+          if (IsSpilling()) {
+            TF_RETURN_IF_ERROR(AddToSpillBuffer(std::move(input_element)));
+          } else {
+            AddToShuffleBuffer(ctx, std::move(input_element));
+          }
           continue;
         }
         input_impl_.reset();
@@ -515,6 +585,9 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
         // we need to add to the buffer.
         return true;
       }
+      if (IsSpilling()) {
+        return num_elements_ < dataset()->buffer_size_;
+      }
       return num_elements_ < buffer_->size();
     }
 
@@ -529,6 +602,11 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
           TF_RETURN_IF_ERROR(provider->Reset());
         }
       }
+      if (IsSpilling()) {
+        spill_buffers_.push_back(std::make_unique<ShuffleSpillBuffer>(
+            ctx->env(), dataset()->spill_directory_,
+            dataset()->output_dtypes().size()));
+      }
       TF_RETURN_IF_ERROR(this->dataset()->input_->MakeIterator(
           ctx, this, this->prefix(), &input_impl_));
       epoch_++;
@@ -556,10 +634,37 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       slices_.back()->end++;
     }
 
+    // Adds `element` to the spill buffer of the current epoch. While the
+    // elements held in memory exceed the memory budget, spills the buffers of
+    // the most recent epochs first.
+    absl::Status AddToSpillBuffer(std::vector<Tensor>&& element)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      data_produced_ = true;
+      spill_buffers_.back()->Add(std::move(element));
+      num_elements_++;
+      slices_.back()->end++;
+      int64_t resident_bytes = 0;
+      for (const auto& spill_buffer : spill_buffers_) {
+        resident_bytes += spill_buffer->resident_bytes();
+      }
+      for (auto it = spill_buffers_.rbegin();
+           it != spill_buffers_.rend() &&
+           resident_bytes > dataset()->spill_memory_bytes_;
+           ++it) {
+        resident_bytes -= (*it)->resident_bytes();
+        TF_RETURN_IF_ERROR((*it)->Spill(
+            [this]() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) { return Random(); }));
+      }
+      return absl::OkStatus();
+    }
+
     void ClearEmptySlices() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       // Garbage collect all empty slices.
       while (slices_.front()->start == slices_.front()->end) {
         slices_.pop_front();
+        if (IsSpilling()) {
+          spill_buffers_.pop_front();
+        }
         // Reinitialize the RNG state for the next epoch.
         num_random_samples_ = 0;
         seed_generator_->GenerateSeeds(&seed_, &seed2_);
@@ -589,6 +694,10 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
     // buffered epoch. It is an invariant that all slices reference
     // non-overlapping sections of `buffer_`.
     std::deque<std::unique_ptr<Slice>> slices_ TF_GUARDED_BY(mu_);
+    // When spilling, holds the elements of the corresponding slices of
+    // `slices_` instead of `buffer_`.
+    std::deque<std::unique_ptr<ShuffleSpillBuffer>> spill_buffers_
+        TF_GUARDED_BY(mu_);
     random::PhiloxRandom parent_generator_ TF_GUARDED_BY(mu_);
     random::SingleSampleAdapter<random::PhiloxRandom> generator_
         TF_GUARDED_BY(mu_);
@@ -603,6 +712,10 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
   // fuse shuffle and repeat together, and make the shuffle dataset op
   // responsible for repeating as well.
   const int64_t count_;
+  // If not empty, iterators keep at most `spill_memory_bytes_` of buffered
+  // elements in memory and spill the rest to files in this directory.
+  const std::string spill_directory_;
+  const int64_t spill_memory_bytes_;
   const TraceMeMetadata traceme_metadata_;
   mutable mutex mu_;
   mutable std::vector<std::int64_t> shuffled_indices_ TF_GUARDED_BY(mu_);
@@ -728,8 +841,10 @@ class ShuffleDatasetOp::DatasetV3 : public ShuffleDatasetBase {
  public:
   DatasetV3(OpKernelContext* ctx, const DatasetBase* input, int64_t buffer_size,
             int64_t count, RandomSeeds&& seeds, SeedGeneratorManager* manager,
-            ResourceHandle&& resource_handle, bool owns_resource)
-      : ShuffleDatasetBase(ctx, input, buffer_size, manager->get(), count),
+            ResourceHandle&& resource_handle, bool owns_resource,
+            std::string spill_directory, int64_t spill_memory_bytes)
+      : ShuffleDatasetBase(ctx, input, buffer_size, manager->get(), count,
+                           std::move(spill_directory), spill_memory_bytes),
         manager_(manager),
         owns_resource_(owns_resource),
         resource_handle_(std::move(resource_handle)),
@@ -768,13 +883,18 @@ class ShuffleDatasetOp::DatasetV3 : public ShuffleDatasetBase {
     AttrValue reshuffle_each_iteration;
     b->BuildAttrValue(seed_generator_->reshuffle_each_iteration(),
                       &reshuffle_each_iteration);
-    TF_RETURN_IF_ERROR(
-        b->AddDataset(this,
-                      {input_graph_node, buffer_size_node, seed_node,
-                       seed2_node, resource_handle_node},  // Inputs
-                      {std::make_pair(kReshuffleEachIteration,
-                                      reshuffle_each_iteration)},  // Attrs
-                      output));
+    AttrValue spill_directory;
+    b->BuildAttrValue(spill_directory_, &spill_directory);
+    AttrValue spill_memory_bytes;
+    b->BuildAttrValue(spill_memory_bytes_, &spill_memory_bytes);
+    TF_RETURN_IF_ERROR(b->AddDataset(
+        this,
+        {input_graph_node, buffer_size_node, seed_node, seed2_node,
+         resource_handle_node},  // Inputs
+        {std::make_pair(kReshuffleEachIteration, reshuffle_each_iteration),
+         std::make_pair(kSpillDirectory, spill_directory),
+         std::make_pair(kSpillMemoryBytes, spill_memory_bytes)},  // Attrs
+        output));
     return absl::OkStatus();
   }
 
@@ -811,6 +931,7 @@ void ShuffleDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
       ctx, buffer_size > 0 || buffer_size == kUnknownCardinality,
       absl::InvalidArgumentError(
           "buffer_size must be greater than zero or UNKNOWN_CARDINALITY"));
+  OP_REQUIRES_OK(ctx, CheckSpillable(input, buffer_size));
 
   int64_t count = 1;
   static std::atomic<int64_t> resource_id_counter(0);
@@ -852,9 +973,10 @@ void ShuffleDatasetOp::MakeDataset(OpKernelContext* ctx, DatasetBase* input,
     }
 
     // Ownership of manager is transferred onto `DatasetV3`.
-    *output = new ShuffleDatasetOp::DatasetV3(ctx, input, buffer_size, count,
-                                              std::move(seeds), manager,
-                                              std::move(handle), owns_resource);
+    *output = new ShuffleDatasetOp::DatasetV3(
+        ctx, input, buffer_size, count, std::move(seeds), manager,
+        std::move(handle), owns_resource, spill_directory_,
+        spill_memory_bytes_);
   } else if (op_version_ == 2) {
     ResourceHandle handle;
     OP_REQUIRES_OK(ctx, HandleFromInput(ctx, 2, &handle));
@@ -980,8 +1102,10 @@ class ShuffleAndRepeatDatasetOp::DatasetV2 : public ShuffleDatasetBase {
  public:
   DatasetV2(OpKernelContext* ctx, const DatasetBase* input, int64_t buffer_size,
             int64_t count, RandomSeeds&& seeds, SeedGeneratorManager* manager,
-            ResourceHandle&& resource_handle, bool owns_resource)
-      : ShuffleDatasetBase(ctx, input, buffer_size, manager->get(), count),
+            ResourceHandle&& resource_handle, bool owns_resource,
+            std::string spill_directory, int64_t spill_memory_bytes)
+      : ShuffleDatasetBase(ctx, input, buffer_size, manager->get(), count,
+                           std::move(spill_directory), spill_memory_bytes),
         manager_(manager),
         owns_resource_(owns_resource),
         resource_handle_(std::move(resource_handle)),
@@ -1022,13 +1146,18 @@ class ShuffleAndRepeatDatasetOp::DatasetV2 : public ShuffleDatasetBase {
     AttrValue reshuffle_each_iteration;
     b->BuildAttrValue(seed_generator_->reshuffle_each_iteration(),
                       &reshuffle_each_iteration);
-    TF_RETURN_IF_ERROR(
-        b->AddDataset(this,
-                      {input_graph_node, buffer_size_node, seed_node,
-                       seed2_node, count_node, resource_handle_node},  // Inputs
-                      {std::make_pair(kReshuffleEachIteration,
-                                      reshuffle_each_iteration)},  // Attrs
-                      output));
+    AttrValue spill_directory;
+    b->BuildAttrValue(spill_directory_, &spill_directory);
+    AttrValue spill_memory_bytes;
+    b->BuildAttrValue(spill_memory_bytes_, &spill_memory_bytes);
+    TF_RETURN_IF_ERROR(b->AddDataset(
+        this,
+        {input_graph_node, buffer_size_node, seed_node, seed2_node, count_node,
+         resource_handle_node},  // Inputs
+        {std::make_pair(kReshuffleEachIteration, reshuffle_each_iteration),
+         std::make_pair(kSpillDirectory, spill_directory),
+         std::make_pair(kSpillMemoryBytes, spill_memory_bytes)},  // Attrs
+        output));
     return absl::OkStatus();
   }
 
@@ -1064,6 +1193,7 @@ void ShuffleAndRepeatDatasetOp::MakeDataset(OpKernelContext* ctx,
       ctx, buffer_size > 0 || buffer_size == kUnknownCardinality,
       absl::InvalidArgumentError(
           "buffer_size must be greater than zero or UNKNOWN_CARDINALITY"));
+  OP_REQUIRES_OK(ctx, CheckSpillable(input, buffer_size));
 
   int64_t seed;
   OP_REQUIRES_OK(ctx, ParseScalarArgument<int64_t>(ctx, kSeed, &seed));
@@ -1116,7 +1246,8 @@ void ShuffleAndRepeatDatasetOp::MakeDataset(OpKernelContext* ctx,
     // Ownership of manager is transferred onto `DatasetV2`.
     *output = new ShuffleAndRepeatDatasetOp::DatasetV2(
         ctx, input, buffer_size, count, std::move(seeds), manager,
-        std::move(handle), owns_resource);
+        std::move(handle), owns_resource, spill_directory_,
+        spill_memory_bytes_);
   } else {
     if (op_version_ != 1) {
       LOG(WARNING) << "Unsupported version of shuffle dataset op: "
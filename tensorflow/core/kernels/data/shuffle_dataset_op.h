@@ -15,6 +15,10 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_DATA_SHUFFLE_DATASET_OP_H_
 #define TENSORFLOW_CORE_KERNELS_DATA_SHUFFLE_DATASET_OP_H_
 
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"
 #include "tensorflow/core/framework/dataset.h"
 
 namespace tensorflow {
@@ -30,11 +34,23 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
   static constexpr const char* const kOutputShapes = "output_shapes";
   static constexpr const char* const kReshuffleEachIteration =
       "reshuffle_each_iteration";
+  static constexpr const char* const kSpillDirectory = "spill_directory";
+  static constexpr const char* const kSpillMemoryBytes = "spill_memory_bytes";
 
   explicit ShuffleDatasetOpBase(OpKernelConstruction* ctx);
 
  protected:
   class ShuffleDatasetBase;
+
+  // Returns an error if the elements of `input` cannot be spilled to disk
+  // when `spill_directory_` is set.
+  absl::Status CheckSpillable(const DatasetBase* input,
+                              int64_t buffer_size) const;
+
+  // If not empty, iterators keep at most `spill_memory_bytes_` of buffered
+  // elements in memory and spill the rest to files in this directory.
+  std::string spill_directory_;
+  int64_t spill_memory_bytes_ = 0;
 };
 
 class ShuffleDatasetOp : public ShuffleDatasetOpBase {
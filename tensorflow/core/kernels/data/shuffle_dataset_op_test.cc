@@ -11,12 +11,17 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/shuffle_dataset_op.h"
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/framework/resource_handle.h"
+#include "tensorflow/core/platform/path.h"
 
 namespace tensorflow {
 namespace data {
@@ -595,6 +600,161 @@ TEST_F(ShuffleDatasetOpTest, InvalidArguments) {
   }
 }
 
+// Parameters for `ShuffleAndRepeatDatasetV2`, the shuffle op version that
+// can spill its buffer to disk.
+class SpillingShuffleAndRepeatDatasetParams : public DatasetParams {
+ public:
+  template <typename T>
+  SpillingShuffleAndRepeatDatasetParams(T input_dataset_params,
+                                        int64_t buffer_size, int64_t count,
+                                        std::string spill_directory,
+                                        int64_t spill_memory_bytes)
+      : DatasetParams(input_dataset_params.output_dtypes(),
+                      input_dataset_params.output_shapes(),
+                      kShuffleAndRepeatNodeName),
+        buffer_size_(buffer_size),
+        count_(count),
+        spill_directory_(std::move(spill_directory)),
+        spill_memory_bytes_(spill_memory_bytes) {
+    input_dataset_params_.push_back(std::make_unique<T>(input_dataset_params));
+    op_version_ = 2;
+    iterator_prefix_ =
+        name_utils::IteratorPrefix(input_dataset_params.dataset_type(),
+                                   input_dataset_params.iterator_prefix());
+  }
+
+  std::vector<Tensor> GetInputTensors() const override {
+    // A handle to a seed generator that does not exist, so the dataset
+    // creates its own.
+    Tensor seed_generator(DT_RESOURCE, TensorShape({}));
+    seed_generator.scalar<ResourceHandle>()() = ResourceHandle();
+    return {CreateTensor<int64_t>(TensorShape({}), {buffer_size_}),
+            CreateTensor<int64_t>(TensorShape({}), {1}),
+            CreateTensor<int64_t>(TensorShape({}), {2}),
+            CreateTensor<int64_t>(TensorShape({}), {count_}), seed_generator};
+  }
+
+  absl::Status GetInputNames(
+      std::vector<std::string>* input_names) const override {
+    *input_names = {ShuffleDatasetOpBase::kInputDataset,
+                    ShuffleDatasetOpBase::kBufferSize,
+                    ShuffleDatasetOpBase::kSeed,
+                    ShuffleDatasetOpBase::kSeed2,
+                    ShuffleAndRepeatDatasetOp::kCount,
+                    "seed_generator"};
+    return absl::OkStatus();
+  }
+
+  absl::Status GetAttributes(AttributeVector* attr_vector) const override {
+    *attr_vector = {
+        {"output_types", output_dtypes_},
+        {"output_shapes", output_shapes_},
+        {"reshuffle_each_iteration", true},
+        {"metadata", ""},
+        {ShuffleDatasetOpBase::kSpillDirectory, spill_directory_},
+        {ShuffleDatasetOpBase::kSpillMemoryBytes, spill_memory_bytes_}};
+    return absl::OkStatus();
+  }
+
+  std::string dataset_type() const override {
+    return ShuffleAndRepeatDatasetOp::kDatasetType;
+  }
+
+ private:
+  int64_t buffer_size_;
+  int64_t count_;
+  std::string spill_directory_;
+  int64_t spill_memory_bytes_;
+};
+
+std::string SpillDirectory() {
+  return io::JoinPath(
+      testing::TmpDir(),
+      ::testing::UnitTest::GetInstance()->current_test_info()->name());
+}
+
+// Spills once the buffer holds more than two int64 scalars in memory.
+SpillingShuffleAndRepeatDatasetParams SpillingDatasetParams() {
+  return SpillingShuffleAndRepeatDatasetParams(
+      RangeDatasetParams(0, 100, 1), /*buffer_size=*/50, /*count=*/2,
+      SpillDirectory(), /*spill_memory_bytes=*/16);
+}
+
+TEST_F(ShuffleDatasetOpTest, SpillToDisk) {
+  TF_ASSERT_OK(Initialize(SpillingDatasetParams()));
+
+  std::vector<int64_t> expected;
+  for (int epoch = 0; epoch < 2; ++epoch) {
+    for (int64_t i = 0; i < 100; ++i) {
+      expected.push_back(i);
+    }
+  }
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  std::vector<Tensor> next;
+  TF_ASSERT_OK(
+      iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+  out_tensors.insert(out_tensors.end(), next.begin(), next.end());
+  // The buffer holds 50 elements, but only 2 of them in memory.
+  std::vector<std::string> files;
+  TF_ASSERT_OK(Env::Default()->GetChildren(SpillDirectory(), &files));
+  EXPECT_FALSE(files.empty());
+
+  while (!end_of_sequence) {
+    TF_ASSERT_OK(
+        iterator_->GetNext(iterator_ctx_.get(), &next, &end_of_sequence));
+    out_tensors.insert(out_tensors.end(), next.begin(), next.end());
+  }
+  TF_EXPECT_OK(ExpectEqual(out_tensors,
+                           CreateTensors<int64_t>(TensorShape({}), {expected}),
+                           /*compare_order=*/false));
+  // Spill files are deleted once they have been read.
+  TF_ASSERT_OK(Env::Default()->GetChildren(SpillDirectory(), &files));
+  EXPECT_TRUE(files.empty());
+}
+
+TEST_F(ShuffleDatasetOpTest, SpillToDiskDoesNotSupportCheckpointing) {
+  TF_ASSERT_OK(Initialize(SpillingDatasetParams()));
+  std::unique_ptr<SerializationContext> serialization_ctx;
+  TF_ASSERT_OK(CreateSerializationContext(&serialization_ctx));
+  VariantTensorDataWriter writer;
+  EXPECT_EQ(iterator_->Save(serialization_ctx.get(), &writer).code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+// Shuffle datasets that do not set a spill directory are unaffected by the
+// spilling of other datasets in the same process.
+TEST_F(ShuffleDatasetOpTest, SpillDirectoryIsPerDataset) {
+  TF_ASSERT_OK(Initialize(SpillingShuffleAndRepeatDatasetParams(
+      RangeDatasetParams(0, 100, 1), /*buffer_size=*/50, /*count=*/2,
+      /*spill_directory=*/"", /*spill_memory_bytes=*/16)));
+  std::unique_ptr<SerializationContext> serialization_ctx;
+  TF_ASSERT_OK(CreateSerializationContext(&serialization_ctx));
+  VariantTensorDataWriter writer;
+  TF_EXPECT_OK(iterator_->Save(serialization_ctx.get(), &writer));
+}
+
+TEST_F(ShuffleDatasetOpTest, SpillMemoryBytesMustBePositive) {
+  EXPECT_EQ(Initialize(SpillingShuffleAndRepeatDatasetParams(
+                           RangeDatasetParams(0, 100, 1), /*buffer_size=*/50,
+                           /*count=*/2, SpillDirectory(),
+                           /*spill_memory_bytes=*/0))
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(ShuffleDatasetOpTest, SpillToDiskRejectsVariantElements) {
+  auto variant_dataset_params = TensorSliceDatasetParams(
+      /*components=*/{Tensor(DT_VARIANT, TensorShape({4}))},
+      /*node_name=*/"tensor_slice_dataset");
+  EXPECT_EQ(Initialize(SpillingShuffleAndRepeatDatasetParams(
+                           std::move(variant_dataset_params),
+                           /*buffer_size=*/2, /*count=*/1, SpillDirectory(),
+                           /*spill_memory_bytes=*/16))
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -15,6 +15,10 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/utils.h"
@@ -23,13 +27,19 @@ limitations under the License.
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tf_data_file_logger_options.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/tstring.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tsl/profiler/lib/traceme.h"
 
 namespace tensorflow {
@@ -53,6 +63,7 @@ constexpr int64_t kUnspecifiedBufferSize = -1;
 constexpr int64_t kDefaultBufferSize = 256LL << 10;  // 256KB
 constexpr int64_t kCloudTpuBlockSize = 127LL << 20;  // 127MB.
 constexpr int64_t kS3BlockSize = kCloudTpuBlockSize;
+constexpr char kUseMmapEnvVar[] = "TF_DATA_TFRECORD_USE_MMAP";
 
 bool is_cloud_tpu_gcs_fs() {
 #if defined(LIBTPU_ON_GCE)
@@ -64,18 +75,34 @@ bool is_cloud_tpu_gcs_fs() {
 #endif
 }
 
+// Returns whether uncompressed files on file systems that support memory
+// mapping should be read through a mapping, whose bytes the output records
+// then alias instead of copying them.
+bool UseMemoryMappedReads() {
+  bool use_mmap = false;
+  absl::Status s = ReadBoolFromEnvVar(kUseMmapEnvVar, false, &use_mmap);
+  if (!s.ok()) {
+    LOG(WARNING) << "Ignoring " << kUseMmapEnvVar << ": " << s;
+    return false;
+  }
+  return use_mmap;
+}
+
 class TFRecordDatasetOp::Dataset : public DatasetBase {
  public:
   explicit Dataset(OpKernelContext* ctx, std::vector<std::string> filenames,
                    const std::string& compression_type, int64_t buffer_size,
-                   std::vector<int64_t> byte_offsets, int op_version)
+                   std::vector<int64_t> byte_offsets, int op_version,
+                   bool use_mmap)
       : DatasetBase(DatasetContext(ctx)),
         filenames_(std::move(filenames)),
         compression_type_(compression_type),
         options_(io::RecordReaderOptions::CreateRecordReaderOptions(
             compression_type)),
         byte_offsets_(std::move(byte_offsets)),
-        op_version_(op_version) {
+        op_version_(op_version),
+        use_mmap_(use_mmap && options_.compression_type ==
+                                  io::RecordReaderOptions::NONE) {
     if (buffer_size > 0) {
       options_.buffer_size = buffer_size;
     }
@@ -153,11 +180,11 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       mutex_lock l(mu_);
       do {
         // We are currently processing a file, so try to read the next record.
-        if (reader_) {
+        if (reader_ || mapped_file_) {
           out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
                                     TensorShape({}));
           absl::Status s =
-              reader_->ReadRecord(&out_tensors->back().scalar<tstring>()());
+              ReadRecordLocked(&out_tensors->back().scalar<tstring>()());
           if (s.ok()) {
             static monitoring::CounterCell* bytes_counter =
                 metrics::GetTFDataBytesReadCounter(kDatasetType);
@@ -200,10 +227,10 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       do {
         // We are currently processing a file, so try to skip reading
         // the next (num_to_skip - *num_skipped) record.
-        if (reader_) {
+        if (reader_ || mapped_file_) {
           int last_num_skipped;
-          absl::Status s = reader_->SkipRecords(num_to_skip - *num_skipped,
-                                                &last_num_skipped);
+          absl::Status s = SkipRecordsLocked(num_to_skip - *num_skipped,
+                                             &last_num_skipped);
           *num_skipped += last_num_skipped;
           if (s.ok()) {
             *end_of_sequence = false;
@@ -246,9 +273,10 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kCurrentFileIndex,
                                              current_file_index_));
 
-      if (reader_) {
-        TF_RETURN_IF_ERROR(
-            writer->WriteScalar(prefix(), kOffset, reader_->TellOffset()));
+      if (reader_ || mapped_file_) {
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            prefix(), kOffset,
+            mapped_file_ ? mapped_offset_ : reader_->TellOffset()));
       }
       return absl::OkStatus();
     }
@@ -265,7 +293,7 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
         int64_t offset;
         TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kOffset, &offset));
         TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
-        TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+        TF_RETURN_IF_ERROR(SeekOffsetLocked(offset));
       }
       return absl::OkStatus();
     }
@@ -288,14 +316,28 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
           },
           tsl::profiler::kInfo);
 
-      TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
-          TranslateFileName(dataset()->filenames_[current_file_index_]),
-          &file_));
-      reader_ = std::make_unique<io::SequentialRecordReader>(
-          file_.get(), dataset()->options_);
+      const std::string filename =
+          TranslateFileName(dataset()->filenames_[current_file_index_]);
+      if (dataset()->use_mmap_) {
+        std::unique_ptr<ReadOnlyMemoryRegion> region;
+        absl::Status s =
+            env->NewReadOnlyMemoryRegionFromFile(filename, &region);
+        if (s.ok()) {
+          mapped_file_.reset(new MappedFile(std::move(region)));
+          mapped_offset_ = 0;
+        } else {
+          // E.g. remote or empty files, which cannot be mapped.
+          VLOG(2) << "Reading " << filename << " without mmap: " << s;
+        }
+      }
+      if (!mapped_file_) {
+        TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file_));
+        reader_ = std::make_unique<io::SequentialRecordReader>(
+            file_.get(), dataset()->options_);
+      }
       if (!dataset()->byte_offsets_.empty()) {
         TF_RETURN_IF_ERROR(
-            reader_->SeekOffset(dataset()->byte_offsets_[current_file_index_]));
+            SeekOffsetLocked(dataset()->byte_offsets_[current_file_index_]));
       }
       return absl::OkStatus();
     }
@@ -304,8 +346,97 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       reader_.reset();
       file_.reset();
+      mapped_file_.reset();
+      mapped_offset_ = 0;
     }
 
+    absl::Status ReadRecordLocked(tstring* record)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (!mapped_file_) {
+        return reader_->ReadRecord(record);
+      }
+      absl::string_view data;
+      TF_RETURN_IF_ERROR(NextMappedRecordLocked(/*verify_data=*/true, &data));
+      // The record aliases the mapping, which stays alive as long as any
+      // string refers to it, even after the iterator moved on.
+      record->assign_as_shared_view(data, mapped_file_.get());
+      return absl::OkStatus();
+    }
+
+    absl::Status SkipRecordsLocked(int num_to_skip, int* num_skipped)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (!mapped_file_) {
+        return reader_->SkipRecords(num_to_skip, num_skipped);
+      }
+      *num_skipped = 0;
+      for (; *num_skipped < num_to_skip; ++*num_skipped) {
+        absl::string_view unused;
+        // Like io::RecordReader::SkipRecords(), only checks the headers.
+        TF_RETURN_IF_ERROR(
+            NextMappedRecordLocked(/*verify_data=*/false, &unused));
+      }
+      return absl::OkStatus();
+    }
+
+    absl::Status SeekOffsetLocked(int64_t offset)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (!mapped_file_) {
+        return reader_->SeekOffset(offset);
+      }
+      if (offset < 0) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Invalid offset ", offset));
+      }
+      mapped_offset_ = offset;
+      return absl::OkStatus();
+    }
+
+    // Returns the data of the record at `mapped_offset_` in `mapped_file_` and
+    // advances past it, with the same checks and errors as io::RecordReader.
+    absl::Status NextMappedRecordLocked(bool verify_data,
+                                        absl::string_view* data)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      constexpr uint64_t kHeaderSize = io::RecordReader::kHeaderSize;
+      constexpr uint64_t kFooterSize = io::RecordReader::kFooterSize;
+      const ReadOnlyMemoryRegion& region = *mapped_file_->value();
+      const char* const base = static_cast<const char*>(region.data());
+      const uint64_t size = region.length();
+      const uint64_t offset = mapped_offset_;
+      if (offset >= size) {
+        return absl::OutOfRangeError(absl::StrCat("eof at ", offset));
+      }
+      if (size - offset < kHeaderSize) {
+        return absl::DataLossError(
+            absl::StrCat("truncated record at ", offset));
+      }
+      const uint64_t length = core::DecodeFixed64(base + offset);
+      const uint32_t length_crc =
+          core::DecodeFixed32(base + offset + sizeof(uint64_t));
+      if (crc32c::Unmask(length_crc) !=
+          crc32c::Value(base + offset, sizeof(uint64_t))) {
+        return absl::DataLossError(
+            absl::StrCat("corrupted record at ", offset));
+      }
+      const uint64_t remaining = size - offset - kHeaderSize;
+      if (remaining < kFooterSize || length > remaining - kFooterSize) {
+        return absl::DataLossError(
+            absl::StrCat("truncated record at ", offset));
+      }
+      const char* const record = base + offset + kHeaderSize;
+      if (verify_data &&
+          crc32c::Unmask(core::DecodeFixed32(record + length)) !=
+              crc32c::Value(record, length)) {
+        return absl::DataLossError(
+            absl::StrCat("corrupted record at ", offset));
+      }
+      *data = absl::string_view(record, length);
+      mapped_offset_ = offset + kHeaderSize + length + kFooterSize;
+      return absl::OkStatus();
+    }
+
+    // A memory mapped file, shared by the iterator and the records it returned.
+    using MappedFile = tstring::owner<std::unique_ptr<ReadOnlyMemoryRegion>>;
+
     mutex mu_;
     size_t current_file_index_ TF_GUARDED_BY(mu_) = 0;
 
@@ -313,6 +444,10 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     // we must destroy `reader_` before `file_`.
     std::unique_ptr<RandomAccessFile> file_ TF_GUARDED_BY(mu_);
     std::unique_ptr<io::SequentialRecordReader> reader_ TF_GUARDED_BY(mu_);
+
+    // Set instead of `file_` and `reader_` when the file is memory mapped.
+    core::RefCountPtr<MappedFile> mapped_file_ TF_GUARDED_BY(mu_);
+    uint64_t mapped_offset_ TF_GUARDED_BY(mu_) = 0;
   };
 
   const std::vector<std::string> filenames_;
@@ -320,6 +455,7 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
   io::RecordReaderOptions options_;
   const std::vector<int64_t> byte_offsets_;
   const int op_version_;
+  const bool use_mmap_;
 };
 
 TFRecordDatasetOp::TFRecordDatasetOp(OpKernelConstruction* ctx)
@@ -402,7 +538,8 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
   }
 
   *output = new Dataset(ctx, std::move(filenames), compression_type,
-                        buffer_size, std::move(byte_offsets), op_version_);
+                        buffer_size, std::move(byte_offsets), op_version_,
+                        UseMemoryMappedReads());
 }
 
 namespace {
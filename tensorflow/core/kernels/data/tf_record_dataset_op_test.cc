@@ -12,6 +12,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
 #include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <string>
 #include <utility>
@@ -379,6 +380,93 @@ IteratorSaveAndRestoreTestCases() {
 ITERATOR_SAVE_AND_RESTORE_TEST_P(TFRecordDatasetOpTest, TFRecordDatasetParams,
                                  IteratorSaveAndRestoreTestCases())
 
+// Reads uncompressed files through memory mappings while alive.
+class ScopedMmapReads {
+ public:
+  ScopedMmapReads() { setenv("TF_DATA_TFRECORD_USE_MMAP", "true", 1); }
+  ~ScopedMmapReads() { unsetenv("TF_DATA_TFRECORD_USE_MMAP"); }
+};
+
+TEST_F(TFRecordDatasetOpTest, MmapGetNext) {
+  ScopedMmapReads mmap_reads;
+  auto dataset_params = TFRecordDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckIteratorGetNext(
+      CreateTensors<tstring>(
+          TensorShape({}), {{"1"}, {"22"}, {"333"}, {"a"}, {"bb"}, {"ccc"}}),
+      /*compare_order=*/true));
+}
+
+TEST_F(TFRecordDatasetOpTest, MmapByteOffsetsAndSkip) {
+  ScopedMmapReads mmap_reads;
+  auto dataset_params = TFRecordDatasetParams4();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  bool end_of_sequence = false;
+  int num_skipped = 0;
+  TF_ASSERT_OK(iterator_->Skip(iterator_ctx_.get(), /*num_to_skip=*/2,
+                               &end_of_sequence, &num_skipped));
+  EXPECT_EQ(num_skipped, 2);
+  TF_ASSERT_OK(CheckIteratorGetNext(
+      CreateTensors<tstring>(TensorShape({}),
+                             {{"333"}, {"bb"}, {"ccc"}, {"zzz"}}),
+      /*compare_order=*/true));
+}
+
+TEST_F(TFRecordDatasetOpTest, MmapRecordsOutliveIterator) {
+  ScopedMmapReads mmap_reads;
+  auto dataset_params = TFRecordDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  std::vector<Tensor> records;
+  bool end_of_sequence = false;
+  while (!end_of_sequence) {
+    TF_ASSERT_OK(
+        iterator_->GetNext(iterator_ctx_.get(), &records, &end_of_sequence));
+  }
+  iterator_.reset();
+  ASSERT_EQ(records.size(), 6);
+  Tensor copy = records[5];
+  records.clear();
+  EXPECT_EQ(copy.scalar<tstring>()(), "ccc");
+}
+
+TEST_F(TFRecordDatasetOpTest, MmapSaveAndRestore) {
+  ScopedMmapReads mmap_reads;
+  auto dataset_params = TFRecordDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckIteratorSaveAndRestore(
+      dataset_params.iterator_prefix(),
+      CreateTensors<tstring>(
+          TensorShape({}), {{"1"}, {"22"}, {"333"}, {"a"}, {"bb"}, {"ccc"}}),
+      /*breakpoints=*/{0, 2, 7}, /*compare_order=*/true));
+}
+
+TEST_F(TFRecordDatasetOpTest, MmapTruncatedRecord) {
+  ScopedMmapReads mmap_reads;
+  const tstring filename =
+      absl::StrCat(testing::TmpDir(), "/tf_record_mmap_truncated");
+  TF_ASSERT_OK(CreateTestFiles({filename}, {{"1", "22", "333"}},
+                               CompressionType::UNCOMPRESSED));
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), filename, &contents));
+  contents.resize(contents.size() - 2);
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename, contents));
+
+  TFRecordDatasetParams dataset_params(
+      {filename}, CompressionType::UNCOMPRESSED, /*buffer_size=*/10,
+      /*byte_offsets=*/{}, kNodeName);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  std::vector<Tensor> records;
+  bool end_of_sequence = false;
+  for (int i = 0; i < 2; ++i) {
+    TF_ASSERT_OK(
+        iterator_->GetNext(iterator_ctx_.get(), &records, &end_of_sequence));
+  }
+  EXPECT_EQ(
+      iterator_->GetNext(iterator_ctx_.get(), &records, &end_of_sequence)
+          .code(),
+      absl::StatusCode::kDataLoss);
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
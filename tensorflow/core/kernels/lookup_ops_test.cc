@@ -15,16 +15,34 @@ limitations under the License.
 
 // Tests kernels of lookup ops.
 
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/fake_input.h"
 #include "tensorflow/core/framework/lookup_interface.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/shape_inference_testutil.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/graph_def_builder.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/kernels/lookup_table_op.h"
+#include "tensorflow/core/kernels/mapped_hash_table.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/status_matchers.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/protobuf/error_codes.pb.h"
 
 namespace tensorflow {
 namespace {
@@ -100,5 +118,326 @@ TEST_F(LookupOpsTest, AnonymousHashTable_RefCounting) {
   EXPECT_FALSE(alive);
 }
 
+TEST_F(LookupOpsTest, ShardedMutableHashTable_InsertFindRemove) {
+  TF_ASSERT_OK(NodeDefBuilder("table", "AnonymousMutableHashTable")
+                   .Attr("key_dtype", DT_INT64)
+                   .Attr("value_dtype", DT_INT64)
+                   .Attr("num_shards", 4)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  TF_ASSERT_OK(RunOpKernel());
+  auto table_or = GetOutput(0)
+                      ->scalar<ResourceHandle>()()
+                      .GetResource<lookup::LookupInterface>();
+  TF_ASSERT_OK(table_or.status());
+  lookup::LookupInterface* table = table_or.value();
+
+  const int64_t kNumKeys = 100;
+  Tensor keys(DT_INT64, TensorShape({kNumKeys}));
+  Tensor values(DT_INT64, TensorShape({kNumKeys}));
+  for (int64_t i = 0; i < kNumKeys; ++i) {
+    keys.flat<int64_t>()(i) = i;
+    values.flat<int64_t>()(i) = i * 10;
+  }
+  TF_ASSERT_OK(table->Insert(context_.get(), keys, values));
+  EXPECT_EQ(table->size(), kNumKeys);
+
+  // Duplicate keys within one batch resolve to the last value.
+  TF_ASSERT_OK(table->Insert(context_.get(),
+                             test::AsTensor<int64_t>({7, 7}, {2}),
+                             test::AsTensor<int64_t>({1, 2}, {2})));
+  TF_ASSERT_OK(table->Remove(context_.get(),
+                             test::AsTensor<int64_t>({3, 1000}, {2})));
+  EXPECT_EQ(table->size(), kNumKeys - 1);
+
+  Tensor found(DT_INT64, TensorShape({4}));
+  TF_ASSERT_OK(table->Find(context_.get(),
+                           test::AsTensor<int64_t>({0, 3, 7, 99}, {4}),
+                           &found, test::AsScalar<int64_t>(-1)));
+  test::ExpectTensorEqual<int64_t>(
+      found, test::AsTensor<int64_t>({0, -1, 2, 990}, {4}));
+}
+
+TEST_F(LookupOpsTest, MutableHashTable_AsGraphDefNumShards) {
+  for (int64_t num_shards : {1, 4}) {
+    TF_ASSERT_OK(NodeDefBuilder("table", "AnonymousMutableHashTable")
+                     .Attr("key_dtype", DT_INT64)
+                     .Attr("value_dtype", DT_INT64)
+                     .Attr("num_shards", num_shards)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+    TF_ASSERT_OK(RunOpKernel());
+    auto table_or = GetOutput(0)
+                        ->scalar<ResourceHandle>()()
+                        .GetResource<lookup::LookupInterface>();
+    TF_ASSERT_OK(table_or.status());
+
+    GraphDefBuilder builder(GraphDefBuilder::kFailImmediately);
+    Node* out = nullptr;
+    TF_ASSERT_OK(table_or.value()->AsGraphDef(&builder, &out));
+    GraphDef graph_def;
+    TF_ASSERT_OK(builder.ToGraphDef(&graph_def));
+    bool found_table = false;
+    for (const NodeDef& node : graph_def.node()) {
+      if (node.op() != "MutableHashTableV2") {
+        continue;
+      }
+      found_table = true;
+      // Unsharded tables leave `num_shards` to the op default, so that their
+      // graphs still load in binaries that predate the attr.
+      EXPECT_EQ(node.attr().count("num_shards") > 0, num_shards > 1);
+    }
+    EXPECT_TRUE(found_table);
+  }
+}
+
+TEST_F(LookupOpsTest, MutableDenseHashTable_LargeBatchFind) {
+  TF_ASSERT_OK(NodeDefBuilder("table", "AnonymousMutableDenseHashTable")
+                   .Input(FakeInput(DT_INT64))
+                   .Input(FakeInput(DT_INT64))
+                   .Attr("value_dtype", DT_INT64)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromArray<int64_t>(TensorShape({}), {-1});
+  AddInputFromArray<int64_t>(TensorShape({}), {-2});
+  TF_ASSERT_OK(RunOpKernel());
+  auto table_or = GetOutput(0)
+                      ->scalar<ResourceHandle>()()
+                      .GetResource<lookup::LookupInterface>();
+  TF_ASSERT_OK(table_or.status());
+  lookup::LookupInterface* table = table_or.value();
+
+  // Large enough to be split across the worker threads.
+  const int64_t kNumKeys = 1 << 15;
+  Tensor keys(DT_INT64, TensorShape({kNumKeys}));
+  Tensor values(DT_INT64, TensorShape({kNumKeys}));
+  for (int64_t i = 0; i < kNumKeys; ++i) {
+    keys.flat<int64_t>()(i) = 2 * i;
+    values.flat<int64_t>()(i) = i;
+  }
+  TF_ASSERT_OK(table->Insert(context_.get(), keys, values));
+
+  const int64_t kNumQueries = 2 * kNumKeys;
+  Tensor queries(DT_INT64, TensorShape({kNumQueries}));
+  for (int64_t i = 0; i < kNumQueries; ++i) {
+    queries.flat<int64_t>()(i) = i;
+  }
+  Tensor found(DT_INT64, TensorShape({kNumQueries}));
+  TF_ASSERT_OK(table->Find(context_.get(), queries, &found,
+                           test::AsScalar<int64_t>(-3)));
+  for (int64_t i = 0; i < kNumQueries; ++i) {
+    ASSERT_EQ(found.flat<int64_t>()(i), i % 2 == 0 ? i / 2 : -3) << i;
+  }
+
+  // Reserved keys are rejected from any shard of the batch.
+  queries.flat<int64_t>()(kNumQueries - 1) = -1;
+  EXPECT_FALSE(table->Find(context_.get(), queries, &found,
+                           test::AsScalar<int64_t>(-3))
+                   .ok());
+}
+
+class MappedHashTableOpTest : public OpsTestBase {
+ protected:
+  // Runs a MappedHashTable kernel over `filename` and returns its table in
+  // `table`, which the caller must unref. The table is shared by node name,
+  // so it outlives the kernel and later kernels can look up its handle.
+  absl::Status CreateTable(const std::string& filename, DataType key_dtype,
+                           DataType value_dtype,
+                           lookup::LookupInterface** table) {
+    TF_RETURN_IF_ERROR(NodeDefBuilder("table", "MappedHashTable")
+                           .Attr("filename", filename)
+                           .Attr("use_node_name_sharing", true)
+                           .Attr("key_dtype", key_dtype)
+                           .Attr("value_dtype", value_dtype)
+                           .Finalize(node_def()));
+    TF_RETURN_IF_ERROR(InitOp());
+    TF_RETURN_IF_ERROR(RunOpKernel());
+    return LookupResource(context_.get(),
+                          GetOutput(0)->scalar<ResourceHandle>()(), table);
+  }
+};
+
+TEST_F(MappedHashTableOpTest, Find) {
+  const std::string filename =
+      io::JoinPath(testing::TmpDir(), "mapped_hash_table_find");
+  TF_ASSERT_OK(lookup::WriteMappedHashTable(
+      Env::Default(), filename, test::AsTensor<tstring>({"a", "b", "c"}),
+      test::AsTensor<int64_t>({1, 2, 3})));
+  lookup::LookupInterface* table;
+  TF_ASSERT_OK(CreateTable(filename, DT_STRING, DT_INT64, &table));
+  core::ScopedUnref unref(table);
+  EXPECT_EQ(table->size(), 3);
+
+  const Tensor keys = test::AsTensor<tstring>({"c", "x", "a", "y"});
+  Tensor found(DT_INT64, TensorShape({4}));
+  TF_ASSERT_OK(table->Find(context_.get(), keys, &found,
+                           test::AsScalar<int64_t>(-1)));
+  test::ExpectTensorEqual<int64_t>(found,
+                                   test::AsTensor<int64_t>({3, -1, 1, -1}));
+
+  // A default value with the shape of the keys holds one default per key.
+  TF_ASSERT_OK(table->Find(context_.get(), keys, &found,
+                           test::AsTensor<int64_t>({10, 20, 30, 40})));
+  test::ExpectTensorEqual<int64_t>(found,
+                                   test::AsTensor<int64_t>({3, 20, 1, 40}));
+}
+
+TEST_F(MappedHashTableOpTest, Export) {
+  const std::string filename =
+      io::JoinPath(testing::TmpDir(), "mapped_hash_table_export");
+  TF_ASSERT_OK(lookup::WriteMappedHashTable(
+      Env::Default(), filename, test::AsTensor<int64_t>({5, 7, 9}),
+      test::AsTensor<float>({0.5, 0.7, 0.9})));
+  lookup::LookupInterface* table;
+  TF_ASSERT_OK(CreateTable(filename, DT_INT64, DT_FLOAT, &table));
+  core::ScopedUnref unref(table);
+
+  const ResourceHandle handle = GetOutput(0)->scalar<ResourceHandle>()();
+
+  TF_ASSERT_OK(NodeDefBuilder("export", "LookupTableExportV2")
+                   .Input(FakeInput(DT_RESOURCE))
+                   .Attr("Tkeys", DT_INT64)
+                   .Attr("Tvalues", DT_FLOAT)
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromArray<ResourceHandle>(TensorShape({}), {handle});
+  TF_ASSERT_OK(RunOpKernel());
+  const Tensor& keys = *GetOutput(0);
+  const Tensor& values = *GetOutput(1);
+  ASSERT_EQ(keys.NumElements(), 3);
+  absl::flat_hash_map<int64_t, float> exported;
+  for (int64_t i = 0; i < keys.NumElements(); ++i) {
+    exported[keys.flat<int64_t>()(i)] = values.flat<float>()(i);
+  }
+  const absl::flat_hash_map<int64_t, float> expected = {
+      {5, 0.5}, {7, 0.7}, {9, 0.9}};
+  EXPECT_EQ(exported, expected);
+}
+
+TEST_F(MappedHashTableOpTest, DtypeMismatch) {
+  const std::string filename =
+      io::JoinPath(testing::TmpDir(), "mapped_hash_table_dtype_mismatch");
+  TF_ASSERT_OK(lookup::WriteMappedHashTable(
+      Env::Default(), filename, test::AsTensor<int64_t>({1}),
+      test::AsTensor<float>({1.0})));
+  lookup::LookupInterface* table;
+  EXPECT_THAT(CreateTable(filename, DT_INT64, DT_INT64, &table),
+              absl_testing::StatusIs(error::INVALID_ARGUMENT));
+}
+
+TEST_F(MappedHashTableOpTest, ReadOnly) {
+  const std::string filename =
+      io::JoinPath(testing::TmpDir(), "mapped_hash_table_read_only");
+  TF_ASSERT_OK(lookup::WriteMappedHashTable(
+      Env::Default(), filename, test::AsTensor<int64_t>({1}),
+      test::AsTensor<int64_t>({2})));
+  lookup::LookupInterface* table;
+  TF_ASSERT_OK(CreateTable(filename, DT_INT64, DT_INT64, &table));
+  core::ScopedUnref unref(table);
+
+  const Tensor keys = test::AsTensor<int64_t>({3});
+  const Tensor values = test::AsTensor<int64_t>({4});
+  EXPECT_THAT(table->Insert(context_.get(), keys, values),
+              absl_testing::StatusIs(error::FAILED_PRECONDITION));
+  EXPECT_THAT(table->Remove(context_.get(), keys),
+              absl_testing::StatusIs(error::FAILED_PRECONDITION));
+  EXPECT_THAT(table->ImportValues(context_.get(), keys, values),
+              absl_testing::StatusIs(error::FAILED_PRECONDITION));
+  EXPECT_EQ(table->size(), 1);
+}
+
+TEST_F(LookupOpsTest, WriteMappedHashTable) {
+  const std::string filename =
+      io::JoinPath(testing::TmpDir(), "write_mapped_hash_table");
+  TF_ASSERT_OK(NodeDefBuilder("write", "WriteMappedHashTable")
+                   .Input(FakeInput(DT_STRING))
+                   .Input(FakeInput(DT_INT64))
+                   .Input(FakeInput(DT_DOUBLE))
+                   .Finalize(node_def()));
+  TF_ASSERT_OK(InitOp());
+  AddInputFromArray<tstring>(TensorShape({}), {filename});
+  AddInputFromArray<int64_t>(TensorShape({2}), {4, 8});
+  AddInputFromArray<double>(TensorShape({2}), {0.25, 0.125});
+  TF_ASSERT_OK(RunOpKernel());
+
+  std::unique_ptr<lookup::MappedHashTableFile> file;
+  TF_ASSERT_OK(
+      lookup::MappedHashTableFile::Open(Env::Default(), filename, &file));
+  EXPECT_EQ(file->key_dtype(), DT_INT64);
+  EXPECT_EQ(file->value_dtype(), DT_DOUBLE);
+  const lookup::MappedHashTableBucket* bucket = file->Find(int64_t{8});
+  ASSERT_NE(bucket, nullptr);
+  EXPECT_EQ(lookup::MappedHashTableFile::Value<double>(*bucket), 0.125);
+}
+
+// Builds a MutableHashTableV2 node sharing the table named "table" on the
+// benchmark device.
+static Node* MutableHashTable(Graph* g, int num_shards) {
+  Node* table;
+  TF_CHECK_OK(NodeBuilder(g->NewName("table"), "MutableHashTableV2")
+                  .Attr("shared_name", "table")
+                  .Attr("key_dtype", DT_INT64)
+                  .Attr("value_dtype", DT_INT64)
+                  .Attr("num_shards", num_shards)
+                  .Finalize(g, &table));
+  return table;
+}
+
+static Tensor Iota(int64_t size) {
+  Tensor t(DT_INT64, TensorShape({size}));
+  auto flat = t.flat<int64_t>();
+  for (int64_t i = 0; i < size; ++i) {
+    flat(i) = i * 7919;
+  }
+  return t;
+}
+
+// Runs `num_finds` independent LookupTableFindV2 ops against one table per
+// step, so the number of concurrent readers grows with `num_finds`.
+static void BM_MutableHashTableFind(::testing::benchmark::State& state) {
+  const int num_shards = state.range(0);
+  const int num_finds = state.range(1);
+  const int64_t kTableSize = 1 << 16;
+  const int64_t kBatchSize = 1 << 12;
+
+  Graph* init = new Graph(OpRegistry::Global());
+  {
+    Node* insert;
+    Tensor keys = Iota(kTableSize);
+    TF_CHECK_OK(NodeBuilder(init->NewName("insert"), "LookupTableInsertV2")
+                    .Input(MutableHashTable(init, num_shards))
+                    .Input(test::graph::Constant(init, keys))
+                    .Input(test::graph::Constant(init, keys))
+                    .Finalize(init, &insert));
+  }
+
+  Graph* g = new Graph(OpRegistry::Global());
+  Node* table = MutableHashTable(g, num_shards);
+  Node* keys = test::graph::Constant(g, Iota(kBatchSize));
+  Node* default_value = test::graph::Constant(g, test::AsScalar<int64_t>(-1));
+  for (int i = 0; i < num_finds; ++i) {
+    Node* find;
+    TF_CHECK_OK(NodeBuilder(g->NewName("find"), "LookupTableFindV2")
+                    .Input(table)
+                    .Input(keys)
+                    .Input(default_value)
+                    .Finalize(g, &find));
+  }
+
+  test::Benchmark("cpu", g, /*options=*/nullptr, init, nullptr, "",
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+  state.SetItemsProcessed(state.iterations() * num_finds * kBatchSize);
+}
+
+BENCHMARK(BM_MutableHashTableFind)
+    ->UseRealTime()
+    ->ArgPair(1, 1)
+    ->ArgPair(1, 4)
+    ->ArgPair(1, 16)
+    ->ArgPair(16, 1)
+    ->ArgPair(16, 4)
+    ->ArgPair(16, 16);
+
 }  // namespace
 }  // namespace tensorflow
@@ -15,9 +15,13 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
@@ -25,9 +29,12 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/variant.h"
 #include "tensorflow/core/kernels/initializable_lookup_table.h"
+#include "tensorflow/core/kernels/mapped_hash_table.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/prefetch.h"
 #include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace lookup {
@@ -37,11 +44,204 @@ std::string UniqueNodeName(const std::string& base) {
   return strings::StrCat(base, "/", counter.fetch_add(1), "/", random::New64());
 }
 
+namespace {
+
+template <typename T>
+inline uint64_t HashScalar(const T& key) {
+  return static_cast<uint64_t>(key);
+}
+
+inline uint64_t HashScalar(const tstring& key) { return Hash64(key); }
+
+// Unlike HashScalar, mixes the bits of integral keys so that dense or strided
+// id ranges spread evenly across shards.
+template <typename T>
+inline uint64_t ShardHash(const T& key) {
+  return Hash64(reinterpret_cast<const char*>(&key), sizeof(key));
+}
+
+inline uint64_t ShardHash(const tstring& key) { return Hash64(key); }
+
+// If the given shape is a scalar return {1} instead. Otherwise leave it alone.
+TensorShape MaybeVectorizeShape(const TensorShape& shape) {
+  if (shape.dims() == 0) {
+    return TensorShape({1});
+  }
+  return shape;
+}
+
+// Returns the value of the optional `num_shards` attr, or 1 for ops (such as
+// the legacy ref-typed tables) that do not define it.
+int64_t GetNumShardsAttr(OpKernel* kernel) {
+  int64_t num_shards = 1;
+  if (!TryGetNodeAttr(kernel->def(), "num_shards", &num_shards) ||
+      num_shards < 1) {
+    return 1;
+  }
+  return num_shards;
+}
+
+// Adds the `num_shards` attr to `opts` only for sharded tables, so that graphs
+// of unsharded tables still load in binaries that predate the attr.
+GraphDefBuilder::Options WithNumShardsAttr(const GraphDefBuilder::Options& opts,
+                                           int64_t num_shards) {
+  if (num_shards > 1) {
+    return opts.WithAttr("num_shards", num_shards);
+  }
+  return opts;
+}
+
+// An unordered_map split into independently locked shards. Keys are assigned
+// to shards by hash, so lookups and inserts that touch different shards do not
+// contend on the same mutex. With a single shard this behaves exactly like one
+// unordered_map guarded by one mutex.
+template <class K, class V>
+class ShardedHashMap {
+ public:
+  typedef std::unordered_map<K, V> Map;
+
+  explicit ShardedHashMap(int64_t num_shards) : shards_(num_shards) {}
+
+  int64_t num_shards() const { return shards_.size(); }
+
+  // Returns the index of the shard that owns `key`.
+  int64_t ShardIndex(const K& key) const {
+    return ShardHash(key) % shards_.size();
+  }
+
+  // Returns the number of entries. Each shard is locked separately, so the
+  // result is only a snapshot if the table is mutated concurrently.
+  size_t size() const {
+    size_t size = 0;
+    for (const Shard& shard : shards_) {
+      tf_shared_lock l(shard.mu);
+      size += shard.map.size();
+    }
+    return size;
+  }
+
+  // Calls `fn(map, i)` for each i in [0, num_keys), where `map` is the shard
+  // owning `key_at(i)`, locked in shared mode. Keys are grouped by shard so
+  // that each shard lock is acquired at most once per call.
+  template <typename KeyFn, typename Fn>
+  void ForEachKeyShared(int64_t num_keys, KeyFn key_at, Fn fn) const {
+    ForEachKey<tf_shared_lock>(shards_, num_keys, key_at, fn);
+  }
+
+  // Like ForEachKeyShared, but locks the shards in exclusive mode and passes a
+  // mutable map. Keys belonging to the same shard are visited in their input
+  // order, so the last of several duplicate keys in a batch wins.
+  template <typename KeyFn, typename Fn>
+  void ForEachKeyExclusive(int64_t num_keys, KeyFn key_at, Fn fn) {
+    ForEachKey<mutex_lock>(shards_, num_keys, key_at, fn);
+  }
+
+  // Holds every shard lock in shared mode, acquired in shard order, for
+  // operations that need a consistent view of the whole table.
+  class SharedLockAll {
+   public:
+    explicit SharedLockAll(const ShardedHashMap* map)
+        TF_NO_THREAD_SAFETY_ANALYSIS : map_(map) {
+      for (const Shard& shard : map_->shards_) shard.mu.lock_shared();
+    }
+    ~SharedLockAll() TF_NO_THREAD_SAFETY_ANALYSIS {
+      for (const Shard& shard : map_->shards_) shard.mu.unlock_shared();
+    }
+
+   private:
+    const ShardedHashMap* const map_;
+    SharedLockAll(const SharedLockAll&) = delete;
+    void operator=(const SharedLockAll&) = delete;
+  };
+
+  // Holds every shard lock in exclusive mode, acquired in shard order.
+  class ExclusiveLockAll {
+   public:
+    explicit ExclusiveLockAll(ShardedHashMap* map) TF_NO_THREAD_SAFETY_ANALYSIS
+        : map_(map) {
+      for (Shard& shard : map_->shards_) shard.mu.lock();
+    }
+    ~ExclusiveLockAll() TF_NO_THREAD_SAFETY_ANALYSIS {
+      for (Shard& shard : map_->shards_) shard.mu.unlock();
+    }
+
+   private:
+    ShardedHashMap* const map_;
+    ExclusiveLockAll(const ExclusiveLockAll&) = delete;
+    void operator=(const ExclusiveLockAll&) = delete;
+  };
+
+  // The accessors below require a SharedLockAll or ExclusiveLockAll to be
+  // held by the caller.
+  const Map& shard_map(int64_t i) const TF_NO_THREAD_SAFETY_ANALYSIS {
+    return shards_[i].map;
+  }
+  Map* mutable_shard_map(int64_t i) TF_NO_THREAD_SAFETY_ANALYSIS {
+    return &shards_[i].map;
+  }
+  size_t size_locked() const TF_NO_THREAD_SAFETY_ANALYSIS {
+    size_t size = 0;
+    for (const Shard& shard : shards_) size += shard.map.size();
+    return size;
+  }
+
+ private:
+  // Aligned so that the mutexes of neighbouring shards do not share a cache
+  // line.
+  struct alignas(64) Shard {
+    mutable mutex mu;
+    Map map TF_GUARDED_BY(mu);
+  };
+
+  template <typename Lock, typename Shards, typename KeyFn, typename Fn>
+  void ForEachKey(Shards& shards, int64_t num_keys, KeyFn key_at,
+                  Fn fn) const {
+    if (shards.size() == 1) {
+      Lock l(shards[0].mu);
+      for (int64_t i = 0; i < num_keys; ++i) {
+        fn(shards[0].map, i);
+      }
+      return;
+    }
+    // Counting sort of the key positions by shard. `offsets[s]` is the start
+    // of shard s's positions in `order`.
+    const int64_t num_shards = shards.size();
+    std::vector<int64_t> shard_of(num_keys);
+    std::vector<int64_t> offsets(num_shards + 1, 0);
+    for (int64_t i = 0; i < num_keys; ++i) {
+      shard_of[i] = ShardIndex(key_at(i));
+      ++offsets[shard_of[i] + 1];
+    }
+    for (int64_t s = 0; s < num_shards; ++s) {
+      offsets[s + 1] += offsets[s];
+    }
+    std::vector<int64_t> order(num_keys);
+    std::vector<int64_t> next(offsets.begin(), offsets.end() - 1);
+    for (int64_t i = 0; i < num_keys; ++i) {
+      order[next[shard_of[i]]++] = i;
+    }
+    for (int64_t s = 0; s < num_shards; ++s) {
+      if (offsets[s] == offsets[s + 1]) continue;
+      Lock l(shards[s].mu);
+      for (int64_t j = offsets[s]; j < offsets[s + 1]; ++j) {
+        fn(shards[s].map, order[j]);
+      }
+    }
+  }
+
+  std::vector<Shard> shards_;
+};
+
+}  // namespace
+
 // Lookup table that wraps an unordered_map, where the key and value data type
 // is specified. Each individual value must be a scalar. If vector values are
 // required, use MutableHashTableOfTensors.
 //
 // This table is mutable and thread safe - Insert can be called at any time.
+// If the op sets `num_shards` > 1 the map is split into that many
+// independently locked shards, so that concurrent Find and Insert calls from
+// different threads only contend when they touch the same shard.
 //
 // Sample use case:
 //
@@ -54,12 +254,10 @@ std::string UniqueNodeName(const std::string& base) {
 template <class K, class V>
 class MutableHashTableOfScalars final : public LookupInterface {
  public:
-  MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel) {}
+  MutableHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel)
+      : table_(GetNumShardsAttr(kernel)) {}
 
-  size_t size() const override {
-    tf_shared_lock l(mu_);
-    return table_.size();
-  }
+  size_t size() const override { return table_.size(); }
 
   absl::Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
                     const Tensor& default_value) override {
@@ -71,18 +269,19 @@ class MutableHashTableOfScalars final : public LookupInterface {
     int64_t default_total = default_flat.size();
     bool is_full_size_default = (total == default_total);
 
-    tf_shared_lock l(mu_);
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      // is_full_size_default is true:
-      //   Each key has an independent default value, key_values(i)
-      //   corresponding uses default_flat(i) as its default value.
-      //
-      // is_full_size_default is false:
-      //   All keys will share the default_flat(0) as default value.
-      value_values(i) = gtl::FindWithDefault(
-          table_, SubtleMustCopyIfIntegral(key_values(i)),
-          is_full_size_default ? default_flat(i) : default_flat(0));
-    }
+    table_.ForEachKeyShared(
+        key_values.size(), [&](int64_t i) { return key_values(i); },
+        [&](const typename Table::Map& map, int64_t i) {
+          // is_full_size_default is true:
+          //   Each key has an independent default value, key_values(i)
+          //   corresponding uses default_flat(i) as its default value.
+          //
+          // is_full_size_default is false:
+          //   All keys will share the default_flat(0) as default value.
+          value_values(i) = gtl::FindWithDefault(
+              map, SubtleMustCopyIfIntegral(key_values(i)),
+              is_full_size_default ? default_flat(i) : default_flat(0));
+        });
 
     return absl::OkStatus();
   }
@@ -91,14 +290,24 @@ class MutableHashTableOfScalars final : public LookupInterface {
     const auto key_values = keys.flat<K>();
     const auto value_values = values.flat<V>();
 
-    mutex_lock l(mu_);
     if (clear) {
-      table_.clear();
-    }
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          SubtleMustCopyIfIntegral(value_values(i)));
+      typename Table::ExclusiveLockAll l(&table_);
+      for (int64_t s = 0; s < table_.num_shards(); ++s) {
+        table_.mutable_shard_map(s)->clear();
+      }
+      for (int64_t i = 0; i < key_values.size(); ++i) {
+        const K key = SubtleMustCopyIfIntegral(key_values(i));
+        gtl::InsertOrUpdate(table_.mutable_shard_map(table_.ShardIndex(key)),
+                            key, SubtleMustCopyIfIntegral(value_values(i)));
+      }
+      return absl::OkStatus();
     }
+    table_.ForEachKeyExclusive(
+        key_values.size(), [&](int64_t i) { return key_values(i); },
+        [&](typename Table::Map& map, int64_t i) {
+          gtl::InsertOrUpdate(&map, SubtleMustCopyIfIntegral(key_values(i)),
+                              SubtleMustCopyIfIntegral(value_values(i)));
+        });
     return absl::OkStatus();
   }
 
@@ -110,10 +319,11 @@ class MutableHashTableOfScalars final : public LookupInterface {
   absl::Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
     const auto key_values = keys.flat<K>();
 
-    mutex_lock l(mu_);
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
-    }
+    table_.ForEachKeyExclusive(
+        key_values.size(), [&](int64_t i) { return key_values(i); },
+        [&](typename Table::Map& map, int64_t i) {
+          map.erase(SubtleMustCopyIfIntegral(key_values(i)));
+        });
     return absl::OkStatus();
   }
 
@@ -123,8 +333,8 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
   absl::Status ExportValues(OpKernelContext* ctx) override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    typename Table::SharedLockAll l(&table_);
+    int64_t size = table_.size_locked();
 
     Tensor* keys;
     Tensor* values;
@@ -146,21 +356,24 @@ class MutableHashTableOfScalars final : public LookupInterface {
 
   int64_t MemoryUsed() const override {
     int64_t ret = 0;
-    tf_shared_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
+    typename Table::SharedLockAll l(&table_);
+    for (int64_t s = 0; s < table_.num_shards(); ++s) {
+      const auto& map = table_.shard_map(s);
+      for (unsigned i = 0; i < map.bucket_count(); ++i) {
+        size_t bucket_size = map.bucket_size(i);
+        if (bucket_size == 0) {
+          ret++;
+        } else {
+          ret += bucket_size;
+        }
       }
     }
     return sizeof(MutableHashTableOfScalars) + ret;
   }
 
   absl::Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    typename Table::SharedLockAll l(&table_);
+    int64_t size = table_.size_locked();
     Tensor keys(key_dtype(), TensorShape({size}));
     Tensor values(value_dtype(), TensorShape({size}));
     ExportKeysAndValues(&keys, &values);
@@ -173,11 +386,13 @@ class MutableHashTableOfScalars final : public LookupInterface {
     // earlier when appropriate.
     Node* table = ops::SourceOp(
         "MutableHashTableV2",
-        builder->opts()
-            .WithName(UniqueNodeName("MutableHashTableFromGraphDef"))
-            .WithAttr("use_node_name_sharing", true)
-            .WithAttr("key_dtype", key_dtype())
-            .WithAttr("value_dtype", value_dtype()));
+        WithNumShardsAttr(
+            builder->opts()
+                .WithName(UniqueNodeName("MutableHashTableFromGraphDef"))
+                .WithAttr("use_node_name_sharing", true)
+                .WithAttr("key_dtype", key_dtype())
+                .WithAttr("value_dtype", value_dtype()),
+            table_.num_shards()));
     Node* keys_node = ops::SourceOp(
         "Const",
         builder->opts().WithAttr("dtype", key_dtype()).WithAttr("value", keys));
@@ -196,21 +411,25 @@ class MutableHashTableOfScalars final : public LookupInterface {
   }
 
  private:
+  typedef ShardedHashMap<K, V> Table;
+
   // Writes all keys and values into `keys` and `values`. `keys` and `values`
-  // must point to tensors of size `table_.size()`.
-  void ExportKeysAndValues(Tensor* keys, Tensor* values) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) {
+  // must point to tensors of size `table_.size_locked()`. Requires all shards
+  // to be locked.
+  void ExportKeysAndValues(Tensor* keys, Tensor* values) const {
     auto keys_data = keys->flat<K>();
     auto values_data = values->flat<V>();
     int64_t i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      keys_data(i) = it->first;
-      values_data(i) = it->second;
+    for (int64_t s = 0; s < table_.num_shards(); ++s) {
+      const auto& map = table_.shard_map(s);
+      for (auto it = map.begin(); it != map.end(); ++it, ++i) {
+        keys_data(i) = it->first;
+        values_data(i) = it->second;
+      }
     }
   }
 
-  mutable mutex mu_;
-  std::unordered_map<K, V> table_ TF_GUARDED_BY(mu_);
+  Table table_;
 };
 
 // Lookup table that wraps an unordered_map. Behaves identical to
@@ -218,7 +437,8 @@ class MutableHashTableOfScalars final : public LookupInterface {
 template <class K, class V>
 class MutableHashTableOfTensors final : public LookupInterface {
  public:
-  MutableHashTableOfTensors(OpKernelContext* ctx, OpKernel* kernel) {
+  MutableHashTableOfTensors(OpKernelContext* ctx, OpKernel* kernel)
+      : table_(GetNumShardsAttr(kernel)) {
     OP_REQUIRES_OK(ctx,
                    GetNodeAttr(kernel->def(), "value_shape", &value_shape_));
     OP_REQUIRES(ctx, TensorShapeUtils::IsVector(value_shape_),
@@ -227,10 +447,7 @@ class MutableHashTableOfTensors final : public LookupInterface {
                                  value_shape_.DebugString())));
   }
 
-  size_t size() const override {
-    tf_shared_lock l(mu_);
-    return table_.size();
-  }
+  size_t size() const override { return table_.size(); }
 
   absl::Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
                     const Tensor& default_value) override {
@@ -243,27 +460,28 @@ class MutableHashTableOfTensors final : public LookupInterface {
     int64_t default_total = default_flat.size();
     bool is_full_size_default = (total == default_total);
 
-    tf_shared_lock l(mu_);
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      ValueArray* value_vec =
-          gtl::FindOrNull(table_, SubtleMustCopyIfIntegral(key_values(i)));
-      if (value_vec != nullptr) {
-        for (int64_t j = 0; j < value_dim; j++) {
-          value_values(i, j) = value_vec->at(j);
-        }
-      } else {
-        // is_full_size_default is true:
-        //   Each key has an independent default value, key_values(i)
-        //   corresponding uses default_flat(i) as its default value.
-        //
-        // is_full_size_default is false:
-        //   All keys will share the default_flat(0) as default value.
-        for (int64_t j = 0; j < value_dim; j++) {
-          value_values(i, j) =
-              is_full_size_default ? default_flat(i, j) : default_flat(0, j);
-        }
-      }
-    }
+    table_.ForEachKeyShared(
+        key_values.size(), [&](int64_t i) { return key_values(i); },
+        [&](const typename Table::Map& map, int64_t i) {
+          const ValueArray* value_vec =
+              gtl::FindOrNull(map, SubtleMustCopyIfIntegral(key_values(i)));
+          if (value_vec != nullptr) {
+            for (int64_t j = 0; j < value_dim; j++) {
+              value_values(i, j) = value_vec->at(j);
+            }
+          } else {
+            // is_full_size_default is true:
+            //   Each key has an independent default value, key_values(i)
+            //   corresponding uses default_flat(i) as its default value.
+            //
+            // is_full_size_default is false:
+            //   All keys will share the default_flat(0) as default value.
+            for (int64_t j = 0; j < value_dim; j++) {
+              value_values(i, j) = is_full_size_default ? default_flat(i, j)
+                                                        : default_flat(0, j);
+            }
+          }
+        });
 
     return absl::OkStatus();
   }
@@ -273,19 +491,33 @@ class MutableHashTableOfTensors final : public LookupInterface {
     const auto value_values = values.flat_inner_dims<V, 2>();
     int64_t value_dim = value_shape_.dim_size(0);
 
-    mutex_lock l(mu_);
-    if (clear) {
-      table_.clear();
-    }
-    for (int64_t i = 0; i < key_values.size(); ++i) {
+    auto make_value = [&](int64_t i) {
       ValueArray value_vec;
       for (int64_t j = 0; j < value_dim; j++) {
         V value = value_values(i, j);
         value_vec.push_back(value);
       }
-      gtl::InsertOrUpdate(&table_, SubtleMustCopyIfIntegral(key_values(i)),
-                          value_vec);
+      return value_vec;
+    };
+
+    if (clear) {
+      typename Table::ExclusiveLockAll l(&table_);
+      for (int64_t s = 0; s < table_.num_shards(); ++s) {
+        table_.mutable_shard_map(s)->clear();
+      }
+      for (int64_t i = 0; i < key_values.size(); ++i) {
+        const K key = SubtleMustCopyIfIntegral(key_values(i));
+        gtl::InsertOrUpdate(table_.mutable_shard_map(table_.ShardIndex(key)),
+                            key, make_value(i));
+      }
+      return absl::OkStatus();
     }
+    table_.ForEachKeyExclusive(
+        key_values.size(), [&](int64_t i) { return key_values(i); },
+        [&](typename Table::Map& map, int64_t i) {
+          gtl::InsertOrUpdate(&map, SubtleMustCopyIfIntegral(key_values(i)),
+                              make_value(i));
+        });
     return absl::OkStatus();
   }
 
@@ -297,10 +529,11 @@ class MutableHashTableOfTensors final : public LookupInterface {
   absl::Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
     const auto key_values = keys.flat<K>();
 
-    mutex_lock l(mu_);
-    for (int64_t i = 0; i < key_values.size(); ++i) {
-      table_.erase(SubtleMustCopyIfIntegral(key_values(i)));
-    }
+    table_.ForEachKeyExclusive(
+        key_values.size(), [&](int64_t i) { return key_values(i); },
+        [&](typename Table::Map& map, int64_t i) {
+          map.erase(SubtleMustCopyIfIntegral(key_values(i)));
+        });
     return absl::OkStatus();
   }
 
@@ -310,8 +543,8 @@ class MutableHashTableOfTensors final : public LookupInterface {
   }
 
   absl::Status ExportValues(OpKernelContext* ctx) override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    typename Table::SharedLockAll l(&table_);
+    int64_t size = table_.size_locked();
     int64_t value_dim = value_shape_.dim_size(0);
 
     Tensor* keys;
@@ -334,21 +567,24 @@ class MutableHashTableOfTensors final : public LookupInterface {
 
   int64_t MemoryUsed() const override {
     int64_t ret = 0;
-    tf_shared_lock l(mu_);
-    for (unsigned i = 0; i < table_.bucket_count(); ++i) {
-      size_t bucket_size = table_.bucket_size(i);
-      if (bucket_size == 0) {
-        ret++;
-      } else {
-        ret += bucket_size;
+    typename Table::SharedLockAll l(&table_);
+    for (int64_t s = 0; s < table_.num_shards(); ++s) {
+      const auto& map = table_.shard_map(s);
+      for (unsigned i = 0; i < map.bucket_count(); ++i) {
+        size_t bucket_size = map.bucket_size(i);
+        if (bucket_size == 0) {
+          ret++;
+        } else {
+          ret += bucket_size;
+        }
       }
     }
     return sizeof(MutableHashTableOfTensors) + ret;
   }
 
   absl::Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
-    tf_shared_lock l(mu_);
-    int64_t size = table_.size();
+    typename Table::SharedLockAll l(&table_);
+    int64_t size = table_.size_locked();
     Tensor keys(key_dtype(), TensorShape({size}));
     Tensor values(value_dtype(), TensorShape({size, value_shape_.dim_size(0)}));
     ExportKeysAndValues(&keys, &values);
@@ -359,14 +595,16 @@ class MutableHashTableOfTensors final : public LookupInterface {
     // manager it is created in.
     // TODO(b/181695913): Provide a mechanism for deleting this resource
     // earlier when appropriate.
-    Node* table =
-        ops::SourceOp("MutableHashTableOfTensorsV2",
-                      builder->opts()
-                          .WithName(UniqueNodeName("MutableHashTableOfTensors"))
-                          .WithAttr("use_node_name_sharing", true)
-                          .WithAttr("key_dtype", key_dtype())
-                          .WithAttr("value_dtype", value_dtype())
-                          .WithAttr("value_shape", value_shape_));
+    Node* table = ops::SourceOp(
+        "MutableHashTableOfTensorsV2",
+        WithNumShardsAttr(
+            builder->opts()
+                .WithName(UniqueNodeName("MutableHashTableOfTensors"))
+                .WithAttr("use_node_name_sharing", true)
+                .WithAttr("key_dtype", key_dtype())
+                .WithAttr("value_dtype", value_dtype())
+                .WithAttr("value_shape", value_shape_),
+            table_.num_shards()));
     Node* keys_node = ops::SourceOp(
         "Const",
         builder->opts().WithAttr("dtype", key_dtype()).WithAttr("value", keys));
@@ -385,49 +623,34 @@ class MutableHashTableOfTensors final : public LookupInterface {
   }
 
  private:
+  typedef gtl::InlinedVector<V, 4> ValueArray;
+  typedef ShardedHashMap<K, ValueArray> Table;
+
   // Writes all keys and values into `keys` and `values`. `keys` and `values`
-  // must point to tensors of size `table_.size()`.
-  void ExportKeysAndValues(Tensor* keys, Tensor* values) const
-      TF_SHARED_LOCKS_REQUIRED(mu_) {
+  // must point to tensors of size `table_.size_locked()`. Requires all shards
+  // to be locked.
+  void ExportKeysAndValues(Tensor* keys, Tensor* values) const {
     int64_t value_dim = value_shape_.dim_size(0);
     auto keys_data = keys->flat<K>();
     auto values_data = values->matrix<V>();
     int64_t i = 0;
-    for (auto it = table_.begin(); it != table_.end(); ++it, ++i) {
-      K key = it->first;
-      ValueArray value = it->second;
-      keys_data(i) = key;
-      for (int64_t j = 0; j < value_dim; j++) {
-        values_data(i, j) = value[j];
+    for (int64_t s = 0; s < table_.num_shards(); ++s) {
+      const auto& map = table_.shard_map(s);
+      for (auto it = map.begin(); it != map.end(); ++it, ++i) {
+        K key = it->first;
+        const ValueArray& value = it->second;
+        keys_data(i) = key;
+        for (int64_t j = 0; j < value_dim; j++) {
+          values_data(i, j) = value[j];
+        }
       }
     }
   }
 
   TensorShape value_shape_;
-  mutable mutex mu_;
-  typedef gtl::InlinedVector<V, 4> ValueArray;
-  std::unordered_map<K, ValueArray> table_ TF_GUARDED_BY(mu_);
+  Table table_;
 };
 
-namespace {
-
-template <typename T>
-inline uint64_t HashScalar(const T& key) {
-  return static_cast<uint64_t>(key);
-}
-
-inline uint64_t HashScalar(const tstring& key) { return Hash64(key); }
-
-// If the given shape is a scalar return {1} instead. Otherwise leave it alone.
-TensorShape MaybeVectorizeShape(const TensorShape& shape) {
-  if (shape.dims() == 0) {
-    return TensorShape({1});
-  }
-  return shape;
-}
-
-}  // namespace
-
 // Modeled after densehashtable in https://github.com/sparsehash/sparsehash
 template <class K, class V>
 class MutableDenseHashTable final : public LookupInterface {
@@ -515,54 +738,32 @@ class MutableDenseHashTable final : public LookupInterface {
     const auto default_flat = default_value.flat<V>();
 
     tf_shared_lock l(mu_);
-    const auto key_buckets_matrix = key_buckets_.template matrix<K>();
-    const auto value_buckets_matrix = value_buckets_.template matrix<V>();
-    const auto empty_key_matrix =
-        empty_key_.template shaped<K, 2>({1, key_size});
-    const auto deleted_key_matrix =
-        deleted_key_.template shaped<K, 2>({1, key_size});
-    const int64_t bit_mask = num_buckets_ - 1;
-    // TODO(andreasst): parallelize using work_sharder
-    for (int64_t i = 0; i < num_elements; ++i) {
-      const uint64_t key_hash = HashKey(key_matrix, i);
-      if (empty_key_hash_ == key_hash &&
-          IsEqualKey(empty_key_matrix, 0, key_matrix, i)) {
-        return absl::InvalidArgumentError(
-            "Using the empty_key as a table key is not allowed");
-      }
-      if (deleted_key_hash_ == key_hash &&
-          IsEqualKey(deleted_key_matrix, 0, key_matrix, i)) {
-        return absl::InvalidArgumentError(
-            "Using the deleted_key as a table key is not allowed");
-      }
-      int64_t bucket_index = key_hash & bit_mask;
-      int64_t num_probes = 0;
-      while (true) {
-        if (IsEqualKey(key_buckets_matrix, bucket_index, key_matrix, i)) {
-          for (int64_t j = 0; j < value_size; ++j) {
-            // TODO(andreasst): check if we can get rid of SubtleMustCopy
-            // here and elsewhere in this file.
-            value_matrix(i, j) =
-                SubtleMustCopyIfIntegral(value_buckets_matrix(bucket_index, j));
-          }
-          break;
-        }
-        if (IsEqualKey(key_buckets_matrix, bucket_index, empty_key_matrix, 0)) {
-          for (int64_t j = 0; j < value_size; ++j) {
-            value_matrix(i, j) = SubtleMustCopyIfIntegral(default_flat(j));
-          }
-          break;
-        }
-        ++num_probes;
-        bucket_index =
-            (bucket_index + num_probes) & bit_mask;  // quadratic probing
-        if (num_probes >= num_buckets_) {
-          return absl::InternalError(
-              "Internal error in MutableDenseHashTable lookup");
-        }
-      }
+    const Tensor& key_buckets = key_buckets_;
+    const Tensor& value_buckets = value_buckets_;
+    auto find_range = [&](int64_t begin, int64_t end) {
+      return FindRange(key_matrix, begin, end, key_buckets, value_buckets,
+                       default_flat, &value_matrix);
+    };
+
+    // The caller blocks until all shards are done, so the workers below read
+    // the buckets under the shared lock held by this thread.
+    if (ctx == nullptr || num_elements < kMinParallelFindBatchSize) {
+      return find_range(0, num_elements);
     }
-    return absl::OkStatus();
+    mutex status_mu;
+    absl::Status status;
+    auto worker_threads = *(ctx->device()->tensorflow_cpu_worker_threads());
+    // Each lookup is dominated by one or two cache misses on the buckets.
+    const int64_t cost_per_key = 100 + 10 * (key_size + value_size);
+    Shard(worker_threads.num_threads, worker_threads.workers, num_elements,
+          cost_per_key, [&](int64_t begin, int64_t end) {
+            absl::Status s = find_range(begin, end);
+            if (!s.ok()) {
+              mutex_lock l(status_mu);
+              status.Update(s);
+            }
+          });
+    return status;
   }
 
   absl::Status Insert(OpKernelContext* ctx, const Tensor& key,
@@ -683,6 +884,97 @@ class MutableDenseHashTable final : public LookupInterface {
   }
 
  private:
+  // Batches smaller than this are looked up on the calling thread; below it
+  // the cost of sharding outweighs the parallel speedup.
+  static constexpr int64_t kMinParallelFindBatchSize = 8192;
+
+  // Number of keys ahead of the current one whose home bucket is prefetched,
+  // so that the cache misses of consecutive lookups overlap instead of being
+  // paid one after another.
+  static constexpr int64_t kPrefetchDistance = 16;
+
+  // Looks up keys [begin, end) of `key_matrix` in the given buckets and
+  // writes their values (or the default value) into the same rows of
+  // `value_matrix`. `key_buckets` and `value_buckets` must be protected by
+  // `mu_`, held possibly by another thread waiting on this call.
+  absl::Status FindRange(typename TTypes<K>::ConstMatrix key_matrix,
+                         int64_t begin, int64_t end, const Tensor& key_buckets,
+                         const Tensor& value_buckets,
+                         typename TTypes<V>::ConstFlat default_flat,
+                         typename TTypes<V>::Matrix* value_matrix) const {
+    const int64_t key_size = key_shape_.num_elements();
+    const int64_t value_size = value_shape_.num_elements();
+    const int64_t num_buckets = key_buckets.dim_size(0);
+    const auto key_buckets_matrix = key_buckets.template matrix<K>();
+    const auto value_buckets_matrix = value_buckets.template matrix<V>();
+    const auto empty_key_matrix =
+        empty_key_.template shaped<K, 2>({1, key_size});
+    const auto deleted_key_matrix =
+        deleted_key_.template shaped<K, 2>({1, key_size});
+    const int64_t bit_mask = num_buckets - 1;
+
+    // Ring buffer of the hashes of the keys that have been prefetched but not
+    // yet probed.
+    uint64_t hashes[kPrefetchDistance];
+    auto prefetch = [&](int64_t i) {
+      const uint64_t key_hash = HashKey(key_matrix, i);
+      hashes[i % kPrefetchDistance] = key_hash;
+      const int64_t bucket_index = key_hash & bit_mask;
+      port::prefetch<port::PREFETCH_HINT_T0>(
+          reinterpret_cast<const char*>(&key_buckets_matrix(bucket_index, 0)));
+      port::prefetch<port::PREFETCH_HINT_T0>(reinterpret_cast<const char*>(
+          &value_buckets_matrix(bucket_index, 0)));
+    };
+    const int64_t prefetch_end = std::min(begin + kPrefetchDistance, end);
+    for (int64_t i = begin; i < prefetch_end; ++i) {
+      prefetch(i);
+    }
+
+    for (int64_t i = begin; i < end; ++i) {
+      const uint64_t key_hash = hashes[i % kPrefetchDistance];
+      if (i + kPrefetchDistance < end) {
+        prefetch(i + kPrefetchDistance);
+      }
+      if (empty_key_hash_ == key_hash &&
+          IsEqualKey(empty_key_matrix, 0, key_matrix, i)) {
+        return absl::InvalidArgumentError(
+            "Using the empty_key as a table key is not allowed");
+      }
+      if (deleted_key_hash_ == key_hash &&
+          IsEqualKey(deleted_key_matrix, 0, key_matrix, i)) {
+        return absl::InvalidArgumentError(
+            "Using the deleted_key as a table key is not allowed");
+      }
+      int64_t bucket_index = key_hash & bit_mask;
+      int64_t num_probes = 0;
+      while (true) {
+        if (IsEqualKey(key_buckets_matrix, bucket_index, key_matrix, i)) {
+          for (int64_t j = 0; j < value_size; ++j) {
+            // TODO(andreasst): check if we can get rid of SubtleMustCopy
+            // here and elsewhere in this file.
+            (*value_matrix)(i, j) =
+                SubtleMustCopyIfIntegral(value_buckets_matrix(bucket_index, j));
+          }
+          break;
+        }
+        if (IsEqualKey(key_buckets_matrix, bucket_index, empty_key_matrix, 0)) {
+          for (int64_t j = 0; j < value_size; ++j) {
+            (*value_matrix)(i, j) = SubtleMustCopyIfIntegral(default_flat(j));
+          }
+          break;
+        }
+        ++num_probes;
+        bucket_index =
+            (bucket_index + num_probes) & bit_mask;  // quadratic probing
+        if (num_probes >= num_buckets) {
+          return absl::InternalError(
+              "Internal error in MutableDenseHashTable lookup");
+        }
+      }
+    }
+    return absl::OkStatus();
+  }
+
   absl::Status DoInsert(OpKernelContext* ctx, const Tensor& key,
                         const Tensor& value, bool ignore_empty_and_deleted_key)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -863,9 +1155,9 @@ class MutableDenseHashTable final : public LookupInterface {
 
   // Use a template to allow this function to be used both with Matrix and
   // ConstMatrix types.
-  template <typename MT2>
-  bool IsEqualKey(typename TTypes<K>::Matrix tensor1, int64_t index1,
-                  MT2 tensor2, int64_t index2) const {
+  template <typename MT1, typename MT2>
+  bool IsEqualKey(MT1 tensor1, int64_t index1, MT2 tensor2,
+                  int64_t index2) const {
     for (int64_t i = 0; i < key_shape_.num_elements(); ++i) {
       if (tensor1(index1, i) != tensor2(index2, i)) {
         return false;
@@ -888,6 +1180,138 @@ class MutableDenseHashTable final : public LookupInterface {
   uint64_t deleted_key_hash_;
 };
 
+// Read-only lookup table served directly from a MappedHashTableFile. The file
+// is memory-mapped when the table is created and never copied to the heap, so
+// creating the table costs the same regardless of its size and processes that
+// load the same file share its pages through the page cache.
+template <class K, class V>
+class MappedHashTable final : public LookupInterface {
+ public:
+  MappedHashTable(OpKernelContext* ctx, OpKernel* kernel) {
+    OP_REQUIRES_OK(ctx, GetNodeAttr(kernel->def(), "filename", &filename_));
+    OP_REQUIRES_OK(ctx,
+                   MappedHashTableFile::Open(ctx->env(), filename_, &file_));
+    OP_REQUIRES(
+        ctx,
+        file_->key_dtype() == key_dtype() &&
+            file_->value_dtype() == value_dtype(),
+        absl::InvalidArgumentError(absl::StrCat(
+            "Mapped hash table ", filename_, " maps ",
+            DataTypeString(file_->key_dtype()), " to ",
+            DataTypeString(file_->value_dtype()), " but the op expects ",
+            DataTypeString(key_dtype()), " to ",
+            DataTypeString(value_dtype()))));
+  }
+
+  size_t size() const override { return file_->size(); }
+
+  absl::Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
+                    const Tensor& default_value) override {
+    const auto key_values = key.flat<K>();
+    auto value_values = value->flat<V>();
+    const auto default_flat = default_value.flat<V>();
+    // A default value with the shape of `key` holds one default per key.
+    const bool is_full_size_default =
+        default_flat.size() == value_values.size();
+
+    for (int64_t i = 0; i < key_values.size(); ++i) {
+      const MappedHashTableBucket* bucket =
+          FindBucket(SubtleMustCopyIfIntegral(key_values(i)));
+      if (bucket != nullptr) {
+        value_values(i) = MappedHashTableFile::Value<V>(*bucket);
+      } else {
+        value_values(i) =
+            is_full_size_default ? default_flat(i) : default_flat(0);
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status Insert(OpKernelContext* ctx, const Tensor& keys,
+                      const Tensor& values) override {
+    return absl::FailedPreconditionError(
+        absl::StrCat("Mapped hash table ", filename_, " is read-only"));
+  }
+
+  absl::Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
+    return absl::FailedPreconditionError(
+        absl::StrCat("Mapped hash table ", filename_, " is read-only"));
+  }
+
+  absl::Status ImportValues(OpKernelContext* ctx, const Tensor& keys,
+                            const Tensor& values) override {
+    return absl::FailedPreconditionError(
+        absl::StrCat("Mapped hash table ", filename_, " is read-only"));
+  }
+
+  absl::Status ExportValues(OpKernelContext* ctx) override {
+    const int64_t size = file_->size();
+    Tensor* keys;
+    Tensor* values;
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_output("keys", TensorShape({size}), &keys));
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_output("values", TensorShape({size}), &values));
+    auto keys_data = keys->flat<K>();
+    auto values_data = values->flat<V>();
+    int64_t i = 0;
+    for (uint64_t b = 0; b < file_->num_buckets() && i < size; ++b) {
+      const MappedHashTableBucket& bucket = file_->bucket(b);
+      if (bucket.key_size == MappedHashTableFile::kEmptyBucket) continue;
+      SetKey(bucket, &keys_data(i));
+      values_data(i) = MappedHashTableFile::Value<V>(bucket);
+      ++i;
+    }
+    if (i != size) {
+      return absl::DataLossError(absl::StrCat(
+          "Mapped hash table ", filename_, " holds ", i,
+          " entries but its header records ", size));
+    }
+    return absl::OkStatus();
+  }
+
+  DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
+
+  DataType value_dtype() const override { return DataTypeToEnum<V>::v(); }
+
+  TensorShape key_shape() const final { return TensorShape(); }
+
+  TensorShape value_shape() const override { return TensorShape(); }
+
+  // The mapped pages are backed by the file rather than by heap memory.
+  int64_t MemoryUsed() const override { return sizeof(MappedHashTable); }
+
+  absl::Status AsGraphDef(GraphDefBuilder* builder, Node** out) const override {
+    *out = ops::SourceOp(
+        "MappedHashTable",
+        builder->opts()
+            .WithName(UniqueNodeName("MappedHashTableFromGraphDef"))
+            .WithAttr("use_node_name_sharing", true)
+            .WithAttr("filename", filename_)
+            .WithAttr("key_dtype", key_dtype())
+            .WithAttr("value_dtype", value_dtype()));
+    return absl::OkStatus();
+  }
+
+ private:
+  const MappedHashTableBucket* FindBucket(int64_t key) const {
+    return file_->Find(key);
+  }
+  const MappedHashTableBucket* FindBucket(const tstring& key) const {
+    return file_->Find(absl::string_view(key));
+  }
+
+  void SetKey(const MappedHashTableBucket& bucket, int64_t* key) const {
+    *key = static_cast<int64_t>(bucket.key);
+  }
+  void SetKey(const MappedHashTableBucket& bucket, tstring* key) const {
+    *key = file_->StringKey(bucket);
+  }
+
+  std::string filename_;
+  std::unique_ptr<MappedHashTableFile> file_;
+};
+
 }  // namespace lookup
 
 // Base class for kernels that take a LookupTable handle as the 0th input.
@@ -1254,4 +1678,45 @@ REGISTER_KERNEL(tstring, ResourceHandle);
 
 #undef REGISTER_KERNEL
 
+// Register the MappedHashTable op.
+#define REGISTER_KERNEL(key_dtype, value_dtype)                      \
+  REGISTER_KERNEL_BUILDER(                                           \
+      Name("MappedHashTable")                                        \
+          .Device(DEVICE_CPU)                                        \
+          .TypeConstraint<key_dtype>("key_dtype")                    \
+          .TypeConstraint<value_dtype>("value_dtype"),               \
+      LookupTableOp<lookup::MappedHashTable<key_dtype, value_dtype>, \
+                    key_dtype, value_dtype>)
+
+REGISTER_KERNEL(int64_t, double);
+REGISTER_KERNEL(int64_t, float);
+REGISTER_KERNEL(int64_t, int32_t);
+REGISTER_KERNEL(int64_t, int64_t);
+REGISTER_KERNEL(tstring, double);
+REGISTER_KERNEL(tstring, float);
+REGISTER_KERNEL(tstring, int32_t);
+REGISTER_KERNEL(tstring, int64_t);
+
+#undef REGISTER_KERNEL
+
+// Writes keys and values to a file that MappedHashTable can serve.
+class WriteMappedHashTableOp : public OpKernel {
+ public:
+  explicit WriteMappedHashTableOp(OpKernelConstruction* ctx) : OpKernel(ctx) {}
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor& filename = ctx->input(0);
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(filename.shape()),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "Filename must be a scalar, got shape ",
+                    filename.shape().DebugString())));
+    OP_REQUIRES_OK(ctx, lookup::WriteMappedHashTable(
+                            ctx->env(), filename.scalar<tstring>()(),
+                            ctx->input(1), ctx->input(2)));
+  }
+};
+
+REGISTER_KERNEL_BUILDER(Name("WriteMappedHashTable").Device(DEVICE_CPU),
+                        WriteMappedHashTableOp);
+
 }  // namespace tensorflow
@@ -0,0 +1,303 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/mapped_hash_table.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/byte_order.h"
+#include "tensorflow/core/platform/errors.h"
+
+namespace tensorflow {
+namespace lookup {
+namespace {
+
+constexpr char kMagic[8] = {'T', 'F', 'M', 'H', 'T', 'A', 'B', 'L'};
+constexpr uint32_t kVersion = 1;
+constexpr uint64_t kHashSeed = 0x6d617070656468ULL;
+
+uint64_t HashKey(int64_t key) {
+  return Hash64(reinterpret_cast<const char*>(&key), sizeof(key), kHashSeed);
+}
+
+uint64_t HashKey(absl::string_view key) {
+  return Hash64(key.data(), key.size(), kHashSeed);
+}
+
+bool IsSupportedKeyType(DataType dtype) {
+  return dtype == DT_INT64 || dtype == DT_STRING;
+}
+
+bool IsSupportedValueType(DataType dtype) {
+  return dtype == DT_INT32 || dtype == DT_INT64 || dtype == DT_FLOAT ||
+         dtype == DT_DOUBLE;
+}
+
+uint64_t ValueBits(const Tensor& values, int64_t i) {
+  uint64_t bits = 0;
+  switch (values.dtype()) {
+    case DT_INT32:
+      std::memcpy(&bits, &values.flat<int32_t>()(i), sizeof(int32_t));
+      break;
+    case DT_INT64:
+      std::memcpy(&bits, &values.flat<int64_t>()(i), sizeof(int64_t));
+      break;
+    case DT_FLOAT:
+      std::memcpy(&bits, &values.flat<float>()(i), sizeof(float));
+      break;
+    case DT_DOUBLE:
+      std::memcpy(&bits, &values.flat<double>()(i), sizeof(double));
+      break;
+    default:
+      break;
+  }
+  return bits;
+}
+
+// Returns the smallest power of two that keeps the load factor at or below
+// 1/2.
+uint64_t NumBucketsFor(int64_t num_keys) {
+  uint64_t num_buckets = 2;
+  while (num_buckets < 2 * static_cast<uint64_t>(num_keys)) {
+    num_buckets <<= 1;
+  }
+  return num_buckets;
+}
+
+}  // namespace
+
+absl::Status WriteMappedHashTable(Env* env, const std::string& filename,
+                                  const Tensor& keys, const Tensor& values) {
+  if (!port::kLittleEndian) {
+    return absl::UnimplementedError(
+        "Mapped hash tables are only supported on little-endian hosts");
+  }
+  if (!IsSupportedKeyType(keys.dtype())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported key type for a mapped hash table: ",
+                     DataTypeString(keys.dtype())));
+  }
+  if (!IsSupportedValueType(values.dtype())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported value type for a mapped hash table: ",
+                     DataTypeString(values.dtype())));
+  }
+  if (keys.dims() != 1 || !keys.shape().IsSameSize(values.shape())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Keys and values must be vectors of the same size, got ",
+                     keys.shape().DebugString(), " and ",
+                     values.shape().DebugString()));
+  }
+
+  const int64_t num_keys = keys.NumElements();
+  const uint64_t num_buckets = NumBucketsFor(num_keys);
+  const uint64_t mask = num_buckets - 1;
+  const bool string_keys = keys.dtype() == DT_STRING;
+
+  MappedHashTableBucket empty_bucket;
+  std::memset(&empty_bucket, 0, sizeof(empty_bucket));
+  empty_bucket.key_size = MappedHashTableFile::kEmptyBucket;
+  std::vector<MappedHashTableBucket> buckets(num_buckets, empty_bucket);
+  std::string strings;
+  int64_t num_entries = 0;
+
+  for (int64_t i = 0; i < num_keys; ++i) {
+    absl::string_view string_key;
+    int64_t int_key = 0;
+    uint64_t hash;
+    if (string_keys) {
+      string_key = keys.flat<tstring>()(i);
+      hash = HashKey(string_key);
+    } else {
+      int_key = keys.flat<int64_t>()(i);
+      hash = HashKey(int_key);
+    }
+    const uint32_t hash_tag = hash >> 32;
+    const uint64_t value = ValueBits(values, i);
+
+    uint64_t index = hash & mask;
+    while (true) {
+      MappedHashTableBucket& bucket = buckets[index];
+      if (bucket.key_size == MappedHashTableFile::kEmptyBucket) {
+        if (string_keys) {
+          bucket.key = strings.size();
+          bucket.key_size = string_key.size();
+          strings.append(string_key.data(), string_key.size());
+        } else {
+          bucket.key = static_cast<uint64_t>(int_key);
+          bucket.key_size = 0;
+        }
+        bucket.hash_tag = hash_tag;
+        bucket.value = value;
+        ++num_entries;
+        break;
+      }
+      const bool same_key =
+          bucket.hash_tag == hash_tag &&
+          (string_keys
+               ? absl::string_view(strings.data() + bucket.key,
+                                   bucket.key_size) == string_key
+               : bucket.key == static_cast<uint64_t>(int_key));
+      if (same_key) {
+        if (bucket.value != value) {
+          return errors::FailedPrecondition(
+              "Mapped hash table has different values for the key at index ",
+              i);
+        }
+        break;
+      }
+      index = (index + 1) & mask;
+    }
+  }
+
+  MappedHashTableHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.key_dtype = keys.dtype();
+  header.value_dtype = values.dtype();
+  header.num_entries = num_entries;
+  header.num_buckets = num_buckets;
+  header.strings_offset =
+      sizeof(header) + num_buckets * sizeof(MappedHashTableBucket);
+  header.strings_size = strings.size();
+
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(filename, &file));
+  TF_RETURN_IF_ERROR(file->Append(absl::string_view(
+      reinterpret_cast<const char*>(&header), sizeof(header))));
+  TF_RETURN_IF_ERROR(file->Append(
+      absl::string_view(reinterpret_cast<const char*>(buckets.data()),
+                        buckets.size() * sizeof(MappedHashTableBucket))));
+  TF_RETURN_IF_ERROR(file->Append(strings));
+  return file->Close();
+}
+
+MappedHashTableFile::MappedHashTableFile(
+    std::unique_ptr<ReadOnlyMemoryRegion> region)
+    : region_(std::move(region)) {
+  const char* data = static_cast<const char*>(region_->data());
+  header_ = reinterpret_cast<const MappedHashTableHeader*>(data);
+  buckets_ = reinterpret_cast<const MappedHashTableBucket*>(data +
+                                                            sizeof(*header_));
+  strings_ = data + header_->strings_offset;
+}
+
+absl::Status MappedHashTableFile::Open(
+    Env* env, const std::string& filename,
+    std::unique_ptr<MappedHashTableFile>* file) {
+  if (!port::kLittleEndian) {
+    return absl::UnimplementedError(
+        "Mapped hash tables are only supported on little-endian hosts");
+  }
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  TF_RETURN_IF_ERROR(env->NewReadOnlyMemoryRegionFromFile(filename, &region));
+  const uint64_t length = region->length();
+  if (length < sizeof(MappedHashTableHeader)) {
+    return errors::DataLoss("Mapped hash table file ", filename,
+                            " is too short: ", length, " bytes");
+  }
+  const auto* header =
+      static_cast<const MappedHashTableHeader*>(region->data());
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+    return errors::DataLoss(filename, " is not a mapped hash table file");
+  }
+  if (header->version != kVersion) {
+    return errors::Unimplemented("Unsupported mapped hash table version ",
+                                 header->version, " in ", filename);
+  }
+  if (!IsSupportedKeyType(static_cast<DataType>(header->key_dtype)) ||
+      !IsSupportedValueType(static_cast<DataType>(header->value_dtype))) {
+    return errors::DataLoss("Mapped hash table file ", filename,
+                            " has unsupported key or value types");
+  }
+  const uint64_t num_buckets = header->num_buckets;
+  if (num_buckets == 0 || (num_buckets & (num_buckets - 1)) != 0 ||
+      header->num_entries >= num_buckets ||
+      num_buckets > (length - sizeof(MappedHashTableHeader)) /
+                        sizeof(MappedHashTableBucket)) {
+    return errors::DataLoss("Mapped hash table file ", filename,
+                            " has an invalid bucket count ", num_buckets);
+  }
+  const uint64_t buckets_end = sizeof(MappedHashTableHeader) +
+                               num_buckets * sizeof(MappedHashTableBucket);
+  if (header->strings_offset < buckets_end ||
+      header->strings_offset > length ||
+      header->strings_size > length - header->strings_offset) {
+    return errors::DataLoss("Mapped hash table file ", filename,
+                            " has an invalid string section");
+  }
+  file->reset(new MappedHashTableFile(std::move(region)));
+  return absl::OkStatus();
+}
+
+template <typename Matches>
+const MappedHashTableBucket* MappedHashTableFile::Probe(
+    uint64_t hash, Matches matches) const {
+  const uint64_t mask = header_->num_buckets - 1;
+  const uint32_t hash_tag = hash >> 32;
+  uint64_t index = hash & mask;
+  // The writer keeps at least half of the buckets empty, so a well-formed file
+  // always terminates at an empty bucket; the probe limit guards against
+  // corrupt files.
+  for (uint64_t num_probes = 0; num_probes < header_->num_buckets;
+       ++num_probes) {
+    const MappedHashTableBucket& bucket = buckets_[index];
+    if (bucket.key_size == kEmptyBucket) {
+      return nullptr;
+    }
+    if (bucket.hash_tag == hash_tag && matches(bucket)) {
+      return &bucket;
+    }
+    index = (index + 1) & mask;
+  }
+  return nullptr;
+}
+
+const MappedHashTableBucket* MappedHashTableFile::Find(int64_t key) const {
+  return Probe(HashKey(key), [key](const MappedHashTableBucket& bucket) {
+    return bucket.key == static_cast<uint64_t>(key);
+  });
+}
+
+const MappedHashTableBucket* MappedHashTableFile::Find(
+    absl::string_view key) const {
+  return Probe(HashKey(key), [this, key](const MappedHashTableBucket& bucket) {
+    return bucket.key_size == key.size() && StringKey(bucket) == key;
+  });
+}
+
+absl::string_view MappedHashTableFile::StringKey(
+    const MappedHashTableBucket& bucket) const {
+  if (bucket.key > header_->strings_size ||
+      bucket.key_size > header_->strings_size - bucket.key) {
+    return absl::string_view();
+  }
+  return absl::string_view(strings_ + bucket.key, bucket.key_size);
+}
+
+}  // namespace lookup
+}  // namespace tensorflow
@@ -0,0 +1,143 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_MAPPED_HASH_TABLE_H_
+#define TENSORFLOW_CORE_KERNELS_MAPPED_HASH_TABLE_H_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+
+namespace tensorflow {
+namespace lookup {
+
+// File format for immutable hash tables that are queried in place through a
+// read-only memory mapping. Tables are written once offline with
+// WriteMappedHashTable() and opened with MappedHashTableFile::Open(), which
+// maps the file without reading it, so opening is O(1) in the table size and
+// the pages are shared through the page cache by all processes on a host.
+//
+// Layout, in host byte order (only little-endian hosts are supported):
+//
+//   MappedHashTableHeader
+//   MappedHashTableBucket[num_buckets]  open addressing, linear probing
+//   char[strings_size]                  bytes of DT_STRING keys
+//
+// Supported key types are DT_INT64 and DT_STRING. Values may be DT_INT32,
+// DT_INT64, DT_FLOAT or DT_DOUBLE and are stored zero-padded to 8 bytes.
+
+struct MappedHashTableHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t key_dtype;
+  uint32_t value_dtype;
+  uint32_t reserved;
+  uint64_t num_entries;
+  // Always a power of two.
+  uint64_t num_buckets;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+};
+
+struct MappedHashTableBucket {
+  // The key for DT_INT64 tables, or the offset of the key bytes in the string
+  // section for DT_STRING tables.
+  uint64_t key;
+  // Length of a DT_STRING key, 0 for DT_INT64 keys, or kEmptyBucket if the
+  // bucket is unused.
+  uint32_t key_size;
+  // Upper 32 bits of the key hash, compared before the key itself.
+  uint32_t hash_tag;
+  uint64_t value;
+};
+
+static_assert(sizeof(MappedHashTableHeader) == 56,
+              "MappedHashTableHeader is part of the file format");
+static_assert(sizeof(MappedHashTableBucket) == 24,
+              "MappedHashTableBucket is part of the file format");
+
+// Writes `keys` and `values`, two vectors of the same length, to `filename`
+// in the format described above. Returns an error if a key is repeated with
+// different values.
+absl::Status WriteMappedHashTable(Env* env, const std::string& filename,
+                                  const Tensor& keys, const Tensor& values);
+
+// A read-only view of a hash table file written by WriteMappedHashTable().
+// Thread-safe.
+class MappedHashTableFile {
+ public:
+  static constexpr uint32_t kEmptyBucket = 0xffffffff;
+
+  // Maps `filename` and validates its header. The bucket and string sections
+  // are only touched by lookups.
+  static absl::Status Open(Env* env, const std::string& filename,
+                           std::unique_ptr<MappedHashTableFile>* file);
+
+  DataType key_dtype() const {
+    return static_cast<DataType>(header_->key_dtype);
+  }
+  DataType value_dtype() const {
+    return static_cast<DataType>(header_->value_dtype);
+  }
+  int64_t size() const { return header_->num_entries; }
+  uint64_t num_buckets() const { return header_->num_buckets; }
+  // Number of bytes mapped.
+  uint64_t length() const { return region_->length(); }
+
+  // Returns the bucket holding `key`, or nullptr if the key is absent.
+  const MappedHashTableBucket* Find(int64_t key) const;
+  const MappedHashTableBucket* Find(absl::string_view key) const;
+
+  const MappedHashTableBucket& bucket(uint64_t i) const { return buckets_[i]; }
+
+  // Returns the key bytes of a bucket in a DT_STRING table, or an empty view
+  // if the bucket points outside of the string section.
+  absl::string_view StringKey(const MappedHashTableBucket& bucket) const;
+
+  template <typename V>
+  static V Value(const MappedHashTableBucket& bucket) {
+    static_assert(sizeof(V) <= sizeof(bucket.value), "Value too large");
+    V value;
+    std::memcpy(&value, &bucket.value, sizeof(V));
+    return value;
+  }
+
+ private:
+  explicit MappedHashTableFile(std::unique_ptr<ReadOnlyMemoryRegion> region);
+
+  template <typename Matches>
+  const MappedHashTableBucket* Probe(uint64_t hash, Matches matches) const;
+
+  std::unique_ptr<ReadOnlyMemoryRegion> region_;
+  const MappedHashTableHeader* header_;
+  const MappedHashTableBucket* buckets_;
+  const char* strings_;
+
+  MappedHashTableFile(const MappedHashTableFile&) = delete;
+  void operator=(const MappedHashTableFile&) = delete;
+};
+
+}  // namespace lookup
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_MAPPED_HASH_TABLE_H_
@@ -0,0 +1,132 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/mapped_hash_table.h"
+
+#include <memory>
+#include <string>
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace lookup {
+namespace {
+
+std::string TablePath(const std::string& name) {
+  return io::JoinPath(testing::TmpDir(), name);
+}
+
+TEST(MappedHashTableTest, Int64Keys) {
+  const std::string path = TablePath("int64_keys");
+  const int64_t kNumKeys = 1000;
+  Tensor keys(DT_INT64, TensorShape({kNumKeys}));
+  Tensor values(DT_FLOAT, TensorShape({kNumKeys}));
+  for (int64_t i = 0; i < kNumKeys; ++i) {
+    keys.flat<int64_t>()(i) = i * 31 - 500;
+    values.flat<float>()(i) = i * 0.5f;
+  }
+  TF_ASSERT_OK(WriteMappedHashTable(Env::Default(), path, keys, values));
+
+  std::unique_ptr<MappedHashTableFile> file;
+  TF_ASSERT_OK(MappedHashTableFile::Open(Env::Default(), path, &file));
+  EXPECT_EQ(file->key_dtype(), DT_INT64);
+  EXPECT_EQ(file->value_dtype(), DT_FLOAT);
+  EXPECT_EQ(file->size(), kNumKeys);
+  for (int64_t i = 0; i < kNumKeys; ++i) {
+    const MappedHashTableBucket* bucket = file->Find(i * 31 - 500);
+    ASSERT_NE(bucket, nullptr) << i;
+    EXPECT_EQ(MappedHashTableFile::Value<float>(*bucket), i * 0.5f);
+  }
+  EXPECT_EQ(file->Find(int64_t{1}), nullptr);
+}
+
+TEST(MappedHashTableTest, StringKeys) {
+  const std::string path = TablePath("string_keys");
+  Tensor keys = test::AsTensor<tstring>({"a", "", "brown", "fox", "a"});
+  Tensor values = test::AsTensor<int64_t>({1, 2, 3, 4, 1});
+  TF_ASSERT_OK(WriteMappedHashTable(Env::Default(), path, keys, values));
+
+  std::unique_ptr<MappedHashTableFile> file;
+  TF_ASSERT_OK(MappedHashTableFile::Open(Env::Default(), path, &file));
+  // The repeated key "a" is stored once.
+  EXPECT_EQ(file->size(), 4);
+  const MappedHashTableBucket* bucket = file->Find(absl::string_view("brown"));
+  ASSERT_NE(bucket, nullptr);
+  EXPECT_EQ(file->StringKey(*bucket), "brown");
+  EXPECT_EQ(MappedHashTableFile::Value<int64_t>(*bucket), 3);
+  bucket = file->Find(absl::string_view(""));
+  ASSERT_NE(bucket, nullptr);
+  EXPECT_EQ(MappedHashTableFile::Value<int64_t>(*bucket), 2);
+  EXPECT_EQ(file->Find(absl::string_view("quick")), nullptr);
+}
+
+TEST(MappedHashTableTest, EmptyTable) {
+  const std::string path = TablePath("empty");
+  TF_ASSERT_OK(WriteMappedHashTable(Env::Default(), path,
+                                    Tensor(DT_INT64, TensorShape({0})),
+                                    Tensor(DT_INT64, TensorShape({0}))));
+  std::unique_ptr<MappedHashTableFile> file;
+  TF_ASSERT_OK(MappedHashTableFile::Open(Env::Default(), path, &file));
+  EXPECT_EQ(file->size(), 0);
+  EXPECT_EQ(file->Find(int64_t{0}), nullptr);
+}
+
+TEST(MappedHashTableTest, ConflictingValues) {
+  EXPECT_FALSE(WriteMappedHashTable(Env::Default(), TablePath("conflict"),
+                                    test::AsTensor<int64_t>({7, 7}),
+                                    test::AsTensor<int64_t>({1, 2}))
+                   .ok());
+}
+
+TEST(MappedHashTableTest, UnsupportedTypes) {
+  EXPECT_FALSE(WriteMappedHashTable(Env::Default(), TablePath("bad_key"),
+                                    test::AsTensor<int32_t>({1}),
+                                    test::AsTensor<int64_t>({1}))
+                   .ok());
+  EXPECT_FALSE(WriteMappedHashTable(Env::Default(), TablePath("bad_value"),
+                                    test::AsTensor<int64_t>({1}),
+                                    test::AsTensor<tstring>({"x"}))
+                   .ok());
+}
+
+TEST(MappedHashTableTest, RejectsCorruptFiles) {
+  const std::string path = TablePath("corrupt");
+  std::unique_ptr<MappedHashTableFile> file;
+
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), path, "short"));
+  EXPECT_FALSE(MappedHashTableFile::Open(Env::Default(), path, &file).ok());
+
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), path, std::string(256, 'x')));
+  EXPECT_FALSE(MappedHashTableFile::Open(Env::Default(), path, &file).ok());
+
+  // A valid file truncated in the middle of its buckets.
+  TF_ASSERT_OK(WriteMappedHashTable(Env::Default(), path,
+                                    test::AsTensor<int64_t>({1, 2, 3}),
+                                    test::AsTensor<int64_t>({1, 2, 3})));
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), path, &contents));
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), path,
+                                 contents.substr(0, contents.size() / 2)));
+  EXPECT_FALSE(MappedHashTableFile::Open(Env::Default(), path, &file).ok());
+}
+
+}  // namespace
+}  // namespace lookup
+}  // namespace tensorflow
@@ -311,6 +311,12 @@ REGISTER_OP("ParallelInterleaveDatasetV4")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
     .Attr("metadata: string = ''")
+    // If positive, a deterministic interleave returns each element at most
+    // `reorder_window` positions away from its place in the interleave order.
+    // Within the window it moves past elements that are not ready yet, and
+    // chooses among the ready ones with a generator seeded by `reorder_seed`.
+    .Attr("reorder_window: int = 0")
+    .Attr("reorder_seed: int = 0")
     .SetTypeConstructor(full_type::VariadicTensorContainer(TFT_DATASET,
                                                            "output_types"))
     .SetShapeFn(shape_inference::ScalarShape);
@@ -650,6 +656,10 @@ REGISTER_OP("ShuffleDatasetV3")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
     .Attr("metadata: string = ''")
+    // If not empty, buffered elements beyond `spill_memory_bytes` are
+    // spilled to files in this local directory.
+    .Attr("spill_directory: string = ''")
+    .Attr("spill_memory_bytes: int = 1073741824")
     .SetTypeConstructor(full_type::VariadicTensorContainer(TFT_DATASET,
                                                            "output_types"))
     .SetShapeFn([](shape_inference::InferenceContext* c) {
@@ -697,6 +707,10 @@ REGISTER_OP("ShuffleAndRepeatDatasetV2")
     .Attr("output_types: list(type) >= 1")
     .Attr("output_shapes: list(shape) >= 1")
     .Attr("metadata: string = ''")
+    // If not empty, buffered elements beyond `spill_memory_bytes` are
+    // spilled to files in this local directory.
+    .Attr("spill_directory: string = ''")
+    .Attr("spill_memory_bytes: int = 1073741824")
     .SetTypeConstructor(full_type::VariadicTensorContainer(TFT_DATASET,
                                                            "output_types"))
     .SetShapeFn([](shape_inference::InferenceContext* c) {
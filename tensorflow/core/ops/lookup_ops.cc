@@ -378,6 +378,35 @@ REGISTER_OP("HashTableV2")
     .SetIsStateful()
     .SetShapeFn(ScalarOutput);
 
+REGISTER_OP("MappedHashTable")
+    .Output("table_handle: resource")
+    .Attr("filename: string")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .Attr("use_node_name_sharing: bool = false")
+    .Attr("key_dtype: {int64, string}")
+    .Attr("value_dtype: {int32, int64, float, double}")
+    .SetIsStateful()
+    .SetShapeFn(ScalarOutput);
+
+REGISTER_OP("WriteMappedHashTable")
+    .Input("filename: string")
+    .Input("keys: key_dtype")
+    .Input("values: value_dtype")
+    .Attr("key_dtype: {int64, string}")
+    .Attr("value_dtype: {int32, int64, float, double}")
+    .SetIsStateful()
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      ShapeHandle keys;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &keys));
+      ShapeHandle values;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &values));
+      TF_RETURN_IF_ERROR(c->Merge(keys, values, &unused));
+      return absl::OkStatus();
+    });
+
 REGISTER_OP("AnonymousHashTable")
     .Output("table_handle: resource")
     .Attr("key_dtype: type")
@@ -402,6 +431,7 @@ REGISTER_OP("MutableHashTableV2")
     .Attr("use_node_name_sharing: bool = false")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
+    .Attr("num_shards: int >= 1 = 1")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableShapeFn);
 
@@ -409,6 +439,7 @@ REGISTER_OP("AnonymousMutableHashTable")
     .Output("table_handle: resource")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
+    .Attr("num_shards: int >= 1 = 1")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableShapeFn);
 
@@ -431,6 +462,7 @@ REGISTER_OP("MutableHashTableOfTensorsV2")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
     .Attr("value_shape: shape = {}")
+    .Attr("num_shards: int >= 1 = 1")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableOfTensorsShapeFn);
 
@@ -439,6 +471,7 @@ REGISTER_OP("AnonymousMutableHashTableOfTensors")
     .Attr("key_dtype: type")
     .Attr("value_dtype: type")
     .Attr("value_shape: shape = {}")
+    .Attr("num_shards: int >= 1 = 1")
     .SetIsStateful()
     .SetShapeFn(MutableHashTableOfTensorsShapeFn);
 
@@ -15,6 +15,8 @@ limitations under the License.
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <optional>
 #include <utility>
@@ -119,6 +121,39 @@ constexpr uint8_t kVarintTag(uint32_t tag) { return (tag << 3) | 0; }
 constexpr uint8_t kDelimitedTag(uint32_t tag) { return (tag << 3) | 2; }
 constexpr uint8_t kFixed32Tag(uint32_t tag) { return (tag << 3) | 5; }
 
+// Decodes the packed varints in [begin, end) into `int64_list`. Runs of eight
+// single-byte varints, which are typical for ids and small counts, are found
+// with one 64-bit test and converted without per-byte branches.
+template <typename Result>
+bool DecodePackedVarints(const uint8_t* begin, const uint8_t* end,
+                         Result* int64_list) {
+  constexpr uint64_t kContinuationBits = 0x8080808080808080ULL;
+  const uint8_t* p = begin;
+  while (p != end) {
+    if (end - p >= 8) {
+      uint64_t word;
+      std::memcpy(&word, p, sizeof(word));
+      if ((word & kContinuationBits) == 0) {
+        for (int i = 0; i < 8; ++i) {
+          int64_list->push_back(static_cast<int64_t>(p[i]));
+        }
+        p += 8;
+        continue;
+      }
+    }
+    // Like protobuf, accept at most 10 bytes and drop the bits beyond 64.
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+      if (p == end || shift > 63) return false;
+      const uint8_t byte = *p++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) break;
+    }
+    int64_list->push_back(static_cast<int64_t>(value));
+  }
+  return true;
+}
+
 namespace parsed {
 
 // ParseDataType has to be called first, then appropriate ParseZzzzList.
@@ -311,15 +346,20 @@ class Feature {
         if (!stream.ExpectTag(kDelimitedTag(1))) return false;  // packed tag
         uint32_t packed_length;
         if (!stream.ReadVarint32(&packed_length)) return false;
-        auto packed_limit = stream.PushLimit(packed_length);
-
-        while (!stream.ExpectAtEnd()) {
-          protobuf_uint64 n;  // There is no API for int64
-          if (!stream.ReadVarint64(&n)) return false;
-          int64_list->push_back(static_cast<int64_t>(n));
+        if (packed_length > 0) {
+          const void* packed_data;
+          int size;
+          if (!stream.GetDirectBufferPointer(&packed_data, &size) ||
+              static_cast<uint32_t>(size) < packed_length) {
+            return false;
+          }
+          const auto* packed = static_cast<const uint8_t*>(packed_data);
+          if (!DecodePackedVarints(packed, packed + packed_length,
+                                   int64_list)) {
+            return false;
+          }
+          if (!stream.Skip(packed_length)) return false;
         }
-
-        stream.PopLimit(packed_limit);
       } else {  // non-packed
         while (!stream.ExpectAtEnd()) {
           if (!stream.ExpectTag(kVarintTag(1))) return false;
@@ -596,26 +636,100 @@ void LogSparseFeatureDataLoss(absl::string_view feature_name) {
   duplicated_sparse_feature->GetCell()->IncrementBy(1);
 }
 
+// State that FastParseSerializedExample() reuses across the examples of a
+// minibatch. Examples of one dataset usually list the same features in the
+// same order, so the config entry of the feature at each position of the
+// previous example is a good guess for the current one, and saves hashing
+// and looking up its name.
+struct ExampleParserState {
+  explicit ExampleParserState(const Config& config)
+      : sparse_feature_last_example(config.sparse.size(), -1),
+        dense_feature_last_example(config.dense.size(), -1),
+        ragged_feature_last_example(config.ragged.size(), -1) {}
+
+  struct FeatureAtPosition {
+    bool seen = false;
+    absl::string_view name;
+    bool in_config = false;
+    std::pair<size_t, Type> d_and_type;
+  };
+
+  parsed::Example parsed_example;
+  // Index of the last example that had each feature.
+  std::vector<int64_t> sparse_feature_last_example;
+  std::vector<int64_t> dense_feature_last_example;
+  std::vector<int64_t> ragged_feature_last_example;
+  // Lookup results for the features of the previous examples, by position.
+  std::vector<FeatureAtPosition> feature_at_position;
+};
+
+const tstring& ConfigFeatureName(const Config& config,
+                                 std::pair<size_t, Type> d_and_type) {
+  switch (d_and_type.second) {
+    case Type::Dense:
+      return config.dense[d_and_type.first].feature_name;
+    case Type::Sparse:
+      return config.sparse[d_and_type.first].feature_name;
+    case Type::Ragged:
+      break;
+  }
+  return config.ragged[d_and_type.first].feature_name;
+}
+
+// Finds the config entry of `feature_name`, the feature at `position` of the
+// current example. Returns false if the config does not have the feature.
+bool FindConfigFeature(
+    absl::string_view feature_name, size_t position, const Config& config,
+    const PresizedCuckooMap<std::pair<size_t, Type>>& config_index,
+    SeededHasher hasher, ExampleParserState* state,
+    std::pair<size_t, Type>* d_and_type) {
+  if (position >= state->feature_at_position.size()) {
+    state->feature_at_position.resize(position + 1);
+  }
+  ExampleParserState::FeatureAtPosition& guess =
+      state->feature_at_position[position];
+  if (guess.seen && guess.name == feature_name) {
+    *d_and_type = guess.d_and_type;
+    return guess.in_config;
+  }
+  // Testing for PresizedCuckooMap collision.
+  // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
+  const bool in_config =
+      config_index.Find(hasher(feature_name), d_and_type) &&
+      ConfigFeatureName(config, *d_and_type) == feature_name;
+  guess.seen = true;
+  guess.name = feature_name;
+  guess.in_config = in_config;
+  guess.d_and_type = *d_and_type;
+  return in_config;
+}
+
 absl::Status FastParseSerializedExample(
     const tstring& serialized_example, const tstring& example_name,
     const size_t example_index, const Config& config,
     const PresizedCuckooMap<std::pair<size_t, Type>>& config_index,
-    SeededHasher hasher, std::vector<Tensor>* output_dense,
+    SeededHasher hasher, ExampleParserState* state,
+    std::vector<Tensor>* output_dense,
     std::vector<SparseBuffer>* output_varlen_dense,
     std::vector<SparseBuffer>* output_sparse,
     std::vector<SparseBuffer>* output_ragged,
     PerExampleFeatureStats* output_stats) {
+  DCHECK(state != nullptr);
   DCHECK(output_dense != nullptr);
   DCHECK(output_sparse != nullptr);
   DCHECK(output_ragged != nullptr);
-  parsed::Example parsed_example;
+  parsed::Example& parsed_example = state->parsed_example;
+  parsed_example.clear();
   if (!ParseExample(serialized_example, &parsed_example)) {
     return absl::InvalidArgumentError(absl::StrCat(
         "Could not parse example input, value: '", serialized_example, "'"));
   }
-  std::vector<int64_t> sparse_feature_last_example(config.sparse.size(), -1);
-  std::vector<int64_t> dense_feature_last_example(config.dense.size(), -1);
-  std::vector<int64_t> ragged_feature_last_example(config.ragged.size(), -1);
+  std::vector<int64_t>& sparse_feature_last_example =
+      state->sparse_feature_last_example;
+  std::vector<int64_t>& dense_feature_last_example =
+      state->dense_feature_last_example;
+  std::vector<int64_t>& ragged_feature_last_example =
+      state->ragged_feature_last_example;
 
   // Handle features present in the example.
   const size_t parsed_example_size = parsed_example.size();
@@ -630,30 +744,22 @@ absl::Status FastParseSerializedExample(
   for (size_t i = 0; i < parsed_example_size; ++i) {
     // This is a logic that standard protobuf parsing is implementing.
     // I.e. last entry in the map overwrites all the previous ones.
-    parsed::FeatureMapEntry& name_and_feature =
-        parsed_example[parsed_example_size - i - 1];
+    const size_t position = parsed_example_size - i - 1;
+    parsed::FeatureMapEntry& name_and_feature = parsed_example[position];
 
     const absl::string_view feature_name = name_and_feature.first;
     parsed::Feature& feature = name_and_feature.second;
 
     std::pair<size_t, Type> d_and_type;
-    uint64_t h = hasher(feature_name);
-    if (!config_index.Find(h, &d_and_type)) continue;
+    if (!FindConfigFeature(feature_name, position, config, config_index,
+                           hasher, state, &d_and_type)) {
+      continue;
+    }
 
     size_t d = d_and_type.first;
     bool is_dense = d_and_type.second == Type::Dense;
     bool is_ragged = d_and_type.second == Type::Ragged;
 
-    {
-      // Testing for PresizedCuckooMap collision.
-      // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
-      const tstring& config_feature_name =
-          is_dense ? config.dense[d].feature_name
-                   : (is_ragged ? config.ragged[d].feature_name
-                                : config.sparse[d].feature_name);
-      if (feature_name != config_feature_name) continue;
-    }
-
     auto example_error = [&](absl::string_view suffix) {
       return absl::InvalidArgumentError(
           absl::StrCat("Name: ", example_name, ", Key: ", feature_name,
@@ -1242,6 +1348,7 @@ absl::Status FastParseExample(const Config& config,
     sparse_buffers[minibatch].resize(config.sparse.size());
     varlen_dense_buffers[minibatch].resize(config.dense.size());
     ragged_buffers[minibatch].resize(config.ragged.size());
+    ExampleParserState state(config);
     size_t start = first_example_of_minibatch(minibatch);
     size_t end = first_example_of_minibatch(minibatch + 1);
     for (size_t e = start; e < end; ++e) {
@@ -1252,7 +1359,7 @@ absl::Status FastParseExample(const Config& config,
       status_of_minibatch[minibatch] = FastParseSerializedExample(
           serialized[e],
           (!example_names.empty() ? example_names[e] : "<unknown>"), e, config,
-          config_index, hasher, &fixed_dense_values,
+          config_index, hasher, &state, &fixed_dense_values,
           &varlen_dense_buffers[minibatch], &sparse_buffers[minibatch],
           &ragged_buffers[minibatch], stats);
       if (!status_of_minibatch[minibatch].ok()) break;
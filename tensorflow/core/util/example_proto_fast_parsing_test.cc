@@ -16,6 +16,8 @@ limitations under the License.
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
 #include <cstdint>
+#include <limits>
+#include <string>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -24,6 +26,7 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/platform/protobuf.h"
@@ -175,6 +178,30 @@ TEST(FastParse, Packed) {
       "\x0a\x0d\x0a\x0b\x0a\x03\x61\x67\x65\x12\x04\x1a\x02\x08\x0d");
 }
 
+TEST(FastParse, PackedInt64Runs) {
+  Example example;
+  Int64List* int64_list =
+      (*example.mutable_features()->mutable_feature())["ids"]
+          .mutable_int64_list();
+  // Runs of single-byte varints, broken up by multi-byte ones.
+  for (int i = 0; i < 20; ++i) int64_list->add_value(i);
+  int64_list->add_value(300);
+  int64_list->add_value(-1);
+  int64_list->add_value(std::numeric_limits<int64_t>::max());
+  for (int i = 0; i < 9; ++i) int64_list->add_value(127 - i);
+  TestCorrectness(Serialize(example));
+}
+
+TEST(FastParse, TruncatedPackedInt64) {
+  // A packed int64 list whose only varint has its continuation bit set.
+  Example example;
+  EXPECT_FALSE(TestFastParse(
+      std::string("\x0a\x0e\x0a\x0c\x0a\x03\x61\x67\x65\x12\x05\x1a\x03\x0a"
+                  "\x01\x80",
+                  16),
+      &example));
+}
+
 TEST(FastParse, ValueBeforeKeyInMap) {
   TestCorrectness("\x0a\x12\x0a\x10\x12\x09\x0a\x07\x0a\x05value\x0a\x03key");
 }
@@ -432,6 +459,34 @@ TEST(TestFastParseExample, Empty) {
   EXPECT_TRUE(status.ok()) << status;
 }
 
+TEST(TestFastParseExample, FeatureOrderChangesAcrossExamples) {
+  auto single_feature = [](const std::string& name, int64_t value) {
+    Example example;
+    (*example.mutable_features()->mutable_feature())[name]
+        .mutable_int64_list()
+        ->add_value(value);
+    return Serialize(example);
+  };
+  // Concatenated examples list their features in concatenation order.
+  const std::vector<tstring> serialized = {
+      single_feature("a", 1) + single_feature("b", 2),
+      single_feature("b", 4) + single_feature("a", 3),
+      single_feature("c", 0) + single_feature("a", 5) + single_feature("b", 6),
+      single_feature("a", 7) + single_feature("b", 8),
+  };
+  FastParseExampleConfig config;
+  AddDenseFeature("a", DT_INT64, {1}, false, 1, &config);
+  AddDenseFeature("b", DT_INT64, {1}, false, 1, &config);
+
+  Result result;
+  TF_ASSERT_OK(FastParseExample(config, serialized, {}, nullptr, &result));
+  ASSERT_EQ(result.dense_values.size(), 2);
+  for (int i = 0; i < serialized.size(); ++i) {
+    EXPECT_EQ(result.dense_values[0].matrix<int64_t>()(i, 0), 2 * i + 1);
+    EXPECT_EQ(result.dense_values[1].matrix<int64_t>()(i, 0), 2 * i + 2);
+  }
+}
+
 TEST(FastParse, OOB_Write_Vulnerability_NonPacked_FloatList) {
   FastParseExampleConfig config;
   AddDenseFeature("f", DT_FLOAT, {1}, false, 1, &config);
@@ -619,6 +674,50 @@ TEST(FastParse, OobWriteVulnerabilityMalformedSparseSequenceExample) {
   EXPECT_TRUE(absl::IsInvalidArgument(status));
 }
 
+// Parses a batch of examples with `num_features` dense features of four
+// values each, alternating between int64 (arg 1 = 0) or float (arg 1 = 1).
+void BM_FastParseExampleDenseNumeric(::testing::benchmark::State& state) {
+  const int num_features = state.range(0);
+  const DataType dtype = state.range(1) == 0 ? DT_INT64 : DT_FLOAT;
+  constexpr int kBatchSize = 4096;
+  constexpr int kValuesPerFeature = 4;
+
+  FastParseExampleConfig config;
+  Example example;
+  for (int f = 0; f < num_features; ++f) {
+    const std::string name = absl::StrCat("feature_", f);
+    config.dense.emplace_back();
+    auto& dense = config.dense.back();
+    dense.feature_name = name;
+    dense.dtype = dtype;
+    dense.shape = PartialTensorShape({kValuesPerFeature});
+    dense.default_value = Tensor(dtype, {});
+    dense.variable_length = false;
+    dense.elements_per_stride = kValuesPerFeature;
+    Feature& feature = (*example.mutable_features()->mutable_feature())[name];
+    for (int v = 0; v < kValuesPerFeature; ++v) {
+      if (dtype == DT_INT64) {
+        feature.mutable_int64_list()->add_value(f * v % 100);
+      } else {
+        feature.mutable_float_list()->add_value(f * 0.5f + v);
+      }
+    }
+  }
+  const std::vector<tstring> serialized(kBatchSize, Serialize(example));
+
+  for (auto s : state) {
+    Result result;
+    TF_CHECK_OK(FastParseExample(config, serialized, {}, nullptr, &result));
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+BENCHMARK(BM_FastParseExampleDenseNumeric)
+    ->ArgPair(30, 0)
+    ->ArgPair(30, 1)
+    ->ArgPair(300, 0)
+    ->ArgPair(300, 1);
+
 }  // namespace
 }  // namespace example
 }  // namespace tensorflow
@@ -18,7 +18,9 @@ import numpy as np
 from tensorflow.python.data.benchmarks import benchmark_base
 from tensorflow.python.data.ops import dataset_ops
 from tensorflow.python.data.ops import options as options_lib
+from tensorflow.python.framework import dtypes
 from tensorflow.python.framework import sparse_tensor
+from tensorflow.python.ops import math_ops
 from tensorflow.python.ops import random_ops
 
 
@@ -104,6 +106,32 @@ class BatchBenchmark(benchmark_base.DatasetBenchmarkBase):
           },
           name="batch_size_%d_%s" % (batch_size, op_str))
 
+  def benchmark_parallel_batch_large_images(self):
+    batch_size = 64
+    num_range = 2048
+
+    def static_shape(_):
+      return random_ops.random_uniform([512, 512, 3])
+
+    def dynamic_shape(x):
+      # The shape is only known when the function runs, so the batch cannot be
+      # allocated before its elements are produced.
+      return random_ops.random_uniform(
+          math_ops.cast(x * 0, dtypes.int32) + [512, 512, 3])
+
+    for shape_str, f in [("static", static_shape), ("dynamic", dynamic_shape)]:
+      dataset = dataset_ops.Dataset.range(num_range).map(f).batch(
+          batch_size, num_parallel_calls=dataset_ops.AUTOTUNE)
+      self.run_and_report_benchmark(
+          dataset,
+          num_elements=num_range // batch_size,
+          iters=1,
+          extras={
+              "model_name": "batch.benchmark.5",
+              "parameters": "%d.%s" % (batch_size, shape_str),
+          },
+          name="parallel_batch_large_images_%s_shape" % shape_str)
+
 
 if __name__ == "__main__":
   benchmark_base.test.main()
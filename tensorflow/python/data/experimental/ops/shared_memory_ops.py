@@ -0,0 +1,55 @@
+# Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Experimental API for reading elements from shared memory."""
+
+from tensorflow.python.data.ops import dataset_ops
+from tensorflow.python.framework import dtypes
+from tensorflow.python.framework import ops
+from tensorflow.python.ops import gen_experimental_dataset_ops as ged_ops
+
+
+class SharedMemoryDataset(dataset_ops.DatasetSource):
+  """A `Dataset` that reads elements published to a shared memory buffer.
+
+  Another process on the same host publishes the elements with
+  `SharedMemoryElementPublisher`. Every consumer of the buffer reads every
+  element, and the publisher waits for the slowest consumer, so each
+  `consumer_index` in `[0, num_consumers)` must be read by exactly one dataset.
+  The iterator waits until the publisher has created the buffer, and it does
+  not support checkpointing. Not available on Windows.
+  """
+
+  def __init__(self, buffer_name, consumer_index, element_spec):
+    """Creates a `SharedMemoryDataset`.
+
+    Args:
+      buffer_name: A `tf.string` scalar, the name of the shared memory object
+        that the publisher created, e.g. "/tf_data_train".
+      consumer_index: A `tf.int64` scalar, the index of this consumer.
+      element_spec: A (nested) structure of `tf.TensorSpec` objects that
+        matches the published elements.
+    """
+    self._buffer_name = ops.convert_to_tensor(
+        buffer_name, dtype=dtypes.string, name="buffer_name")
+    self._consumer_index = ops.convert_to_tensor(
+        consumer_index, dtype=dtypes.int64, name="consumer_index")
+    self._element_spec = element_spec
+    variant_tensor = ged_ops.shared_memory_dataset(
+        self._buffer_name, self._consumer_index, **self._flat_structure)
+    super(SharedMemoryDataset, self).__init__(variant_tensor)
+
+  @property
+  def element_spec(self):
+    return self._element_spec
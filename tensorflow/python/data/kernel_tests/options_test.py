@@ -165,6 +165,8 @@ class OptionsTest(test_base.DatasetTestBase, parameterized.TestCase):
     options.experimental_optimization.seq_interleave_prefetch = True
     options.experimental_warm_start = True
     options.experimental_slack = True
+    options.experimental_compress_memory_cache = True
+    options.experimental_mmap_file_cache = True
     options.dataset_name = "test_name"
     options.framework_type = ["TFDS", "TfGrain"]
     options.threading.max_intra_op_parallelism = 30
@@ -659,6 +659,23 @@ class Options(options_lib.OptionsBase):
       "frequency is determined by the number of devices attached to this "
       "input pipeline. If None, defaults to False.")
 
+  experimental_compress_memory_cache = options_lib.create_option(
+      name="experimental_compress_memory_cache",
+      ty=bool,
+      docstring="Whether in-memory caches created by `Dataset.cache()` hold "
+      "their elements compressed. This trades CPU time on every read of the "
+      "cache for being able to cache larger datasets in memory. If None, "
+      "defaults to False.")
+
+  experimental_mmap_file_cache = options_lib.create_option(
+      name="experimental_mmap_file_cache",
+      ty=bool,
+      docstring="Whether file caches written by `Dataset.cache(filename)` use "
+      "a memory-mapped file format instead of a tensor bundle. Caches in this "
+      "format support random access, such as global shuffling. Existing "
+      "caches are read in the format they were written in. If None, defaults "
+      "to False.")
+
   experimental_symbolic_checkpoint = options_lib.create_option(
       name="experimental_symbolic_checkpoint",
       ty=bool,
@@ -761,6 +778,10 @@ class Options(options_lib.OptionsBase):
     pb.optimization_options.CopyFrom(self.experimental_optimization._to_proto())  # pylint: disable=protected-access
     if self.experimental_slack is not None:
       pb.slack = self.experimental_slack
+    if self.experimental_compress_memory_cache is not None:
+      pb.compress_memory_cache = self.experimental_compress_memory_cache
+    if self.experimental_mmap_file_cache is not None:
+      pb.mmap_file_cache = self.experimental_mmap_file_cache
     if self.experimental_symbolic_checkpoint is not None:
       pb.symbolic_checkpoint = self.experimental_symbolic_checkpoint
     if self.experimental_warm_start is not None:
@@ -786,6 +807,10 @@ class Options(options_lib.OptionsBase):
     self.experimental_optimization._from_proto(pb.optimization_options)  # pylint: disable=protected-access
     if pb.WhichOneof("optional_slack") is not None:
       self.experimental_slack = pb.slack
+    if pb.WhichOneof("optional_compress_memory_cache") is not None:
+      self.experimental_compress_memory_cache = pb.compress_memory_cache
+    if pb.WhichOneof("optional_mmap_file_cache") is not None:
+      self.experimental_mmap_file_cache = pb.mmap_file_cache
     if pb.WhichOneof("optional_symbolic_checkpoint") is not None:
       self.experimental_symbolic_checkpoint = pb.symbolic_checkpoint
     if pb.WhichOneof("optional_warm_start") is not None: